@@ -142,7 +142,13 @@ typedef enum {
   /* RISC-V fatal codes */
   RISCV_FATAL_NO_TIMEBASE_FREQUENCY_IN_DEVICE_TREE = BSP_FATAL_CODE_BLOCK(13),
   RISCV_FATAL_NO_NS16550_REG_IN_DEVICE_TREE,
-  RISCV_FATAL_NO_NS16550_CLOCK_FREQUENCY_IN_DEVICE_TREE
+  RISCV_FATAL_NO_NS16550_CLOCK_FREQUENCY_IN_DEVICE_TREE,
+
+  /* amd64 fatal codes */
+  AMD64_FATAL_CLOCK_IRQ_INSTALL = BSP_FATAL_CODE_BLOCK(14),
+  AMD64_FATAL_CLOCK_CALIBRATION,
+  AMD64_FATAL_SMP_IPI_INSTALL,
+  AMD64_FATAL_WORK_AREA
 } bsp_fatal_code;
 
 RTEMS_NO_RETURN static inline void
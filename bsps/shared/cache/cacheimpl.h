@@ -28,6 +28,13 @@
  *  strongly recommended to provide the implementation in terms of static
  *  inline functions for performance reasons.
  *
+ *  It can define
+ *
+ *    #define CPU_CACHE_SUPPORT_PROVIDES_DATA_PREFETCH
+ *
+ *  if it provides _CPU_cache_prefetch_data_range().  Otherwise data prefetch
+ *  hints are ignored.
+ *
  *  The functions below are implemented with CPU dependent inline routines
  *  found in the cache.c files for each CPU. In the event that a CPU does
  *  not support a specific function for a cache it has, the CPU dependent
@@ -215,6 +222,23 @@ rtems_cache_invalidate_multiple_data_lines( const void * d_addr, size_t n_bytes
 }
 
 
+/*
+ * This function hints that an area will be accessed soon, so that its data
+ * cache lines may be loaded in advance.
+ */
+void
+rtems_cache_prefetch_multiple_data_lines( const void * d_addr, size_t n_bytes )
+{
+#if defined(CPU_DATA_CACHE_ALIGNMENT) && \
+  defined(CPU_CACHE_SUPPORT_PROVIDES_DATA_PREFETCH)
+  _CPU_cache_prefetch_data_range( d_addr, n_bytes );
+#else
+  (void) d_addr;
+  (void) n_bytes;
+#endif
+}
+
+
 /*
  * This function is responsible for performing a data cache flush.
  * It flushes the entire cache.
@@ -0,0 +1,361 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * Cache manager for amd64.
+ *
+ * The caches of x86 processors are coherent with DMA and instruction fetches,
+ * so the maintenance operations are only required for devices outside the
+ * coherence domain and for persistent memory.  Ranges are written back with
+ * CLWB, which keeps the lines valid, and invalidated with CLFLUSHOPT.  Both
+ * fall back to CLFLUSH on processors without them.  The geometry is read from
+ * the deterministic cache parameters of CPUID leaf 4, or leaf 0x8000001D on
+ * AMD processors.
+ *
+ * There is no way to discard a dirty line without writing it back, so
+ * invalidations also write back, which never loses data.
+ */
+
+#include <bsp.h>
+#include <rtems/score/cpuimpl.h>
+
+/* All amd64 processors use 64 byte cache lines */
+#define AMD64_CACHE_LINE_SIZE 64
+
+#define CPU_DATA_CACHE_ALIGNMENT AMD64_CACHE_LINE_SIZE
+#define CPU_INSTRUCTION_CACHE_ALIGNMENT AMD64_CACHE_LINE_SIZE
+#define CPU_CACHE_SUPPORT_PROVIDES_RANGE_FUNCTIONS
+#define CPU_CACHE_SUPPORT_PROVIDES_CACHE_SIZE_FUNCTIONS
+#define CPU_CACHE_SUPPORT_PROVIDES_INSTRUCTION_SYNC_FUNCTION
+#define CPU_CACHE_SUPPORT_PROVIDES_DATA_PREFETCH
+
+#define AMD64_CACHE_LEVELS 4
+
+#define CPUID_1_EBX_CLFLUSH_SIZE(ebx) ((((ebx) >> 8) & 0xff) * 8)
+#define CPUID_1_EDX_CLFLUSH (1 << 19)
+#define CPUID_7_EBX_CLFLUSHOPT (1 << 23)
+#define CPUID_7_EBX_CLWB (1 << 24)
+#define CPUID_80000001_ECX_TOPOEXT (1 << 22)
+
+#define CPUID_CACHE_TYPE(eax) ((eax) & 0x1f)
+#define CPUID_CACHE_TYPE_NULL 0
+#define CPUID_CACHE_TYPE_DATA 1
+#define CPUID_CACHE_TYPE_INSTRUCTION 2
+#define CPUID_CACHE_TYPE_UNIFIED 3
+#define CPUID_CACHE_LEVEL(eax) (((eax) >> 5) & 0x7)
+#define CPUID_CACHE_WAYS(ebx) ((((ebx) >> 22) & 0x3ff) + 1)
+#define CPUID_CACHE_PARTITIONS(ebx) ((((ebx) >> 12) & 0x3ff) + 1)
+#define CPUID_CACHE_LINE_SIZE(ebx) (((ebx) & 0xfff) + 1)
+#define CPUID_CACHE_SETS(ecx) ((ecx) + 1)
+
+#define CR0_NW (1 << 29)
+#define CR0_CD (1 << 30)
+
+typedef enum {
+  AMD64_CACHE_FLUSH_CLFLUSH,
+  AMD64_CACHE_FLUSH_CLFLUSHOPT,
+  AMD64_CACHE_FLUSH_CLWB
+} amd64_cache_flush_instruction;
+
+static size_t amd64_cache_clflush_size = AMD64_CACHE_LINE_SIZE;
+
+static amd64_cache_flush_instruction amd64_cache_writeback =
+  AMD64_CACHE_FLUSH_CLFLUSH;
+
+static amd64_cache_flush_instruction amd64_cache_invalidate =
+  AMD64_CACHE_FLUSH_CLFLUSH;
+
+/* Cache sizes in bytes by level, index zero is the last level */
+static size_t amd64_cache_data_size[AMD64_CACHE_LEVELS + 1];
+
+static size_t amd64_cache_instruction_size[AMD64_CACHE_LEVELS + 1];
+
+static void amd64_cache_read_geometry(uint32_t leaf)
+{
+  uint32_t subleaf;
+
+  for (subleaf = 0; ; ++subleaf) {
+    uint32_t eax, ebx, ecx, edx;
+    uint32_t type;
+    uint32_t level;
+    size_t size;
+
+    cpuid_subleaf(leaf, subleaf, &eax, &ebx, &ecx, &edx);
+
+    type = CPUID_CACHE_TYPE(eax);
+    if (type == CPUID_CACHE_TYPE_NULL) {
+      break;
+    }
+
+    level = CPUID_CACHE_LEVEL(eax);
+    if (level == 0 || level > AMD64_CACHE_LEVELS) {
+      continue;
+    }
+
+    size = (size_t) CPUID_CACHE_WAYS(ebx) * CPUID_CACHE_PARTITIONS(ebx) *
+      CPUID_CACHE_LINE_SIZE(ebx) * CPUID_CACHE_SETS(ecx);
+
+    if (type != CPUID_CACHE_TYPE_INSTRUCTION) {
+      amd64_cache_data_size[level] = size;
+      amd64_cache_data_size[0] = size;
+    }
+
+    if (type != CPUID_CACHE_TYPE_DATA) {
+      amd64_cache_instruction_size[level] = size;
+      amd64_cache_instruction_size[0] = size;
+    }
+  }
+}
+
+void amd64_cache_initialize(void)
+{
+  uint32_t max_leaf, max_extended_leaf;
+  uint32_t eax, ebx, ecx, edx;
+  bool is_amd;
+
+  cpuid(0, &max_leaf, &ebx, &ecx, &edx);
+  is_amd = ebx == 0x68747541; /* "AuthenticAMD" */
+
+  cpuid(1, &eax, &ebx, &ecx, &edx);
+  if (
+    (edx & CPUID_1_EDX_CLFLUSH) != 0 &&
+    CPUID_1_EBX_CLFLUSH_SIZE(ebx) != 0
+  ) {
+    amd64_cache_clflush_size = CPUID_1_EBX_CLFLUSH_SIZE(ebx);
+  }
+
+  if (max_leaf >= 7) {
+    cpuid_subleaf(7, 0, &eax, &ebx, &ecx, &edx);
+
+    if ((ebx & CPUID_7_EBX_CLFLUSHOPT) != 0) {
+      amd64_cache_writeback = AMD64_CACHE_FLUSH_CLFLUSHOPT;
+      amd64_cache_invalidate = AMD64_CACHE_FLUSH_CLFLUSHOPT;
+    }
+
+    if ((ebx & CPUID_7_EBX_CLWB) != 0) {
+      amd64_cache_writeback = AMD64_CACHE_FLUSH_CLWB;
+    }
+  }
+
+  cpuid(0x80000000, &max_extended_leaf, &ebx, &ecx, &edx);
+
+  if (is_amd) {
+    if (max_extended_leaf >= 0x8000001D) {
+      cpuid(0x80000001, &eax, &ebx, &ecx, &edx);
+
+      if ((ecx & CPUID_80000001_ECX_TOPOEXT) != 0) {
+        amd64_cache_read_geometry(0x8000001D);
+      }
+    }
+  } else if (max_leaf >= 4) {
+    amd64_cache_read_geometry(4);
+  }
+}
+
+static inline uintptr_t amd64_cache_align_down(const void *addr)
+{
+  return (uintptr_t) addr & ~(uintptr_t) (amd64_cache_clflush_size - 1);
+}
+
+static inline void amd64_cache_flush_range(
+  const void *d_addr,
+  size_t n_bytes,
+  amd64_cache_flush_instruction insn
+)
+{
+  uintptr_t addr;
+  uintptr_t end;
+
+  if (n_bytes == 0) {
+    return;
+  }
+
+  addr = amd64_cache_align_down(d_addr);
+  end = (uintptr_t) d_addr + n_bytes;
+
+  switch (insn) {
+    case AMD64_CACHE_FLUSH_CLWB:
+      for (; addr < end; addr += amd64_cache_clflush_size) {
+        __asm__ volatile ( "clwb %0" : "+m" (*(volatile char *) addr) );
+      }
+      break;
+    case AMD64_CACHE_FLUSH_CLFLUSHOPT:
+      for (; addr < end; addr += amd64_cache_clflush_size) {
+        __asm__ volatile ( "clflushopt %0" : "+m" (*(volatile char *) addr) );
+      }
+      break;
+    default:
+      for (; addr < end; addr += amd64_cache_clflush_size) {
+        __asm__ volatile ( "clflush %0" : "+m" (*(volatile char *) addr) );
+      }
+      break;
+  }
+
+  /* CLWB and CLFLUSHOPT are only ordered by fencing operations */
+  __asm__ volatile ( "sfence" : : : "memory" );
+}
+
+static inline void _CPU_cache_flush_data_range(
+  const void *d_addr,
+  size_t n_bytes
+)
+{
+  amd64_cache_flush_range(d_addr, n_bytes, amd64_cache_writeback);
+}
+
+static inline void _CPU_cache_invalidate_data_range(
+  const void *d_addr,
+  size_t n_bytes
+)
+{
+  amd64_cache_flush_range(d_addr, n_bytes, amd64_cache_invalidate);
+}
+
+static inline void _CPU_cache_prefetch_data_range(
+  const void *d_addr,
+  size_t n_bytes
+)
+{
+  uintptr_t addr;
+  uintptr_t end;
+
+  if (n_bytes == 0) {
+    return;
+  }
+
+  addr = (uintptr_t) d_addr & ~(uintptr_t) (AMD64_CACHE_LINE_SIZE - 1);
+  end = (uintptr_t) d_addr + n_bytes;
+
+  for (; addr < end; addr += AMD64_CACHE_LINE_SIZE) {
+    __builtin_prefetch((const void *) addr, 0, 3);
+  }
+}
+
+static inline void _CPU_cache_invalidate_instruction_range(
+  const void *i_addr,
+  size_t n_bytes
+)
+{
+  /* Instruction fetches snoop the data caches */
+  (void) i_addr;
+  (void) n_bytes;
+}
+
+static inline void _CPU_cache_instruction_sync_after_code_change(
+  const void *code_addr,
+  size_t n_bytes
+)
+{
+  uint32_t eax, ebx, ecx, edx;
+
+  (void) code_addr;
+  (void) n_bytes;
+
+  /*
+   * Self-modifying code is detected by the processor, a serializing
+   * instruction discards instructions already fetched from the old code.
+   */
+  cpuid(0, &eax, &ebx, &ecx, &edx);
+}
+
+static inline void _CPU_cache_flush_entire_data(void)
+{
+  __asm__ volatile ( "wbinvd" : : : "memory" );
+}
+
+static inline void _CPU_cache_invalidate_entire_data(void)
+{
+  /* INVD would discard dirty lines of the whole system */
+  __asm__ volatile ( "wbinvd" : : : "memory" );
+}
+
+static inline void _CPU_cache_invalidate_entire_instruction(void)
+{
+  /* Instruction fetches snoop the data caches */
+}
+
+static inline void amd64_cache_set_cr0(uint64_t clear, uint64_t set)
+{
+  uint64_t cr0;
+
+  __asm__ volatile ( "movq %%cr0, %0" : "=r" (cr0) );
+  cr0 = (cr0 & ~clear) | set;
+  __asm__ volatile ( "movq %0, %%cr0" : : "r" (cr0) : "memory" );
+}
+
+static inline void _CPU_cache_enable_data(void)
+{
+  amd64_cache_set_cr0(CR0_CD | CR0_NW, 0);
+}
+
+static inline void _CPU_cache_disable_data(void)
+{
+  amd64_cache_set_cr0(CR0_NW, CR0_CD);
+  _CPU_cache_flush_entire_data();
+}
+
+static inline void _CPU_cache_enable_instruction(void)
+{
+  _CPU_cache_enable_data();
+}
+
+static inline void _CPU_cache_disable_instruction(void)
+{
+  _CPU_cache_disable_data();
+}
+
+static inline void _CPU_cache_freeze_data(void)
+{
+  /* Not supported */
+}
+
+static inline void _CPU_cache_unfreeze_data(void)
+{
+  /* Not supported */
+}
+
+static inline void _CPU_cache_freeze_instruction(void)
+{
+  /* Not supported */
+}
+
+static inline void _CPU_cache_unfreeze_instruction(void)
+{
+  /* Not supported */
+}
+
+static inline size_t _CPU_cache_get_data_cache_size(uint32_t level)
+{
+  return level <= AMD64_CACHE_LEVELS ? amd64_cache_data_size[level] : 0;
+}
+
+static inline size_t _CPU_cache_get_instruction_cache_size(uint32_t level)
+{
+  return level <= AMD64_CACHE_LEVELS ?
+    amd64_cache_instruction_size[level] : 0;
+}
+
+#include "../../../shared/cache/cacheimpl.h"
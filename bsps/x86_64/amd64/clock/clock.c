@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * Clock driver using the local APIC timer of each processor.
+ *
+ * The timer is calibrated against channel 2 of the 8254 PIT and then runs in
+ * periodic mode.  Every processor programs its own local APIC timer, so ticks
+ * are delivered locally without a shared interrupt source: the boot processor
+ * advances the timecounter and the others only process their watchdogs.
+ *
+ * The timecounter is the TSC if it is invariant, otherwise the boot
+ * processor's local APIC timer.
+ */
+
+#include <bsp.h>
+#include <bsp/fatal.h>
+#include <bsp/irq.h>
+#include <apic.h>
+#include <clock.h>
+#include <rtems/counter.h>
+#include <rtems/timecounter.h>
+#include <rtems/score/cpuimpl.h>
+#include <rtems/score/percpu.h>
+#include <rtems/score/smpimpl.h>
+#include <rtems/score/watchdogimpl.h>
+
+#define APIC_TIMER_IDT_VECTOR (BSP_IRQ_VECTOR_BASE + BSP_VECTOR_APIC_TIMER)
+
+static rtems_timecounter_simple amd64_clock_tc;
+
+static struct timecounter amd64_tsc_tc;
+
+static bool amd64_clock_use_tsc;
+
+static uint32_t amd64_clock_frequency;
+
+static uint32_t amd64_clock_reload;
+
+static uint32_t amd64_clock_calibrate(void)
+{
+  uint32_t elapsed;
+
+  lapic_write(APIC_REGISTER_TIMER_DIV, APIC_TIMER_DIVIDE_16);
+  lapic_write(APIC_REGISTER_LVT_TIMER, APIC_LVT_MASKED);
+
+  pit_calibration_start();
+  lapic_write(APIC_REGISTER_TIMER_INITCNT, 0xffffffff);
+  pit_calibration_wait();
+
+  elapsed = 0xffffffff - lapic_read(APIC_REGISTER_TIMER_CURRCNT);
+  lapic_write(APIC_REGISTER_TIMER_INITCNT, 0);
+
+  return (uint32_t) (((uint64_t) elapsed * PIT_FREQUENCY) /
+    PIT_CALIBRATE_COUNT);
+}
+
+static void amd64_clock_start(void)
+{
+  lapic_write(APIC_REGISTER_TIMER_DIV, APIC_TIMER_DIVIDE_16);
+  lapic_write(
+    APIC_REGISTER_LVT_TIMER,
+    APIC_LVT_TIMER_MODE_PERIODIC | APIC_TIMER_IDT_VECTOR
+  );
+  lapic_write(APIC_REGISTER_TIMER_INITCNT, amd64_clock_reload);
+}
+
+#ifdef RTEMS_SMP
+static void amd64_clock_secondary_action(void *arg)
+{
+  (void) arg;
+  amd64_clock_start();
+}
+#endif
+
+static uint32_t amd64_clock_tc_get(rtems_timecounter_simple *tc)
+{
+  return lapic_read(APIC_REGISTER_TIMER_CURRCNT);
+}
+
+static bool amd64_clock_tc_is_pending(rtems_timecounter_simple *tc)
+{
+  return lapic_is_pending(APIC_TIMER_IDT_VECTOR);
+}
+
+static uint32_t amd64_clock_tc_get_timecount(struct timecounter *tc)
+{
+  return rtems_timecounter_simple_downcounter_get(
+    tc,
+    amd64_clock_tc_get,
+    amd64_clock_tc_is_pending
+  );
+}
+
+static void amd64_clock_tc_at_tick(rtems_timecounter_simple *tc)
+{
+  /* The timer reloads itself in periodic mode */
+}
+
+static uint32_t amd64_tsc_get_timecount(struct timecounter *tc)
+{
+  return _CPU_Counter_read();
+}
+
+static void amd64_clock_tc_tick(void)
+{
+  Per_CPU_Control *cpu_self = _Per_CPU_Get();
+
+  if (_Per_CPU_Is_boot_processor(cpu_self)) {
+    if (amd64_clock_use_tsc) {
+      rtems_timecounter_tick();
+    } else {
+      rtems_timecounter_simple_downcounter_tick(
+        &amd64_clock_tc,
+        amd64_clock_tc_get,
+        amd64_clock_tc_at_tick
+      );
+    }
+  } else {
+    _Watchdog_Tick(cpu_self);
+  }
+}
+
+static void amd64_clock_initialize(void)
+{
+  uint64_t us_per_tick = rtems_configuration_get_microseconds_per_tick();
+
+  amd64_clock_frequency = amd64_clock_calibrate();
+  if (amd64_clock_frequency == 0) {
+    bsp_fatal(AMD64_FATAL_CLOCK_CALIBRATION);
+  }
+
+  amd64_clock_reload = (uint32_t)
+    ((amd64_clock_frequency * us_per_tick) / 1000000);
+
+  amd64_clock_start();
+
+#ifdef RTEMS_SMP
+  /*
+   * The secondary processors wait for the start of multitasking at this
+   * point, with their local APIC already enabled.
+   */
+  _SMP_Before_multitasking_action_broadcast(
+    amd64_clock_secondary_action,
+    NULL
+  );
+#endif
+
+  /*
+   * An invariant TSC is cheaper to read than the local APIC and is shared
+   * by all processors, so prefer it as the timecounter when available.
+   */
+  amd64_clock_use_tsc = amd64_tsc_is_invariant();
+
+  if (amd64_clock_use_tsc) {
+    amd64_tsc_tc.tc_get_timecount = amd64_tsc_get_timecount;
+    amd64_tsc_tc.tc_counter_mask = 0xffffffff;
+    amd64_tsc_tc.tc_frequency = rtems_counter_frequency();
+    amd64_tsc_tc.tc_quality = RTEMS_TIMECOUNTER_QUALITY_CLOCK_DRIVER + 100;
+    rtems_timecounter_install(&amd64_tsc_tc);
+  } else {
+    rtems_timecounter_simple_install(
+      &amd64_clock_tc,
+      amd64_clock_frequency,
+      amd64_clock_reload,
+      amd64_clock_tc_get_timecount
+    );
+  }
+}
+
+static void amd64_clock_install_isr(rtems_interrupt_handler isr)
+{
+  rtems_status_code sc;
+
+  sc = rtems_interrupt_handler_install(
+    BSP_VECTOR_APIC_TIMER,
+    "Clock",
+    RTEMS_INTERRUPT_UNIQUE,
+    isr,
+    NULL
+  );
+
+  if (sc != RTEMS_SUCCESSFUL) {
+    bsp_fatal(AMD64_FATAL_CLOCK_IRQ_INSTALL);
+  }
+}
+
+#define Clock_driver_support_install_isr(_new) \
+  amd64_clock_install_isr(_new)
+
+#define Clock_driver_support_initialize_hardware() \
+  amd64_clock_initialize()
+
+#define Clock_driver_timecounter_tick() amd64_clock_tc_tick()
+
+#include "../../../shared/dev/clock/clockimpl.h"
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <bsp.h>
+#include <clock.h>
+#include <rtems/score/cpuimpl.h>
+
+void pit_calibration_start(void)
+{
+  uint8_t gate;
+
+  /* Enable channel 2's gate with the speaker disconnected */
+  gate = inport_byte(PIT_PORT_GATE);
+  gate = (gate & ~PIT_GATE_SPEAKER_ENABLE) | PIT_GATE_CHAN2_ENABLE;
+  outport_byte(PIT_PORT_GATE, gate);
+
+  outport_byte(
+    PIT_PORT_MCR,
+    PIT_MCR_CHAN2 | PIT_MCR_ACCESS_LOHI | PIT_MCR_MODE_TERMINAL
+  );
+  outport_byte(PIT_PORT_CHAN2, PIT_CALIBRATE_COUNT & 0xff);
+  /* Writing the high byte starts the countdown */
+  outport_byte(PIT_PORT_CHAN2, (PIT_CALIBRATE_COUNT >> 8) & 0xff);
+}
+
+void pit_calibration_wait(void)
+{
+  while ((inport_byte(PIT_PORT_GATE) & PIT_GATE_CHAN2_OUTPUT) == 0) {
+    /* Wait for the PIT to reach its terminal count */
+  }
+}
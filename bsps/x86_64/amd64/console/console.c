@@ -27,6 +27,7 @@
 #include <libchip/ns16550.h>
 #include <rtems/bspIo.h>
 #include <bsp.h>
+#include <bsp/irq.h>
 #include <bsp/console-termios.h>
 #include <rtems/score/cpuimpl.h>
 
@@ -45,17 +46,25 @@ static ns16550_context amd64_uart_context = {
   .get_reg = amd64_uart_get_register,
   .set_reg = amd64_uart_set_register,
   .port = (uintptr_t) COM1_BASE_IO,
-  .initial_baud = COM1_CLOCK_RATE
+  .irq = BSP_UART_COM1_IRQ,
+  .clock = COM1_CLOCK_RATE,
+  .initial_baud = 115200
 };
 
 /*
- * XXX: We should use the interrupt based handler once interrupts are supported
+ * The interrupt driven handler fills the 16-byte transmit FIFO at once and
+ * drains the receive FIFO on each interrupt, so termios only sees one
+ * interrupt per FIFO load. ns16550_probe() sets OUT2 in the modem control
+ * register, which gates the UART's IRQ line on PC compatible hardware.
+ *
+ * printk() still goes through the polled output_char() below, so that it
+ * works before interrupts are enabled and from interrupt context.
  */
 const console_device console_device_table[] = {
     {
       .device_file = "/dev/console",
-      .probe = console_device_probe_default,
-      .handler = &ns16550_handler_polled,
+      .probe = ns16550_probe,
+      .handler = &ns16550_handler_interrupt,
       .context = &amd64_uart_context.base
     }
 };
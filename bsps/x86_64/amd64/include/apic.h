@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _AMD64_APIC_H
+#define _AMD64_APIC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define APIC_BASE_MSR                 0x1B
+#define APIC_BASE_MSR_ENABLE          0x800
+#define APIC_BASE_MSR_BSP             0x100
+#define APIC_BASE_ADDRESS_MASK        0xFFFFFF000ULL
+#define APIC_DEFAULT_BASE             0xFEE00000
+
+/* Register offsets from the local APIC's base address */
+#define APIC_REGISTER_APICID          0x20
+#define APIC_REGISTER_EOI             0xB0
+#define APIC_REGISTER_SPURIOUS        0xF0
+#define APIC_REGISTER_IRR             0x200
+#define APIC_REGISTER_ESR             0x280
+#define APIC_REGISTER_ICR_LOW         0x300
+#define APIC_REGISTER_ICR_HIGH        0x310
+#define APIC_REGISTER_LVT_TIMER       0x320
+#define APIC_REGISTER_TIMER_INITCNT   0x380
+#define APIC_REGISTER_TIMER_CURRCNT   0x390
+#define APIC_REGISTER_TIMER_DIV       0x3E0
+
+#define APIC_SPURIOUS_ENABLE          0x100
+#define APIC_SPURIOUS_VECTOR          0xFF
+
+#define APIC_LVT_MASKED               0x10000
+#define APIC_LVT_TIMER_MODE_PERIODIC  0x20000
+
+#define APIC_ICR_DELIVERY_FIXED       0x000
+#define APIC_ICR_DELIVERY_INIT        0x500
+#define APIC_ICR_DELIVERY_STARTUP     0x600
+#define APIC_ICR_DELIVERY_PENDING     0x1000
+#define APIC_ICR_LEVEL_ASSERT         0x4000
+#define APIC_ICR_TRIGGER_LEVEL        0x8000
+#define APIC_ICR_DESTINATION_SHIFT    24
+
+#define APIC_TIMER_DIVIDE_16          0x3
+#define APIC_TIMER_DIVIDE_VALUE       16
+
+extern volatile uint32_t *amd64_lapic_base;
+
+/**
+ * @brief Enables the calling processor's local APIC.
+ *
+ * Must be called on every processor before it uses its local APIC timer.
+ */
+void lapic_initialize(void);
+
+/**
+ * @brief Returns the local APIC ID of the calling processor.
+ */
+uint32_t lapic_get_id(void);
+
+static inline uint32_t lapic_read(uint32_t reg_offset)
+{
+  return amd64_lapic_base[reg_offset / sizeof(uint32_t)];
+}
+
+static inline void lapic_write(uint32_t reg_offset, uint32_t value)
+{
+  amd64_lapic_base[reg_offset / sizeof(uint32_t)] = value;
+}
+
+/**
+ * @brief Sends an inter-processor interrupt with the given ICR low word to
+ * the local APIC with the given ID and waits until it has been accepted.
+ */
+void lapic_send_ipi(uint32_t apic_id, uint32_t icr_low);
+
+static inline bool lapic_is_pending(uint32_t idt_vector)
+{
+  uint32_t irr = lapic_read(APIC_REGISTER_IRR + (idt_vector / 32) * 0x10);
+
+  return (irr & (1U << (idt_vector % 32))) != 0;
+}
+
+static inline void lapic_eoi(void)
+{
+  lapic_write(APIC_REGISTER_EOI, 0);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _AMD64_APIC_H */
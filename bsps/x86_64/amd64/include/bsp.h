@@ -44,6 +44,14 @@
 extern "C" {
 #endif
 
+#define BSP_FEATURE_IRQ_EXTENSION
+
+/**
+ * @brief Detects the cache geometry and the cache maintenance instructions of
+ * the processor, called by bsp_start().
+ */
+void amd64_cache_initialize(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef LIBBSP_AMD64_IRQ_H
+#define LIBBSP_AMD64_IRQ_H
+
+#ifndef ASM
+
+#include <rtems.h>
+#include <rtems/irq.h>
+#include <rtems/irq-extension.h>
+
+/*
+ * The first 32 IDT vectors are reserved by the architecture for exceptions;
+ * external interrupts are remapped to start right after them.
+ *
+ * The RTEMS interrupt vector number (rtems_vector_number) is the offset from
+ * BSP_IRQ_VECTOR_BASE, i.e. for the legacy 8259 PIC it is the ISA IRQ line.
+ */
+#define BSP_IRQ_VECTOR_BASE     32
+#define BSP_IRQ_LINES_NUMBER    16
+
+#define BSP_PERIODIC_TIMER      0
+#define BSP_KEYBOARD            1
+#define BSP_UART_COM2_IRQ       3
+#define BSP_UART_COM1_IRQ       4
+
+/*
+ * Vectors past the PIC's lines are delivered by the local APIC of each
+ * processor and acknowledged there.
+ */
+#define BSP_VECTOR_APIC_TIMER   BSP_IRQ_LINES_NUMBER
+#define BSP_VECTOR_IPI          (BSP_VECTOR_APIC_TIMER + 1)
+
+#define BSP_INTERRUPT_VECTOR_MIN  0
+#define BSP_INTERRUPT_VECTOR_MAX  BSP_VECTOR_IPI
+
+/**
+ * @brief Dispatches the interrupt handlers of an external interrupt.
+ *
+ * Installed into the CPU vector table for every vector between
+ * BSP_IRQ_VECTOR_BASE and BSP_IRQ_VECTOR_BASE + BSP_INTERRUPT_VECTOR_MAX.
+ *
+ * @param[in] vector The IDT vector number the interrupt arrived on.
+ */
+void amd64_dispatch_isr(uint32_t vector);
+
+#endif /* ASM */
+#endif /* LIBBSP_AMD64_IRQ_H */
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _AMD64_CLOCK_H
+#define _AMD64_CLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 8254 programmable interval timer, used to calibrate the local APIC timer */
+#define PIT_FREQUENCY           1193182
+#define PIT_PORT_CHAN2          0x42
+#define PIT_PORT_MCR            0x43
+#define PIT_MCR_CHAN2           0x80
+#define PIT_MCR_ACCESS_LOHI     0x30
+#define PIT_MCR_MODE_TERMINAL   0x00
+
+/* Port B of the 8255, which gates channel 2 and reflects its output */
+#define PIT_PORT_GATE           0x61
+#define PIT_GATE_CHAN2_ENABLE   0x01
+#define PIT_GATE_SPEAKER_ENABLE 0x02
+#define PIT_GATE_CHAN2_OUTPUT   0x20
+
+/* Calibrate over 10ms */
+#define PIT_CALIBRATE_HZ        100
+#define PIT_CALIBRATE_COUNT     (PIT_FREQUENCY / PIT_CALIBRATE_HZ)
+
+/**
+ * @brief Starts a PIT_CALIBRATE_COUNT long countdown on PIT channel 2.
+ */
+void pit_calibration_start(void);
+
+/**
+ * @brief Busy waits until the countdown started by pit_calibration_start()
+ * expires.
+ */
+void pit_calibration_wait(void);
+
+/**
+ * @brief Returns true if the TSC runs at a constant rate in all ACPI P-, C-
+ * and T-states.
+ */
+bool amd64_tsc_is_invariant(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _AMD64_CLOCK_H */
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef LIBBSP_AMD64_MULTIBOOT2_H
+#define LIBBSP_AMD64_MULTIBOOT2_H
+
+/*
+ * Multiboot2 boot protocol, as implemented by GRUB.  The image carries an EFI
+ * amd64 entry address tag so that GRUB calls _multiboot2_start() in long mode
+ * with the identity mapping of the firmware.  GRUB uses this entry only if
+ * the image also requests that the UEFI boot services are kept, otherwise it
+ * exits them and enters the ELF entry in protected mode.  The boot services
+ * are only used to get the UEFI memory map and are never exited, so their
+ * memory stays reserved.  BIOS boots would enter in protected mode and are
+ * not supported.
+ */
+#define MULTIBOOT2_HEADER_MAGIC                   0xe85250d6
+#define MULTIBOOT2_BOOTLOADER_MAGIC               0x36d76289
+#define MULTIBOOT2_ARCHITECTURE_I386              0
+
+#define MULTIBOOT2_HEADER_TAG_END                 0
+#define MULTIBOOT2_HEADER_TAG_EFI_BS              7
+#define MULTIBOOT2_HEADER_TAG_ENTRY_ADDRESS_EFI64 9
+
+#define MULTIBOOT2_TAG_ALIGN                      8
+
+#define MULTIBOOT2_TAG_TYPE_END                   0
+#define MULTIBOOT2_TAG_TYPE_CMDLINE               1
+#define MULTIBOOT2_TAG_TYPE_MMAP                  6
+#define MULTIBOOT2_TAG_TYPE_EFI64                 12
+#define MULTIBOOT2_TAG_TYPE_EFI_MMAP              17
+#define MULTIBOOT2_TAG_TYPE_EFI_BS                18
+
+#define MULTIBOOT2_MEMORY_AVAILABLE               1
+
+/*
+ * The UEFI conventional memory type.  The boot services code and data types
+ * are in use since the boot services are not exited.
+ */
+#define EFI_CONVENTIONAL_MEMORY                   7
+
+#define EFI_PAGE_SIZE                             4096
+
+#define EFI_SUCCESS                               0
+
+/* Stack used by _multiboot2_start() until the first context switch */
+#define AMD64_MULTIBOOT2_STACK_SIZE               16384
+
+#ifndef ASM
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  uint32_t total_size;
+  uint32_t reserved;
+} multiboot2_info;
+
+typedef struct {
+  uint32_t type;
+  uint32_t size;
+} multiboot2_tag;
+
+typedef struct {
+  uint32_t type;
+  uint32_t size;
+  char string[];
+} multiboot2_tag_string;
+
+typedef struct {
+  uint64_t addr;
+  uint64_t len;
+  uint32_t type;
+  uint32_t zero;
+} multiboot2_mmap_entry;
+
+typedef struct {
+  uint32_t type;
+  uint32_t size;
+  uint32_t entry_size;
+  uint32_t entry_version;
+  multiboot2_mmap_entry entries[];
+} multiboot2_tag_mmap;
+
+typedef struct {
+  uint32_t type;
+  uint32_t pad;
+  uint64_t physical_start;
+  uint64_t virtual_start;
+  uint64_t number_of_pages;
+  uint64_t attribute;
+} efi_memory_descriptor;
+
+typedef struct {
+  uint32_t type;
+  uint32_t size;
+  uint32_t descr_size;
+  uint32_t descr_vers;
+  uint8_t efi_mmap[];
+} multiboot2_tag_efi_mmap;
+
+typedef struct {
+  uint32_t type;
+  uint32_t size;
+  uint64_t pointer;
+} multiboot2_tag_efi64;
+
+typedef struct {
+  uint64_t signature;
+  uint32_t revision;
+  uint32_t header_size;
+  uint32_t crc32;
+  uint32_t reserved;
+} efi_table_header;
+
+typedef uint64_t (__attribute__((ms_abi)) *efi_get_memory_map)(
+  uint64_t *memory_map_size,
+  efi_memory_descriptor *memory_map,
+  uint64_t *map_key,
+  uint64_t *descriptor_size,
+  uint32_t *descriptor_version
+);
+
+/* Only the members up to the ones used by the BSP */
+typedef struct {
+  efi_table_header hdr;
+  void *raise_tpl;
+  void *restore_tpl;
+  void *allocate_pages;
+  void *free_pages;
+  efi_get_memory_map get_memory_map;
+} efi_boot_services;
+
+/* Only the members up to the ones used by the BSP */
+typedef struct {
+  efi_table_header hdr;
+  void *firmware_vendor;
+  uint32_t firmware_revision;
+  void *console_in_handle;
+  void *con_in;
+  void *console_out_handle;
+  void *con_out;
+  void *standard_error_handle;
+  void *std_err;
+  void *runtime_services;
+  efi_boot_services *boot_services;
+} efi_system_table;
+
+/* Set by _multiboot2_start(), zero if the BSP was loaded otherwise */
+extern uint32_t amd64_multiboot2_magic;
+extern const multiboot2_info *amd64_multiboot2_info;
+
+/**
+ * @brief Multiboot2 entry point, see the EFI amd64 entry address tag in
+ * start/multiboot2.S.
+ */
+void _multiboot2_start(void);
+
+/**
+ * @brief Returns the boot information passed by a multiboot2 boot loader, or
+ * NULL if there is none.
+ */
+const multiboot2_info *amd64_multiboot2_get_info(void);
+
+/**
+ * @brief Returns the first tag of the given type in the boot information, or
+ * NULL if there is no such tag.
+ */
+const multiboot2_tag *amd64_multiboot2_find_tag(uint32_t type);
+
+/**
+ * @brief Returns the kernel command line given to the boot loader, or an
+ * empty string.
+ */
+const char *amd64_multiboot2_get_cmdline(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ASM */
+#endif /* LIBBSP_AMD64_MULTIBOOT2_H */
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef LIBBSP_AMD64_PAGE_H
+#define LIBBSP_AMD64_PAGE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AMD64_PAGE_PRESENT   (1 << 0)
+#define AMD64_PAGE_WRITABLE  (1 << 1)
+#define AMD64_PAGE_LARGE     (1 << 7)
+
+#define AMD64_PAGE_SIZE_4K   0x1000UL
+#define AMD64_PAGE_SIZE_2M   0x200000UL
+#define AMD64_PAGE_SIZE_1G   0x40000000UL
+
+#define AMD64_PAGE_TABLE_ENTRIES 512
+
+/*
+ * Without 1GiB pages every GiB needs a page directory of 2MiB pages, which
+ * limits the identity mapping to this many GiB.
+ */
+#ifndef AMD64_PAGE_DIRECTORY_COUNT
+#define AMD64_PAGE_DIRECTORY_COUNT 64
+#endif
+
+/**
+ * @brief Replaces the page tables of the boot loader with an identity mapping
+ * of [0, end) built from 1GiB pages, or 2MiB pages on processors without
+ * them.
+ *
+ * At least the first 4GiB are mapped to keep the memory mapped devices
+ * accessible.  The caching attributes are left to the MTRRs set up by the
+ * firmware.
+ *
+ * @return The end of the mapped address space, which may be below @a end if
+ * the page tables cannot cover it.
+ */
+uintptr_t amd64_page_map_identity(uintptr_t end);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBBSP_AMD64_PAGE_H */
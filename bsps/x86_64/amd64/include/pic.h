@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef LIBBSP_AMD64_PIC_H
+#define LIBBSP_AMD64_PIC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define PIC1_COMMAND  0x20
+#define PIC1_DATA     (PIC1_COMMAND + 1)
+#define PIC2_COMMAND  0xA0
+#define PIC2_DATA     (PIC2_COMMAND + 1)
+
+#define PIC_ICW1_ICW4 0x01
+#define PIC_ICW1_INIT 0x10
+#define PIC_ICW4_8086 0x01
+#define PIC_EOI       0x20
+
+/* Line on the master PIC that the slave PIC cascades through */
+#define PIC_CASCADE_IRQ 2
+
+/**
+ * @brief Remaps both 8259 PICs to start at @a vector_base and masks all
+ * lines.
+ */
+void pic_initialize(uint8_t vector_base);
+
+/**
+ * @brief Unmasks an IRQ line on the 8259 PICs.
+ */
+void pic_unmask_irq(uint8_t irq);
+
+/**
+ * @brief Masks an IRQ line on the 8259 PICs.
+ */
+void pic_mask_irq(uint8_t irq);
+
+/**
+ * @brief Sends an end-of-interrupt command for @a irq to the PIC(s).
+ */
+void pic_eoi(uint8_t irq);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LIBBSP_AMD64_PIC_H */
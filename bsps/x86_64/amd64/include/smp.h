@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef LIBBSP_AMD64_SMP_H
+#define LIBBSP_AMD64_SMP_H
+
+/*
+ * Application processors start in real mode at a 4KiB aligned page below
+ * 1MiB, selected through the vector of the STARTUP IPI.  The trampoline in
+ * start/smp-trampoline.S is copied there and takes them to long mode, using
+ * the parameters the boot processor stores behind its code.
+ */
+#define AMD64_SMP_TRAMPOLINE_ADDRESS  0x8000
+
+/* Offsets into amd64_smp_trampoline_params */
+#define AMD64_SMP_PARAM_CR3           0
+#define AMD64_SMP_PARAM_CR4           8
+#define AMD64_SMP_PARAM_EFER          16
+#define AMD64_SMP_PARAM_STACK         24
+#define AMD64_SMP_PARAM_ENTRY         32
+#define AMD64_SMP_PARAM_CPU_INDEX     40
+#define AMD64_SMP_PARAM_CODE_SELECTOR 44
+#define AMD64_SMP_PARAM_DATA_SELECTOR 46
+#define AMD64_SMP_PARAM_GDTR          48
+#define AMD64_SMP_PARAMS_SIZE         64
+
+#ifndef ASM
+
+#include <stdint.h>
+#include <rtems/score/basedefs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  uint64_t cr3;
+  uint64_t cr4;
+  uint64_t efer;
+  uint64_t stack;
+  uint64_t entry;
+  uint32_t cpu_index;
+  uint16_t code_selector;
+  uint16_t data_selector;
+  uint16_t gdtr_limit;
+  uint64_t gdtr_base;
+  uint8_t reserved[6];
+} RTEMS_PACKED amd64_smp_params;
+
+extern char amd64_smp_trampoline[];
+extern char amd64_smp_trampoline_params[];
+extern char amd64_smp_trampoline_end[];
+
+/**
+ * @brief Entered by the trampoline on the application processor with the
+ * given index, running on its interrupt stack with interrupts disabled.
+ */
+void amd64_smp_start_on_secondary_processor(uint32_t cpu_index)
+  RTEMS_NO_RETURN;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ASM */
+#endif /* LIBBSP_AMD64_SMP_H */
@@ -36,7 +36,8 @@ extern "C" {
  *
  * The linkcmds script sets this function as the entry point, to be jumped into
  * the bootloader. It calls boot_card and kicks the whole RTEMS initialization
- * process off.
+ * process off.  Multiboot2 boot loaders enter through _multiboot2_start()
+ * instead, which sets up a stack and calls this function.
  */
 void _start(void);
 
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <bsp.h>
+#include <apic.h>
+#include <rtems/score/cpu.h>
+#include <rtems/score/cpuimpl.h>
+
+volatile uint32_t *amd64_lapic_base;
+
+/*
+ * Spurious interrupts are not acknowledged through the local APIC's EOI
+ * register, so they must not go through the BSP's dispatcher.
+ */
+static void lapic_spurious_handler(uint32_t vector)
+{
+  (void) vector;
+}
+
+void lapic_initialize(void)
+{
+  uint64_t apic_base_msr;
+
+  apic_base_msr = rdmsr(APIC_BASE_MSR);
+  amd64_lapic_base = (uint32_t *) (uintptr_t)
+    (apic_base_msr & APIC_BASE_ADDRESS_MASK);
+
+  if ((apic_base_msr & APIC_BASE_MSR_ENABLE) == 0) {
+    wrmsr(APIC_BASE_MSR, apic_base_msr | APIC_BASE_MSR_ENABLE);
+  }
+
+  if (amd64_lapic_base == NULL) {
+    amd64_lapic_base = (uint32_t *) APIC_DEFAULT_BASE;
+  }
+
+  if ((apic_base_msr & APIC_BASE_MSR_BSP) != 0) {
+    proc_ptr old_handler;
+
+    _CPU_ISR_install_vector(
+      APIC_SPURIOUS_VECTOR,
+      (proc_ptr) lapic_spurious_handler,
+      &old_handler
+    );
+  }
+
+  lapic_write(APIC_REGISTER_LVT_TIMER, APIC_LVT_MASKED);
+  lapic_write(
+    APIC_REGISTER_SPURIOUS,
+    APIC_SPURIOUS_ENABLE | APIC_SPURIOUS_VECTOR
+  );
+}
+
+uint32_t lapic_get_id(void)
+{
+  return lapic_read(APIC_REGISTER_APICID) >> 24;
+}
+
+void lapic_send_ipi(uint32_t apic_id, uint32_t icr_low)
+{
+  rtems_interrupt_level level;
+
+  /* An interrupt handler sending an IPI must not split the ICR writes */
+  rtems_interrupt_local_disable(level);
+
+  lapic_write(APIC_REGISTER_ESR, 0);
+  lapic_write(
+    APIC_REGISTER_ICR_HIGH,
+    apic_id << APIC_ICR_DESTINATION_SHIFT
+  );
+  lapic_write(APIC_REGISTER_ICR_LOW, icr_low);
+
+  while ((lapic_read(APIC_REGISTER_ICR_LOW) & APIC_ICR_DELIVERY_PENDING) != 0) {
+    /* Wait */
+  }
+
+  rtems_interrupt_local_enable(level);
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <bsp.h>
+#include <bsp/irq.h>
+#include <bsp/irq-generic.h>
+#include <pic.h>
+#include <apic.h>
+#include <rtems/score/cpu.h>
+
+void amd64_dispatch_isr(uint32_t vector)
+{
+  rtems_vector_number irq = vector - BSP_IRQ_VECTOR_BASE;
+
+  bsp_interrupt_handler_dispatch(irq);
+
+  if (irq < BSP_IRQ_LINES_NUMBER) {
+    pic_eoi(irq);
+  } else {
+    lapic_eoi();
+  }
+}
+
+rtems_status_code bsp_interrupt_facility_initialize(void)
+{
+  proc_ptr old_handler;
+  uint32_t vector;
+
+  pic_initialize(BSP_IRQ_VECTOR_BASE);
+  lapic_initialize();
+
+  for (
+    vector = BSP_IRQ_VECTOR_BASE + BSP_INTERRUPT_VECTOR_MIN;
+    vector <= BSP_IRQ_VECTOR_BASE + BSP_INTERRUPT_VECTOR_MAX;
+    vector++
+  ) {
+    _CPU_ISR_install_vector(vector, (proc_ptr) amd64_dispatch_isr, &old_handler);
+  }
+
+  return RTEMS_SUCCESSFUL;
+}
+
+void bsp_interrupt_vector_enable(rtems_vector_number vector)
+{
+  bsp_interrupt_assert(bsp_interrupt_is_valid_vector(vector));
+
+  if (vector == BSP_VECTOR_APIC_TIMER) {
+    lapic_write(
+      APIC_REGISTER_LVT_TIMER,
+      lapic_read(APIC_REGISTER_LVT_TIMER) & ~APIC_LVT_MASKED
+    );
+  } else if (vector == BSP_VECTOR_IPI) {
+    /* Inter-processor interrupts cannot be masked */
+  } else {
+    pic_unmask_irq(vector);
+  }
+}
+
+void bsp_interrupt_vector_disable(rtems_vector_number vector)
+{
+  bsp_interrupt_assert(bsp_interrupt_is_valid_vector(vector));
+
+  if (vector == BSP_VECTOR_APIC_TIMER) {
+    lapic_write(
+      APIC_REGISTER_LVT_TIMER,
+      lapic_read(APIC_REGISTER_LVT_TIMER) | APIC_LVT_MASKED
+    );
+  } else if (vector == BSP_VECTOR_IPI) {
+    /* Inter-processor interrupts cannot be masked */
+  } else {
+    pic_mask_irq(vector);
+  }
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <bsp.h>
+#include <pic.h>
+#include <rtems/score/cpuimpl.h>
+
+RTEMS_INTERRUPT_LOCK_DEFINE(static, pic_lock, "8259 PIC")
+
+/* Both PICs start out fully masked, except for the cascade line */
+static uint16_t pic_imr_cache = 0xFFFF & ~(1 << PIC_CASCADE_IRQ);
+
+/*
+ * Writes to an unused port to give the (possibly slow) PIC time to react to
+ * the previous command.
+ */
+static inline void pic_io_wait(void)
+{
+  outport_byte(0x80, 0);
+}
+
+static void pic_update_imr(uint8_t irq)
+{
+  if (irq < 8) {
+    outport_byte(PIC1_DATA, pic_imr_cache & 0xff);
+  } else {
+    outport_byte(PIC2_DATA, (pic_imr_cache >> 8) & 0xff);
+  }
+}
+
+void pic_initialize(uint8_t vector_base)
+{
+  /* ICW1: start initialization sequence, ICW4 follows */
+  outport_byte(PIC1_COMMAND, PIC_ICW1_INIT | PIC_ICW1_ICW4);
+  pic_io_wait();
+  outport_byte(PIC2_COMMAND, PIC_ICW1_INIT | PIC_ICW1_ICW4);
+  pic_io_wait();
+
+  /* ICW2: vector offsets */
+  outport_byte(PIC1_DATA, vector_base);
+  pic_io_wait();
+  outport_byte(PIC2_DATA, vector_base + 8);
+  pic_io_wait();
+
+  /* ICW3: master has the slave on IRQ2, slave's cascade identity is 2 */
+  outport_byte(PIC1_DATA, 1 << PIC_CASCADE_IRQ);
+  pic_io_wait();
+  outport_byte(PIC2_DATA, PIC_CASCADE_IRQ);
+  pic_io_wait();
+
+  /* ICW4: 8086 mode */
+  outport_byte(PIC1_DATA, PIC_ICW4_8086);
+  pic_io_wait();
+  outport_byte(PIC2_DATA, PIC_ICW4_8086);
+  pic_io_wait();
+
+  outport_byte(PIC1_DATA, pic_imr_cache & 0xff);
+  outport_byte(PIC2_DATA, (pic_imr_cache >> 8) & 0xff);
+}
+
+void pic_unmask_irq(uint8_t irq)
+{
+  rtems_interrupt_lock_context lock_context;
+
+  rtems_interrupt_lock_acquire(&pic_lock, &lock_context);
+  pic_imr_cache &= ~(1 << irq);
+  pic_update_imr(irq);
+  rtems_interrupt_lock_release(&pic_lock, &lock_context);
+}
+
+void pic_mask_irq(uint8_t irq)
+{
+  rtems_interrupt_lock_context lock_context;
+
+  rtems_interrupt_lock_acquire(&pic_lock, &lock_context);
+  pic_imr_cache |= (1 << irq);
+  pic_update_imr(irq);
+  rtems_interrupt_lock_release(&pic_lock, &lock_context);
+}
+
+void pic_eoi(uint8_t irq)
+{
+  if (irq >= 8) {
+    outport_byte(PIC2_COMMAND, PIC_EOI);
+  }
+  outport_byte(PIC1_COMMAND, PIC_EOI);
+}
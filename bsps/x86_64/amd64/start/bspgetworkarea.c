@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * The work area consists of the free memory regions reported by the
+ * multiboot2 boot loader, or of the region defined by the linker script for
+ * other boot loaders.  If the UEFI boot services are kept, then the boot
+ * loader reports their memory as available, so the free regions come from
+ * the UEFI memory map of the firmware instead.  Each region becomes a
+ * separate heap area which bsp_work_area_initialize_with_table() adds through
+ * _Heap_Extend().  Memory below the end of the image is never used, since it
+ * holds the firmware data structures, the SMP trampoline and the image itself.
+ */
+
+#include <bsp.h>
+#include <bsp/bootcard.h>
+#include <bsp/fatal.h>
+#include <multiboot2.h>
+#include <page.h>
+
+#include <string.h>
+
+#define AMD64_WORK_AREA_COUNT_MAX 32
+
+/* Regions smaller than this are not worth a heap area */
+#define AMD64_WORK_AREA_SIZE_MIN AMD64_PAGE_SIZE_4K
+
+#define AMD64_EFI_MMAP_SIZE (16 * 1024)
+
+extern char WorkAreaBase[];
+extern char RamBase[];
+extern char RamSize[];
+
+typedef void (*amd64_region_visitor)(uintptr_t begin, uintptr_t end, void *arg);
+
+typedef struct {
+  Heap_Area areas[AMD64_WORK_AREA_COUNT_MAX];
+  size_t area_count;
+  uintptr_t begin_min;
+  uintptr_t end_max;
+  uintptr_t hole_begin;
+  uintptr_t hole_end;
+} amd64_work_area_context;
+
+static uint64_t amd64_efi_mmap[AMD64_EFI_MMAP_SIZE / sizeof(uint64_t)];
+
+static uint64_t amd64_efi_mmap_size;
+
+static uint64_t amd64_efi_descr_size;
+
+static bool amd64_efi_boot_services;
+
+static bool amd64_visit_mmap(amd64_region_visitor visitor, void *arg)
+{
+  const multiboot2_tag_mmap *mmap;
+  uintptr_t entry_addr;
+  uintptr_t mmap_end;
+
+  mmap = (const multiboot2_tag_mmap *)
+    amd64_multiboot2_find_tag(MULTIBOOT2_TAG_TYPE_MMAP);
+
+  if (mmap == NULL || mmap->entry_size < sizeof(multiboot2_mmap_entry)) {
+    return false;
+  }
+
+  entry_addr = (uintptr_t) &mmap->entries[0];
+  mmap_end = (uintptr_t) mmap + mmap->size;
+
+  while (entry_addr + sizeof(multiboot2_mmap_entry) <= mmap_end) {
+    const multiboot2_mmap_entry *entry;
+
+    entry = (const multiboot2_mmap_entry *) entry_addr;
+
+    if (entry->type == MULTIBOOT2_MEMORY_AVAILABLE) {
+      (*visitor)(entry->addr, entry->addr + entry->len, arg);
+    }
+
+    entry_addr += mmap->entry_size;
+  }
+
+  return true;
+}
+
+static void amd64_visit_efi_descriptors(
+  uintptr_t descr_addr,
+  uintptr_t mmap_end,
+  uintptr_t descr_size,
+  amd64_region_visitor visitor,
+  void *arg
+)
+{
+  while (descr_addr + sizeof(efi_memory_descriptor) <= mmap_end) {
+    const efi_memory_descriptor *descr;
+
+    descr = (const efi_memory_descriptor *) descr_addr;
+
+    /*
+     * The boot services code and data may still be in use, so only the
+     * conventional memory is free.
+     */
+    if (descr->type == EFI_CONVENTIONAL_MEMORY) {
+      (*visitor)(
+        descr->physical_start,
+        descr->physical_start + descr->number_of_pages * EFI_PAGE_SIZE,
+        arg
+      );
+    }
+
+    descr_addr += descr_size;
+  }
+}
+
+static bool amd64_visit_efi_mmap(amd64_region_visitor visitor, void *arg)
+{
+  const multiboot2_tag_efi_mmap *mmap;
+
+  mmap = (const multiboot2_tag_efi_mmap *)
+    amd64_multiboot2_find_tag(MULTIBOOT2_TAG_TYPE_EFI_MMAP);
+
+  if (mmap == NULL || mmap->descr_size < sizeof(efi_memory_descriptor)) {
+    return false;
+  }
+
+  amd64_visit_efi_descriptors(
+    (uintptr_t) &mmap->efi_mmap[0],
+    (uintptr_t) mmap + mmap->size,
+    mmap->descr_size,
+    visitor,
+    arg
+  );
+  return true;
+}
+
+/*
+ * The boot loader provides no UEFI memory map if it keeps the boot services,
+ * so get it from the firmware.  This must be done before the page tables of
+ * the firmware are replaced.
+ */
+static void amd64_get_efi_mmap(void)
+{
+  const multiboot2_tag_efi64 *efi64;
+  const efi_system_table *system_table;
+  uint64_t map_key;
+  uint32_t descr_version;
+  uint64_t status;
+
+  amd64_efi_boot_services =
+    amd64_multiboot2_find_tag(MULTIBOOT2_TAG_TYPE_EFI_BS) != NULL;
+
+  if (!amd64_efi_boot_services) {
+    return;
+  }
+
+  efi64 = (const multiboot2_tag_efi64 *)
+    amd64_multiboot2_find_tag(MULTIBOOT2_TAG_TYPE_EFI64);
+
+  if (efi64 == NULL) {
+    return;
+  }
+
+  system_table = (const efi_system_table *) efi64->pointer;
+  amd64_efi_mmap_size = sizeof(amd64_efi_mmap);
+  status = (*system_table->boot_services->get_memory_map)(
+    &amd64_efi_mmap_size,
+    (efi_memory_descriptor *) &amd64_efi_mmap[0],
+    &map_key,
+    &amd64_efi_descr_size,
+    &descr_version
+  );
+
+  if (
+    status != EFI_SUCCESS
+      || amd64_efi_descr_size < sizeof(efi_memory_descriptor)
+  ) {
+    amd64_efi_mmap_size = 0;
+  }
+}
+
+static void amd64_visit_free_regions(amd64_region_visitor visitor, void *arg)
+{
+  if (amd64_efi_boot_services) {
+    /*
+     * The multiboot2 memory map reports the boot services code and data as
+     * available, so it must not be used.  Without the UEFI memory map only
+     * the region of the linker script is known to be free.
+     */
+    if (amd64_efi_mmap_size != 0) {
+      amd64_visit_efi_descriptors(
+        (uintptr_t) &amd64_efi_mmap[0],
+        (uintptr_t) &amd64_efi_mmap[0] + amd64_efi_mmap_size,
+        amd64_efi_descr_size,
+        visitor,
+        arg
+      );
+      return;
+    }
+  } else {
+    if (amd64_visit_mmap(visitor, arg)) {
+      return;
+    }
+
+    if (amd64_visit_efi_mmap(visitor, arg)) {
+      return;
+    }
+  }
+
+  (*visitor)(
+    (uintptr_t) WorkAreaBase,
+    (uintptr_t) RamBase + (uintptr_t) RamSize,
+    arg
+  );
+}
+
+static void amd64_find_end(uintptr_t begin, uintptr_t end, void *arg)
+{
+  amd64_work_area_context *ctx = arg;
+
+  (void) begin;
+
+  if (end > ctx->end_max) {
+    ctx->end_max = end;
+  }
+}
+
+static void amd64_add_area(
+  amd64_work_area_context *ctx,
+  uintptr_t begin,
+  uintptr_t end
+)
+{
+  Heap_Area *area;
+
+  if (begin >= end || end - begin < AMD64_WORK_AREA_SIZE_MIN) {
+    return;
+  }
+
+  if (ctx->area_count >= AMD64_WORK_AREA_COUNT_MAX) {
+    /* Drop the remaining regions rather than failing the boot */
+    return;
+  }
+
+  area = &ctx->areas[ctx->area_count];
+  ++ctx->area_count;
+  area->begin = (void *) begin;
+  area->size = end - begin;
+}
+
+static void amd64_add_region(uintptr_t begin, uintptr_t end, void *arg)
+{
+  amd64_work_area_context *ctx = arg;
+
+  if (begin < ctx->begin_min) {
+    begin = ctx->begin_min;
+  }
+
+  if (end > ctx->end_max) {
+    end = ctx->end_max;
+  }
+
+  if (begin >= end) {
+    return;
+  }
+
+  /* Keep the boot information, the command line of boot_card() lives in it */
+  if (begin < ctx->hole_end && ctx->hole_begin < end) {
+    amd64_add_area(ctx, begin, ctx->hole_begin);
+    amd64_add_area(ctx, ctx->hole_end, end);
+  } else {
+    amd64_add_area(ctx, begin, end);
+  }
+}
+
+void bsp_work_area_initialize(void)
+{
+  amd64_work_area_context ctx;
+  const multiboot2_info *info;
+
+  memset(&ctx, 0, sizeof(ctx));
+  ctx.begin_min = (uintptr_t) WorkAreaBase;
+
+  info = amd64_multiboot2_get_info();
+
+  if (info != NULL) {
+    ctx.hole_begin = (uintptr_t) info;
+    ctx.hole_end = (uintptr_t) info + info->total_size;
+  }
+
+  amd64_get_efi_mmap();
+
+  /*
+   * Map everything up to the end of the highest free region with large pages,
+   * which keeps TLB misses low even on large heaps.
+   */
+  amd64_visit_free_regions(amd64_find_end, &ctx);
+  ctx.end_max = amd64_page_map_identity(ctx.end_max);
+
+  amd64_visit_free_regions(amd64_add_region, &ctx);
+
+  if (ctx.area_count == 0) {
+    bsp_fatal(AMD64_FATAL_WORK_AREA);
+  }
+
+  bsp_work_area_initialize_with_table(ctx.areas, ctx.area_count);
+}
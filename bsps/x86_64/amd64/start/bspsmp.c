@@ -0,0 +1,552 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * SMP support for the amd64 BSP.
+ *
+ * The local APICs of the processors are enumerated through the ACPI MADT,
+ * or the Intel MultiProcessor Specification tables on systems without ACPI.
+ * Application processors are started with the INIT-SIPI-SIPI sequence and
+ * inter-processor interrupts are fixed interrupts sent through the local
+ * APIC on the BSP_VECTOR_IPI vector.
+ */
+
+#include <bsp.h>
+#include <bsp/fatal.h>
+#include <bsp/irq.h>
+#include <apic.h>
+#include <smp.h>
+#include <rtems/counter.h>
+#include <rtems/score/cpuimpl.h>
+#include <rtems/score/idt.h>
+#include <rtems/score/percpu.h>
+#include <rtems/score/smpimpl.h>
+#include <rtems/score/x86_64.h>
+#include <string.h>
+
+#define AMD64_SMP_START_TIMEOUT_NS 100000000
+
+#define BIOS_EBDA_SEGMENT_POINTER 0x40E
+#define BIOS_ROM_BEGIN 0xE0000
+#define BIOS_ROM_END 0x100000
+#define BIOS_BASE_MEMORY_END 0xA0000
+
+#define ACPI_MADT_TYPE_LOCAL_APIC 0
+#define ACPI_MADT_LOCAL_APIC_ENABLED 0x1
+
+#define MP_ENTRY_PROCESSOR 0
+#define MP_PROCESSOR_ENABLED 0x1
+
+#define CR4_PCIDE (1 << 17)
+#define EFER_LMA (1 << 10)
+
+typedef struct {
+  char signature[8];
+  uint8_t checksum;
+  char oem_id[6];
+  uint8_t revision;
+  uint32_t rsdt_address;
+  uint32_t length;
+  uint64_t xsdt_address;
+  uint8_t extended_checksum;
+  uint8_t reserved[3];
+} RTEMS_PACKED acpi_rsdp;
+
+typedef struct {
+  char signature[4];
+  uint32_t length;
+  uint8_t revision;
+  uint8_t checksum;
+  char oem_id[6];
+  char oem_table_id[8];
+  uint32_t oem_revision;
+  uint32_t creator_id;
+  uint32_t creator_revision;
+} RTEMS_PACKED acpi_sdt_header;
+
+typedef struct {
+  acpi_sdt_header header;
+  uint32_t local_apic_address;
+  uint32_t flags;
+} RTEMS_PACKED acpi_madt;
+
+typedef struct {
+  uint8_t type;
+  uint8_t length;
+  uint8_t processor_id;
+  uint8_t apic_id;
+  uint32_t flags;
+} RTEMS_PACKED acpi_madt_local_apic;
+
+typedef struct {
+  char signature[4];
+  uint32_t config_table;
+  uint8_t length;
+  uint8_t spec_revision;
+  uint8_t checksum;
+  uint8_t features[5];
+} RTEMS_PACKED mp_floating_pointer;
+
+typedef struct {
+  char signature[4];
+  uint16_t length;
+  uint8_t spec_revision;
+  uint8_t checksum;
+  char oem_id[8];
+  char product_id[12];
+  uint32_t oem_table;
+  uint16_t oem_table_size;
+  uint16_t entry_count;
+  uint32_t local_apic_address;
+  uint16_t extended_length;
+  uint8_t extended_checksum;
+  uint8_t reserved;
+} RTEMS_PACKED mp_config_table;
+
+typedef struct {
+  uint8_t type;
+  uint8_t apic_id;
+  uint8_t apic_version;
+  uint8_t flags;
+  uint32_t signature;
+  uint32_t features;
+  uint32_t reserved[2];
+} RTEMS_PACKED mp_processor_entry;
+
+typedef struct {
+  uint16_t limit;
+  uint64_t base;
+} RTEMS_PACKED amd64_gdt_register;
+
+RTEMS_STATIC_ASSERT(
+  offsetof(amd64_smp_params, cr3) == AMD64_SMP_PARAM_CR3,
+  AMD64_SMP_PARAM_CR3
+);
+
+RTEMS_STATIC_ASSERT(
+  offsetof(amd64_smp_params, cr4) == AMD64_SMP_PARAM_CR4,
+  AMD64_SMP_PARAM_CR4
+);
+
+RTEMS_STATIC_ASSERT(
+  offsetof(amd64_smp_params, efer) == AMD64_SMP_PARAM_EFER,
+  AMD64_SMP_PARAM_EFER
+);
+
+RTEMS_STATIC_ASSERT(
+  offsetof(amd64_smp_params, stack) == AMD64_SMP_PARAM_STACK,
+  AMD64_SMP_PARAM_STACK
+);
+
+RTEMS_STATIC_ASSERT(
+  offsetof(amd64_smp_params, entry) == AMD64_SMP_PARAM_ENTRY,
+  AMD64_SMP_PARAM_ENTRY
+);
+
+RTEMS_STATIC_ASSERT(
+  offsetof(amd64_smp_params, cpu_index) == AMD64_SMP_PARAM_CPU_INDEX,
+  AMD64_SMP_PARAM_CPU_INDEX
+);
+
+RTEMS_STATIC_ASSERT(
+  offsetof(amd64_smp_params, code_selector) ==
+    AMD64_SMP_PARAM_CODE_SELECTOR,
+  AMD64_SMP_PARAM_CODE_SELECTOR
+);
+
+RTEMS_STATIC_ASSERT(
+  offsetof(amd64_smp_params, data_selector) ==
+    AMD64_SMP_PARAM_DATA_SELECTOR,
+  AMD64_SMP_PARAM_DATA_SELECTOR
+);
+
+RTEMS_STATIC_ASSERT(
+  offsetof(amd64_smp_params, gdtr_limit) == AMD64_SMP_PARAM_GDTR,
+  AMD64_SMP_PARAM_GDTR
+);
+
+RTEMS_STATIC_ASSERT(
+  sizeof(amd64_smp_params) == AMD64_SMP_PARAMS_SIZE,
+  AMD64_SMP_PARAMS_SIZE
+);
+
+/* Local APIC IDs by processor index, the boot processor comes first */
+static uint32_t amd64_smp_apic_ids[CPU_MAXIMUM_PROCESSORS];
+
+static uint32_t amd64_smp_cpu_count;
+
+static bool amd64_smp_checksum_is_valid(const void *begin, size_t size)
+{
+  const uint8_t *p = begin;
+  uint8_t sum = 0;
+  size_t i;
+
+  for (i = 0; i < size; ++i) {
+    sum += p[i];
+  }
+
+  return sum == 0;
+}
+
+static void amd64_smp_add_processor(uint32_t apic_id)
+{
+  if (
+    apic_id != amd64_smp_apic_ids[0] &&
+    amd64_smp_cpu_count < RTEMS_ARRAY_SIZE(amd64_smp_apic_ids)
+  ) {
+    amd64_smp_apic_ids[amd64_smp_cpu_count] = apic_id;
+    ++amd64_smp_cpu_count;
+  }
+}
+
+static uintptr_t amd64_smp_ebda_begin(void)
+{
+  return (uintptr_t) *(volatile uint16_t *) BIOS_EBDA_SEGMENT_POINTER << 4;
+}
+
+static const void *amd64_smp_find_signature(
+  uintptr_t begin,
+  uintptr_t end,
+  const char *signature,
+  size_t signature_size,
+  size_t size
+)
+{
+  uintptr_t p;
+
+  for (p = begin; p + size <= end; p += 16) {
+    if (
+      memcmp((const void *) p, signature, signature_size) == 0 &&
+      amd64_smp_checksum_is_valid((const void *) p, size)
+    ) {
+      return (const void *) p;
+    }
+  }
+
+  return NULL;
+}
+
+static const acpi_rsdp *amd64_smp_find_rsdp(void)
+{
+  uintptr_t ebda = amd64_smp_ebda_begin();
+  const acpi_rsdp *rsdp = NULL;
+
+  if (ebda != 0) {
+    rsdp = amd64_smp_find_signature(ebda, ebda + 1024, "RSD PTR ", 8, 20);
+  }
+
+  if (rsdp == NULL) {
+    rsdp = amd64_smp_find_signature(
+      BIOS_ROM_BEGIN,
+      BIOS_ROM_END,
+      "RSD PTR ",
+      8,
+      20
+    );
+  }
+
+  return rsdp;
+}
+
+static const acpi_madt *amd64_smp_find_madt(const acpi_rsdp *rsdp)
+{
+  const acpi_sdt_header *sdt;
+  size_t entry_size;
+  size_t entry_count;
+  size_t i;
+
+  if (rsdp->revision >= 2 && rsdp->xsdt_address != 0) {
+    sdt = (const acpi_sdt_header *) (uintptr_t) rsdp->xsdt_address;
+    entry_size = sizeof(uint64_t);
+  } else {
+    sdt = (const acpi_sdt_header *) (uintptr_t) rsdp->rsdt_address;
+    entry_size = sizeof(uint32_t);
+  }
+
+  if (!amd64_smp_checksum_is_valid(sdt, sdt->length)) {
+    return NULL;
+  }
+
+  entry_count = (sdt->length - sizeof(*sdt)) / entry_size;
+
+  for (i = 0; i < entry_count; ++i) {
+    const uint8_t *entry = (const uint8_t *) (sdt + 1) + i * entry_size;
+    const acpi_sdt_header *table;
+    uint64_t address;
+
+    if (entry_size == sizeof(uint64_t)) {
+      memcpy(&address, entry, sizeof(address));
+    } else {
+      uint32_t address_32;
+
+      memcpy(&address_32, entry, sizeof(address_32));
+      address = address_32;
+    }
+
+    table = (const acpi_sdt_header *) (uintptr_t) address;
+
+    if (
+      memcmp(table->signature, "APIC", 4) == 0 &&
+      amd64_smp_checksum_is_valid(table, table->length)
+    ) {
+      return (const acpi_madt *) table;
+    }
+  }
+
+  return NULL;
+}
+
+static bool amd64_smp_parse_madt(void)
+{
+  const acpi_rsdp *rsdp;
+  const acpi_madt *madt;
+  const uint8_t *entry;
+  const uint8_t *end;
+
+  rsdp = amd64_smp_find_rsdp();
+  if (rsdp == NULL) {
+    return false;
+  }
+
+  madt = amd64_smp_find_madt(rsdp);
+  if (madt == NULL) {
+    return false;
+  }
+
+  entry = (const uint8_t *) (madt + 1);
+  end = (const uint8_t *) madt + madt->header.length;
+
+  while (entry + 2 <= end && entry[1] >= 2) {
+    if (entry[0] == ACPI_MADT_TYPE_LOCAL_APIC) {
+      const acpi_madt_local_apic *lapic =
+        (const acpi_madt_local_apic *) entry;
+
+      if ((lapic->flags & ACPI_MADT_LOCAL_APIC_ENABLED) != 0) {
+        amd64_smp_add_processor(lapic->apic_id);
+      }
+    }
+
+    entry += entry[1];
+  }
+
+  return true;
+}
+
+static bool amd64_smp_parse_mp_table(void)
+{
+  uintptr_t ebda = amd64_smp_ebda_begin();
+  const mp_floating_pointer *mpf = NULL;
+  const mp_config_table *config;
+  const uint8_t *entry;
+  uint16_t i;
+
+  if (ebda != 0) {
+    mpf = amd64_smp_find_signature(ebda, ebda + 1024, "_MP_", 4, 16);
+  }
+
+  if (mpf == NULL) {
+    mpf = amd64_smp_find_signature(
+      BIOS_BASE_MEMORY_END - 1024,
+      BIOS_BASE_MEMORY_END,
+      "_MP_",
+      4,
+      16
+    );
+  }
+
+  if (mpf == NULL) {
+    mpf = amd64_smp_find_signature(
+      BIOS_ROM_BEGIN,
+      BIOS_ROM_END,
+      "_MP_",
+      4,
+      16
+    );
+  }
+
+  if (mpf == NULL || mpf->config_table == 0) {
+    return false;
+  }
+
+  config = (const mp_config_table *) (uintptr_t) mpf->config_table;
+
+  if (
+    memcmp(config->signature, "PCMP", 4) != 0 ||
+    !amd64_smp_checksum_is_valid(config, config->length)
+  ) {
+    return false;
+  }
+
+  entry = (const uint8_t *) (config + 1);
+
+  for (i = 0; i < config->entry_count; ++i) {
+    if (entry[0] == MP_ENTRY_PROCESSOR) {
+      const mp_processor_entry *processor =
+        (const mp_processor_entry *) entry;
+
+      if ((processor->flags & MP_PROCESSOR_ENABLED) != 0) {
+        amd64_smp_add_processor(processor->apic_id);
+      }
+
+      entry += sizeof(*processor);
+    } else {
+      entry += 8;
+    }
+  }
+
+  return true;
+}
+
+static void amd64_smp_inter_processor_interrupt(void *arg)
+{
+  (void) arg;
+  _SMP_Inter_processor_interrupt_handler();
+}
+
+void amd64_smp_start_on_secondary_processor(uint32_t cpu_index)
+{
+  _X86_64_SMP_Initialize_processor(cpu_index);
+  amd64_idt_load();
+  _X86_64_FP_Initialize_processor();
+  _X86_64_TLS_Initialize_processor();
+  lapic_initialize();
+
+  _SMP_Start_multitasking_on_secondary_processor();
+}
+
+uint32_t _CPU_SMP_Initialize(void)
+{
+  amd64_smp_apic_ids[0] = lapic_get_id();
+  amd64_smp_cpu_count = 1;
+
+  if (!amd64_smp_parse_madt()) {
+    amd64_smp_parse_mp_table();
+  }
+
+  return amd64_smp_cpu_count;
+}
+
+bool _CPU_SMP_Start_processor(uint32_t cpu_index)
+{
+  const Per_CPU_Control *cpu = _Per_CPU_Get_by_index(cpu_index);
+  uint32_t apic_id = amd64_smp_apic_ids[cpu_index];
+  amd64_smp_params *params;
+  amd64_gdt_register gdtr;
+  uint64_t cr3;
+  uint64_t cr4;
+  uint16_t selector;
+
+  __asm__ volatile ( "movq %%cr3, %0" : "=r" (cr3) );
+  __asm__ volatile ( "movq %%cr4, %0" : "=r" (cr4) );
+
+  /* The trampoline loads CR3 while still in protected mode */
+  if (cr3 > UINT32_MAX) {
+    return false;
+  }
+
+  memcpy(
+    (void *) AMD64_SMP_TRAMPOLINE_ADDRESS,
+    amd64_smp_trampoline,
+    (size_t) (amd64_smp_trampoline_end - amd64_smp_trampoline)
+  );
+
+  params = (amd64_smp_params *) (AMD64_SMP_TRAMPOLINE_ADDRESS +
+    (amd64_smp_trampoline_params - amd64_smp_trampoline));
+
+  __asm__ volatile ( "sgdt %0" : "=m" (gdtr) );
+
+  params->cr3 = cr3;
+  params->cr4 = cr4 & ~(uint64_t) CR4_PCIDE;
+  params->efer = rdmsr(X86_64_MSR_EFER) & ~(uint64_t) EFER_LMA;
+  params->stack = (uintptr_t) cpu->interrupt_stack_high;
+  params->entry = (uintptr_t) amd64_smp_start_on_secondary_processor;
+  params->cpu_index = cpu_index;
+  __asm__ volatile ( "movw %%cs, %0" : "=r" (selector) );
+  params->code_selector = selector;
+  __asm__ volatile ( "movw %%ss, %0" : "=r" (selector) );
+  params->data_selector = selector;
+  params->gdtr_limit = gdtr.limit;
+  params->gdtr_base = gdtr.base;
+
+  lapic_send_ipi(
+    apic_id,
+    APIC_ICR_DELIVERY_INIT | APIC_ICR_TRIGGER_LEVEL | APIC_ICR_LEVEL_ASSERT
+  );
+  rtems_counter_delay_nanoseconds(10000000);
+  lapic_send_ipi(apic_id, APIC_ICR_DELIVERY_INIT | APIC_ICR_TRIGGER_LEVEL);
+
+  /* The second STARTUP IPI is ignored if the first one succeeded */
+  lapic_send_ipi(
+    apic_id,
+    APIC_ICR_DELIVERY_STARTUP | (AMD64_SMP_TRAMPOLINE_ADDRESS >> 12)
+  );
+  rtems_counter_delay_nanoseconds(200000);
+  lapic_send_ipi(
+    apic_id,
+    APIC_ICR_DELIVERY_STARTUP | (AMD64_SMP_TRAMPOLINE_ADDRESS >> 12)
+  );
+
+  /*
+   * The trampoline and its parameters are shared, so the next processor must
+   * not be started before this one left them.
+   */
+  return _Per_CPU_State_wait_for_non_initial_state(
+    cpu_index,
+    AMD64_SMP_START_TIMEOUT_NS
+  );
+}
+
+void _CPU_SMP_Finalize_initialization(uint32_t cpu_count)
+{
+  rtems_status_code sc;
+
+  if (cpu_count > 1) {
+    sc = rtems_interrupt_handler_install(
+      BSP_VECTOR_IPI,
+      "IPI",
+      RTEMS_INTERRUPT_UNIQUE,
+      amd64_smp_inter_processor_interrupt,
+      NULL
+    );
+
+    if (sc != RTEMS_SUCCESSFUL) {
+      bsp_fatal(AMD64_FATAL_SMP_IPI_INSTALL);
+    }
+  }
+}
+
+void _CPU_SMP_Prepare_start_multitasking(void)
+{
+  /* Do nothing */
+}
+
+void _CPU_SMP_Send_interrupt(uint32_t target_processor_index)
+{
+  lapic_send_ipi(
+    amd64_smp_apic_ids[target_processor_index],
+    APIC_ICR_DELIVERY_FIXED | (BSP_IRQ_VECTOR_BASE + BSP_VECTOR_IPI)
+  );
+}
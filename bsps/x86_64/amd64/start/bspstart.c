@@ -26,7 +26,10 @@
 
 #include <bsp.h>
 #include <bsp/bootcard.h>
+#include <bsp/irq-generic.h>
 
 void bsp_start(void)
 {
+  amd64_cache_initialize();
+  bsp_interrupt_initialize();
 }
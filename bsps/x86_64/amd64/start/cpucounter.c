@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * CPU counter based on the time-stamp counter.
+ *
+ * The frequency is taken from CPUID leaf 0x15 when the processor enumerates
+ * its TSC to core crystal clock ratio, and is otherwise measured against the
+ * 8254 PIT.
+ */
+
+#include <bsp.h>
+#include <clock.h>
+#include <rtems/counter.h>
+#include <rtems/sysinit.h>
+#include <rtems/score/cpuimpl.h>
+
+#define CPUID_LEAF_MAX_EXTENDED   0x80000000
+#define CPUID_LEAF_ADVANCED_PM    0x80000007
+#define CPUID_ADVANCED_PM_EDX_INVARIANT_TSC (1 << 8)
+#define CPUID_LEAF_TSC_CRYSTAL    0x15
+
+static uint32_t amd64_tsc_frequency;
+
+/*
+ * CPU_Counter_ticks and the counter frequency are 32 bits wide, so a TSC
+ * faster than 4GHz is scaled down by a power of two.
+ */
+static uint32_t amd64_tsc_shift;
+
+uint32_t _CPU_Counter_frequency(void)
+{
+  return amd64_tsc_frequency;
+}
+
+CPU_Counter_ticks _CPU_Counter_read(void)
+{
+  return (CPU_Counter_ticks) (rdtsc() >> amd64_tsc_shift);
+}
+
+bool amd64_tsc_is_invariant(void)
+{
+  uint32_t eax, ebx, ecx, edx;
+
+  cpuid(CPUID_LEAF_MAX_EXTENDED, &eax, &ebx, &ecx, &edx);
+  if (eax < CPUID_LEAF_ADVANCED_PM) {
+    return false;
+  }
+
+  cpuid(CPUID_LEAF_ADVANCED_PM, &eax, &ebx, &ecx, &edx);
+  return (edx & CPUID_ADVANCED_PM_EDX_INVARIANT_TSC) != 0;
+}
+
+static uint64_t amd64_tsc_frequency_from_cpuid(void)
+{
+  uint32_t eax, ebx, ecx, edx;
+
+  cpuid(0, &eax, &ebx, &ecx, &edx);
+  if (eax < CPUID_LEAF_TSC_CRYSTAL) {
+    return 0;
+  }
+
+  /* eax: denominator, ebx: numerator, ecx: crystal frequency in Hz */
+  cpuid(CPUID_LEAF_TSC_CRYSTAL, &eax, &ebx, &ecx, &edx);
+  if (eax == 0 || ebx == 0 || ecx == 0) {
+    return 0;
+  }
+
+  return ((uint64_t) ecx * ebx) / eax;
+}
+
+static uint64_t amd64_tsc_frequency_from_pit(void)
+{
+  uint64_t begin;
+  uint64_t end;
+
+  pit_calibration_start();
+  begin = rdtsc();
+  pit_calibration_wait();
+  end = rdtsc();
+
+  return ((end - begin) * PIT_FREQUENCY) / PIT_CALIBRATE_COUNT;
+}
+
+static void amd64_counter_initialize(void)
+{
+  uint64_t frequency;
+
+  frequency = amd64_tsc_frequency_from_cpuid();
+  if (frequency == 0) {
+    frequency = amd64_tsc_frequency_from_pit();
+  }
+
+  while (frequency > UINT32_MAX) {
+    frequency >>= 1;
+    ++amd64_tsc_shift;
+  }
+
+  amd64_tsc_frequency = (uint32_t) frequency;
+}
+
+RTEMS_SYSINIT_ITEM(
+  amd64_counter_initialize,
+  RTEMS_SYSINIT_CPU_COUNTER,
+  RTEMS_SYSINIT_ORDER_FIRST
+);
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <bsp.h>
+#include <multiboot2.h>
+
+uint32_t amd64_multiboot2_magic;
+
+const multiboot2_info *amd64_multiboot2_info;
+
+const multiboot2_info *amd64_multiboot2_get_info(void)
+{
+  if (amd64_multiboot2_magic != MULTIBOOT2_BOOTLOADER_MAGIC) {
+    return NULL;
+  }
+
+  return amd64_multiboot2_info;
+}
+
+const multiboot2_tag *amd64_multiboot2_find_tag(uint32_t type)
+{
+  const multiboot2_info *info;
+  uintptr_t tag_addr;
+  uintptr_t info_end;
+
+  info = amd64_multiboot2_get_info();
+
+  if (info == NULL) {
+    return NULL;
+  }
+
+  tag_addr = (uintptr_t) (info + 1);
+  info_end = (uintptr_t) info + info->total_size;
+
+  while (tag_addr + sizeof(multiboot2_tag) <= info_end) {
+    const multiboot2_tag *tag = (const multiboot2_tag *) tag_addr;
+
+    if (tag->type == MULTIBOOT2_TAG_TYPE_END) {
+      break;
+    }
+
+    if (tag->type == type) {
+      return tag;
+    }
+
+    tag_addr += (tag->size + MULTIBOOT2_TAG_ALIGN - 1) &
+      ~(uintptr_t) (MULTIBOOT2_TAG_ALIGN - 1);
+  }
+
+  return NULL;
+}
+
+const char *amd64_multiboot2_get_cmdline(void)
+{
+  const multiboot2_tag_string *cmdline;
+
+  cmdline = (const multiboot2_tag_string *)
+    amd64_multiboot2_find_tag(MULTIBOOT2_TAG_TYPE_CMDLINE);
+
+  if (cmdline == NULL) {
+    return "";
+  }
+
+  return cmdline->string;
+}
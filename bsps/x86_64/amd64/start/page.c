@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <bsp.h>
+#include <page.h>
+#include <rtems/score/cpuimpl.h>
+
+#define CPUID_80000001_EDX_PAGE1GB (1 << 26)
+
+#define AMD64_PAGE_TABLE_FLAGS (AMD64_PAGE_PRESENT | AMD64_PAGE_WRITABLE)
+
+/* A single page directory pointer table covers 512GiB */
+#define AMD64_PAGE_IDENTITY_MAX \
+  ((uintptr_t) AMD64_PAGE_TABLE_ENTRIES * AMD64_PAGE_SIZE_1G)
+
+static uint64_t amd64_pml4[AMD64_PAGE_TABLE_ENTRIES]
+  RTEMS_ALIGNED(AMD64_PAGE_SIZE_4K);
+
+static uint64_t amd64_pdpt[AMD64_PAGE_TABLE_ENTRIES]
+  RTEMS_ALIGNED(AMD64_PAGE_SIZE_4K);
+
+static uint64_t
+amd64_pd[AMD64_PAGE_DIRECTORY_COUNT][AMD64_PAGE_TABLE_ENTRIES]
+  RTEMS_ALIGNED(AMD64_PAGE_SIZE_4K);
+
+static bool amd64_page_has_1g_pages(void)
+{
+  uint32_t eax, ebx, ecx, edx;
+
+  cpuid(0x80000000, &eax, &ebx, &ecx, &edx);
+
+  if (eax < 0x80000001) {
+    return false;
+  }
+
+  cpuid(0x80000001, &eax, &ebx, &ecx, &edx);
+  return (edx & CPUID_80000001_EDX_PAGE1GB) != 0;
+}
+
+uintptr_t amd64_page_map_identity(uintptr_t end)
+{
+  uintptr_t gib_count;
+  uintptr_t i;
+
+  if (end < (uintptr_t) 4 * AMD64_PAGE_SIZE_1G) {
+    end = (uintptr_t) 4 * AMD64_PAGE_SIZE_1G;
+  }
+
+  if (end > AMD64_PAGE_IDENTITY_MAX) {
+    end = AMD64_PAGE_IDENTITY_MAX;
+  }
+
+  gib_count = (end + AMD64_PAGE_SIZE_1G - 1) / AMD64_PAGE_SIZE_1G;
+
+  if (amd64_page_has_1g_pages()) {
+    for (i = 0; i < gib_count; ++i) {
+      amd64_pdpt[i] = (i * AMD64_PAGE_SIZE_1G) | AMD64_PAGE_TABLE_FLAGS |
+        AMD64_PAGE_LARGE;
+    }
+  } else {
+    uintptr_t j;
+
+    if (gib_count > AMD64_PAGE_DIRECTORY_COUNT) {
+      gib_count = AMD64_PAGE_DIRECTORY_COUNT;
+    }
+
+    for (i = 0; i < gib_count; ++i) {
+      for (j = 0; j < AMD64_PAGE_TABLE_ENTRIES; ++j) {
+        amd64_pd[i][j] = (i * AMD64_PAGE_SIZE_1G + j * AMD64_PAGE_SIZE_2M) |
+          AMD64_PAGE_TABLE_FLAGS | AMD64_PAGE_LARGE;
+      }
+
+      amd64_pdpt[i] = (uintptr_t) &amd64_pd[i][0] | AMD64_PAGE_TABLE_FLAGS;
+    }
+  }
+
+  amd64_pml4[0] = (uintptr_t) &amd64_pdpt[0] | AMD64_PAGE_TABLE_FLAGS;
+
+  /*
+   * The tables live in the identity mapped image, so their addresses are
+   * physical ones.  Loading CR3 flushes all non-global TLB entries.
+   */
+  __asm__ volatile (
+    "movq %0, %%cr3"
+    :
+    : "r" ((uintptr_t) &amd64_pml4[0])
+    : "memory"
+  );
+
+  if (gib_count * AMD64_PAGE_SIZE_1G < end) {
+    end = gib_count * AMD64_PAGE_SIZE_1G;
+  }
+
+  return end;
+}
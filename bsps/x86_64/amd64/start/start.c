@@ -26,11 +26,18 @@
 
 #include <bsp.h>
 #include <start.h>
+#include <multiboot2.h>
 #include <bsp/bootcard.h>
 
-// XXX: _start can pass boot arguments to boot_card
+// XXX: Only multiboot2 boot loaders pass a command line so far, the bootinfo
+// of FreeBSD's loader is not parsed
 // https://lists.rtems.org/pipermail/devel/2018-June/022123.html
 void _start(void)
 {
-  boot_card("");
+#ifdef RTEMS_SMP
+  /* _Per_CPU_Get() is GS relative, see _X86_64_SMP_Initialize_processor() */
+  _X86_64_SMP_Initialize_processor(0);
+#endif
+
+  boot_card(amd64_multiboot2_get_cmdline());
 }
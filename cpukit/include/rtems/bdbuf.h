@@ -44,7 +44,14 @@ extern "C" {
  *
  * The Block Device Buffer Management implements a cache between the disk
  * devices and file systems.  The code provides read-ahead and write queuing to
- * the drivers and fast cache look-up using an AVL tree.
+ * the drivers and fast cache look-up using a hash index.
+ *
+ * The buffers may be split into several shards, each with its own lock, hash
+ * index and lists.  A physical disk device and its logical disks use the
+ * buffers of one shard, which is selected round-robin when the physical disk
+ * is initialized.  Disks in different shards can be accessed in parallel, but
+ * they also cannot use the buffers of the other shards.  The shard count is
+ * configured by CONFIGURE_BDBUF_SHARD_COUNT and defaults to one.
  *
  * The block size used by a file system can be set at runtime and must be a
  * multiple of the disk device block size.  The disk device's physical block
@@ -129,7 +136,7 @@ extern "C" {
  * Empty or cached buffers are added to the LRU list and removed from this
  * queue when a caller requests a buffer.  This is referred to as getting a
  * buffer in the code and the event get in the state diagram.  The buffer is
- * assigned to a block and inserted to the AVL based on the block/device key.
+ * assigned to a block and inserted to the index based on the block/device key.
  * If the block is to be read by the user and not in the cache it is transfered
  * from the disk into memory.  If no buffers are on the LRU list the modified
  * list is checked.  If buffers are on the modified the swap out task will be
@@ -148,14 +155,32 @@ extern "C" {
  * released as modified the user would have to block waiting until it had been
  * written.  This would be a performance problem.
  *
+ * The swap out task writes the buffers of a device sorted in block order.  It
+ * may hand several write requests to the driver before it waits for their
+ * completion, see CONFIGURE_BDBUF_MAX_WRITE_REQUESTS.  Once the number of
+ * modified buffers of a shard reaches the write-behind limit, see
+ * CONFIGURE_BDBUF_WRITE_BEHIND_BLOCKS, the swap out task writes them without
+ * waiting for the hold time.  If the count reaches twice the limit, writers
+ * releasing modified buffers block until it dropped below the limit again.
+ *
+ * The swap out task and the read-ahead task keep up to the queue depth of a
+ * device of transfer requests in flight, see RTEMS_BLKIO_GETQUEUEDEPTH.  The
+ * read-ahead task serves the streams of other devices or other streams of the
+ * same device while read-ahead requests are in progress, up to
+ * CONFIGURE_BDBUF_MAX_READ_AHEAD_REQUESTS requests in total.
+ *
  * The code performs multiple block reads and writes.  Multiple block reads or
  * read-ahead increases performance with hardware that supports it.  It also
  * helps with a large cache as the disk head movement is reduced.  It however
  * is a speculative operation so excessive use can remove valuable and needed
  * blocks from the cache.  The read-ahead is triggered after two misses of
  * ascending consecutive blocks or a read hit of a block read by the
- * most-resent read-ahead transfer.  The read-ahead works per disk, but all
- * transfers are issued by the read-ahead task.
+ * most-resent read-ahead transfer.  The read-ahead works per stream of
+ * sequential reads, a disk has several streams, so that interleaved readers do
+ * not disturb each other.  The read-ahead window of a stream is halved in case
+ * more read-ahead blocks are dropped from the cache unused than read and grows
+ * up to the maximum read-ahead block count otherwise.  All transfers are issued
+ * by the read-ahead task.
  *
  * The cache has the following lists of buffers:
  *  - LRU: Accessed or transfered buffers released in least recently used
@@ -178,11 +203,11 @@ extern "C" {
  * @brief State of a buffer of the cache.
  *
  * The state has several implications.  Depending on the state a buffer can be
- * in the AVL tree, in a list, in use by an entity and a group user or not.
+ * in the index, in a list, in use by an entity and a group user or not.
  *
  * <table>
  *   <tr>
- *     <th>State</th><th>Valid Data</th><th>AVL Tree</th>
+ *     <th>State</th><th>Valid Data</th><th>Index</th>
  *     <th>LRU List</th><th>Modified List</th><th>Synchronization List</th>
  *     <th>Group User</th><th>External User</th>
  *   </tr>
@@ -299,21 +324,13 @@ typedef struct rtems_bdbuf_group rtems_bdbuf_group;
 /**
  * To manage buffers we using buffer descriptors (BD). A BD holds a buffer plus
  * a range of other information related to managing the buffer in the cache. To
- * speed-up buffer lookup descriptors are organized in AVL-Tree. The fields
+ * speed-up buffer lookup descriptors are organized in a hash index. The fields
  * 'dd' and 'block' are search keys.
  */
 typedef struct rtems_bdbuf_buffer
 {
   rtems_chain_node link;       /**< Link the BD onto a number of lists. */
 
-  struct rtems_bdbuf_avl_node
-  {
-    struct rtems_bdbuf_buffer* left;   /**< Left Child */
-    struct rtems_bdbuf_buffer* right;  /**< Right Child */
-    signed char                cache;  /**< Cache */
-    signed char                bal;    /**< The balance of the sub-tree */
-  } avl;
-
   rtems_disk_device *dd;        /**< disk device */
 
   rtems_blkdev_bnum block;      /**< block number on the device */
@@ -331,6 +348,10 @@ typedef struct rtems_bdbuf_buffer
 
   int   references;              /**< Allow reference counting by owner. */
   void* user;                    /**< User data. */
+
+  rtems_blkdev_read_ahead_stream* read_ahead_stream; /**< The read-ahead
+                                  * stream which read this buffer, if it was
+                                  * not accessed since, otherwise NULL. */
 } rtems_bdbuf_buffer;
 
 /**
@@ -356,8 +377,8 @@ struct rtems_bdbuf_group
  * structure.
  */
 typedef struct rtems_bdbuf_config {
-  uint32_t            max_read_ahead_blocks;   /**< Number of blocks to read
-                                                * ahead. */
+  uint32_t            max_read_ahead_blocks;   /**< Maximum number of blocks
+                                                * to read ahead. */
   uint32_t            max_write_blocks;        /**< Number of blocks to write
                                                 * at once. */
   rtems_task_priority swapout_priority;        /**< Priority of the swap out
@@ -380,6 +401,18 @@ typedef struct rtems_bdbuf_config {
                                                 * allocation size. */
   rtems_task_priority read_ahead_priority;     /**< Priority of the read-ahead
                                                 * task. */
+  size_t              shard_count;             /**< Number of cache shards. */
+  uint32_t            max_write_requests;      /**< Number of write requests
+                                                * a swap-out task hands to a
+                                                * driver at once. */
+  uint32_t            write_behind_blocks;     /**< Number of modified blocks
+                                                * of a shard which triggers a
+                                                * write. Zero disables the
+                                                * write-behind. */
+  uint32_t            max_read_ahead_requests; /**< Number of read-ahead
+                                                * requests the read-ahead
+                                                * task hands to the drivers
+                                                * at once. */
 } rtems_bdbuf_config;
 
 /**
@@ -452,6 +485,30 @@ extern const rtems_bdbuf_config rtems_bdbuf_configuration;
  */
 #define RTEMS_BDBUF_BUFFER_MAX_SIZE_DEFAULT (4096)
 
+/**
+ * Default number of cache shards.  A single shard shares all buffers among
+ * all disk devices.
+ */
+#define RTEMS_BDBUF_SHARD_COUNT_DEFAULT (1)
+
+/**
+ * Default number of write requests in flight per swap-out task.  The swap-out
+ * task waits for each write request to complete before it issues the next.
+ */
+#define RTEMS_BDBUF_MAX_WRITE_REQUESTS_DEFAULT (1)
+
+/**
+ * The default value for the write-behind blocks disables the write-behind
+ * feature.  Modified buffers are only written after the hold time then.
+ */
+#define RTEMS_BDBUF_WRITE_BEHIND_BLOCKS_DEFAULT (0)
+
+/**
+ * Default number of read-ahead requests in flight.  The read-ahead task waits
+ * for the completion of a read-ahead request before it issues the next.
+ */
+#define RTEMS_BDBUF_MAX_READ_AHEAD_REQUESTS_DEFAULT (1)
+
 /**
  * Prepare buffering layer to work - initialize buffer descritors and (if it is
  * neccessary) buffers. After initialization all blocks is placed into the
@@ -536,6 +593,85 @@ rtems_bdbuf_read (
   rtems_bdbuf_buffer** bd
 );
 
+/**
+ * @brief Checks if a buffer is suitable for direct transfers.
+ *
+ * Direct transfers hand the buffer to the block device driver which may use
+ * DMA.  The buffer must be aligned on the maximal cache line size for this.
+ *
+ * @param buffer [in] The buffer.
+ *
+ * @retval true The buffer may be used for direct transfers.
+ * @retval false Otherwise.
+ */
+static inline bool
+rtems_bdbuf_is_direct_buffer (const void *buffer)
+{
+  size_t line_size = rtems_cache_get_maximal_line_size ();
+
+  return line_size == 0 || ((uintptr_t) buffer % line_size) == 0;
+}
+
+/**
+ * Read a range of blocks from the disk directly into the user buffer without
+ * copying them through the cache. Modified buffers of the range which are in
+ * the cache are written to the disk before the data is read. The blocks are
+ * not added to the cache and the read-ahead state is not changed. The call
+ * blocks until the transfer has completed. The caller must not hold a buffer
+ * of the range.
+ *
+ * Before you can use this function, the rtems_bdbuf_init() routine must be
+ * called at least once to initialize the cache, otherwise a fatal error will
+ * occur.
+ *
+ * @param dd [in] The disk device.
+ * @param block [in] Linear media block number of the first block.
+ * @param block_count [in] Number of blocks to read.
+ * @param buffer [out] Buffer for the block data. It must be large enough for
+ * the block count times the block size and satisfy
+ * rtems_bdbuf_is_direct_buffer().
+ *
+ * @retval RTEMS_SUCCESSFUL Successful operation.
+ * @retval RTEMS_INVALID_ADDRESS The buffer is not suitable for direct
+ * transfers.
+ * @retval RTEMS_INVALID_ID Invalid block range.
+ * @retval RTEMS_IO_ERROR IO error.
+ */
+rtems_status_code
+rtems_bdbuf_read_direct (rtems_disk_device *dd,
+                         rtems_blkdev_bnum  block,
+                         uint32_t           block_count,
+                         void              *buffer);
+
+/**
+ * Write a range of blocks from the user buffer directly to the disk without
+ * copying them through the cache. Buffers of the range which are in the
+ * cache are removed from it, modified ones are discarded since the write
+ * replaces their data. The call blocks until the transfer has completed. The
+ * caller must not hold a buffer of the range.
+ *
+ * Before you can use this function, the rtems_bdbuf_init() routine must be
+ * called at least once to initialize the cache, otherwise a fatal error will
+ * occur.
+ *
+ * @param dd [in] The disk device.
+ * @param block [in] Linear media block number of the first block.
+ * @param block_count [in] Number of blocks to write.
+ * @param buffer [in] The block data. It must satisfy
+ * rtems_bdbuf_is_direct_buffer().
+ *
+ * @retval RTEMS_SUCCESSFUL Successful operation.
+ * @retval RTEMS_INVALID_ADDRESS The buffer is not suitable for direct
+ * transfers.
+ * @retval RTEMS_INVALID_ID Invalid block range.
+ * @retval RTEMS_IO_ERROR IO error.
+ */
+rtems_status_code
+rtems_bdbuf_write_direct (rtems_disk_device *dd,
+                          rtems_blkdev_bnum  block,
+                          uint32_t           block_count,
+                          const void        *buffer);
+
 /**
  * Release the buffer obtained by a read call back to the cache. If the buffer
  * was obtained by a get call and was not already in the cache the release
@@ -639,6 +775,19 @@ rtems_bdbuf_syncdev (rtems_disk_device *dd);
 void
 rtems_bdbuf_purge_dev (rtems_disk_device *dd);
 
+/**
+ * @brief Selects the cache shard of a physical disk device.
+ *
+ * The shards are handed out round-robin, so that up to the configured shard
+ * count of physical disk devices do not contend for a cache lock.  Logical
+ * disk devices use the shard of their physical disk device.  This function is
+ * called by rtems_disk_init_phys().
+ *
+ * @param dd [in, out] The physical disk device.
+ */
+void
+rtems_bdbuf_select_shard (rtems_disk_device *dd);
+
 /**
  * @brief Sets the block size of a disk device.
  *
@@ -36,6 +36,13 @@ extern "C" {
  * control. This call puts IO @ref rtems_blkdev_request "requests" to the block
  * device for asynchronous processing. When a driver executes a request, it
  * invokes the request done callback function to finish the request.
+ *
+ * A driver must accept new requests while others are still in progress.  The
+ * count of requests the device is able to process concurrently is reported by
+ * the @ref RTEMS_BLKIO_GETQUEUEDEPTH IO control.  The cache uses it to keep
+ * several reads and writes in flight.  Drivers which do not support this IO
+ * control get a queue depth of one.  Drivers which finish requests within the
+ * IO control, for example the RAM disk, may report UINT32_MAX.
  */
 /**@{**/
 
@@ -189,6 +196,7 @@ static inline void rtems_blkdev_request_done(
 #define RTEMS_BLKIO_PURGEDEV        _IO('B', 10)
 #define RTEMS_BLKIO_GETDEVSTATS     _IOR('B', 11, rtems_blkdev_stats *)
 #define RTEMS_BLKIO_RESETDEVSTATS   _IO('B', 12)
+#define RTEMS_BLKIO_GETQUEUEDEPTH   _IOR('B', 13, uint32_t)
 
 /** @} */
 
@@ -249,6 +257,11 @@ static inline int rtems_disk_fd_reset_device_stats(int fd)
   return ioctl(fd, RTEMS_BLKIO_RESETDEVSTATS);
 }
 
+static inline int rtems_disk_fd_get_queue_depth(int fd, uint32_t *queue_depth)
+{
+  return ioctl(fd, RTEMS_BLKIO_GETQUEUEDEPTH, queue_depth);
+}
+
 /**
  * @name Block Device Driver Capabilities
  */
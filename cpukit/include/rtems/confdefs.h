@@ -155,6 +155,37 @@ extern rtems_initialization_tasks_table Initialization_tasks[];
   const uint32_t rtems_libio_number_iops = RTEMS_ARRAY_SIZE(rtems_libio_iops);
 #endif
 
+/**
+ * This macro defines the number of entries of the path evaluation cache.
+ * File systems with expensive directory lookups, e.g. RFS and FAT, use it to
+ * resolve hot path components without a directory search.  It must be zero
+ * or a power of two.  The cache is disabled by default.
+ */
+#ifndef CONFIGURE_FILESYSTEM_EVAL_PATH_CACHE_ENTRIES
+  #define CONFIGURE_FILESYSTEM_EVAL_PATH_CACHE_ENTRIES 0
+#endif
+
+#if (CONFIGURE_FILESYSTEM_EVAL_PATH_CACHE_ENTRIES & \
+  (CONFIGURE_FILESYSTEM_EVAL_PATH_CACHE_ENTRIES - 1)) != 0
+  #error "CONFIGURE_FILESYSTEM_EVAL_PATH_CACHE_ENTRIES must be a power of two"
+#endif
+
+#ifdef CONFIGURE_INIT
+  #if CONFIGURE_FILESYSTEM_EVAL_PATH_CACHE_ENTRIES > 0
+    static rtems_filesystem_eval_path_cache_entry
+      _Configure_Eval_path_cache[CONFIGURE_FILESYSTEM_EVAL_PATH_CACHE_ENTRIES];
+
+    rtems_filesystem_eval_path_cache_entry *const
+      rtems_filesystem_eval_path_cache_table = _Configure_Eval_path_cache;
+  #else
+    rtems_filesystem_eval_path_cache_entry *const
+      rtems_filesystem_eval_path_cache_table = NULL;
+  #endif
+
+  const size_t rtems_filesystem_eval_path_cache_size =
+    CONFIGURE_FILESYSTEM_EVAL_PATH_CACHE_ENTRIES;
+#endif
+
 /**
  * This macro specifies the number of PTYs that can be concurrently
  * active.
@@ -333,6 +364,22 @@ extern rtems_initialization_tasks_table Initialization_tasks[];
                     IMFS_MEMFILE_DEFAULT_BYTES_PER_BLOCK
 #endif
 
+/*
+ * If CONFIGURE_IMFS_ENABLE_EXTENT_FILES is defined, then the regular files
+ * of the base IMFS use the extent based storage instead of the block based
+ * memory files.  Large files are read and written in big contiguous chunks
+ * and readers do not need a lock.  The file size is not limited by
+ * CONFIGURE_IMFS_MEMFILE_BYTES_PER_BLOCK.
+ */
+
+/*
+ * If CONFIGURE_IMFS_ENABLE_HASHED_DIRECTORIES is defined, then the
+ * directories of the base IMFS index their entries in a hash table once
+ * they have IMFS_DIRECTORY_HASH_MIN_ENTRIES entries.  The path evaluation
+ * time is then independent of the directory size.  The readdir() order is
+ * the creation order like for the default directories.
+ */
+
 /**
  * This defines the IMFS file system table entry.
  */
@@ -584,12 +631,16 @@ extern rtems_initialization_tasks_table Initialization_tasks[];
       static const IMFS_mknod_controls _Configure_IMFS_mknod_controls = {
         #ifdef CONFIGURE_IMFS_DISABLE_READDIR
           &IMFS_mknod_control_dir_minimal,
+        #elif defined(CONFIGURE_IMFS_ENABLE_HASHED_DIRECTORIES)
+          &IMFS_mknod_control_dir_hashed,
         #else
           &IMFS_mknod_control_dir_default,
         #endif
         &IMFS_mknod_control_device,
         #ifdef CONFIGURE_IMFS_DISABLE_MKNOD_FILE
           &IMFS_mknod_control_enosys,
+        #elif defined(CONFIGURE_IMFS_ENABLE_EXTENT_FILES)
+          &IMFS_mknod_control_extfile,
         #else
           &IMFS_mknod_control_memfile,
         #endif
@@ -1315,6 +1366,40 @@ extern rtems_initialization_tasks_table Initialization_tasks[];
       NULL;
     #endif
 #endif
+
+/**
+ * This configures the count of objects each magazine of the per-processor
+ * malloc caches can hold.  Each processor has one magazine per size class.
+ * Small allocations are satisfied from the magazine of the current processor
+ * and refilled from or spilled to the C program heap in batches.  The caches
+ * are disabled by default.
+ */
+#ifndef CONFIGURE_MALLOC_PER_CPU_CACHE_SIZE
+  #define CONFIGURE_MALLOC_PER_CPU_CACHE_SIZE 0
+#endif
+
+#ifdef CONFIGURE_INIT
+  #if CONFIGURE_MALLOC_PER_CPU_CACHE_SIZE > 0
+    static rtems_malloc_cache
+      _Configure_Malloc_cache[ CONFIGURE_MAXIMUM_PROCESSORS ];
+
+    static void *_Configure_Malloc_cache_objects[
+      CONFIGURE_MAXIMUM_PROCESSORS * RTEMS_MALLOC_CACHE_CLASS_COUNT
+        * CONFIGURE_MALLOC_PER_CPU_CACHE_SIZE
+    ];
+
+    rtems_malloc_cache *const rtems_malloc_cache_table =
+      _Configure_Malloc_cache;
+
+    void **const rtems_malloc_cache_objects = _Configure_Malloc_cache_objects;
+  #else
+    rtems_malloc_cache *const rtems_malloc_cache_table = NULL;
+
+    void **const rtems_malloc_cache_objects = NULL;
+  #endif
+
+  const size_t rtems_malloc_cache_size = CONFIGURE_MALLOC_PER_CPU_CACHE_SIZE;
+#endif
 /**@}*/  /* end of Malloc Configuration */
 
 /**
@@ -1775,6 +1860,22 @@ extern rtems_initialization_tasks_table Initialization_tasks[];
     #define CONFIGURE_BDBUF_READ_AHEAD_TASK_PRIORITY \
                               RTEMS_BDBUF_READ_AHEAD_TASK_PRIORITY_DEFAULT
   #endif
+  #ifndef CONFIGURE_BDBUF_SHARD_COUNT
+    #define CONFIGURE_BDBUF_SHARD_COUNT \
+                              RTEMS_BDBUF_SHARD_COUNT_DEFAULT
+  #endif
+  #ifndef CONFIGURE_BDBUF_MAX_WRITE_REQUESTS
+    #define CONFIGURE_BDBUF_MAX_WRITE_REQUESTS \
+                              RTEMS_BDBUF_MAX_WRITE_REQUESTS_DEFAULT
+  #endif
+  #ifndef CONFIGURE_BDBUF_WRITE_BEHIND_BLOCKS
+    #define CONFIGURE_BDBUF_WRITE_BEHIND_BLOCKS \
+                              RTEMS_BDBUF_WRITE_BEHIND_BLOCKS_DEFAULT
+  #endif
+  #ifndef CONFIGURE_BDBUF_MAX_READ_AHEAD_REQUESTS
+    #define CONFIGURE_BDBUF_MAX_READ_AHEAD_REQUESTS \
+                              RTEMS_BDBUF_MAX_READ_AHEAD_REQUESTS_DEFAULT
+  #endif
   #ifdef CONFIGURE_INIT
     const rtems_bdbuf_config rtems_bdbuf_configuration = {
       CONFIGURE_BDBUF_MAX_READ_AHEAD_BLOCKS,
@@ -1788,7 +1889,11 @@ extern rtems_initialization_tasks_table Initialization_tasks[];
       CONFIGURE_BDBUF_CACHE_MEMORY_SIZE,
       CONFIGURE_BDBUF_BUFFER_MIN_SIZE,
       CONFIGURE_BDBUF_BUFFER_MAX_SIZE,
-      CONFIGURE_BDBUF_READ_AHEAD_TASK_PRIORITY
+      CONFIGURE_BDBUF_READ_AHEAD_TASK_PRIORITY,
+      CONFIGURE_BDBUF_SHARD_COUNT,
+      CONFIGURE_BDBUF_MAX_WRITE_REQUESTS,
+      CONFIGURE_BDBUF_WRITE_BEHIND_BLOCKS,
+      CONFIGURE_BDBUF_MAX_READ_AHEAD_REQUESTS
     };
   #endif
 
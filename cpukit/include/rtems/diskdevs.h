@@ -59,7 +59,17 @@ typedef int (*rtems_block_device_ioctl)(
 #define RTEMS_DISK_READ_AHEAD_NO_TRIGGER ((rtems_blkdev_bnum) -1)
 
 /**
- * @brief Block device read-ahead control.
+ * @brief Count of read-ahead streams of a disk.
+ */
+#define RTEMS_DISK_READ_AHEAD_STREAM_COUNT 4
+
+/**
+ * @brief Block device read-ahead stream.
+ *
+ * A stream follows one sequential reader of the disk.  The read-ahead window
+ * of the stream shrinks in case read-ahead blocks are dropped from the cache
+ * unused and grows up to the configured maximum read-ahead block count in case
+ * they are read.
  */
 typedef struct {
   /**
@@ -67,6 +77,11 @@ typedef struct {
    */
   rtems_chain_node node;
 
+  /**
+   * @brief The disk of this stream.
+   */
+  rtems_disk_device *dd;
+
   /**
    * @brief Block value to trigger the read-ahead request.
    *
@@ -82,6 +97,52 @@ typedef struct {
    * be arbitrary.
    */
   rtems_blkdev_bnum next;
+
+  /**
+   * @brief Block count of the next read-ahead request.
+   */
+  uint32_t window;
+
+  /**
+   * @brief Count of read-ahead blocks read since the last read-ahead request.
+   */
+  uint32_t hits;
+
+  /**
+   * @brief Count of read-ahead blocks dropped unused since the last
+   * read-ahead request.
+   */
+  uint32_t misses;
+
+  /**
+   * @brief Value of the use counter at the last use of this stream.
+   */
+  uint32_t last_use;
+} rtems_blkdev_read_ahead_stream;
+
+/**
+ * @brief Block device read-ahead control.
+ *
+ * Interleaved sequential readers use different streams.  A read miss which
+ * does not continue a stream replaces an idle or the least recently used
+ * stream.
+ */
+typedef struct {
+  /**
+   * @brief The read-ahead streams.
+   */
+  rtems_blkdev_read_ahead_stream streams[RTEMS_DISK_READ_AHEAD_STREAM_COUNT];
+
+  /**
+   * @brief Use counter to find the least recently used stream.
+   */
+  uint32_t use_count;
+
+  /**
+   * @brief Count of read-ahead transfer requests passed to the driver and not
+   * completed yet.
+   */
+  uint32_t requests;
 } rtems_blkdev_read_ahead;
 
 /**
@@ -144,6 +205,23 @@ typedef struct {
    * Error count of transfers issued by write requests.
    */
   uint32_t write_errors;
+
+  /**
+   * @brief Read-ahead hit count.
+   *
+   * A read-ahead hit occurs in the rtems_bdbuf_read() function in case the
+   * block was read by a read-ahead transfer and not accessed since.
+   */
+  uint32_t read_ahead_hits;
+
+  /**
+   * @brief Read-ahead miss count.
+   *
+   * A read-ahead miss occurs in case a block read by a read-ahead transfer is
+   * dropped from the cache or obtained by rtems_bdbuf_get() before it was
+   * read.
+   */
+  uint32_t read_ahead_misses;
 } rtems_blkdev_stats;
 
 /**
@@ -171,6 +249,16 @@ struct rtems_disk_device {
    */
   uint32_t capabilities;
 
+  /**
+   * @brief Count of transfer requests the driver processes concurrently.
+   *
+   * The cache hands up to this count of transfer requests of one task to the
+   * driver before it waits for their completion.  It is positive.
+   *
+   * @see RTEMS_BLKIO_GETQUEUEDEPTH.
+   */
+  uint32_t queue_depth;
+
   /**
    * @brief Disk device name.
    */
@@ -245,6 +333,13 @@ struct rtems_disk_device {
    */
   size_t bds_per_group;
 
+  /**
+   * @brief Index of the buffer cache shard of this disk.
+   *
+   * @see rtems_bdbuf_select_shard().
+   */
+  size_t bdbuf_shard;
+
   /**
    * @brief IO control handler for this disk.
    */
@@ -95,6 +95,50 @@ typedef block_p *block_ptr;
 #define IMFS_MEMFILE_MAXIMUM_SIZE \
   (LAST_TRIPLY_INDIRECT * IMFS_MEMFILE_BYTES_PER_BLOCK)
 
+/**
+ *  IMFS "extfile" information
+ *
+ *  Extent files store the data in extents which start small and double in
+ *  size up to IMFS_EXTFILE_MAX_EXTENT_SIZE.  The extent of a file offset is
+ *  computed and not searched.  The extents are found through a radix tree
+ *  of direct, indirect and doubly indirect extent tables.  Reads and writes
+ *  copy whole contiguous spans of an extent at once.
+ *
+ *  Extents are allocated on demand, so unwritten ranges of a file take no
+ *  memory.  Once published an extent or table does not move until the file
+ *  is destroyed.  Readers thus take no lock.  The file size is updated after
+ *  the data.
+ *
+ *  @code
+ *    extent    0 .. 6      512 bytes doubling up to 32KiB, 65024 bytes total
+ *    extent    7           64KiB, the last direct extent
+ *    indirect  1024 extents of 64KiB,                     64MiB
+ *    doubly    1024 * 1024 extents of 64KiB,              64GiB
+ *  @endcode
+ */
+#define IMFS_EXTFILE_MIN_EXTENT_SIZE  512
+#define IMFS_EXTFILE_MAX_EXTENT_SIZE  (64 * 1024)
+
+/*
+ *  Number of extents until the maximum extent size is reached.
+ */
+#define IMFS_EXTFILE_GROWTH_EXTENTS   7
+
+#define IMFS_EXTFILE_DIRECT_EXTENTS   8
+#define IMFS_EXTFILE_TABLE_SLOTS      1024
+
+#define IMFS_EXTFILE_MAXIMUM_EXTENTS \
+  (IMFS_EXTFILE_DIRECT_EXTENTS + IMFS_EXTFILE_TABLE_SLOTS + \
+    IMFS_EXTFILE_TABLE_SLOTS * IMFS_EXTFILE_TABLE_SLOTS)
+
+#define IMFS_EXTFILE_GROWTH_SIZE \
+  (IMFS_EXTFILE_MIN_EXTENT_SIZE * ((1 << IMFS_EXTFILE_GROWTH_EXTENTS) - 1))
+
+#define IMFS_EXTFILE_MAXIMUM_SIZE \
+  ((off_t) IMFS_EXTFILE_GROWTH_SIZE + \
+    (off_t) (IMFS_EXTFILE_MAXIMUM_EXTENTS - IMFS_EXTFILE_GROWTH_EXTENTS) * \
+      IMFS_EXTFILE_MAX_EXTENT_SIZE)
+
 /** @} */
 
 /**
@@ -187,6 +231,13 @@ IMFS_jnode_t *IMFS_node_remove_default(
 
 IMFS_jnode_t *IMFS_node_remove_directory( IMFS_jnode_t *node );
 
+IMFS_jnode_t *IMFS_node_initialize_hashed_directory(
+  IMFS_jnode_t *node,
+  void *arg
+);
+
+void IMFS_node_destroy_hashed_directory( IMFS_jnode_t *node );
+
 /**
  * @brief Destroys an IMFS node.
  *
@@ -241,6 +292,7 @@ typedef struct {
 struct IMFS_jnode_tt {
   rtems_chain_node    Node;                  /* for chaining them together */
   IMFS_jnode_t       *Parent;                /* Parent node */
+  IMFS_jnode_t       *hash_next;             /* Next in directory bucket */
   const char         *name;                  /* "basename" (not \0 terminated) */
   uint16_t            namelen;               /* Length of "basename" */
   uint16_t            flags;                 /* Node flags */
@@ -259,10 +311,21 @@ struct IMFS_jnode_tt {
 
 #define IMFS_NODE_FLAG_NAME_ALLOCATED 0x1
 
+#define IMFS_NODE_FLAG_HASHED_DIRECTORY 0x2
+
+/*
+ *  Hashed directories start to use buckets at this number of entries.  The
+ *  bucket count doubles each time the entries outnumber the buckets.
+ */
+#define IMFS_DIRECTORY_HASH_MIN_ENTRIES 16
+
 typedef struct {
   IMFS_jnode_t                          Node;
   rtems_chain_control                   Entries;
   rtems_filesystem_mount_table_entry_t *mt_fs;
+  size_t                                entry_count;
+  size_t                                bucket_count;
+  IMFS_jnode_t                        **buckets;
 } IMFS_directory_t;
 
 typedef struct {
@@ -293,6 +356,13 @@ typedef struct {
   block_ptr       triply_indirect;  /* 128 doubly indirect blocks */
 } IMFS_memfile_t;
 
+typedef struct {
+  IMFS_filebase_t File;
+  Atomic_Uintptr  direct[ IMFS_EXTFILE_DIRECT_EXTENTS ];
+  Atomic_Uintptr  indirect;         /* table of extents */
+  Atomic_Uintptr  doubly_indirect;  /* table of extent tables */
+} IMFS_extfile_t;
+
 typedef struct {
   IMFS_filebase_t File;
   block_p         direct;           /* pointer to file image */
@@ -397,8 +467,10 @@ typedef struct {
 
 extern const IMFS_mknod_control IMFS_mknod_control_dir_default;
 extern const IMFS_mknod_control IMFS_mknod_control_dir_minimal;
+extern const IMFS_mknod_control IMFS_mknod_control_dir_hashed;
 extern const IMFS_mknod_control IMFS_mknod_control_device;
 extern const IMFS_mknod_control IMFS_mknod_control_memfile;
+extern const IMFS_mknod_control IMFS_mknod_control_extfile;
 extern const IMFS_node_control IMFS_node_control_linfile;
 extern const IMFS_mknod_control IMFS_mknod_control_fifo;
 extern const IMFS_mknod_control IMFS_mknod_control_enosys;
@@ -865,6 +937,22 @@ static inline void IMFS_Set_handlers( rtems_filesystem_location_info_t *loc )
   loc->handlers = node->control->handlers;
 }
 
+void IMFS_directory_hash_insert(
+  IMFS_directory_t *dir,
+  IMFS_jnode_t *entry_node
+);
+
+void IMFS_directory_hash_remove(
+  IMFS_directory_t *dir,
+  IMFS_jnode_t *entry_node
+);
+
+IMFS_jnode_t *IMFS_directory_hash_lookup(
+  const IMFS_directory_t *dir,
+  const char *name,
+  size_t namelen
+);
+
 static inline void IMFS_add_to_directory(
   IMFS_jnode_t *dir_node,
   IMFS_jnode_t *entry_node
@@ -874,11 +962,24 @@ static inline void IMFS_add_to_directory(
 
   entry_node->Parent = dir_node;
   rtems_chain_append_unprotected( &dir->Entries, &entry_node->Node );
+  ++dir->entry_count;
+
+  if ( ( dir_node->flags & IMFS_NODE_FLAG_HASHED_DIRECTORY ) != 0 ) {
+    IMFS_directory_hash_insert( dir, entry_node );
+  }
 }
 
 static inline void IMFS_remove_from_directory( IMFS_jnode_t *node )
 {
+  IMFS_directory_t *dir = (IMFS_directory_t *) node->Parent;
+
   IMFS_assert( node->Parent != NULL );
+
+  if ( dir->buckets != NULL ) {
+    IMFS_directory_hash_remove( dir, node );
+  }
+
+  --dir->entry_count;
   node->Parent = NULL;
   rtems_chain_extract_unprotected( &node->Node );
 }
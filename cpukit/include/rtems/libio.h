@@ -1369,6 +1369,7 @@ typedef struct {
 #define LIBIO_FLAGS_WRITE         0x0004U  /* writing */
 #define LIBIO_FLAGS_OPEN          0x0100U  /* device is open */
 #define LIBIO_FLAGS_APPEND        0x0200U  /* all writes append */
+#define LIBIO_FLAGS_DIRECT        0x0400U  /* transfer bypasses the cache */
 #define LIBIO_FLAGS_CLOSE_ON_EXEC 0x0800U  /* close on process exec() */
 #define LIBIO_FLAGS_READ_WRITE    (LIBIO_FLAGS_READ | LIBIO_FLAGS_WRITE)
 #define LIBIO_FLAGS_REFERENCE_INC 0x1000U
@@ -1420,6 +1421,19 @@ static inline bool rtems_libio_iop_is_append( const rtems_libio_t *iop )
   return ( rtems_libio_iop_flags( iop ) & LIBIO_FLAGS_APPEND ) != 0;
 }
 
+/**
+ * @brief Returns true if this is a direct I/O iop, otherwise returns false.
+ *
+ * File systems and block devices may transfer suitably aligned data of a
+ * direct I/O iop without copying it through the block device buffer cache.
+ *
+ * @param[in] iop The iop.
+ */
+static inline bool rtems_libio_iop_is_direct( const rtems_libio_t *iop )
+{
+  return ( rtems_libio_iop_flags( iop ) & LIBIO_FLAGS_DIRECT ) != 0;
+}
+
 /**
  * @name External I/O Handlers
  */
@@ -529,6 +529,134 @@ void rtems_filesystem_eval_path_generic(
   const rtems_filesystem_eval_path_generic_config *config
 );
 
+/**
+ * @brief Maximum name length of a path evaluation cache entry.
+ *
+ * Longer names are not cached.
+ */
+#define RTEMS_FILESYSTEM_EVAL_PATH_CACHE_NAME_MAX 32
+
+/**
+ * @brief Path evaluation cache entry.
+ *
+ * The directory and node values are defined by the file system, e.g. inode
+ * numbers.
+ */
+typedef struct {
+  const rtems_filesystem_mount_table_entry_t *mt_entry;
+  uintptr_t dir;
+  uintptr_t node;
+  uintptr_t data;
+  bool no_entry;
+  uint8_t namelen;
+  char name[ RTEMS_FILESYSTEM_EVAL_PATH_CACHE_NAME_MAX ];
+} rtems_filesystem_eval_path_cache_entry;
+
+/**
+ * @brief The path evaluation cache entries.
+ *
+ * Provided by the application configuration, see
+ * CONFIGURE_FILESYSTEM_EVAL_PATH_CACHE_ENTRIES.
+ */
+extern rtems_filesystem_eval_path_cache_entry *const
+  rtems_filesystem_eval_path_cache_table;
+
+/**
+ * @brief The path evaluation cache entry count.
+ *
+ * It is zero or a power of two.  A value of zero disables the cache.
+ */
+extern const size_t rtems_filesystem_eval_path_cache_size;
+
+typedef enum {
+  RTEMS_FILESYSTEM_EVAL_PATH_CACHE_MISS,
+  RTEMS_FILESYSTEM_EVAL_PATH_CACHE_HIT,
+  RTEMS_FILESYSTEM_EVAL_PATH_CACHE_NO_ENTRY
+} rtems_filesystem_eval_path_cache_status;
+
+/**
+ * @brief Looks up a name in the path evaluation cache.
+ *
+ * The cache maps a name in a directory of a file system instance to the
+ * directory entry or to the knowledge that there is no such entry.  File
+ * systems with expensive directory lookups use it in their token
+ * evaluation handler.  The caller must own the file system instance lock.
+ *
+ * @param[in] mt_entry The file system instance.
+ * @param[in] dir The file system specific directory value.
+ * @param[in] name The name.
+ * @param[in] namelen The name length in characters.
+ * @param[out] node The file system specific node value in case of a hit.
+ * @param[out] data The file system specific node data in case of a hit.
+ *
+ * @retval RTEMS_FILESYSTEM_EVAL_PATH_CACHE_HIT The node and data values are
+ *   valid.
+ * @retval RTEMS_FILESYSTEM_EVAL_PATH_CACHE_NO_ENTRY The directory contains
+ *   no entry with this name.
+ * @retval RTEMS_FILESYSTEM_EVAL_PATH_CACHE_MISS The name is not cached.
+ */
+rtems_filesystem_eval_path_cache_status rtems_filesystem_eval_path_cache_lookup(
+  const rtems_filesystem_mount_table_entry_t *mt_entry,
+  uintptr_t dir,
+  const char *name,
+  size_t namelen,
+  uintptr_t *node,
+  uintptr_t *data
+);
+
+/**
+ * @brief Adds a directory entry to the path evaluation cache.
+ *
+ * @param[in] mt_entry The file system instance.
+ * @param[in] dir The file system specific directory value.
+ * @param[in] name The name.
+ * @param[in] namelen The name length in characters.
+ * @param[in] node The file system specific node value.
+ * @param[in] data The file system specific node data.
+ *
+ * @see rtems_filesystem_eval_path_cache_lookup().
+ */
+void rtems_filesystem_eval_path_cache_insert(
+  const rtems_filesystem_mount_table_entry_t *mt_entry,
+  uintptr_t dir,
+  const char *name,
+  size_t namelen,
+  uintptr_t node,
+  uintptr_t data
+);
+
+/**
+ * @brief Adds a missing directory entry to the path evaluation cache.
+ *
+ * @param[in] mt_entry The file system instance.
+ * @param[in] dir The file system specific directory value.
+ * @param[in] name The name.
+ * @param[in] namelen The name length in characters.
+ *
+ * @see rtems_filesystem_eval_path_cache_lookup().
+ */
+void rtems_filesystem_eval_path_cache_insert_no_entry(
+  const rtems_filesystem_mount_table_entry_t *mt_entry,
+  uintptr_t dir,
+  const char *name,
+  size_t namelen
+);
+
+/**
+ * @brief Removes all entries of a file system instance from the path
+ * evaluation cache.
+ *
+ * The file system independent system calls which change a directory call
+ * this function while they own the file system instance lock, e.g. unlink()
+ * and rename().  It is also called before a file system instance is
+ * unmounted.
+ *
+ * @param[in] mt_entry The file system instance.
+ */
+void rtems_filesystem_eval_path_cache_invalidate(
+  const rtems_filesystem_mount_table_entry_t *mt_entry
+);
+
 void rtems_filesystem_initialize(void);
 
 /**
@@ -158,6 +158,20 @@ rtems_status_code rtems_heap_extend(
   uintptr_t area_size
 );
 
+/**
+ * @brief Processes the deferred frees of all processors.
+ *
+ * Frees from interrupt or thread dispatch disabled context are deferred to a
+ * list of the current processor.  Each allocation processes the list of its
+ * processor.  A low priority task may call this function periodically to
+ * return the deferred frees of all processors to the heap, so that the
+ * allocations do not have to do it.
+ *
+ * This function does nothing if called from interrupt or thread dispatch
+ * disabled context.
+ */
+void rtems_malloc_process_deferred_frees( void );
+
 /**
  * @brief Greedy allocate that empties the heap.
  *
@@ -194,6 +208,139 @@ void *rtems_heap_greedy_allocate_all_except_largest(
  */
 void rtems_heap_greedy_free( void *opaque );
 
+/**
+ * @brief Count of size classes of the per-processor malloc caches.
+ */
+#define RTEMS_MALLOC_CACHE_CLASS_COUNT 8
+
+/**
+ * @brief Per-processor malloc cache.
+ *
+ * Each processor has a magazine of cached objects for each size class.  The
+ * objects are used blocks of the C program heap.  The magazine storage is
+ * provided by the application configuration, see
+ * CONFIGURE_MALLOC_PER_CPU_CACHE_SIZE.
+ */
+typedef struct {
+  /**
+   * @brief Protects the magazines and the statistics of this cache.
+   */
+  rtems_interrupt_lock Lock;
+
+  /**
+   * @brief Count of objects in the magazine of each size class.
+   */
+  uint32_t count[ RTEMS_MALLOC_CACHE_CLASS_COUNT ];
+
+  /**
+   * @brief Count of allocations satisfied by the cache.
+   */
+  uint32_t allocation_hits;
+
+  /**
+   * @brief Count of allocations which found an empty magazine.
+   */
+  uint32_t allocation_misses;
+
+  /**
+   * @brief Count of frees which put the object into a magazine.
+   */
+  uint32_t free_hits;
+
+  /**
+   * @brief Count of bulk refills from the heap.
+   */
+  uint32_t refills;
+
+  /**
+   * @brief Count of bulk spills to the heap.
+   */
+  uint32_t spills;
+} RTEMS_ALIGNED( CPU_CACHE_LINE_BYTES ) rtems_malloc_cache;
+
+/**
+ * @brief The per-processor malloc caches.
+ *
+ * This table is provided by the application configuration and has an entry
+ * for each configured processor.  It is NULL if the caches are disabled.
+ */
+extern rtems_malloc_cache *const rtems_malloc_cache_table;
+
+/**
+ * @brief The magazine storage of the per-processor malloc caches.
+ *
+ * Each magazine has rtems_malloc_cache_size entries.  The magazines of a
+ * processor are stored consecutively in size class order.
+ */
+extern void **const rtems_malloc_cache_objects;
+
+/**
+ * @brief Count of objects a magazine can hold.
+ *
+ * The per-processor malloc caches are disabled if this value is zero.
+ */
+extern const size_t rtems_malloc_cache_size;
+
+/**
+ * @brief Statistics of the per-processor malloc caches.
+ */
+typedef struct {
+  /**
+   * @brief Count of objects currently cached.
+   */
+  uint32_t cached_objects;
+
+  /**
+   * @brief Bytes currently cached.
+   *
+   * Objects are accounted with the size of their size class, so this is a
+   * lower bound of the heap memory held by the caches.
+   */
+  uintptr_t cached_bytes;
+
+  /**
+   * @brief Count of allocations satisfied by the caches.
+   */
+  uint32_t allocation_hits;
+
+  /**
+   * @brief Count of allocations which found an empty magazine.
+   */
+  uint32_t allocation_misses;
+
+  /**
+   * @brief Count of frees which put the object into a magazine.
+   */
+  uint32_t free_hits;
+
+  /**
+   * @brief Count of bulk refills from the heap.
+   */
+  uint32_t refills;
+
+  /**
+   * @brief Count of bulk spills to the heap.
+   */
+  uint32_t spills;
+} rtems_malloc_cache_information;
+
+/**
+ * @brief Gets the summed statistics of the per-processor malloc caches.
+ *
+ * All values are zero if the caches are disabled.
+ */
+void rtems_malloc_cache_get_information(
+  rtems_malloc_cache_information *info
+);
+
+/**
+ * @brief Returns all objects of the per-processor malloc caches to the heap.
+ *
+ * Use this function before inspecting the free memory of the heap, for
+ * example before a resource snapshot.
+ */
+void rtems_malloc_cache_flush( void );
+
 #ifdef __cplusplus
 }
 #endif
@@ -45,6 +45,8 @@ typedef rtems_blkdev_bnum  rtems_rfs_buffer_block;
 typedef rtems_bdbuf_buffer rtems_rfs_buffer;
 #define rtems_rfs_buffer_io_request rtems_rfs_buffer_bdbuf_request
 #define rtems_rfs_buffer_io_release rtems_rfs_buffer_bdbuf_release
+#define rtems_rfs_buffer_io_direct  rtems_rfs_buffer_bdbuf_direct
+#define rtems_rfs_buffer_io_direct_buffer(_d) rtems_bdbuf_is_direct_buffer (_d)
 
 /**
  * Request a buffer from the RTEMS libblock BD buffer cache.
@@ -58,6 +60,15 @@ int rtems_rfs_buffer_bdbuf_request (rtems_rfs_file_system* fs,
  */
 int rtems_rfs_buffer_bdbuf_release (rtems_rfs_buffer* handle,
                                     bool              modified);
+/**
+ * Transfer blocks between the media and a user buffer bypassing the RTEMS
+ * libblock BD buffer cache.
+ */
+int rtems_rfs_buffer_bdbuf_direct (rtems_rfs_file_system* fs,
+                                   rtems_rfs_buffer_block block,
+                                   size_t                 count,
+                                   void*                  data,
+                                   bool                   read);
 #else /* Device I/O */
 typedef uint32_t rtems_rfs_buffer_block;
 typedef struct _rtems_rfs_buffer
@@ -70,6 +81,8 @@ typedef struct _rtems_rfs_buffer
 } rtems_rfs_buffer;
 #define rtems_rfs_buffer_io_request rtems_rfs_buffer_deviceio_request
 #define rtems_rfs_buffer_io_release rtems_rfs_buffer_deviceio_release
+#define rtems_rfs_buffer_io_direct  rtems_rfs_buffer_deviceio_direct
+#define rtems_rfs_buffer_io_direct_buffer(_d) (false)
 
 /**
  * Request a buffer from the device I/O.
@@ -83,6 +96,15 @@ int rtems_rfs_buffer_deviceio_request (rtems_rfs_file_system* fs,
  */
 int rtems_rfs_buffer_deviceio_release (rtems_rfs_buffer* handle,
                                        bool              modified);
+/**
+ * Transfer blocks between the media and a user buffer. Not supported by the
+ * device I/O.
+ */
+int rtems_rfs_buffer_deviceio_direct (rtems_rfs_file_system* fs,
+                                      rtems_rfs_buffer_block block,
+                                      size_t                 count,
+                                      void*                  data,
+                                      bool                   read);
 #endif
 
 /**
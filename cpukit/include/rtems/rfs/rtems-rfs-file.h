@@ -360,6 +360,30 @@ int rtems_rfs_file_io_end (rtems_rfs_file_handle* handle,
                            size_t                 size,
                            bool                   read);
 
+/**
+ * Perform I/O on whole blocks of a file directly between the media and the
+ * data buffer bypassing the buffer cache. The I/O starts at the current file
+ * position which must be at the start of a block and the data buffer must be
+ * suitable for direct transfers, otherwise no I/O is performed. Runs of
+ * contiguous blocks are transferred together. A write grows the file as
+ * needed, a read stops at the last whole block of the file. The file
+ * position is updated by the amount transferred.
+ *
+ * @param[in] handle is the file handle.
+ * @param[in] data is the data buffer.
+ * @param[in,out] size is the amount of data requested and returns the amount
+ *                     transferred which is a multiple of the block size. A
+ *                     return size of 0 means the I/O has to use the cache.
+ * @param[in] read is the I/O operation is a read.
+ *
+ * @retval 0 Successful operation.
+ * @retval error_code An error occurred.
+ */
+int rtems_rfs_file_io_direct (rtems_rfs_file_handle* handle,
+                              void*                  data,
+                              size_t*                size,
+                              bool                   read);
+
 /**
  * Release the I/O resources without any changes. If data has changed in the
  * buffer and the buffer was not already released as modified the data will be
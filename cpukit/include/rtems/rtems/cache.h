@@ -119,6 +119,21 @@ void rtems_cache_invalidate_multiple_data_lines(
   size_t size
 );
 
+/**
+ * @brief Prefetches multiple data cache lines.
+ *
+ * This is a hint that the area will be accessed soon.  The cache lines
+ * covering the area may be loaded in the background.  Implementations without
+ * prefetch support do nothing.
+ *
+ * @param[in] addr The start address of the area to prefetch.
+ * @param[in] size The size in bytes of the area to prefetch.
+ */
+void rtems_cache_prefetch_multiple_data_lines(
+  const void *addr,
+  size_t size
+);
+
 /**
  * @brief Invalidates multiple instruction cache lines.
  *
@@ -230,6 +230,109 @@ rtems_status_code rtems_message_queue_receive(
   rtems_interval  timeout
 );
 
+/**
+ * @brief RTEMS Message Queue Get Buffer
+ *
+ * This directive lends an inactive message buffer of the message queue
+ * indicated by ID to the calling task.  The task fills in the message in
+ * place and sends it with rtems_message_queue_send_buffer() or gives the
+ * buffer back with rtems_message_queue_return_buffer().  Together with
+ * rtems_message_queue_receive_buffer() the message is written once and
+ * never copied.  The message buffer has the maximum message size of the
+ * message queue.  All lent message buffers must be given back before the
+ * message queue is deleted.
+ *
+ * @param[in] id is the queue id
+ * @param[out] buffer is the pointer to the lent message buffer
+ *
+ * @retval RTEMS_SUCCESSFUL Successful operation.
+ * @retval RTEMS_INVALID_ADDRESS The buffer pointer is NULL.
+ * @retval RTEMS_INVALID_ID Invalid message queue identifier.
+ * @retval RTEMS_TOO_MANY No message buffer is available.
+ * @retval RTEMS_ILLEGAL_ON_REMOTE_OBJECT Not supported for remote message
+ *   queues.
+ */
+rtems_status_code rtems_message_queue_get_buffer(
+  rtems_id   id,
+  void     **buffer
+);
+
+/**
+ * @brief RTEMS Message Queue Send Buffer
+ *
+ * This directive sends the message in the lent message buffer to the message
+ * queue indicated by ID without a copy.  A task waiting in
+ * rtems_message_queue_receive_buffer() gets the message buffer itself, a
+ * task waiting in rtems_message_queue_receive() gets a copy.  On success, the
+ * message buffer is no longer lent to the calling task.
+ *
+ * @param[in] id is the queue id
+ * @param[in] buffer is the lent message buffer
+ * @param[in] size is the size of the message
+ *
+ * @retval RTEMS_SUCCESSFUL Successful operation.
+ * @retval RTEMS_INVALID_ADDRESS The buffer is not a lent message buffer of
+ *   this message queue.
+ * @retval RTEMS_INVALID_ID Invalid message queue identifier.
+ * @retval RTEMS_INVALID_SIZE The size is greater than the maximum message
+ *   size.  The message buffer is still lent to the calling task.
+ * @retval RTEMS_ILLEGAL_ON_REMOTE_OBJECT Not supported for remote message
+ *   queues.
+ */
+rtems_status_code rtems_message_queue_send_buffer(
+  rtems_id  id,
+  void     *buffer,
+  size_t    size
+);
+
+/**
+ * @brief RTEMS Message Queue Receive Buffer
+ *
+ * This directive receives a message from the message queue indicated by ID
+ * like rtems_message_queue_receive(), however, the message is not copied.
+ * Instead the message buffer is lent to the calling task.  The task gives the
+ * buffer back with rtems_message_queue_return_buffer() or sends it again
+ * with rtems_message_queue_send_buffer().
+ *
+ * @param[in] id is the queue id
+ * @param[out] buffer is the pointer to the lent message buffer
+ * @param[out] size is the size of the received message
+ * @param[in] option_set is the options on receive
+ * @param[in] timeout is the number of ticks to wait
+ *
+ * @retval This method returns RTEMS_SUCCESSFUL if there was not an
+ *         error. Otherwise, a status code is returned indicating the
+ *         source of the error.
+ */
+rtems_status_code rtems_message_queue_receive_buffer(
+  rtems_id         id,
+  void           **buffer,
+  size_t          *size,
+  rtems_option     option_set,
+  rtems_interval   timeout
+);
+
+/**
+ * @brief RTEMS Message Queue Return Buffer
+ *
+ * This directive gives a lent message buffer back to the message queue
+ * indicated by ID.
+ *
+ * @param[in] id is the queue id
+ * @param[in] buffer is the lent message buffer
+ *
+ * @retval RTEMS_SUCCESSFUL Successful operation.
+ * @retval RTEMS_INVALID_ADDRESS The buffer is not a lent message buffer of
+ *   this message queue.
+ * @retval RTEMS_INVALID_ID Invalid message queue identifier.
+ * @retval RTEMS_ILLEGAL_ON_REMOTE_OBJECT Not supported for remote message
+ *   queues.
+ */
+rtems_status_code rtems_message_queue_return_buffer(
+  rtems_id  id,
+  void     *buffer
+);
+
 /**
  *  @brief rtems_message_queue_flush
  *
@@ -172,6 +172,8 @@ struct rtems_rtl_obj
   rtems_rtl_obj_sym*  global_table; /**< Global symbol table. */
   size_t              global_syms;  /**< Global symbol count. */
   size_t              global_size;  /**< Global symbol memory usage. */
+  rtems_rtl_symbol_index sym_index; /**< The symbol lookup index. Built when
+                                     *   first searched. */
   uint32_t            unresolved;   /**< The number of unresolved relocations. */
   void*               text_base;    /**< The base address of the text section
                                      *   in memory. */
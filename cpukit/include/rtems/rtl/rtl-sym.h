@@ -28,26 +28,56 @@ extern "C" {
  */
 typedef struct rtems_rtl_obj_sym
 {
-  rtems_chain_node node;    /**< The node's link in the chain. */
   const char*      name;    /**< The symbol's name. */
   void*            value;   /**< The value of the symbol. */
   uint32_t         data;    /**< Format specific data. */
+  uint32_t         hash;    /**< The hash of the name, set when indexed. */
 } rtems_rtl_obj_sym;
 
 /**
- * Table of symbols stored in a hash table.
+ * A slot in the global symbol table. The name's hash is held in the slot so
+ * a probe only touches a symbol when the hashes match.
+ */
+typedef struct rtems_rtl_symbol_slot
+{
+  uint32_t           hash;  /**< The hash of the symbol's name. */
+  rtems_rtl_obj_sym* sym;   /**< The symbol, NULL if the slot is empty. */
+} rtems_rtl_symbol_slot;
+
+/**
+ * Table of symbols stored in an open addressing hash table with linear
+ * probing. The table doubles in size when it is three quarters full.
  */
 typedef struct rtems_rtl_symbols
 {
-  rtems_chain_control* buckets;
-  size_t               nbuckets;
+  rtems_rtl_symbol_slot* slots;    /**< The slots, a power of 2 in number. */
+  size_t                 nslots;   /**< The number of slots. */
+  size_t                 count;    /**< The number of symbols in the table. */
+  size_t                 deleted;  /**< The number of deleted slots. */
 } rtems_rtl_symbols;
 
 /**
- * Open a symbol table with the specified number of buckets.
+ * An object file's symbol lookup index. The index covers the local symbols
+ * followed by the global symbols. A GNU hash style Bloom filter of the name
+ * hashes rejects most names that are not in the object without walking a
+ * hash chain.
+ */
+typedef struct rtems_rtl_symbol_index
+{
+  uintptr_t* bloom;       /**< The Bloom filter words. Owns the memory. */
+  uint32_t*  buckets;     /**< The first symbol + 1 in a bucket, 0 if empty. */
+  uint32_t*  chains;      /**< The next symbol + 1 in a chain, 0 ends it. */
+  uint32_t   bloom_mask;  /**< The number of Bloom filter words - 1. */
+  uint32_t   nbuckets;    /**< The number of hash buckets. */
+  uint32_t   bloom_shift; /**< The hash shift for the second Bloom bit. */
+} rtems_rtl_symbol_index;
+
+/**
+ * Open a symbol table with the specified number of slots.
  *
  * @param symbols The symbol table to open.
- * @param buckets The number of buckets in the hash table.
+ * @param buckets The initial number of slots in the hash table. It is rounded
+ *                up to a power of 2.
  * @retval true The symbol is open.
  * @retval false The symbol table could not created. The RTL
  *               error has the error.
@@ -108,11 +138,14 @@ rtems_rtl_obj_sym* rtems_rtl_symbol_obj_find (rtems_rtl_obj* obj,
                                               const char*    name);
 
 /**
- * Add the object file's symbols to the global table.
+ * Add the object file's symbols to the global table. A symbol is not added if
+ * the global table already has a symbol with the same name.
  *
  * @param obj The object file the symbols are to be added.
+ * @retval true The symbols have been added.
+ * @retval false The global table could not grow. The RTL error has the error.
  */
-void rtems_rtl_symbol_obj_add (rtems_rtl_obj* obj);
+bool rtems_rtl_symbol_obj_add (rtems_rtl_obj* obj);
 
 /**
  * Erase the object file's local symbols.
@@ -122,7 +155,9 @@ void rtems_rtl_symbol_obj_add (rtems_rtl_obj* obj);
 void rtems_rtl_symbol_obj_erase_local (rtems_rtl_obj* obj);
 
 /**
- * Erase the object file's symbols.
+ * Erase the object file's symbols. A global symbol removed from the global
+ * table is replaced by a symbol with the same name exported by another
+ * object file if there is one.
  *
  * @param obj The object file the symbols are to be erased from.
  */
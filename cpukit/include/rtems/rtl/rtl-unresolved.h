@@ -60,10 +60,10 @@ extern "C" {
 #endif /* __cplusplus */
 
 /**
- * Hack to work around machine size. This needs to be cleaned up
- * to better support 64bit targets.
+ * A relocation record word. It is the size of a pointer so the offset, info
+ * and addend fields of 64bit targets are held without truncation.
  */
-typedef uint32_t rtems_rtl_word;
+typedef uintptr_t rtems_rtl_word;
 
 /**
  * The types of records in the blocks.
@@ -61,7 +61,7 @@ extern "C" {
 #define RTL_GLUE(a,b) RTL_XGLUE(a,b)
 
 /**
- * The number of buckets in the global symbol table.
+ * The initial number of slots in the global symbol table.
  */
 #define RTEMS_RTL_SYMS_GLOBAL_BUCKETS (32)
 
@@ -270,6 +270,127 @@ void _CORE_message_queue_Insert_message(
   CORE_message_queue_Submit_types    submit_type
 );
 
+/**
+ *  @brief Insert a filled message buffer into the message queue.
+ *
+ *  Inserts the message into the message queue according to the submit type.
+ *  The message content and size must be already present in the message
+ *  buffer.
+ *
+ *  @param[in] the_message_queue points to the message queue
+ *  @param[in] the_message is the message to enqueue
+ *  @param[in] submit_type determines whether the message is prepended,
+ *         appended, or enqueued in priority order.
+ */
+void _CORE_message_queue_Insert_buffer(
+  CORE_message_queue_Control        *the_message_queue,
+  CORE_message_queue_Buffer_control *the_message,
+  CORE_message_queue_Submit_types    submit_type
+);
+
+/**
+ *  @brief Lend an inactive message buffer.
+ *
+ *  Removes a message buffer from the inactive messages of the message queue
+ *  and lends it to the caller.  The caller fills in the message content in
+ *  place and either submits the buffer with
+ *  _CORE_message_queue_Submit_buffer() or gives it back with
+ *  _CORE_message_queue_Return_buffer().
+ *
+ *  @param[in] the_message_queue points to the message queue
+ *  @param[out] the_message_p points to the variable that will contain the
+ *         lent message buffer
+ *  @param[in] queue_context The thread queue context used for
+ *    _CORE_message_queue_Acquire() or _CORE_message_queue_Acquire_critical().
+ *
+ *  @retval STATUS_SUCCESSFUL Successful operation.
+ *  @retval STATUS_TOO_MANY No inactive message buffer is available.
+ */
+Status_Control _CORE_message_queue_Get_buffer(
+  CORE_message_queue_Control         *the_message_queue,
+  CORE_message_queue_Buffer_control **the_message_p,
+  Thread_queue_Context               *queue_context
+);
+
+/**
+ *  @brief Submit a lent message buffer to the message queue.
+ *
+ *  The message content is not copied.  A receiver waiting with
+ *  _CORE_message_queue_Seize_buffer() gets the message buffer itself, a
+ *  receiver waiting with _CORE_message_queue_Seize() gets a copy of the
+ *  message content.  Otherwise the message buffer is inserted into the
+ *  pending messages.
+ *
+ *  Lent message buffers must not be used together with blocking sends.
+ *
+ *  @param[in] the_message_queue points to the message queue
+ *  @param[in] the_message is the lent message buffer
+ *  @param[in] size is the size of the message content
+ *  @param[in] submit_type determines whether the message is prepended,
+ *         appended, or enqueued in priority order.
+ *  @param[in] queue_context The thread queue context used for
+ *    _CORE_message_queue_Acquire() or _CORE_message_queue_Acquire_critical().
+ *
+ *  @retval STATUS_SUCCESSFUL Successful operation.
+ *  @retval STATUS_MESSAGE_INVALID_SIZE The size is greater than the maximum
+ *         message size.  The message buffer is still lent to the caller.
+ */
+Status_Control _CORE_message_queue_Submit_buffer(
+  CORE_message_queue_Control        *the_message_queue,
+  CORE_message_queue_Buffer_control *the_message,
+  size_t                             size,
+  CORE_message_queue_Submit_types    submit_type,
+  Thread_queue_Context              *queue_context
+);
+
+/**
+ *  @brief Lend a pending message buffer.
+ *
+ *  Dequeues a message and lends its message buffer to the caller without a
+ *  copy of the message content.  The caller must give the message buffer back
+ *  with _CORE_message_queue_Return_buffer() or submit it again with
+ *  _CORE_message_queue_Submit_buffer().  The thread will be blocked if wait
+ *  is true, otherwise an error will be given to the thread if no messages
+ *  are available.
+ *
+ *  @param[in] the_message_queue points to the message queue
+ *  @param[in] executing is the executing thread
+ *  @param[out] the_message_p points to the variable that will contain the
+ *         lent message buffer
+ *  @param[in] wait indicates whether the calling thread is willing to block
+ *         if the message queue is empty.
+ *  @param[in] queue_context The thread queue context used for
+ *    _CORE_message_queue_Acquire() or _CORE_message_queue_Acquire_critical().
+ *
+ *  @retval indication of the successful completion or reason for failure.
+ *
+ *  @note Returns message priority via return area in TCB.
+ */
+Status_Control _CORE_message_queue_Seize_buffer(
+  CORE_message_queue_Control         *the_message_queue,
+  Thread_Control                     *executing,
+  CORE_message_queue_Buffer_control **the_message_p,
+  bool                                wait,
+  Thread_queue_Context               *queue_context
+);
+
+/**
+ *  @brief Give back a lent message buffer.
+ *
+ *  The message buffer is returned to the inactive messages of the message
+ *  queue or used for the message of a thread waiting to send.
+ *
+ *  @param[in] the_message_queue points to the message queue
+ *  @param[in] the_message is the lent message buffer
+ *  @param[in] queue_context The thread queue context used for
+ *    _CORE_message_queue_Acquire() or _CORE_message_queue_Acquire_critical().
+ */
+void _CORE_message_queue_Return_buffer(
+  CORE_message_queue_Control        *the_message_queue,
+  CORE_message_queue_Buffer_control *the_message,
+  Thread_queue_Context              *queue_context
+);
+
 RTEMS_INLINE_ROUTINE Status_Control _CORE_message_queue_Send(
   CORE_message_queue_Control       *the_message_queue,
   const void                       *buffer,
@@ -345,6 +466,67 @@ RTEMS_INLINE_ROUTINE void _CORE_message_queue_Copy_buffer (
   memcpy(destination, source, size);
 }
 
+/**
+ * This function returns the size of a message buffer control including the
+ * message content area for the maximum message size.  The message buffers of
+ * a message queue are consecutive with this size.
+ */
+RTEMS_INLINE_ROUTINE size_t _CORE_message_queue_Buffer_control_size(
+  size_t maximum_message_size
+)
+{
+  size_t align_mask;
+
+  /*
+   * Align up the maximum message size to be an integral multiple of the
+   * pointer size.
+   */
+  align_mask = sizeof( uintptr_t ) - 1;
+  return ( ( maximum_message_size + align_mask ) & ~align_mask )
+    + sizeof( CORE_message_queue_Buffer_control );
+}
+
+/**
+ * This function returns the message buffer control of the message content
+ * area @a buffer if it is a message buffer of @a the_message_queue which is
+ * currently lent, otherwise NULL.
+ */
+RTEMS_INLINE_ROUTINE CORE_message_queue_Buffer_control *
+_CORE_message_queue_Get_lent_buffer(
+  const CORE_message_queue_Control *the_message_queue,
+  const void                       *buffer
+)
+{
+  CORE_message_queue_Buffer_control *the_message;
+  uintptr_t                          offset;
+  size_t                             buffer_size;
+
+  the_message = RTEMS_CONTAINER_OF(
+    buffer,
+    CORE_message_queue_Buffer_control,
+    Contents.buffer
+  );
+  offset = (uintptr_t) the_message
+    - (uintptr_t) the_message_queue->message_buffers;
+  buffer_size = _CORE_message_queue_Buffer_control_size(
+    the_message_queue->maximum_message_size
+  );
+
+  /*
+   * The unsigned offset is out of range for addresses before the message
+   * buffers as well.
+   */
+  if (
+    offset >= the_message_queue->maximum_pending_messages * buffer_size
+      || offset % buffer_size != 0
+      || !_Chain_Is_node_off_chain( &the_message->Node )
+  ) {
+    return NULL;
+  }
+
+  return the_message;
+}
+
 /**
  * This function allocates a message buffer from the inactive
  * message buffer chain.
@@ -431,6 +613,39 @@ RTEMS_INLINE_ROUTINE
     do { } while ( 0 )
 #endif
 
+/**
+ * This routine releases @a the_message_queue after the insertion of a
+ * pending message.  If notification is enabled and the message queue made a
+ * 0->1 transition on pending messages, then the notification handler is
+ * invoked instead which releases the message queue.
+ */
+RTEMS_INLINE_ROUTINE void _CORE_message_queue_Release_and_notify(
+  CORE_message_queue_Control *the_message_queue,
+  Thread_queue_Context       *queue_context
+)
+{
+#if defined(RTEMS_SCORE_COREMSG_ENABLE_NOTIFICATION)
+  /*
+   *  According to POSIX, does this happen before or after the message
+   *  is actually enqueued.  It is logical to think afterwards, because
+   *  the message is actually in the queue at this point.
+   */
+  if (
+    the_message_queue->number_of_pending_messages == 1
+      && the_message_queue->notify_handler != NULL
+  ) {
+    ( *the_message_queue->notify_handler )(
+      the_message_queue,
+      queue_context
+    );
+  } else {
+    _CORE_message_queue_Release( the_message_queue, queue_context );
+  }
+#else
+  _CORE_message_queue_Release( the_message_queue, queue_context );
+#endif
+}
+
 RTEMS_INLINE_ROUTINE Thread_Control *_CORE_message_queue_Dequeue_receiver(
   CORE_message_queue_Control      *the_message_queue,
   const void                      *buffer,
@@ -465,14 +680,40 @@ RTEMS_INLINE_ROUTINE Thread_Control *_CORE_message_queue_Dequeue_receiver(
     return NULL;
   }
 
-   *(size_t *) the_thread->Wait.return_argument = size;
-   the_thread->Wait.count = (uint32_t) submit_type;
+  if ( the_thread->Wait.return_argument == NULL ) {
+    CORE_message_queue_Buffer_control *the_message;
+
+    /*
+     *  The receiver waits in _CORE_message_queue_Seize_buffer() and borrows
+     *  a message buffer.  If no inactive message buffer is available, then
+     *  the message cannot be delivered.
+     */
+    the_message =
+      _CORE_message_queue_Allocate_message_buffer( the_message_queue );
+    if ( the_message == NULL ) {
+      return NULL;
+    }
+
+    the_message->Contents.size = size;
+    _CORE_message_queue_Copy_buffer(
+      buffer,
+      the_message->Contents.buffer,
+      size
+    );
+    _Chain_Set_off_chain( &the_message->Node );
+    *(CORE_message_queue_Buffer_control **)
+      the_thread->Wait.return_argument_second.mutable_object = the_message;
+  } else {
+    *(size_t *) the_thread->Wait.return_argument = size;
+
+    _CORE_message_queue_Copy_buffer(
+      buffer,
+      the_thread->Wait.return_argument_second.mutable_object,
+      size
+    );
+  }
 
-  _CORE_message_queue_Copy_buffer(
-    buffer,
-    the_thread->Wait.return_argument_second.mutable_object,
-    size
-  );
+  the_thread->Wait.count = (uint32_t) submit_type;
 
   _Thread_queue_Extract_critical(
     &the_message_queue->Wait_queue.Queue,
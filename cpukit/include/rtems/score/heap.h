@@ -37,10 +37,11 @@ extern "C" {
  * @brief The Heap Handler provides a heap.
  *
  * A heap is a doubly linked list of variable size blocks which are allocated
- * using the first fit method.  Garbage collection is performed each time a
- * block is returned to the heap by coalescing neighbor blocks.  Control
- * information for both allocated and free blocks is contained in the heap
- * area.  A heap control structure contains control information for the heap.
+ * using a two-level segregated fit method.  Garbage collection is performed
+ * each time a block is returned to the heap by coalescing neighbor blocks.
+ * Control information for both allocated and free blocks is contained in the
+ * heap area.  A heap control structure contains control information for the
+ * heap.
  *
  * The alignment routines could be made faster should we require only powers of
  * two to be supported for page size, alignment and boundary arguments.  The
@@ -52,6 +53,18 @@ extern "C" {
  * we can allocate memory.  The other blocks are used and provide an allocated
  * memory area.  The free blocks are accessible via a list of free blocks.
  *
+ * The free list is ordered by size classes.  The first level size class of a
+ * block is the index of the most significant bit of the block size.  Each
+ * first level class is divided into @ref HEAP_FREE_LIST_SECOND_LEVEL_COUNT
+ * second level classes of equal width.  A free list index in the heap control
+ * provides the first block of each non-empty size class and bitmaps of the
+ * non-empty classes.  This allows to find a block which satisfies an
+ * allocation request without an alignment constraint in constant time.  The
+ * first block of the size class of the request is examined, then the first
+ * block of the next non-empty greater class.  Other blocks of the size class
+ * of the request are not examined, so such a request may fail even if one of
+ * them is large enough (good fit instead of first fit).
+ *
  * Blocks or areas cover a continuous set of memory addresses. They have a
  * begin and end address.  The end address is not part of the set.  The size of
  * a block or area equals the distance between the begin and end address in
@@ -336,11 +349,61 @@ typedef struct {
   uint32_t resizes;
 } Heap_Statistics;
 
+/**
+ * @brief Binary logarithm of the count of second level size classes per first
+ * level size class.
+ */
+#define HEAP_FREE_LIST_SECOND_LEVEL_LOG2 2
+
+/**
+ * @brief Count of second level size classes per first level size class.
+ */
+#define HEAP_FREE_LIST_SECOND_LEVEL_COUNT \
+  (1U << HEAP_FREE_LIST_SECOND_LEVEL_LOG2)
+
+/**
+ * @brief Count of first level size classes.
+ */
+#define HEAP_FREE_LIST_FIRST_LEVEL_COUNT (8 * sizeof(uintptr_t))
+
+/**
+ * @brief Count of size classes.
+ */
+#define HEAP_FREE_LIST_CLASS_COUNT \
+  (HEAP_FREE_LIST_FIRST_LEVEL_COUNT * HEAP_FREE_LIST_SECOND_LEVEL_COUNT)
+
+/**
+ * @brief Index of the size classes in the free list.
+ */
+typedef struct {
+  /**
+   * @brief Bitmap of the first level classes with a non-empty second level
+   * class.
+   */
+  uintptr_t first_level;
+
+  /**
+   * @brief Bitmaps of the non-empty second level classes for each first level
+   * class.
+   */
+  uint8_t second_level[ HEAP_FREE_LIST_FIRST_LEVEL_COUNT ];
+
+  /**
+   * @brief The first free block of each size class.
+   *
+   * The entry is NULL for an empty class.  All other blocks of a class follow
+   * the first block in the free list.  This table adds about 0.5KiB to the
+   * heap control on 32-bit targets and about 2KiB on 64-bit targets.
+   */
+  Heap_Block *first[ HEAP_FREE_LIST_CLASS_COUNT ];
+} Heap_Free_list_index;
+
 /**
  * @brief Control block used to manage a heap.
  */
 struct Heap_Control {
   Heap_Block free_list;
+  Heap_Free_list_index free_list_index;
   uintptr_t page_size;
   uintptr_t min_block_size;
   uintptr_t area_begin;
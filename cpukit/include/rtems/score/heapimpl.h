@@ -106,6 +106,12 @@ uintptr_t _Heap_Initialize(
  * A size value of zero will return a unique address which may be freed with
  * _Heap_Free().
  *
+ * Without an alignment and boundary constraint the search examines at most two
+ * free blocks, the first block of the size class of the request and the first
+ * block of the next non-empty greater size class.  In case both are too
+ * small, then the allocation fails even if another free block of the size
+ * class of the request is large enough.
+ *
  * Returns a pointer to the begin of the allocated memory area, or @c NULL if
  * no memory is available or the parameters are inconsistent.
  */
@@ -290,9 +296,8 @@ Heap_Resize_status _Heap_Resize_block(
  *
  * The block may be split up into multiple blocks.  The previous and next block
  * may be used or free.  Free block parts which form a vaild new block will be
- * inserted into the free list or merged with an adjacent free block.  If the
- * block is used, they will be inserted after the free list head.  If the block
- * is free, they will be inserted after the previous block in the free list.
+ * inserted into the free list according to their size class or merged with an
+ * adjacent free block.
  *
  * Inappropriate values for @a alloc_begin or @a alloc_size may corrupt the
  * heap.
@@ -440,6 +445,91 @@ RTEMS_INLINE_ROUTINE void _Heap_Free_list_insert_before(
   block_next->prev = new_block;
 }
 
+/**
+ * @brief Returns the first and second level size class of a block of size
+ * @a size.
+ *
+ * The size must be positive.
+ */
+RTEMS_INLINE_ROUTINE void _Heap_Free_list_mapping(
+  uintptr_t size,
+  unsigned int *first_level,
+  unsigned int *second_level
+)
+{
+  unsigned int fl;
+  unsigned int sl;
+
+  fl = 8 * sizeof( unsigned long ) - 1
+    - (unsigned int) __builtin_clzl( (unsigned long) size );
+
+  if ( fl >= HEAP_FREE_LIST_SECOND_LEVEL_LOG2 ) {
+    sl = (unsigned int) ( size >> ( fl - HEAP_FREE_LIST_SECOND_LEVEL_LOG2 ) )
+      & ( HEAP_FREE_LIST_SECOND_LEVEL_COUNT - 1 );
+  } else {
+    sl = 0;
+  }
+
+  *first_level = fl;
+  *second_level = sl;
+}
+
+/**
+ * @brief Returns the size class of a block of size @a size.
+ *
+ * The size must be positive.
+ */
+RTEMS_INLINE_ROUTINE unsigned int _Heap_Free_list_class( uintptr_t size )
+{
+  unsigned int fl;
+  unsigned int sl;
+
+  _Heap_Free_list_mapping( size, &fl, &sl );
+
+  return fl * HEAP_FREE_LIST_SECOND_LEVEL_COUNT + sl;
+}
+
+/**
+ * @brief Inserts the free block @a block into the free list according to its
+ * size class.
+ *
+ * The block size must be valid.  The block is inserted as the first block of
+ * its size class.
+ */
+void _Heap_Free_list_insert( Heap_Control *heap, Heap_Block *block );
+
+/**
+ * @brief Extracts the free block @a block from the free list.
+ *
+ * The block size must be the size the block had during the insert.
+ */
+void _Heap_Free_list_extract( Heap_Control *heap, Heap_Block *block );
+
+/**
+ * @brief Returns the first free block with a size class greater than or equal
+ * to the size class of @a size.
+ *
+ * Returns the free list tail if no such block exists.  The free list is
+ * ordered by size classes, so all following free blocks have a size class
+ * greater than or equal to the size class of @a size.
+ */
+Heap_Block *_Heap_Free_list_first_of_class(
+  Heap_Control *heap,
+  uintptr_t size
+);
+
+/**
+ * @brief Returns the first free block with a size class greater than the size
+ * class of @a size.
+ *
+ * Returns the free list tail if no such block exists.  The size of the returned
+ * block is greater than or equal to @a size.
+ */
+Heap_Block *_Heap_Free_list_first_above_class(
+  Heap_Control *heap,
+  uintptr_t size
+);
+
 RTEMS_INLINE_ROUTINE bool _Heap_Is_aligned(
   uintptr_t value,
   uintptr_t alignment
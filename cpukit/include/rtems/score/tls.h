@@ -71,7 +71,7 @@ typedef struct {
 } TLS_Dynamic_thread_vector;
 
 typedef struct TLS_Thread_control_block {
-#ifdef __i386__
+#if defined(__i386__) || defined(__x86_64__)
   struct TLS_Thread_control_block *tcb;
 #else
   TLS_Dynamic_thread_vector *dtv;
@@ -118,7 +118,7 @@ static inline uintptr_t _TLS_Get_allocation_size(
   allocation_size += _TLS_Heap_align_up( size );
   allocation_size += _TLS_Get_thread_control_block_area_size( alignment );
 
-#ifndef __i386__
+#if !defined(__i386__) && !defined(__x86_64__)
   allocation_size += sizeof(TLS_Dynamic_thread_vector);
 #endif
 
@@ -150,7 +150,7 @@ static inline void *_TLS_Initialize(
   TLS_Dynamic_thread_vector *dtv
 )
 {
-#ifdef __i386__
+#if defined(__i386__) || defined(__x86_64__)
   (void) dtv;
   tcb->tcb = tcb;
 #else
@@ -61,9 +61,26 @@ typedef struct rtems_bdbuf_swapout_transfer
   rtems_chain_control   bds;         /**< The transfer list of BDs. */
   rtems_disk_device    *dd;          /**< The device the transfer is for. */
   bool                  syncing;     /**< The data is a sync'ing. */
-  rtems_blkdev_request  write_req;   /**< The write request. */
+  uint32_t              in_flight;   /**< The count of write requests passed
+                                      * to the driver and not done yet. */
+  char                 *write_reqs;  /**< The write requests. There are
+                                      * max_write_requests of them, each with
+                                      * room for max_write_blocks buffers. */
 } rtems_bdbuf_swapout_transfer;
 
+/**
+ * A read-ahead request of the read-ahead task. The read-ahead task passes the
+ * request to the driver and continues with the next read-ahead stream. The
+ * driver puts the completed request on the done chain.
+ */
+typedef struct rtems_bdbuf_read_ahead_request
+{
+  rtems_chain_node      link;        /**< The free or done chain node. */
+  rtems_disk_device    *dd;          /**< The device the request is for. */
+  rtems_blkdev_request *req;         /**< The request with room for
+                                      * max_read_ahead_blocks buffers. */
+} rtems_bdbuf_read_ahead_request;
+
 /**
  * Swapout worker thread. These are available to take processing from the
  * main swapout thread and handle the I/O operation.
@@ -87,6 +104,61 @@ typedef struct rtems_bdbuf_waiters {
   rtems_condition_variable cond_var;
 } rtems_bdbuf_waiters;
 
+/**
+ * A slot of the buffer descriptor index of a shard. The index is an open
+ * addressing hash table with linear probing keyed by the dd/block of the BD.
+ * It has at least twice as many slots as the shard has BDs, so the lookup cost
+ * does not depend on the cache size.
+ */
+typedef struct rtems_bdbuf_index_slot
+{
+  rtems_bdbuf_buffer* bd;                /**< The BD or NULL if free. */
+  uint32_t            hash;              /**< The hash of the BD key. */
+} rtems_bdbuf_index_slot;
+
+/**
+ * A shard of the BD buffer cache. The groups of buffers are split evenly over
+ * the shards and each disk device uses the buffers of one shard only, see
+ * rtems_bdbuf_select_shard(). Disks in different shards never contend for a
+ * lock.
+ */
+typedef struct rtems_bdbuf_shard
+{
+  rtems_mutex         lock;              /**< The shard lock. It locks all
+                                          * shard data, BD and lists. */
+  bool                sync_active;       /**< True if a sync is active. */
+  rtems_id            sync_requester;    /**< The sync requester. */
+  rtems_disk_device  *sync_device;       /**< The device to sync and
+                                          * BDBUF_INVALID_DEV not a device
+                                          * sync. */
+
+  rtems_bdbuf_index_slot* index;         /**< Buffer descriptor lookup hash
+                                          * index. */
+  size_t              index_mask;        /**< The number of index slots minus
+                                          * one. */
+  size_t              bd_count;          /**< The number of BDs of this
+                                          * shard. */
+  rtems_chain_control lru;               /**< Least recently used list */
+  rtems_chain_control modified;          /**< Modified buffers list */
+  rtems_chain_control sync;              /**< Buffers to sync list */
+
+  rtems_bdbuf_waiters access_waiters;    /**< Wait for a buffer in
+                                          * ACCESS_CACHED, ACCESS_MODIFIED or
+                                          * ACCESS_EMPTY
+                                          * state. */
+  rtems_bdbuf_waiters transfer_waiters;  /**< Wait for a buffer in TRANSFER
+                                          * state. */
+  rtems_bdbuf_waiters buffer_waiters;    /**< Wait for a buffer and no one is
+                                          * available. */
+
+  rtems_bdbuf_waiters write_behind_waiters; /**< Wait for the write-behind to
+                                             * write the modified buffers. */
+  uint32_t            modified_count;    /**< The number of buffers in the
+                                          * MODIFIED or SYNC state. */
+
+  rtems_chain_control read_ahead_chain;  /**< Read-ahead request chain */
+} rtems_bdbuf_shard;
+
 /**
  * The BD buffer cache.
  */
@@ -108,29 +180,15 @@ typedef struct rtems_bdbuf_cache
                                           * buffer size that fit in a group. */
   uint32_t            flags;             /**< Configuration flags. */
 
-  rtems_mutex         lock;              /**< The cache lock. It locks all
-                                          * cache data, BD and lists. */
+  rtems_mutex         lock;              /**< The cache lock. It locks the
+                                          * free swapout workers and the
+                                          * shard selection. */
   rtems_mutex         sync_lock;         /**< Sync calls block writes. */
-  bool                sync_active;       /**< True if a sync is active. */
-  rtems_id            sync_requester;    /**< The sync requester. */
-  rtems_disk_device  *sync_device;       /**< The device to sync and
-                                          * BDBUF_INVALID_DEV not a device
-                                          * sync. */
 
-  rtems_bdbuf_buffer* tree;              /**< Buffer descriptor lookup AVL tree
-                                          * root. There is only one. */
-  rtems_chain_control lru;               /**< Least recently used list */
-  rtems_chain_control modified;          /**< Modified buffers list */
-  rtems_chain_control sync;              /**< Buffers to sync list */
-
-  rtems_bdbuf_waiters access_waiters;    /**< Wait for a buffer in
-                                          * ACCESS_CACHED, ACCESS_MODIFIED or
-                                          * ACCESS_EMPTY
-                                          * state. */
-  rtems_bdbuf_waiters transfer_waiters;  /**< Wait for a buffer in TRANSFER
-                                          * state. */
-  rtems_bdbuf_waiters buffer_waiters;    /**< Wait for a buffer and no one is
-                                          * available. */
+  rtems_bdbuf_shard*  shards;            /**< The shards. */
+  size_t              shard_count;       /**< The number of shards. */
+  size_t              next_shard;        /**< The shard of the next physical
+                                          * disk device. */
 
   rtems_bdbuf_swapout_transfer *swapout_transfer;
   rtems_bdbuf_swapout_worker *swapout_workers;
@@ -138,8 +196,17 @@ typedef struct rtems_bdbuf_cache
   size_t              group_count;       /**< The number of groups. */
   rtems_bdbuf_group*  groups;            /**< The groups. */
   rtems_id            read_ahead_task;   /**< Read-ahead task */
-  rtems_chain_control read_ahead_chain;  /**< Read-ahead request chain */
   bool                read_ahead_enabled; /**< Read-ahead enabled */
+  rtems_bdbuf_read_ahead_request *read_ahead_reqs; /**< The read-ahead
+                                          * requests. */
+  rtems_chain_control read_ahead_free;   /**< The free read-ahead requests.
+                                          * Only used by the read-ahead
+                                          * task. */
+  rtems_chain_control read_ahead_done;   /**< The completed read-ahead
+                                          * requests. Protected by the
+                                          * read-ahead lock since drivers may
+                                          * complete requests in interrupt
+                                          * context. */
   rtems_status_code   init_status;       /**< The initialization status */
   pthread_once_t      once;
 } rtems_bdbuf_cache;
@@ -187,11 +254,6 @@ static rtems_task rtems_bdbuf_read_ahead_task(rtems_task_argument arg);
 static rtems_bdbuf_cache bdbuf_cache = {
   .lock = RTEMS_MUTEX_INITIALIZER(NULL),
   .sync_lock = RTEMS_MUTEX_INITIALIZER(NULL),
-  .access_waiters = { .cond_var = RTEMS_CONDITION_VARIABLE_INITIALIZER(NULL) },
-  .transfer_waiters = {
-    .cond_var = RTEMS_CONDITION_VARIABLE_INITIALIZER(NULL)
-  },
-  .buffer_waiters = { .cond_var = RTEMS_CONDITION_VARIABLE_INITIALIZER(NULL) },
   .once = PTHREAD_ONCE_INIT
 };
 
@@ -227,21 +289,28 @@ void
 rtems_bdbuf_show_usage (void)
 {
   uint32_t group;
+  size_t   s;
   uint32_t total = 0;
   uint32_t val;
 
   for (group = 0; group < bdbuf_cache.group_count; group++)
     total += bdbuf_cache.groups[group].users;
   printf ("bdbuf:group users=%lu", total);
-  val = rtems_bdbuf_list_count (&bdbuf_cache.lru);
-  printf (", lru=%lu", val);
-  total = val;
-  val = rtems_bdbuf_list_count (&bdbuf_cache.modified);
-  printf (", mod=%lu", val);
-  total += val;
-  val = rtems_bdbuf_list_count (&bdbuf_cache.sync);
-  printf (", sync=%lu", val);
-  total += val;
+  total = 0;
+  for (s = 0; s < bdbuf_cache.shard_count; s++)
+  {
+    rtems_bdbuf_shard* shard = &bdbuf_cache.shards[s];
+
+    val = rtems_bdbuf_list_count (&shard->lru);
+    printf (", lru[%zu]=%lu", s, val);
+    total += val;
+    val = rtems_bdbuf_list_count (&shard->modified);
+    printf (", mod[%zu]=%lu", s, val);
+    total += val;
+    val = rtems_bdbuf_list_count (&shard->sync);
+    printf (", sync[%zu]=%lu", s, val);
+    total += val;
+  }
   printf (", total=%lu\n", total);
 }
 
@@ -271,15 +340,6 @@ rtems_bdbuf_show_users (const char* where, rtems_bdbuf_buffer* bd)
 #define rtems_bdbuf_show_users(_w, _b) ((void) 0)
 #endif
 
-/**
- * The default maximum height of 32 allows for AVL trees having between
- * 5,704,880 and 4,294,967,295 nodes, depending on order of insertion.  You may
- * change this compile-time constant as you wish.
- */
-#ifndef RTEMS_BDBUF_AVL_MAX_HEIGHT
-#define RTEMS_BDBUF_AVL_MAX_HEIGHT (32)
-#endif
-
 static void
 rtems_bdbuf_fatal (rtems_fatal_code error)
 {
@@ -293,499 +353,150 @@ rtems_bdbuf_fatal_with_state (rtems_bdbuf_buf_state state,
   rtems_bdbuf_fatal ((((uint32_t) state) << 16) | error);
 }
 
+/**
+ * Computes the hash of the specified dd/block.  Consecutive blocks of a
+ * device map to distinct hash values, so that sequential accesses do not
+ * collide in the index.
+ *
+ * @param dd disk device key
+ * @param block block key
+ * @return hash of the key
+ */
+static uint32_t
+rtems_bdbuf_index_hash (const rtems_disk_device *dd,
+                        rtems_blkdev_bnum        block)
+{
+  uint32_t h = (uint32_t) ((uintptr_t) dd >> 4) * UINT32_C (0x9e3779b9);
+
+  h ^= block;
+  h *= UINT32_C (0x85ebca6b);
+  h ^= h >> 15;
+
+  return h;
+}
+
 /**
  * Searches for the node with specified dd/block.
  *
- * @param root pointer to the root node of the AVL-Tree
+ * @param shard shard of the index
  * @param dd disk device search key
  * @param block block search key
  * @retval NULL node with the specified dd/block is not found
  * @return pointer to the node with specified dd/block
  */
 static rtems_bdbuf_buffer *
-rtems_bdbuf_avl_search (rtems_bdbuf_buffer** root,
-                        const rtems_disk_device *dd,
-                        rtems_blkdev_bnum    block)
+rtems_bdbuf_index_search (const rtems_bdbuf_shard *shard,
+                          const rtems_disk_device *dd,
+                          rtems_blkdev_bnum        block)
 {
-  rtems_bdbuf_buffer* p = *root;
+  const rtems_bdbuf_index_slot* index = shard->index;
+  uint32_t hash = rtems_bdbuf_index_hash (dd, block);
+  size_t   i = hash & shard->index_mask;
 
-  while ((p != NULL) && ((p->dd != dd) || (p->block != block)))
+  while (index[i].bd != NULL)
   {
-    if (((uintptr_t) p->dd < (uintptr_t) dd)
-        || ((p->dd == dd) && (p->block < block)))
-    {
-      p = p->avl.right;
-    }
-    else
-    {
-      p = p->avl.left;
-    }
+    /*
+     * Compare the stored hash first, so that only a likely match has to touch
+     * the buffer descriptor.
+     */
+    if (index[i].hash == hash
+        && index[i].bd->dd == dd && index[i].bd->block == block)
+      return index[i].bd;
+
+    i = (i + 1) & shard->index_mask;
   }
 
-  return p;
+  return NULL;
 }
 
 /**
- * Inserts the specified node to the AVl-Tree.
+ * Inserts the specified node to the index.
  *
- * @param root pointer to the root node of the AVL-Tree
+ * @param shard shard of the index
  * @param node Pointer to the node to add.
  * @retval 0 The node added successfully
- * @retval -1 An error occured
+ * @retval -1 A node with the same dd/block is already in the index
  */
 static int
-rtems_bdbuf_avl_insert(rtems_bdbuf_buffer** root,
-                       rtems_bdbuf_buffer*  node)
+rtems_bdbuf_index_insert (rtems_bdbuf_shard*  shard,
+                          rtems_bdbuf_buffer* node)
 {
-  const rtems_disk_device *dd = node->dd;
-  rtems_blkdev_bnum block = node->block;
-
-  rtems_bdbuf_buffer*  p = *root;
-  rtems_bdbuf_buffer*  q;
-  rtems_bdbuf_buffer*  p1;
-  rtems_bdbuf_buffer*  p2;
-  rtems_bdbuf_buffer*  buf_stack[RTEMS_BDBUF_AVL_MAX_HEIGHT];
-  rtems_bdbuf_buffer** buf_prev = buf_stack;
+  rtems_bdbuf_index_slot* index = shard->index;
+  uint32_t hash = rtems_bdbuf_index_hash (node->dd, node->block);
+  size_t   i = hash & shard->index_mask;
 
-  bool modified = false;
-
-  if (p == NULL)
-  {
-    *root = node;
-    node->avl.left = NULL;
-    node->avl.right = NULL;
-    node->avl.bal = 0;
-    return 0;
-  }
-
-  while (p != NULL)
+  /*
+   * The index has more slots than the shard has nodes, so there is always a
+   * free slot.
+   */
+  while (index[i].bd != NULL)
   {
-    *buf_prev++ = p;
-
-    if (((uintptr_t) p->dd < (uintptr_t) dd)
-        || ((p->dd == dd) && (p->block < block)))
-    {
-      p->avl.cache = 1;
-      q = p->avl.right;
-      if (q == NULL)
-      {
-        q = node;
-        p->avl.right = q = node;
-        break;
-      }
-    }
-    else if ((p->dd != dd) || (p->block != block))
-    {
-      p->avl.cache = -1;
-      q = p->avl.left;
-      if (q == NULL)
-      {
-        q = node;
-        p->avl.left = q;
-        break;
-      }
-    }
-    else
-    {
+    if (index[i].hash == hash
+        && index[i].bd->dd == node->dd && index[i].bd->block == node->block)
       return -1;
-    }
 
-    p = q;
+    i = (i + 1) & shard->index_mask;
   }
 
-  q->avl.left = q->avl.right = NULL;
-  q->avl.bal = 0;
-  modified = true;
-  buf_prev--;
-
-  while (modified)
-  {
-    if (p->avl.cache == -1)
-    {
-      switch (p->avl.bal)
-      {
-        case 1:
-          p->avl.bal = 0;
-          modified = false;
-          break;
-
-        case 0:
-          p->avl.bal = -1;
-          break;
-
-        case -1:
-          p1 = p->avl.left;
-          if (p1->avl.bal == -1) /* simple LL-turn */
-          {
-            p->avl.left = p1->avl.right;
-            p1->avl.right = p;
-            p->avl.bal = 0;
-            p = p1;
-          }
-          else /* double LR-turn */
-          {
-            p2 = p1->avl.right;
-            p1->avl.right = p2->avl.left;
-            p2->avl.left = p1;
-            p->avl.left = p2->avl.right;
-            p2->avl.right = p;
-            if (p2->avl.bal == -1) p->avl.bal = +1; else p->avl.bal = 0;
-            if (p2->avl.bal == +1) p1->avl.bal = -1; else p1->avl.bal = 0;
-            p = p2;
-          }
-          p->avl.bal = 0;
-          modified = false;
-          break;
-
-        default:
-          break;
-      }
-    }
-    else
-    {
-      switch (p->avl.bal)
-      {
-        case -1:
-          p->avl.bal = 0;
-          modified = false;
-          break;
-
-        case 0:
-          p->avl.bal = 1;
-          break;
-
-        case 1:
-          p1 = p->avl.right;
-          if (p1->avl.bal == 1) /* simple RR-turn */
-          {
-            p->avl.right = p1->avl.left;
-            p1->avl.left = p;
-            p->avl.bal = 0;
-            p = p1;
-          }
-          else /* double RL-turn */
-          {
-            p2 = p1->avl.left;
-            p1->avl.left = p2->avl.right;
-            p2->avl.right = p1;
-            p->avl.right = p2->avl.left;
-            p2->avl.left = p;
-            if (p2->avl.bal == +1) p->avl.bal = -1; else p->avl.bal = 0;
-            if (p2->avl.bal == -1) p1->avl.bal = +1; else p1->avl.bal = 0;
-            p = p2;
-          }
-          p->avl.bal = 0;
-          modified = false;
-          break;
-
-        default:
-          break;
-      }
-    }
-    q = p;
-    if (buf_prev > buf_stack)
-    {
-      p = *--buf_prev;
-
-      if (p->avl.cache == -1)
-      {
-        p->avl.left = q;
-      }
-      else
-      {
-        p->avl.right = q;
-      }
-    }
-    else
-    {
-      *root = p;
-      break;
-    }
-  };
+  index[i].bd = node;
+  index[i].hash = hash;
 
   return 0;
 }
 
-
 /**
- * Removes the node from the tree.
+ * Removes the node from the index.  The following nodes of the probe sequence
+ * are shifted back into the freed slot, so that no deleted markers are
+ * necessary and the probe sequences stay short.
  *
- * @param root Pointer to pointer to the root node
+ * @param shard shard of the index
  * @param node Pointer to the node to remove
  * @retval 0 Item removed
  * @retval -1 No such item found
  */
 static int
-rtems_bdbuf_avl_remove(rtems_bdbuf_buffer**      root,
-                       const rtems_bdbuf_buffer* node)
+rtems_bdbuf_index_remove (rtems_bdbuf_shard*        shard,
+                          const rtems_bdbuf_buffer* node)
 {
-  const rtems_disk_device *dd = node->dd;
-  rtems_blkdev_bnum block = node->block;
-
-  rtems_bdbuf_buffer*  p = *root;
-  rtems_bdbuf_buffer*  q;
-  rtems_bdbuf_buffer*  r;
-  rtems_bdbuf_buffer*  s;
-  rtems_bdbuf_buffer*  p1;
-  rtems_bdbuf_buffer*  p2;
-  rtems_bdbuf_buffer*  buf_stack[RTEMS_BDBUF_AVL_MAX_HEIGHT];
-  rtems_bdbuf_buffer** buf_prev = buf_stack;
-
-  bool modified = false;
+  rtems_bdbuf_index_slot* index = shard->index;
+  size_t mask = shard->index_mask;
+  size_t i = rtems_bdbuf_index_hash (node->dd, node->block) & mask;
+  size_t j;
 
-  memset (buf_stack, 0, sizeof(buf_stack));
-
-  while (p != NULL)
+  while (index[i].bd != node)
   {
-    *buf_prev++ = p;
+    if (index[i].bd == NULL)
+      return -1;
 
-    if (((uintptr_t) p->dd < (uintptr_t) dd)
-        || ((p->dd == dd) && (p->block < block)))
-    {
-      p->avl.cache = 1;
-      p = p->avl.right;
-    }
-    else if ((p->dd != dd) || (p->block != block))
-    {
-      p->avl.cache = -1;
-      p = p->avl.left;
-    }
-    else
-    {
-      /* node found */
-      break;
-    }
+    i = (i + 1) & mask;
   }
 
-  if (p == NULL)
-  {
-    /* there is no such node */
-    return -1;
-  }
+  j = i;
 
-  q = p;
-
-  buf_prev--;
-  if (buf_prev > buf_stack)
-  {
-    p = *(buf_prev - 1);
-  }
-  else
-  {
-    p = NULL;
-  }
-
-  /* at this moment q - is a node to delete, p is q's parent */
-  if (q->avl.right == NULL)
-  {
-    r = q->avl.left;
-    if (r != NULL)
-    {
-      r->avl.bal = 0;
-    }
-    q = r;
-  }
-  else
-  {
-    rtems_bdbuf_buffer **t;
-
-    r = q->avl.right;
-
-    if (r->avl.left == NULL)
-    {
-      r->avl.left = q->avl.left;
-      r->avl.bal = q->avl.bal;
-      r->avl.cache = 1;
-      *buf_prev++ = q = r;
-    }
-    else
-    {
-      t = buf_prev++;
-      s = r;
-
-      while (s->avl.left != NULL)
-      {
-        *buf_prev++ = r = s;
-        s = r->avl.left;
-        r->avl.cache = -1;
-      }
-
-      s->avl.left = q->avl.left;
-      r->avl.left = s->avl.right;
-      s->avl.right = q->avl.right;
-      s->avl.bal = q->avl.bal;
-      s->avl.cache = 1;
-
-      *t = q = s;
-    }
-  }
-
-  if (p != NULL)
-  {
-    if (p->avl.cache == -1)
-    {
-      p->avl.left = q;
-    }
-    else
-    {
-      p->avl.right = q;
-    }
-  }
-  else
+  while (true)
   {
-    *root = q;
-  }
+    size_t home;
 
-  modified = true;
+    j = (j + 1) & mask;
 
-  while (modified)
-  {
-    if (buf_prev > buf_stack)
-    {
-      p = *--buf_prev;
-    }
-    else
-    {
+    if (index[j].bd == NULL)
       break;
-    }
-
-    if (p->avl.cache == -1)
-    {
-      /* rebalance left branch */
-      switch (p->avl.bal)
-      {
-        case -1:
-          p->avl.bal = 0;
-          break;
-        case  0:
-          p->avl.bal = 1;
-          modified = false;
-          break;
-
-        case +1:
-          p1 = p->avl.right;
-
-          if (p1->avl.bal >= 0) /* simple RR-turn */
-          {
-            p->avl.right = p1->avl.left;
-            p1->avl.left = p;
-
-            if (p1->avl.bal == 0)
-            {
-              p1->avl.bal = -1;
-              modified = false;
-            }
-            else
-            {
-              p->avl.bal = 0;
-              p1->avl.bal = 0;
-            }
-            p = p1;
-          }
-          else /* double RL-turn */
-          {
-            p2 = p1->avl.left;
-
-            p1->avl.left = p2->avl.right;
-            p2->avl.right = p1;
-            p->avl.right = p2->avl.left;
-            p2->avl.left = p;
-
-            if (p2->avl.bal == +1) p->avl.bal = -1; else p->avl.bal = 0;
-            if (p2->avl.bal == -1) p1->avl.bal = 1; else p1->avl.bal = 0;
-
-            p = p2;
-            p2->avl.bal = 0;
-          }
-          break;
-
-        default:
-          break;
-      }
-    }
-    else
-    {
-      /* rebalance right branch */
-      switch (p->avl.bal)
-      {
-        case +1:
-          p->avl.bal = 0;
-          break;
-
-        case  0:
-          p->avl.bal = -1;
-          modified = false;
-          break;
-
-        case -1:
-          p1 = p->avl.left;
-
-          if (p1->avl.bal <= 0) /* simple LL-turn */
-          {
-            p->avl.left = p1->avl.right;
-            p1->avl.right = p;
-            if (p1->avl.bal == 0)
-            {
-              p1->avl.bal = 1;
-              modified = false;
-            }
-            else
-            {
-              p->avl.bal = 0;
-              p1->avl.bal = 0;
-            }
-            p = p1;
-          }
-          else /* double LR-turn */
-          {
-            p2 = p1->avl.right;
-
-            p1->avl.right = p2->avl.left;
-            p2->avl.left = p1;
-            p->avl.left = p2->avl.right;
-            p2->avl.right = p;
-
-            if (p2->avl.bal == -1) p->avl.bal = 1; else p->avl.bal = 0;
-            if (p2->avl.bal == +1) p1->avl.bal = -1; else p1->avl.bal = 0;
-
-            p = p2;
-            p2->avl.bal = 0;
-          }
-          break;
-
-        default:
-          break;
-      }
-    }
 
-    if (buf_prev > buf_stack)
+    /*
+     * The node in slot j may move to slot i if its home slot is not in the
+     * cyclic range (i, j].
+     */
+    home = index[j].hash & mask;
+    if (((j - home) & mask) >= ((j - i) & mask))
     {
-      q = *(buf_prev - 1);
-
-      if (q->avl.cache == -1)
-      {
-        q->avl.left = p;
-      }
-      else
-      {
-        q->avl.right = p;
-      }
+      index[i] = index[j];
+      i = j;
     }
-    else
-    {
-      *root = p;
-      break;
-    }
-
   }
 
-  return 0;
-}
+  index[i].bd = NULL;
 
-static void
-rtems_bdbuf_set_state (rtems_bdbuf_buffer *bd, rtems_bdbuf_buf_state state)
-{
-  bd->state = state;
+  return 0;
 }
 
 static rtems_blkdev_bnum
@@ -842,6 +553,39 @@ rtems_bdbuf_unlock_cache (void)
   rtems_bdbuf_unlock (&bdbuf_cache.lock);
 }
 
+/**
+ * Return the shard which holds the buffers of the disk device.
+ *
+ * @param dd The disk device.
+ */
+static rtems_bdbuf_shard *
+rtems_bdbuf_get_shard (const rtems_disk_device *dd)
+{
+  return &bdbuf_cache.shards[dd->bdbuf_shard % bdbuf_cache.shard_count];
+}
+
+/**
+ * Lock the shard. A single task can nest calls.
+ *
+ * @param shard The shard to lock.
+ */
+static void
+rtems_bdbuf_lock_shard (rtems_bdbuf_shard *shard)
+{
+  rtems_bdbuf_lock (&shard->lock);
+}
+
+/**
+ * Unlock the shard.
+ *
+ * @param shard The shard to unlock.
+ */
+static void
+rtems_bdbuf_unlock_shard (rtems_bdbuf_shard *shard)
+{
+  rtems_bdbuf_unlock (&shard->lock);
+}
+
 /**
  * Lock the cache's sync. A single task can nest calls.
  */
@@ -878,34 +622,37 @@ rtems_bdbuf_group_release (rtems_bdbuf_buffer *bd)
  * be woken and this would require storage and we do not know the number of
  * tasks that could be waiting.
  *
- * While we have the cache locked we can try and claim the semaphore and
- * therefore know when we release the lock to the cache we will block until the
+ * While we have the shard locked we can try and claim the semaphore and
+ * therefore know when we release the lock to the shard we will block until the
  * semaphore is released. This may even happen before we get to block.
  *
  * A counter is used to save the release call when no one is waiting.
  *
- * The function assumes the cache is locked on entry and it will be locked on
+ * The function assumes the shard is locked on entry and it will be locked on
  * exit.
  */
 static void
-rtems_bdbuf_anonymous_wait (rtems_bdbuf_waiters *waiters)
+rtems_bdbuf_anonymous_wait (rtems_bdbuf_shard   *shard,
+                            rtems_bdbuf_waiters *waiters)
 {
   /*
    * Indicate we are waiting.
    */
   ++waiters->count;
 
-  rtems_condition_variable_wait (&waiters->cond_var, &bdbuf_cache.lock);
+  rtems_condition_variable_wait (&waiters->cond_var, &shard->lock);
 
   --waiters->count;
 }
 
 static void
-rtems_bdbuf_wait (rtems_bdbuf_buffer *bd, rtems_bdbuf_waiters *waiters)
+rtems_bdbuf_wait (rtems_bdbuf_shard   *shard,
+                  rtems_bdbuf_buffer  *bd,
+                  rtems_bdbuf_waiters *waiters)
 {
   rtems_bdbuf_group_obtain (bd);
   ++bd->waiters;
-  rtems_bdbuf_anonymous_wait (waiters);
+  rtems_bdbuf_anonymous_wait (shard, waiters);
   --bd->waiters;
   rtems_bdbuf_group_release (bd);
 }
@@ -933,27 +680,121 @@ rtems_bdbuf_wake_swapper (void)
 }
 
 static bool
-rtems_bdbuf_has_buffer_waiters (void)
+rtems_bdbuf_has_buffer_waiters (rtems_bdbuf_shard *shard)
+{
+  return shard->buffer_waiters.count;
+}
+
+static bool
+rtems_bdbuf_is_modified_state (rtems_bdbuf_buf_state state)
+{
+  return state == RTEMS_BDBUF_STATE_MODIFIED
+    || state == RTEMS_BDBUF_STATE_SYNC;
+}
+
+/**
+ * Sets the state of the buffer and maintains the count of modified buffers of
+ * its shard. The shard must be locked.
+ */
+static void
+rtems_bdbuf_set_state (rtems_bdbuf_buffer *bd, rtems_bdbuf_buf_state state)
+{
+  bool was_modified = rtems_bdbuf_is_modified_state (bd->state);
+  bool is_modified = rtems_bdbuf_is_modified_state (state);
+
+  if (was_modified != is_modified)
+  {
+    rtems_bdbuf_shard *shard = rtems_bdbuf_get_shard (bd->dd);
+
+    if (is_modified)
+    {
+      ++shard->modified_count;
+    }
+    else
+    {
+      --shard->modified_count;
+
+      if (shard->modified_count < bdbuf_config.write_behind_blocks)
+        rtems_bdbuf_wake (&shard->write_behind_waiters);
+    }
+  }
+
+  bd->state = state;
+}
+
+static bool
+rtems_bdbuf_is_write_behind_due (const rtems_bdbuf_shard *shard)
+{
+  return bdbuf_config.write_behind_blocks > 0
+    && shard->modified_count >= bdbuf_config.write_behind_blocks;
+}
+
+/**
+ * Starts the write-behind if the shard has enough modified buffers. Writers
+ * which produce modified buffers faster than the swapout task writes them are
+ * throttled. If twice the write-behind block count is reached, the writer
+ * waits until the count drops below the write-behind block count.
+ */
+static void
+rtems_bdbuf_write_behind (rtems_bdbuf_shard *shard)
+{
+  if (rtems_bdbuf_is_write_behind_due (shard))
+  {
+    rtems_bdbuf_wake_swapper ();
+
+    if (shard->modified_count >= 2 * bdbuf_config.write_behind_blocks)
+    {
+      while (rtems_bdbuf_is_write_behind_due (shard))
+        rtems_bdbuf_anonymous_wait (shard, &shard->write_behind_waiters);
+    }
+  }
+}
+
+static void
+rtems_bdbuf_read_ahead_hit (rtems_bdbuf_buffer *bd)
 {
-  return bdbuf_cache.buffer_waiters.count;
+  rtems_blkdev_read_ahead_stream *stream = bd->read_ahead_stream;
+
+  if (stream != NULL)
+  {
+    ++stream->hits;
+    ++bd->dd->stats.read_ahead_hits;
+    bd->read_ahead_stream = NULL;
+  }
 }
 
 static void
-rtems_bdbuf_remove_from_tree (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_read_ahead_miss (rtems_bdbuf_buffer *bd)
 {
-  if (rtems_bdbuf_avl_remove (&bdbuf_cache.tree, bd) != 0)
+  rtems_blkdev_read_ahead_stream *stream = bd->read_ahead_stream;
+
+  if (stream != NULL)
+  {
+    ++stream->misses;
+    ++bd->dd->stats.read_ahead_misses;
+    bd->read_ahead_stream = NULL;
+  }
+}
+
+static void
+rtems_bdbuf_remove_from_index (rtems_bdbuf_shard *shard, rtems_bdbuf_buffer *bd)
+{
+  rtems_bdbuf_read_ahead_miss (bd);
+
+  if (rtems_bdbuf_index_remove (shard, bd) != 0)
     rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_TREE_RM);
 }
 
 static void
-rtems_bdbuf_remove_from_tree_and_lru_list (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_remove_from_index_and_lru_list (rtems_bdbuf_shard  *shard,
+                                           rtems_bdbuf_buffer *bd)
 {
   switch (bd->state)
   {
     case RTEMS_BDBUF_STATE_FREE:
       break;
     case RTEMS_BDBUF_STATE_CACHED:
-      rtems_bdbuf_remove_from_tree (bd);
+      rtems_bdbuf_remove_from_index (shard, bd);
       break;
     default:
       rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_STATE_10);
@@ -963,10 +804,11 @@ rtems_bdbuf_remove_from_tree_and_lru_list (rtems_bdbuf_buffer *bd)
 }
 
 static void
-rtems_bdbuf_make_free_and_add_to_lru_list (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_make_free_and_add_to_lru_list (rtems_bdbuf_shard  *shard,
+                                           rtems_bdbuf_buffer *bd)
 {
   rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_FREE);
-  rtems_chain_prepend_unprotected (&bdbuf_cache.lru, &bd->link);
+  rtems_chain_prepend_unprotected (&shard->lru, &bd->link);
 }
 
 static void
@@ -976,30 +818,32 @@ rtems_bdbuf_make_empty (rtems_bdbuf_buffer *bd)
 }
 
 static void
-rtems_bdbuf_make_cached_and_add_to_lru_list (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_make_cached_and_add_to_lru_list (rtems_bdbuf_shard  *shard,
+                                             rtems_bdbuf_buffer *bd)
 {
   rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_CACHED);
-  rtems_chain_append_unprotected (&bdbuf_cache.lru, &bd->link);
+  rtems_chain_append_unprotected (&shard->lru, &bd->link);
 }
 
 static void
-rtems_bdbuf_discard_buffer (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_discard_buffer (rtems_bdbuf_shard *shard, rtems_bdbuf_buffer *bd)
 {
   rtems_bdbuf_make_empty (bd);
 
   if (bd->waiters == 0)
   {
-    rtems_bdbuf_remove_from_tree (bd);
-    rtems_bdbuf_make_free_and_add_to_lru_list (bd);
+    rtems_bdbuf_remove_from_index (shard, bd);
+    rtems_bdbuf_make_free_and_add_to_lru_list (shard, bd);
   }
 }
 
 static void
-rtems_bdbuf_add_to_modified_list_after_access (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_add_to_modified_list_after_access (rtems_bdbuf_shard  *shard,
+                                               rtems_bdbuf_buffer *bd)
 {
-  if (bdbuf_cache.sync_active && bdbuf_cache.sync_device == bd->dd)
+  if (shard->sync_active && shard->sync_device == bd->dd)
   {
-    rtems_bdbuf_unlock_cache ();
+    rtems_bdbuf_unlock_shard (shard);
 
     /*
      * Wait for the sync lock.
@@ -1007,7 +851,7 @@ rtems_bdbuf_add_to_modified_list_after_access (rtems_bdbuf_buffer *bd)
     rtems_bdbuf_lock_sync ();
 
     rtems_bdbuf_unlock_sync ();
-    rtems_bdbuf_lock_cache ();
+    rtems_bdbuf_lock_shard (shard);
   }
 
   /*
@@ -1026,24 +870,27 @@ rtems_bdbuf_add_to_modified_list_after_access (rtems_bdbuf_buffer *bd)
     bd->hold_timer = bdbuf_config.swap_block_hold;
 
   rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_MODIFIED);
-  rtems_chain_append_unprotected (&bdbuf_cache.modified, &bd->link);
+  rtems_chain_append_unprotected (&shard->modified, &bd->link);
 
   if (bd->waiters)
-    rtems_bdbuf_wake (&bdbuf_cache.access_waiters);
-  else if (rtems_bdbuf_has_buffer_waiters ())
+    rtems_bdbuf_wake (&shard->access_waiters);
+  else if (rtems_bdbuf_has_buffer_waiters (shard))
     rtems_bdbuf_wake_swapper ();
+
+  rtems_bdbuf_write_behind (shard);
 }
 
 static void
-rtems_bdbuf_add_to_lru_list_after_access (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_add_to_lru_list_after_access (rtems_bdbuf_shard  *shard,
+                                          rtems_bdbuf_buffer *bd)
 {
   rtems_bdbuf_group_release (bd);
-  rtems_bdbuf_make_cached_and_add_to_lru_list (bd);
+  rtems_bdbuf_make_cached_and_add_to_lru_list (shard, bd);
 
   if (bd->waiters)
-    rtems_bdbuf_wake (&bdbuf_cache.access_waiters);
+    rtems_bdbuf_wake (&shard->access_waiters);
   else
-    rtems_bdbuf_wake (&bdbuf_cache.buffer_waiters);
+    rtems_bdbuf_wake (&shard->buffer_waiters);
 }
 
 /**
@@ -1071,28 +918,32 @@ rtems_bdbuf_bds_per_group (size_t size)
 }
 
 static void
-rtems_bdbuf_discard_buffer_after_access (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_discard_buffer_after_access (rtems_bdbuf_shard  *shard,
+                                         rtems_bdbuf_buffer *bd)
 {
   rtems_bdbuf_group_release (bd);
-  rtems_bdbuf_discard_buffer (bd);
+  rtems_bdbuf_discard_buffer (shard, bd);
 
   if (bd->waiters)
-    rtems_bdbuf_wake (&bdbuf_cache.access_waiters);
+    rtems_bdbuf_wake (&shard->access_waiters);
   else
-    rtems_bdbuf_wake (&bdbuf_cache.buffer_waiters);
+    rtems_bdbuf_wake (&shard->buffer_waiters);
 }
 
 /**
  * Reallocate a group. The BDs currently allocated in the group are removed
- * from the ALV tree and any lists then the new BD's are prepended to the ready
- * list of the cache.
+ * from the index and any lists then the new BD's are prepended to the ready
+ * list of the shard.
  *
+ * @param shard The shard of the group.
  * @param group The group to reallocate.
  * @param new_bds_per_group The new count of BDs per group.
  * @return A buffer of this group.
  */
 static rtems_bdbuf_buffer *
-rtems_bdbuf_group_realloc (rtems_bdbuf_group* group, size_t new_bds_per_group)
+rtems_bdbuf_group_realloc (rtems_bdbuf_shard* shard,
+                           rtems_bdbuf_group* group,
+                           size_t             new_bds_per_group)
 {
   rtems_bdbuf_buffer* bd;
   size_t              b;
@@ -1108,7 +959,7 @@ rtems_bdbuf_group_realloc (rtems_bdbuf_group* group, size_t new_bds_per_group)
   for (b = 0, bd = group->bdbuf;
        b < group->bds_per_group;
        b++, bd += bufs_per_bd)
-    rtems_bdbuf_remove_from_tree_and_lru_list (bd);
+    rtems_bdbuf_remove_from_index_and_lru_list (shard, bd);
 
   group->bds_per_group = new_bds_per_group;
   bufs_per_bd = bdbuf_cache.max_bds_per_group / new_bds_per_group;
@@ -1116,38 +967,38 @@ rtems_bdbuf_group_realloc (rtems_bdbuf_group* group, size_t new_bds_per_group)
   for (b = 1, bd = group->bdbuf + bufs_per_bd;
        b < group->bds_per_group;
        b++, bd += bufs_per_bd)
-    rtems_bdbuf_make_free_and_add_to_lru_list (bd);
+    rtems_bdbuf_make_free_and_add_to_lru_list (shard, bd);
 
   if (b > 1)
-    rtems_bdbuf_wake (&bdbuf_cache.buffer_waiters);
+    rtems_bdbuf_wake (&shard->buffer_waiters);
 
   return group->bdbuf;
 }
 
 static void
-rtems_bdbuf_setup_empty_buffer (rtems_bdbuf_buffer *bd,
+rtems_bdbuf_setup_empty_buffer (rtems_bdbuf_shard  *shard,
+                                rtems_bdbuf_buffer *bd,
                                 rtems_disk_device  *dd,
                                 rtems_blkdev_bnum   block)
 {
   bd->dd        = dd ;
   bd->block     = block;
-  bd->avl.left  = NULL;
-  bd->avl.right = NULL;
   bd->waiters   = 0;
 
-  if (rtems_bdbuf_avl_insert (&bdbuf_cache.tree, bd) != 0)
+  if (rtems_bdbuf_index_insert (shard, bd) != 0)
     rtems_bdbuf_fatal (RTEMS_BDBUF_FATAL_RECYCLE);
 
   rtems_bdbuf_make_empty (bd);
 }
 
 static rtems_bdbuf_buffer *
-rtems_bdbuf_get_buffer_from_lru_list (rtems_disk_device *dd,
+rtems_bdbuf_get_buffer_from_lru_list (rtems_bdbuf_shard *shard,
+                                      rtems_disk_device *dd,
                                       rtems_blkdev_bnum  block)
 {
-  rtems_chain_node *node = rtems_chain_first (&bdbuf_cache.lru);
+  rtems_chain_node *node = rtems_chain_first (&shard->lru);
 
-  while (!rtems_chain_is_tail (&bdbuf_cache.lru, node))
+  while (!rtems_chain_is_tail (&shard->lru, node))
   {
     rtems_bdbuf_buffer *bd = (rtems_bdbuf_buffer *) node;
     rtems_bdbuf_buffer *empty_bd = NULL;
@@ -1165,17 +1016,18 @@ rtems_bdbuf_get_buffer_from_lru_list (rtems_disk_device *dd,
     {
       if (bd->group->bds_per_group == dd->bds_per_group)
       {
-        rtems_bdbuf_remove_from_tree_and_lru_list (bd);
+        rtems_bdbuf_remove_from_index_and_lru_list (shard, bd);
 
         empty_bd = bd;
       }
       else if (bd->group->users == 0)
-        empty_bd = rtems_bdbuf_group_realloc (bd->group, dd->bds_per_group);
+        empty_bd = rtems_bdbuf_group_realloc (shard, bd->group,
+                                              dd->bds_per_group);
     }
 
     if (empty_bd != NULL)
     {
-      rtems_bdbuf_setup_empty_buffer (empty_bd, dd, block);
+      rtems_bdbuf_setup_empty_buffer (shard, empty_bd, dd, block);
 
       return empty_bd;
     }
@@ -1210,40 +1062,137 @@ rtems_bdbuf_create_task(
   return sc;
 }
 
-static rtems_bdbuf_swapout_transfer*
-rtems_bdbuf_swapout_transfer_alloc (void)
+static size_t
+rtems_bdbuf_read_request_size (uint32_t transfer_count)
+{
+  return sizeof (rtems_blkdev_request)
+    + sizeof (rtems_blkdev_sg_buffer) * transfer_count;
+}
+
+static uint32_t
+rtems_bdbuf_max_write_requests (void)
 {
   /*
-   * @note chrisj The rtems_blkdev_request and the array at the end is a hack.
-   * I am disappointment at finding code like this in RTEMS. The request should
-   * have been a rtems_chain_control. Simple, fast and less storage as the node
-   * is already part of the buffer structure.
+   * Configuration tables of applications which predate the multiple write
+   * requests have no write request count.
    */
+  return bdbuf_config.max_write_requests > 0 ?
+    bdbuf_config.max_write_requests : 1;
+}
+
+/**
+ * @note chrisj The rtems_blkdev_request and the array at the end is a hack.
+ * I am disappointment at finding code like this in RTEMS. The request should
+ * have been a rtems_chain_control. Simple, fast and less storage as the node
+ * is already part of the buffer structure.
+ */
+static size_t
+rtems_bdbuf_write_requests_size (void)
+{
+  return rtems_bdbuf_max_write_requests ()
+    * rtems_bdbuf_read_request_size (bdbuf_config.max_write_blocks);
+}
+
+static rtems_blkdev_request *
+rtems_bdbuf_swapout_write_request (rtems_bdbuf_swapout_transfer *transfer,
+                                   uint32_t                      index)
+{
+  size_t size = rtems_bdbuf_read_request_size (bdbuf_config.max_write_blocks);
+
+  return (rtems_blkdev_request *) (transfer->write_reqs + index * size);
+}
+
+static rtems_bdbuf_swapout_transfer*
+rtems_bdbuf_swapout_transfer_alloc (void)
+{
   size_t transfer_size = sizeof (rtems_bdbuf_swapout_transfer)
-    + (bdbuf_config.max_write_blocks * sizeof (rtems_blkdev_sg_buffer));
+    + rtems_bdbuf_write_requests_size ();
   return calloc (1, transfer_size);
 }
 
 static void
-rtems_bdbuf_transfer_done (rtems_blkdev_request* req, rtems_status_code status);
+rtems_bdbuf_write_done (rtems_blkdev_request* req, rtems_status_code status);
 
+/**
+ * Initialize the transfer. The write requests follow the structure containing
+ * the transfer in memory.
+ */
 static void
 rtems_bdbuf_swapout_transfer_init (rtems_bdbuf_swapout_transfer* transfer,
-                                   rtems_id id)
+                                   void*                         write_reqs,
+                                   rtems_id                      id)
 {
+  uint32_t r;
+
   rtems_chain_initialize_empty (&transfer->bds);
   transfer->dd = BDBUF_INVALID_DEV;
   transfer->syncing = false;
-  transfer->write_req.req = RTEMS_BLKDEV_REQ_WRITE;
-  transfer->write_req.done = rtems_bdbuf_transfer_done;
-  transfer->write_req.io_task = id;
+  transfer->write_reqs = write_reqs;
+
+  for (r = 0; r < rtems_bdbuf_max_write_requests (); ++r)
+  {
+    rtems_blkdev_request *req = rtems_bdbuf_swapout_write_request (transfer, r);
+
+    req->req = RTEMS_BLKDEV_REQ_WRITE;
+    req->done = rtems_bdbuf_write_done;
+    req->done_arg = transfer;
+    req->io_task = id;
+  }
+}
+
+static uint32_t
+rtems_bdbuf_max_read_ahead_requests (void)
+{
+  return bdbuf_config.max_read_ahead_requests > 0 ?
+    bdbuf_config.max_read_ahead_requests : 1;
+}
+
+static void
+rtems_bdbuf_read_ahead_done (rtems_blkdev_request* req,
+                             rtems_status_code     status);
+
+/**
+ * Create the read-ahead requests and put them on the free chain. The requests
+ * follow the table of read-ahead requests in memory.
+ */
+static rtems_status_code
+rtems_bdbuf_read_ahead_requests_create (void)
+{
+  uint32_t count = rtems_bdbuf_max_read_ahead_requests ();
+  size_t   req_size =
+    rtems_bdbuf_read_request_size (bdbuf_config.max_read_ahead_blocks);
+  char    *req_memory;
+  uint32_t r;
+
+  rtems_chain_initialize_empty (&bdbuf_cache.read_ahead_free);
+  rtems_chain_initialize_empty (&bdbuf_cache.read_ahead_done);
+
+  bdbuf_cache.read_ahead_reqs =
+    calloc (count, sizeof (rtems_bdbuf_read_ahead_request) + req_size);
+  if (!bdbuf_cache.read_ahead_reqs)
+    return RTEMS_NO_MEMORY;
+
+  req_memory = (char *) (bdbuf_cache.read_ahead_reqs + count);
+
+  for (r = 0; r < count; ++r)
+  {
+    rtems_bdbuf_read_ahead_request *ra_req = &bdbuf_cache.read_ahead_reqs [r];
+
+    ra_req->req = (rtems_blkdev_request *) (req_memory + r * req_size);
+    ra_req->req->done = rtems_bdbuf_read_ahead_done;
+    ra_req->req->done_arg = ra_req;
+    rtems_chain_append_unprotected (&bdbuf_cache.read_ahead_free,
+                                    &ra_req->link);
+  }
+
+  return RTEMS_SUCCESSFUL;
 }
 
 static size_t
 rtems_bdbuf_swapout_worker_size (void)
 {
   return sizeof (rtems_bdbuf_swapout_worker)
-    + (bdbuf_config.max_write_blocks * sizeof (rtems_blkdev_sg_buffer));
+    + rtems_bdbuf_write_requests_size ();
 }
 
 static rtems_task
@@ -1275,7 +1224,8 @@ rtems_bdbuf_swapout_workers_create (void)
                                   &worker->id);
     if (sc == RTEMS_SUCCESSFUL)
     {
-      rtems_bdbuf_swapout_transfer_init (&worker->transfer, worker->id);
+      rtems_bdbuf_swapout_transfer_init (&worker->transfer, worker + 1,
+                                         worker->id);
 
       rtems_chain_append_unprotected (&bdbuf_cache.swapout_free_workers, &worker->link);
       worker->enabled = true;
@@ -1289,11 +1239,63 @@ rtems_bdbuf_swapout_workers_create (void)
   return sc;
 }
 
+static void
+rtems_bdbuf_shard_init (rtems_bdbuf_shard *shard)
+{
+  rtems_mutex_init (&shard->lock, "bdbuf shard lock");
+  rtems_condition_variable_init (&shard->access_waiters.cond_var,
+                                 "bdbuf access");
+  rtems_condition_variable_init (&shard->transfer_waiters.cond_var,
+                                 "bdbuf transfer");
+  rtems_condition_variable_init (&shard->buffer_waiters.cond_var,
+                                 "bdbuf buffer");
+  rtems_condition_variable_init (&shard->write_behind_waiters.cond_var,
+                                 "bdbuf write-behind");
+
+  shard->sync_device = BDBUF_INVALID_DEV;
+
+  rtems_chain_initialize_empty (&shard->lru);
+  rtems_chain_initialize_empty (&shard->modified);
+  rtems_chain_initialize_empty (&shard->sync);
+  rtems_chain_initialize_empty (&shard->read_ahead_chain);
+}
+
+static bool
+rtems_bdbuf_shard_index_alloc (rtems_bdbuf_shard *shard)
+{
+  size_t slot_count = 1;
+
+  /*
+   * Keep the index at most half full to get short probe sequences.
+   */
+  while (slot_count < 2 * shard->bd_count)
+    slot_count <<= 1;
+
+  shard->index = calloc (sizeof (rtems_bdbuf_index_slot), slot_count);
+  shard->index_mask = slot_count - 1;
+
+  return shard->index != NULL;
+}
+
+static void
+rtems_bdbuf_shard_destroy (rtems_bdbuf_shard *shard)
+{
+  free (shard->index);
+  rtems_mutex_destroy (&shard->lock);
+  rtems_condition_variable_destroy (&shard->access_waiters.cond_var);
+  rtems_condition_variable_destroy (&shard->transfer_waiters.cond_var);
+  rtems_condition_variable_destroy (&shard->buffer_waiters.cond_var);
+  rtems_condition_variable_destroy (&shard->write_behind_waiters.cond_var);
+}
+
 static size_t
-rtems_bdbuf_read_request_size (uint32_t transfer_count)
+rtems_bdbuf_configured_shard_count (void)
 {
-  return sizeof (rtems_blkdev_request)
-    + sizeof (rtems_blkdev_sg_buffer) * transfer_count;
+  /*
+   * Configuration tables of applications which predate the sharding have no
+   * shard count.
+   */
+  return bdbuf_config.shard_count > 0 ? bdbuf_config.shard_count : 1;
 }
 
 static rtems_status_code
@@ -1303,6 +1305,7 @@ rtems_bdbuf_do_init (void)
   rtems_bdbuf_buffer* bd;
   uint8_t*            buffer;
   size_t              b;
+  size_t              s;
   rtems_status_code   sc;
 
   if (rtems_bdbuf_tracer)
@@ -1318,26 +1321,10 @@ rtems_bdbuf_do_init (void)
   if ((bdbuf_config.buffer_max % bdbuf_config.buffer_min) != 0)
     return RTEMS_INVALID_NUMBER;
 
-  if (rtems_bdbuf_read_request_size (bdbuf_config.max_read_ahead_blocks)
-      > RTEMS_MINIMUM_STACK_SIZE / 8U)
-    return RTEMS_INVALID_NUMBER;
-
-  bdbuf_cache.sync_device = BDBUF_INVALID_DEV;
-
   rtems_chain_initialize_empty (&bdbuf_cache.swapout_free_workers);
-  rtems_chain_initialize_empty (&bdbuf_cache.lru);
-  rtems_chain_initialize_empty (&bdbuf_cache.modified);
-  rtems_chain_initialize_empty (&bdbuf_cache.sync);
-  rtems_chain_initialize_empty (&bdbuf_cache.read_ahead_chain);
 
   rtems_mutex_set_name (&bdbuf_cache.lock, "bdbuf lock");
   rtems_mutex_set_name (&bdbuf_cache.sync_lock, "bdbuf sync lock");
-  rtems_condition_variable_set_name (&bdbuf_cache.access_waiters.cond_var,
-                                     "bdbuf access");
-  rtems_condition_variable_set_name (&bdbuf_cache.transfer_waiters.cond_var,
-                                     "bdbuf transfer");
-  rtems_condition_variable_set_name (&bdbuf_cache.buffer_waiters.cond_var,
-                                     "bdbuf buffer");
 
   rtems_bdbuf_lock_cache ();
 
@@ -1351,6 +1338,23 @@ rtems_bdbuf_do_init (void)
   bdbuf_cache.group_count =
     bdbuf_cache.buffer_min_count / bdbuf_cache.max_bds_per_group;
 
+  /*
+   * Each shard needs at least one group.
+   */
+  bdbuf_cache.shard_count = rtems_bdbuf_configured_shard_count ();
+  if (bdbuf_cache.shard_count > bdbuf_cache.group_count)
+    bdbuf_cache.shard_count = bdbuf_cache.group_count;
+  if (bdbuf_cache.shard_count == 0)
+    bdbuf_cache.shard_count = 1;
+
+  bdbuf_cache.shards = calloc (sizeof (rtems_bdbuf_shard),
+                               bdbuf_cache.shard_count);
+  if (!bdbuf_cache.shards)
+    goto error;
+
+  for (s = 0; s < bdbuf_cache.shard_count; s++)
+    rtems_bdbuf_shard_init (&bdbuf_cache.shards[s]);
+
   /*
    * Allocate the memory for the buffer descriptors.
    */
@@ -1379,18 +1383,28 @@ rtems_bdbuf_do_init (void)
 
   /*
    * The cache is empty after opening so we need to add all the buffers to it
-   * and initialise the groups.
+   * and initialise the groups. The groups are split evenly over the shards.
    */
   for (b = 0, group = bdbuf_cache.groups,
          bd = bdbuf_cache.bds, buffer = bdbuf_cache.buffers;
        b < bdbuf_cache.buffer_min_count;
        b++, bd++, buffer += bdbuf_config.buffer_min)
   {
+    size_t g = (size_t) (group - bdbuf_cache.groups);
+    rtems_bdbuf_shard* shard;
+
+    if (g < bdbuf_cache.group_count)
+      shard = &bdbuf_cache.shards[(g * bdbuf_cache.shard_count)
+                                  / bdbuf_cache.group_count];
+    else
+      shard = &bdbuf_cache.shards[bdbuf_cache.shard_count - 1];
+
     bd->dd    = BDBUF_INVALID_DEV;
     bd->group  = group;
     bd->buffer = buffer;
 
-    rtems_chain_append_unprotected (&bdbuf_cache.lru, &bd->link);
+    rtems_chain_append_unprotected (&shard->lru, &bd->link);
+    ++shard->bd_count;
 
     if ((b % bdbuf_cache.max_bds_per_group) ==
         (bdbuf_cache.max_bds_per_group - 1))
@@ -1409,6 +1423,12 @@ rtems_bdbuf_do_init (void)
     group->bdbuf = bd;
   }
 
+  for (s = 0; s < bdbuf_cache.shard_count; s++)
+  {
+    if (!rtems_bdbuf_shard_index_alloc (&bdbuf_cache.shards[s]))
+      goto error;
+  }
+
   /*
    * Create and start swapout task.
    */
@@ -1426,7 +1446,9 @@ rtems_bdbuf_do_init (void)
   if (sc != RTEMS_SUCCESSFUL)
     goto error;
 
-  rtems_bdbuf_swapout_transfer_init (bdbuf_cache.swapout_transfer, bdbuf_cache.swapout);
+  rtems_bdbuf_swapout_transfer_init (bdbuf_cache.swapout_transfer,
+                                     bdbuf_cache.swapout_transfer + 1,
+                                     bdbuf_cache.swapout);
 
   sc = rtems_task_start (bdbuf_cache.swapout,
                          rtems_bdbuf_swapout_task,
@@ -1443,6 +1465,10 @@ rtems_bdbuf_do_init (void)
 
   if (bdbuf_config.max_read_ahead_blocks > 0)
   {
+    sc = rtems_bdbuf_read_ahead_requests_create ();
+    if (sc != RTEMS_SUCCESSFUL)
+      goto error;
+
     bdbuf_cache.read_ahead_enabled = true;
     sc = rtems_bdbuf_create_task (rtems_build_name('B', 'R', 'D', 'A'),
                                   bdbuf_config.read_ahead_priority,
@@ -1488,11 +1514,19 @@ error:
     }
   }
 
+  if (bdbuf_cache.shards)
+  {
+    for (s = 0; s < bdbuf_cache.shard_count; s++)
+      rtems_bdbuf_shard_destroy (&bdbuf_cache.shards[s]);
+  }
+
   free (bdbuf_cache.buffers);
   free (bdbuf_cache.groups);
   free (bdbuf_cache.bds);
+  free (bdbuf_cache.shards);
   free (bdbuf_cache.swapout_transfer);
   free (bdbuf_cache.swapout_workers);
+  free (bdbuf_cache.read_ahead_reqs);
 
   rtems_bdbuf_unlock_cache ();
 
@@ -1543,7 +1577,7 @@ rtems_bdbuf_wait_for_transient_event (void)
 }
 
 static void
-rtems_bdbuf_wait_for_access (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_wait_for_access (rtems_bdbuf_shard *shard, rtems_bdbuf_buffer *bd)
 {
   while (true)
   {
@@ -1561,12 +1595,12 @@ rtems_bdbuf_wait_for_access (rtems_bdbuf_buffer *bd)
       case RTEMS_BDBUF_STATE_ACCESS_EMPTY:
       case RTEMS_BDBUF_STATE_ACCESS_MODIFIED:
       case RTEMS_BDBUF_STATE_ACCESS_PURGED:
-        rtems_bdbuf_wait (bd, &bdbuf_cache.access_waiters);
+        rtems_bdbuf_wait (shard, bd, &shard->access_waiters);
         break;
       case RTEMS_BDBUF_STATE_SYNC:
       case RTEMS_BDBUF_STATE_TRANSFER:
       case RTEMS_BDBUF_STATE_TRANSFER_PURGED:
-        rtems_bdbuf_wait (bd, &bdbuf_cache.transfer_waiters);
+        rtems_bdbuf_wait (shard, bd, &shard->transfer_waiters);
         break;
       default:
         rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_STATE_7);
@@ -1575,11 +1609,12 @@ rtems_bdbuf_wait_for_access (rtems_bdbuf_buffer *bd)
 }
 
 static void
-rtems_bdbuf_request_sync_for_modified_buffer (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_request_sync_for_modified_buffer (rtems_bdbuf_shard  *shard,
+                                              rtems_bdbuf_buffer *bd)
 {
   rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_SYNC);
   rtems_chain_extract_unprotected (&bd->link);
-  rtems_chain_append_unprotected (&bdbuf_cache.sync, &bd->link);
+  rtems_chain_append_unprotected (&shard->sync, &bd->link);
   rtems_bdbuf_wake_swapper ();
 }
 
@@ -1590,7 +1625,7 @@ rtems_bdbuf_request_sync_for_modified_buffer (rtems_bdbuf_buffer *bd)
  * @retval @c false Buffer is invalid and has to searched again.
  */
 static bool
-rtems_bdbuf_wait_for_recycle (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_wait_for_recycle (rtems_bdbuf_shard *shard, rtems_bdbuf_buffer *bd)
 {
   while (true)
   {
@@ -1599,7 +1634,7 @@ rtems_bdbuf_wait_for_recycle (rtems_bdbuf_buffer *bd)
       case RTEMS_BDBUF_STATE_FREE:
         return true;
       case RTEMS_BDBUF_STATE_MODIFIED:
-        rtems_bdbuf_request_sync_for_modified_buffer (bd);
+        rtems_bdbuf_request_sync_for_modified_buffer (shard, bd);
         break;
       case RTEMS_BDBUF_STATE_CACHED:
       case RTEMS_BDBUF_STATE_EMPTY:
@@ -1613,19 +1648,19 @@ rtems_bdbuf_wait_for_recycle (rtems_bdbuf_buffer *bd)
            * pong with another recycle waiter.  The state of the buffer is
            * arbitrary afterwards.
            */
-          rtems_bdbuf_anonymous_wait (&bdbuf_cache.buffer_waiters);
+          rtems_bdbuf_anonymous_wait (shard, &shard->buffer_waiters);
           return false;
         }
       case RTEMS_BDBUF_STATE_ACCESS_CACHED:
       case RTEMS_BDBUF_STATE_ACCESS_EMPTY:
       case RTEMS_BDBUF_STATE_ACCESS_MODIFIED:
       case RTEMS_BDBUF_STATE_ACCESS_PURGED:
-        rtems_bdbuf_wait (bd, &bdbuf_cache.access_waiters);
+        rtems_bdbuf_wait (shard, bd, &shard->access_waiters);
         break;
       case RTEMS_BDBUF_STATE_SYNC:
       case RTEMS_BDBUF_STATE_TRANSFER:
       case RTEMS_BDBUF_STATE_TRANSFER_PURGED:
-        rtems_bdbuf_wait (bd, &bdbuf_cache.transfer_waiters);
+        rtems_bdbuf_wait (shard, bd, &shard->transfer_waiters);
         break;
       default:
         rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_STATE_8);
@@ -1634,7 +1669,7 @@ rtems_bdbuf_wait_for_recycle (rtems_bdbuf_buffer *bd)
 }
 
 static void
-rtems_bdbuf_wait_for_sync_done (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_wait_for_sync_done (rtems_bdbuf_shard *shard, rtems_bdbuf_buffer *bd)
 {
   while (true)
   {
@@ -1651,7 +1686,7 @@ rtems_bdbuf_wait_for_sync_done (rtems_bdbuf_buffer *bd)
       case RTEMS_BDBUF_STATE_SYNC:
       case RTEMS_BDBUF_STATE_TRANSFER:
       case RTEMS_BDBUF_STATE_TRANSFER_PURGED:
-        rtems_bdbuf_wait (bd, &bdbuf_cache.transfer_waiters);
+        rtems_bdbuf_wait (shard, bd, &shard->transfer_waiters);
         break;
       default:
         rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_STATE_9);
@@ -1660,26 +1695,26 @@ rtems_bdbuf_wait_for_sync_done (rtems_bdbuf_buffer *bd)
 }
 
 static void
-rtems_bdbuf_wait_for_buffer (void)
+rtems_bdbuf_wait_for_buffer (rtems_bdbuf_shard *shard)
 {
-  if (!rtems_chain_is_empty (&bdbuf_cache.modified))
+  if (!rtems_chain_is_empty (&shard->modified))
     rtems_bdbuf_wake_swapper ();
 
-  rtems_bdbuf_anonymous_wait (&bdbuf_cache.buffer_waiters);
+  rtems_bdbuf_anonymous_wait (shard, &shard->buffer_waiters);
 }
 
 static void
-rtems_bdbuf_sync_after_access (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_sync_after_access (rtems_bdbuf_shard *shard, rtems_bdbuf_buffer *bd)
 {
   rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_SYNC);
 
-  rtems_chain_append_unprotected (&bdbuf_cache.sync, &bd->link);
+  rtems_chain_append_unprotected (&shard->sync, &bd->link);
 
   if (bd->waiters)
-    rtems_bdbuf_wake (&bdbuf_cache.access_waiters);
+    rtems_bdbuf_wake (&shard->access_waiters);
 
   rtems_bdbuf_wake_swapper ();
-  rtems_bdbuf_wait_for_sync_done (bd);
+  rtems_bdbuf_wait_for_sync_done (shard, bd);
 
   /*
    * We may have created a cached or empty buffer which may be recycled.
@@ -1690,24 +1725,25 @@ rtems_bdbuf_sync_after_access (rtems_bdbuf_buffer *bd)
   {
     if (bd->state == RTEMS_BDBUF_STATE_EMPTY)
     {
-      rtems_bdbuf_remove_from_tree (bd);
-      rtems_bdbuf_make_free_and_add_to_lru_list (bd);
+      rtems_bdbuf_remove_from_index (shard, bd);
+      rtems_bdbuf_make_free_and_add_to_lru_list (shard, bd);
     }
-    rtems_bdbuf_wake (&bdbuf_cache.buffer_waiters);
+    rtems_bdbuf_wake (&shard->buffer_waiters);
   }
 }
 
 static rtems_bdbuf_buffer *
-rtems_bdbuf_get_buffer_for_read_ahead (rtems_disk_device *dd,
+rtems_bdbuf_get_buffer_for_read_ahead (rtems_bdbuf_shard *shard,
+                                       rtems_disk_device *dd,
                                        rtems_blkdev_bnum  block)
 {
   rtems_bdbuf_buffer *bd = NULL;
 
-  bd = rtems_bdbuf_avl_search (&bdbuf_cache.tree, dd, block);
+  bd = rtems_bdbuf_index_search (shard, dd, block);
 
   if (bd == NULL)
   {
-    bd = rtems_bdbuf_get_buffer_from_lru_list (dd, block);
+    bd = rtems_bdbuf_get_buffer_from_lru_list (shard, dd, block);
 
     if (bd != NULL)
       rtems_bdbuf_group_obtain (bd);
@@ -1723,39 +1759,40 @@ rtems_bdbuf_get_buffer_for_read_ahead (rtems_disk_device *dd,
 }
 
 static rtems_bdbuf_buffer *
-rtems_bdbuf_get_buffer_for_access (rtems_disk_device *dd,
+rtems_bdbuf_get_buffer_for_access (rtems_bdbuf_shard *shard,
+                                   rtems_disk_device *dd,
                                    rtems_blkdev_bnum  block)
 {
   rtems_bdbuf_buffer *bd = NULL;
 
   do
   {
-    bd = rtems_bdbuf_avl_search (&bdbuf_cache.tree, dd, block);
+    bd = rtems_bdbuf_index_search (shard, dd, block);
 
     if (bd != NULL)
     {
       if (bd->group->bds_per_group != dd->bds_per_group)
       {
-        if (rtems_bdbuf_wait_for_recycle (bd))
+        if (rtems_bdbuf_wait_for_recycle (shard, bd))
         {
-          rtems_bdbuf_remove_from_tree_and_lru_list (bd);
-          rtems_bdbuf_make_free_and_add_to_lru_list (bd);
-          rtems_bdbuf_wake (&bdbuf_cache.buffer_waiters);
+          rtems_bdbuf_remove_from_index_and_lru_list (shard, bd);
+          rtems_bdbuf_make_free_and_add_to_lru_list (shard, bd);
+          rtems_bdbuf_wake (&shard->buffer_waiters);
         }
         bd = NULL;
       }
     }
     else
     {
-      bd = rtems_bdbuf_get_buffer_from_lru_list (dd, block);
+      bd = rtems_bdbuf_get_buffer_from_lru_list (shard, dd, block);
 
       if (bd == NULL)
-        rtems_bdbuf_wait_for_buffer ();
+        rtems_bdbuf_wait_for_buffer (shard);
     }
   }
   while (bd == NULL);
 
-  rtems_bdbuf_wait_for_access (bd);
+  rtems_bdbuf_wait_for_access (shard, bd);
   rtems_bdbuf_group_obtain (bd);
 
   return bd;
@@ -1791,10 +1828,11 @@ rtems_bdbuf_get (rtems_disk_device   *dd,
                  rtems_bdbuf_buffer **bd_ptr)
 {
   rtems_status_code   sc = RTEMS_SUCCESSFUL;
+  rtems_bdbuf_shard  *shard = rtems_bdbuf_get_shard (dd);
   rtems_bdbuf_buffer *bd = NULL;
   rtems_blkdev_bnum   media_block;
 
-  rtems_bdbuf_lock_cache ();
+  rtems_bdbuf_lock_shard (shard);
 
   sc = rtems_bdbuf_get_media_block (dd, block, &media_block);
   if (sc == RTEMS_SUCCESSFUL)
@@ -1806,11 +1844,12 @@ rtems_bdbuf_get (rtems_disk_device   *dd,
       printf ("bdbuf:get: %" PRIu32 " (%" PRIu32 ") (dev = %08x)\n",
               media_block, block, (unsigned) dd->dev);
 
-    bd = rtems_bdbuf_get_buffer_for_access (dd, media_block);
+    bd = rtems_bdbuf_get_buffer_for_access (shard, dd, media_block);
 
     switch (bd->state)
     {
       case RTEMS_BDBUF_STATE_CACHED:
+        rtems_bdbuf_read_ahead_miss (bd);
         rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_ACCESS_CACHED);
         break;
       case RTEMS_BDBUF_STATE_EMPTY:
@@ -1838,7 +1877,7 @@ rtems_bdbuf_get (rtems_disk_device   *dd,
     }
   }
 
-  rtems_bdbuf_unlock_cache ();
+  rtems_bdbuf_unlock_shard (shard);
 
   *bd_ptr = bd;
 
@@ -1862,42 +1901,71 @@ rtems_bdbuf_transfer_done (rtems_blkdev_request* req, rtems_status_code status)
   rtems_event_transient_send (req->io_task);
 }
 
-static rtems_status_code
-rtems_bdbuf_execute_transfer_request (rtems_disk_device    *dd,
-                                      rtems_blkdev_request *req,
-                                      bool                  cache_locked)
-{
-  rtems_status_code sc = RTEMS_SUCCESSFUL;
-  uint32_t transfer_index = 0;
-  bool wake_transfer_waiters = false;
-  bool wake_buffer_waiters = false;
+RTEMS_INTERRUPT_LOCK_DEFINE (static, bdbuf_write_lock, "bdbuf write")
 
-  if (cache_locked)
-    rtems_bdbuf_unlock_cache ();
+/**
+ * Call back handler called by the low level driver when a swapout write
+ * request has completed. A swapout task may have several write requests in
+ * flight. The task is only woken up once the last of them has completed. This
+ * function may be invoked from interrupt handler.
+ *
+ * @param req The write request of a swapout transfer.
+ * @param status I/O completion status
+ */
+static void
+rtems_bdbuf_write_done (rtems_blkdev_request* req, rtems_status_code status)
+{
+  rtems_bdbuf_swapout_transfer *transfer = req->done_arg;
+  rtems_interrupt_lock_context  lock_context;
+  uint32_t                      in_flight;
 
-  /* The return value will be ignored for transfer requests */
-  dd->ioctl (dd->phys_dev, RTEMS_BLKIO_REQUEST, req);
+  req->status = status;
 
-  /* Wait for transfer request completion */
-  rtems_bdbuf_wait_for_transient_event ();
-  sc = req->status;
+  rtems_interrupt_lock_acquire (&bdbuf_write_lock, &lock_context);
+  in_flight = --transfer->in_flight;
+  rtems_interrupt_lock_release (&bdbuf_write_lock, &lock_context);
 
-  rtems_bdbuf_lock_cache ();
+  if (in_flight == 0)
+    rtems_event_transient_send (req->io_task);
+}
 
-  /* Statistics */
+static void
+rtems_bdbuf_transfer_stats (rtems_disk_device          *dd,
+                            const rtems_blkdev_request *req)
+{
   if (req->req == RTEMS_BLKDEV_REQ_READ)
   {
     dd->stats.read_blocks += req->bufnum;
-    if (sc != RTEMS_SUCCESSFUL)
+    if (req->status != RTEMS_SUCCESSFUL)
       ++dd->stats.read_errors;
   }
   else
   {
     dd->stats.write_blocks += req->bufnum;
     ++dd->stats.write_transfers;
-    if (sc != RTEMS_SUCCESSFUL)
+    if (req->status != RTEMS_SUCCESSFUL)
       ++dd->stats.write_errors;
   }
+}
+
+/**
+ * Account for a completed transfer request and move its buffers to their
+ * final state. The shard must be locked.
+ *
+ * @return The status of the request mapped to RTEMS_SUCCESSFUL,
+ *         RTEMS_UNSATISFIED or RTEMS_IO_ERROR.
+ */
+static rtems_status_code
+rtems_bdbuf_transfer_finish (rtems_bdbuf_shard    *shard,
+                             rtems_disk_device    *dd,
+                             rtems_blkdev_request *req)
+{
+  rtems_status_code sc = req->status;
+  uint32_t transfer_index = 0;
+  bool wake_transfer_waiters = false;
+  bool wake_buffer_waiters = false;
+
+  rtems_bdbuf_transfer_stats (dd, req);
 
   for (transfer_index = 0; transfer_index < req->bufnum; ++transfer_index)
   {
@@ -1912,22 +1980,19 @@ rtems_bdbuf_execute_transfer_request (rtems_disk_device    *dd,
     rtems_bdbuf_group_release (bd);
 
     if (sc == RTEMS_SUCCESSFUL && bd->state == RTEMS_BDBUF_STATE_TRANSFER)
-      rtems_bdbuf_make_cached_and_add_to_lru_list (bd);
+      rtems_bdbuf_make_cached_and_add_to_lru_list (shard, bd);
     else
-      rtems_bdbuf_discard_buffer (bd);
+      rtems_bdbuf_discard_buffer (shard, bd);
 
     if (rtems_bdbuf_tracer)
       rtems_bdbuf_show_users ("transfer", bd);
   }
 
   if (wake_transfer_waiters)
-    rtems_bdbuf_wake (&bdbuf_cache.transfer_waiters);
+    rtems_bdbuf_wake (&shard->transfer_waiters);
 
   if (wake_buffer_waiters)
-    rtems_bdbuf_wake (&bdbuf_cache.buffer_waiters);
-
-  if (!cache_locked)
-    rtems_bdbuf_unlock_cache ();
+    rtems_bdbuf_wake (&shard->buffer_waiters);
 
   if (sc == RTEMS_SUCCESSFUL || sc == RTEMS_UNSATISFIED)
     return sc;
@@ -1936,29 +2001,56 @@ rtems_bdbuf_execute_transfer_request (rtems_disk_device    *dd,
 }
 
 static rtems_status_code
-rtems_bdbuf_execute_read_request (rtems_disk_device  *dd,
-                                  rtems_bdbuf_buffer *bd,
-                                  uint32_t            transfer_count)
+rtems_bdbuf_execute_transfer_request (rtems_disk_device    *dd,
+                                      rtems_blkdev_request *req,
+                                      bool                  shard_locked)
+{
+  rtems_status_code sc = RTEMS_SUCCESSFUL;
+  rtems_bdbuf_shard *shard = rtems_bdbuf_get_shard (dd);
+
+  if (shard_locked)
+    rtems_bdbuf_unlock_shard (shard);
+
+  /* The return value will be ignored for transfer requests */
+  dd->ioctl (dd->phys_dev, RTEMS_BLKIO_REQUEST, req);
+
+  /* Wait for transfer request completion */
+  rtems_bdbuf_wait_for_transient_event ();
+
+  rtems_bdbuf_lock_shard (shard);
+
+  sc = rtems_bdbuf_transfer_finish (shard, dd, req);
+
+  if (!shard_locked)
+    rtems_bdbuf_unlock_shard (shard);
+
+  return sc;
+}
+
+/**
+ * Fill a read request with the buffer and up to transfer count minus one
+ * following buffers which are not in the cache. The buffers are set to the
+ * transfer state. The shard must be locked.
+ */
+static void
+rtems_bdbuf_prepare_read_request (rtems_bdbuf_shard              *shard,
+                                  rtems_disk_device              *dd,
+                                  rtems_bdbuf_buffer             *bd,
+                                  uint32_t                        transfer_count,
+                                  rtems_blkdev_read_ahead_stream *stream,
+                                  rtems_blkdev_request           *req)
 {
-  rtems_blkdev_request *req = NULL;
   rtems_blkdev_bnum media_block = bd->block;
   uint32_t media_blocks_per_block = dd->media_blocks_per_block;
   uint32_t block_size = dd->block_size;
   uint32_t transfer_index = 1;
 
-  /*
-   * TODO: This type of request structure is wrong and should be removed.
-   */
-#define bdbuf_alloc(size) __builtin_alloca (size)
-
-  req = bdbuf_alloc (rtems_bdbuf_read_request_size (transfer_count));
-
   req->req = RTEMS_BLKDEV_REQ_READ;
-  req->done = rtems_bdbuf_transfer_done;
-  req->io_task = rtems_task_self ();
+  req->status = RTEMS_RESOURCE_IN_USE;
   req->bufnum = 0;
 
   rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_TRANSFER);
+  bd->read_ahead_stream = stream;
 
   req->bufs [0].user   = bd;
   req->bufs [0].block  = media_block;
@@ -1972,12 +2064,13 @@ rtems_bdbuf_execute_read_request (rtems_disk_device  *dd,
   {
     media_block += media_blocks_per_block;
 
-    bd = rtems_bdbuf_get_buffer_for_read_ahead (dd, media_block);
+    bd = rtems_bdbuf_get_buffer_for_read_ahead (shard, dd, media_block);
 
     if (bd == NULL)
       break;
 
     rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_TRANSFER);
+    bd->read_ahead_stream = stream;
 
     req->bufs [transfer_index].user   = bd;
     req->bufs [transfer_index].block  = media_block;
@@ -1991,43 +2084,134 @@ rtems_bdbuf_execute_read_request (rtems_disk_device  *dd,
   }
 
   req->bufnum = transfer_index;
+}
+
+static rtems_status_code
+rtems_bdbuf_execute_read_request (rtems_disk_device              *dd,
+                                  rtems_bdbuf_buffer             *bd,
+                                  uint32_t                        transfer_count,
+                                  rtems_blkdev_read_ahead_stream *stream)
+{
+  rtems_blkdev_request *req = NULL;
+  rtems_bdbuf_shard *shard = rtems_bdbuf_get_shard (dd);
+
+  /*
+   * TODO: This type of request structure is wrong and should be removed.
+   */
+#define bdbuf_alloc(size) __builtin_alloca (size)
+
+  req = bdbuf_alloc (rtems_bdbuf_read_request_size (transfer_count));
+
+  req->done = rtems_bdbuf_transfer_done;
+  req->io_task = rtems_task_self ();
+
+  rtems_bdbuf_prepare_read_request (shard, dd, bd, transfer_count, stream, req);
 
   return rtems_bdbuf_execute_transfer_request (dd, req, true);
 }
 
 static bool
-rtems_bdbuf_is_read_ahead_active (const rtems_disk_device *dd)
+rtems_bdbuf_is_read_ahead_active (const rtems_blkdev_read_ahead_stream *stream)
 {
-  return !rtems_chain_is_node_off_chain (&dd->read_ahead.node);
+  return !rtems_chain_is_node_off_chain (&stream->node);
 }
 
 static void
-rtems_bdbuf_read_ahead_cancel (rtems_disk_device *dd)
+rtems_bdbuf_read_ahead_cancel (rtems_blkdev_read_ahead_stream *stream)
 {
-  if (rtems_bdbuf_is_read_ahead_active (dd))
+  if (rtems_bdbuf_is_read_ahead_active (stream))
   {
-    rtems_chain_extract_unprotected (&dd->read_ahead.node);
-    rtems_chain_set_off_chain (&dd->read_ahead.node);
+    rtems_chain_extract_unprotected (&stream->node);
+    rtems_chain_set_off_chain (&stream->node);
   }
 }
 
 static void
 rtems_bdbuf_read_ahead_reset (rtems_disk_device *dd)
 {
-  rtems_bdbuf_read_ahead_cancel (dd);
-  dd->read_ahead.trigger = RTEMS_DISK_READ_AHEAD_NO_TRIGGER;
+  size_t s;
+
+  for (s = 0; s < RTEMS_DISK_READ_AHEAD_STREAM_COUNT; s++)
+  {
+    rtems_blkdev_read_ahead_stream *stream = &dd->read_ahead.streams [s];
+
+    rtems_bdbuf_read_ahead_cancel (stream);
+    stream->trigger = RTEMS_DISK_READ_AHEAD_NO_TRIGGER;
+  }
+}
+
+static rtems_blkdev_read_ahead_stream *
+rtems_bdbuf_find_read_ahead_stream (rtems_disk_device *dd,
+                                    rtems_blkdev_bnum  block)
+{
+  size_t s;
+
+  for (s = 0; s < RTEMS_DISK_READ_AHEAD_STREAM_COUNT; s++)
+  {
+    rtems_blkdev_read_ahead_stream *stream = &dd->read_ahead.streams [s];
+
+    if (stream->trigger == block)
+      return stream;
+  }
+
+  return NULL;
+}
+
+/**
+ * Returns the stream to start a new one. This is the first idle stream or if
+ * all streams are busy the least recently used one.
+ */
+static rtems_blkdev_read_ahead_stream *
+rtems_bdbuf_replace_read_ahead_stream (rtems_disk_device *dd)
+{
+  rtems_blkdev_read_ahead_stream *victim = NULL;
+  uint32_t victim_age = 0;
+  size_t s;
+
+  for (s = 0; s < RTEMS_DISK_READ_AHEAD_STREAM_COUNT; s++)
+  {
+    rtems_blkdev_read_ahead_stream *stream = &dd->read_ahead.streams [s];
+    uint32_t age = dd->read_ahead.use_count - stream->last_use;
+
+    if (stream->trigger == RTEMS_DISK_READ_AHEAD_NO_TRIGGER
+        && !rtems_bdbuf_is_read_ahead_active (stream))
+      return stream;
+
+    if (victim == NULL || age > victim_age)
+    {
+      victim = stream;
+      victim_age = age;
+    }
+  }
+
+  return victim;
+}
+
+static void
+rtems_bdbuf_use_read_ahead_stream (rtems_disk_device              *dd,
+                                   rtems_blkdev_read_ahead_stream *stream)
+{
+  stream->last_use = ++dd->read_ahead.use_count;
 }
 
 static void
-rtems_bdbuf_check_read_ahead_trigger (rtems_disk_device *dd,
+rtems_bdbuf_check_read_ahead_trigger (rtems_bdbuf_shard *shard,
+                                      rtems_disk_device *dd,
                                       rtems_blkdev_bnum  block)
 {
-  if (bdbuf_cache.read_ahead_task != 0
-      && dd->read_ahead.trigger == block
-      && !rtems_bdbuf_is_read_ahead_active (dd))
+  rtems_blkdev_read_ahead_stream *stream;
+
+  if (bdbuf_cache.read_ahead_task == 0)
+    return;
+
+  stream = rtems_bdbuf_find_read_ahead_stream (dd, block);
+
+  if (stream != NULL && !rtems_bdbuf_is_read_ahead_active (stream))
   {
     rtems_status_code sc;
-    rtems_chain_control *chain = &bdbuf_cache.read_ahead_chain;
+    rtems_chain_control *chain = &shard->read_ahead_chain;
+
+    rtems_bdbuf_use_read_ahead_stream (dd, stream);
 
     if (rtems_chain_is_empty (chain))
     {
@@ -2037,7 +2221,7 @@ rtems_bdbuf_check_read_ahead_trigger (rtems_disk_device *dd,
         rtems_bdbuf_fatal (RTEMS_BDBUF_FATAL_RA_WAKE_UP);
     }
 
-    rtems_chain_append_unprotected (chain, &dd->read_ahead.node);
+    rtems_chain_append_unprotected (chain, &stream->node);
   }
 }
 
@@ -2045,12 +2229,57 @@ static void
 rtems_bdbuf_set_read_ahead_trigger (rtems_disk_device *dd,
                                     rtems_blkdev_bnum  block)
 {
-  if (dd->read_ahead.trigger != block)
+  /*
+   * A read miss which continues a stream keeps it.  Otherwise it may be the
+   * start of a new sequential reader, so a stream is started which triggers
+   * if the next block is read as well.
+   */
+  if (rtems_bdbuf_find_read_ahead_stream (dd, block) == NULL)
+  {
+    rtems_blkdev_read_ahead_stream *stream =
+      rtems_bdbuf_replace_read_ahead_stream (dd);
+
+    rtems_bdbuf_read_ahead_cancel (stream);
+    rtems_bdbuf_use_read_ahead_stream (dd, stream);
+    stream->trigger = block + 1;
+    stream->next = block + 2;
+    stream->window = bdbuf_config.max_read_ahead_blocks;
+    stream->hits = 0;
+    stream->misses = 0;
+  }
+}
+
+/**
+ * Adapts the read-ahead window of the stream to the hit rate of the previous
+ * read-ahead requests and returns it. The window is halved if more blocks
+ * were dropped unused than read, and it is doubled up to the configured
+ * maximum if all were read.
+ */
+static uint32_t
+rtems_bdbuf_read_ahead_window (rtems_blkdev_read_ahead_stream *stream)
+{
+  uint32_t window = stream->window;
+
+  if (stream->misses > stream->hits)
+  {
+    window /= 2;
+  }
+  else if (stream->misses == 0 && stream->hits > 0)
   {
-    rtems_bdbuf_read_ahead_cancel (dd);
-    dd->read_ahead.trigger = block + 1;
-    dd->read_ahead.next = block + 2;
+    window *= 2;
   }
+
+  if (window > bdbuf_config.max_read_ahead_blocks)
+    window = bdbuf_config.max_read_ahead_blocks;
+
+  if (window == 0)
+    window = 1;
+
+  stream->window = window;
+  stream->hits = 0;
+  stream->misses = 0;
+
+  return window;
 }
 
 rtems_status_code
@@ -2059,10 +2288,11 @@ rtems_bdbuf_read (rtems_disk_device   *dd,
                   rtems_bdbuf_buffer **bd_ptr)
 {
   rtems_status_code     sc = RTEMS_SUCCESSFUL;
+  rtems_bdbuf_shard    *shard = rtems_bdbuf_get_shard (dd);
   rtems_bdbuf_buffer   *bd = NULL;
   rtems_blkdev_bnum     media_block;
 
-  rtems_bdbuf_lock_cache ();
+  rtems_bdbuf_lock_shard (shard);
 
   sc = rtems_bdbuf_get_media_block (dd, block, &media_block);
   if (sc == RTEMS_SUCCESSFUL)
@@ -2071,11 +2301,12 @@ rtems_bdbuf_read (rtems_disk_device   *dd,
       printf ("bdbuf:read: %" PRIu32 " (%" PRIu32 ") (dev = %08x)\n",
               media_block, block, (unsigned) dd->dev);
 
-    bd = rtems_bdbuf_get_buffer_for_access (dd, media_block);
+    bd = rtems_bdbuf_get_buffer_for_access (shard, dd, media_block);
     switch (bd->state)
     {
       case RTEMS_BDBUF_STATE_CACHED:
         ++dd->stats.read_hits;
+        rtems_bdbuf_read_ahead_hit (bd);
         rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_ACCESS_CACHED);
         break;
       case RTEMS_BDBUF_STATE_MODIFIED:
@@ -2085,7 +2316,7 @@ rtems_bdbuf_read (rtems_disk_device   *dd,
       case RTEMS_BDBUF_STATE_EMPTY:
         ++dd->stats.read_misses;
         rtems_bdbuf_set_read_ahead_trigger (dd, block);
-        sc = rtems_bdbuf_execute_read_request (dd, bd, 1);
+        sc = rtems_bdbuf_execute_read_request (dd, bd, 1, NULL);
         if (sc == RTEMS_SUCCESSFUL)
         {
           rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_ACCESS_CACHED);
@@ -2102,18 +2333,225 @@ rtems_bdbuf_read (rtems_disk_device   *dd,
         break;
     }
 
-    rtems_bdbuf_check_read_ahead_trigger (dd, block);
+    rtems_bdbuf_check_read_ahead_trigger (shard, dd, block);
+  }
+
+  rtems_bdbuf_unlock_shard (shard);
+
+  *bd_ptr = bd;
+
+  return sc;
+}
+
+/**
+ * Make sure a direct read of a block range sees the latest data. Modified
+ * buffers of the range are written to disk first and pending writes are
+ * waited for. The shard must be locked.
+ */
+static void
+rtems_bdbuf_direct_read_sync (rtems_bdbuf_shard *shard,
+                              rtems_disk_device *dd,
+                              rtems_blkdev_bnum  media_block,
+                              uint32_t           block_count)
+{
+  uint32_t i;
+
+  for (i = 0; i < block_count; ++i)
+  {
+    rtems_bdbuf_buffer *bd = rtems_bdbuf_index_search (shard, dd, media_block);
+
+    if (bd != NULL)
+    {
+      if (bd->state == RTEMS_BDBUF_STATE_MODIFIED)
+        rtems_bdbuf_request_sync_for_modified_buffer (shard, bd);
+
+      rtems_bdbuf_wait_for_sync_done (shard, bd);
+
+      if (bd->waiters == 0 && bd->state == RTEMS_BDBUF_STATE_EMPTY)
+      {
+        rtems_bdbuf_remove_from_index (shard, bd);
+        rtems_bdbuf_make_free_and_add_to_lru_list (shard, bd);
+        rtems_bdbuf_wake (&shard->buffer_waiters);
+      }
+    }
+
+    media_block += dd->media_blocks_per_block;
+  }
+}
+
+/**
+ * Remove the buffers of a block range from the cache since a direct write
+ * replaces their data on disk. Before the write the modified buffers are
+ * discarded, after the write they were modified in the meantime and stay in
+ * the cache. The shard must be locked.
+ */
+static void
+rtems_bdbuf_direct_write_invalidate (rtems_bdbuf_shard *shard,
+                                     rtems_disk_device *dd,
+                                     rtems_blkdev_bnum  media_block,
+                                     uint32_t           block_count,
+                                     bool               discard_modified)
+{
+  uint32_t i;
+
+  for (i = 0; i < block_count; ++i)
+  {
+    rtems_bdbuf_buffer *bd;
+
+    while ((bd = rtems_bdbuf_index_search (shard, dd, media_block)) != NULL)
+    {
+      if (bd->state == RTEMS_BDBUF_STATE_MODIFIED)
+      {
+        if (!discard_modified)
+          break;
+
+        rtems_chain_extract_unprotected (&bd->link);
+        rtems_bdbuf_group_release (bd);
+        rtems_bdbuf_discard_buffer (shard, bd);
+        rtems_bdbuf_wake (&shard->buffer_waiters);
+      }
+      else if (rtems_bdbuf_wait_for_recycle (shard, bd))
+      {
+        if (bd->state == RTEMS_BDBUF_STATE_EMPTY)
+          rtems_bdbuf_remove_from_index (shard, bd);
+        else
+          rtems_bdbuf_remove_from_index_and_lru_list (shard, bd);
+
+        rtems_bdbuf_make_free_and_add_to_lru_list (shard, bd);
+        rtems_bdbuf_wake (&shard->buffer_waiters);
+      }
+    }
+
+    media_block += dd->media_blocks_per_block;
+  }
+}
+
+static uint32_t
+rtems_bdbuf_max_direct_blocks (void)
+{
+  return bdbuf_config.max_write_blocks > 0 ? bdbuf_config.max_write_blocks : 1;
+}
+
+/**
+ * Transfer a block range between the disk and the user buffer without copying
+ * it through the cache. The range is split into requests of at most the
+ * maximum write blocks with a scatter/gather entry per block pointing into
+ * the user buffer.
+ */
+static rtems_status_code
+rtems_bdbuf_direct_transfer (rtems_disk_device       *dd,
+                             rtems_blkdev_bnum        block,
+                             uint32_t                 block_count,
+                             char                    *data,
+                             rtems_blkdev_request_op  op)
+{
+  rtems_status_code     sc = RTEMS_SUCCESSFUL;
+  rtems_bdbuf_shard    *shard = rtems_bdbuf_get_shard (dd);
+  rtems_blkdev_request *req = NULL;
+  uint32_t              transfer_count = rtems_bdbuf_max_direct_blocks ();
+  uint32_t              block_size = dd->block_size;
+
+  if (!rtems_bdbuf_is_direct_buffer (data))
+    return RTEMS_INVALID_ADDRESS;
+
+  if (block_count > dd->block_count || block > dd->block_count - block_count)
+    return RTEMS_INVALID_ID;
+
+  req = bdbuf_alloc (rtems_bdbuf_read_request_size (transfer_count));
+
+  req->req = op;
+  req->done = rtems_bdbuf_transfer_done;
+  req->io_task = rtems_task_self ();
+
+  rtems_bdbuf_lock_shard (shard);
+
+  while (sc == RTEMS_SUCCESSFUL && block_count > 0)
+  {
+    rtems_blkdev_bnum media_block = rtems_bdbuf_media_block (dd, block)
+      + dd->start;
+    uint32_t count = block_count < transfer_count ? block_count : transfer_count;
+    uint32_t transfer_index;
+
+    if (rtems_bdbuf_tracer)
+      printf ("bdbuf:direct-%s: %" PRIu32 " (%" PRIu32 ") count=%" PRIu32
+              " (dev = %08x)\n", op == RTEMS_BLKDEV_REQ_READ ? "read" : "write",
+              media_block, block, count, (unsigned) dd->dev);
+
+    if (op == RTEMS_BLKDEV_REQ_READ)
+      rtems_bdbuf_direct_read_sync (shard, dd, media_block, count);
+    else
+      rtems_bdbuf_direct_write_invalidate (shard, dd, media_block, count, true);
+
+    req->status = RTEMS_RESOURCE_IN_USE;
+    req->bufnum = count;
+
+    for (transfer_index = 0; transfer_index < count; ++transfer_index)
+    {
+      req->bufs [transfer_index].user   = NULL;
+      req->bufs [transfer_index].block  = media_block
+        + transfer_index * dd->media_blocks_per_block;
+      req->bufs [transfer_index].length = block_size;
+      req->bufs [transfer_index].buffer = data + transfer_index * block_size;
+    }
+
+    rtems_bdbuf_unlock_shard (shard);
+
+    /* The return value will be ignored for transfer requests */
+    dd->ioctl (dd->phys_dev, RTEMS_BLKIO_REQUEST, req);
+
+    /* Wait for transfer request completion */
+    rtems_bdbuf_wait_for_transient_event ();
+
+    rtems_bdbuf_lock_shard (shard);
+
+    rtems_bdbuf_transfer_stats (dd, req);
+    sc = req->status;
+
+    /*
+     * Blocks read into the cache while the write was in progress may hold the
+     * old data.
+     */
+    if (op == RTEMS_BLKDEV_REQ_WRITE)
+      rtems_bdbuf_direct_write_invalidate (shard, dd, media_block, count, false);
+
+    block += count;
+    block_count -= count;
+    data += count * block_size;
   }
 
-  rtems_bdbuf_unlock_cache ();
+  rtems_bdbuf_unlock_shard (shard);
 
-  *bd_ptr = bd;
+  if (sc == RTEMS_SUCCESSFUL || sc == RTEMS_UNSATISFIED)
+    return sc;
+  else
+    return RTEMS_IO_ERROR;
+}
 
-  return sc;
+rtems_status_code
+rtems_bdbuf_read_direct (rtems_disk_device *dd,
+                         rtems_blkdev_bnum  block,
+                         uint32_t           block_count,
+                         void              *buffer)
+{
+  return rtems_bdbuf_direct_transfer (dd, block, block_count, buffer,
+                                      RTEMS_BLKDEV_REQ_READ);
+}
+
+rtems_status_code
+rtems_bdbuf_write_direct (rtems_disk_device *dd,
+                          rtems_blkdev_bnum  block,
+                          uint32_t           block_count,
+                          const void        *buffer)
+{
+  return rtems_bdbuf_direct_transfer (dd, block, block_count,
+                                      RTEMS_DECONST (void *, buffer),
+                                      RTEMS_BLKDEV_REQ_WRITE);
 }
 
 static rtems_status_code
-rtems_bdbuf_check_bd_and_lock_cache (rtems_bdbuf_buffer *bd, const char *kind)
+rtems_bdbuf_check_bd_and_lock_shard (rtems_bdbuf_buffer  *bd,
+                                     const char          *kind,
+                                     rtems_bdbuf_shard  **shard_ptr)
 {
   if (bd == NULL)
     return RTEMS_INVALID_ADDRESS;
@@ -2122,7 +2560,12 @@ rtems_bdbuf_check_bd_and_lock_cache (rtems_bdbuf_buffer *bd, const char *kind)
     printf ("bdbuf:%s: %" PRIu32 "\n", kind, bd->block);
     rtems_bdbuf_show_users (kind, bd);
   }
-  rtems_bdbuf_lock_cache();
+
+  /*
+   * The buffer is in an access state, so the device cannot change.
+   */
+  *shard_ptr = rtems_bdbuf_get_shard (bd->dd);
+  rtems_bdbuf_lock_shard (*shard_ptr);
 
   return RTEMS_SUCCESSFUL;
 }
@@ -2130,23 +2573,24 @@ rtems_bdbuf_check_bd_and_lock_cache (rtems_bdbuf_buffer *bd, const char *kind)
 rtems_status_code
 rtems_bdbuf_release (rtems_bdbuf_buffer *bd)
 {
-  rtems_status_code sc = RTEMS_SUCCESSFUL;
+  rtems_status_code  sc = RTEMS_SUCCESSFUL;
+  rtems_bdbuf_shard *shard;
 
-  sc = rtems_bdbuf_check_bd_and_lock_cache (bd, "release");
+  sc = rtems_bdbuf_check_bd_and_lock_shard (bd, "release", &shard);
   if (sc != RTEMS_SUCCESSFUL)
     return sc;
 
   switch (bd->state)
   {
     case RTEMS_BDBUF_STATE_ACCESS_CACHED:
-      rtems_bdbuf_add_to_lru_list_after_access (bd);
+      rtems_bdbuf_add_to_lru_list_after_access (shard, bd);
       break;
     case RTEMS_BDBUF_STATE_ACCESS_EMPTY:
     case RTEMS_BDBUF_STATE_ACCESS_PURGED:
-      rtems_bdbuf_discard_buffer_after_access (bd);
+      rtems_bdbuf_discard_buffer_after_access (shard, bd);
       break;
     case RTEMS_BDBUF_STATE_ACCESS_MODIFIED:
-      rtems_bdbuf_add_to_modified_list_after_access (bd);
+      rtems_bdbuf_add_to_modified_list_after_access (shard, bd);
       break;
     default:
       rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_STATE_0);
@@ -2156,7 +2600,7 @@ rtems_bdbuf_release (rtems_bdbuf_buffer *bd)
   if (rtems_bdbuf_tracer)
     rtems_bdbuf_show_usage ();
 
-  rtems_bdbuf_unlock_cache ();
+  rtems_bdbuf_unlock_shard (shard);
 
   return RTEMS_SUCCESSFUL;
 }
@@ -2164,9 +2608,10 @@ rtems_bdbuf_release (rtems_bdbuf_buffer *bd)
 rtems_status_code
 rtems_bdbuf_release_modified (rtems_bdbuf_buffer *bd)
 {
-  rtems_status_code sc = RTEMS_SUCCESSFUL;
+  rtems_status_code  sc = RTEMS_SUCCESSFUL;
+  rtems_bdbuf_shard *shard;
 
-  sc = rtems_bdbuf_check_bd_and_lock_cache (bd, "release modified");
+  sc = rtems_bdbuf_check_bd_and_lock_shard (bd, "release modified", &shard);
   if (sc != RTEMS_SUCCESSFUL)
     return sc;
 
@@ -2175,10 +2620,10 @@ rtems_bdbuf_release_modified (rtems_bdbuf_buffer *bd)
     case RTEMS_BDBUF_STATE_ACCESS_CACHED:
     case RTEMS_BDBUF_STATE_ACCESS_EMPTY:
     case RTEMS_BDBUF_STATE_ACCESS_MODIFIED:
-      rtems_bdbuf_add_to_modified_list_after_access (bd);
+      rtems_bdbuf_add_to_modified_list_after_access (shard, bd);
       break;
     case RTEMS_BDBUF_STATE_ACCESS_PURGED:
-      rtems_bdbuf_discard_buffer_after_access (bd);
+      rtems_bdbuf_discard_buffer_after_access (shard, bd);
       break;
     default:
       rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_STATE_6);
@@ -2188,7 +2633,7 @@ rtems_bdbuf_release_modified (rtems_bdbuf_buffer *bd)
   if (rtems_bdbuf_tracer)
     rtems_bdbuf_show_usage ();
 
-  rtems_bdbuf_unlock_cache ();
+  rtems_bdbuf_unlock_shard (shard);
 
   return RTEMS_SUCCESSFUL;
 }
@@ -2196,9 +2641,10 @@ rtems_bdbuf_release_modified (rtems_bdbuf_buffer *bd)
 rtems_status_code
 rtems_bdbuf_sync (rtems_bdbuf_buffer *bd)
 {
-  rtems_status_code sc = RTEMS_SUCCESSFUL;
+  rtems_status_code  sc = RTEMS_SUCCESSFUL;
+  rtems_bdbuf_shard *shard;
 
-  sc = rtems_bdbuf_check_bd_and_lock_cache (bd, "sync");
+  sc = rtems_bdbuf_check_bd_and_lock_shard (bd, "sync", &shard);
   if (sc != RTEMS_SUCCESSFUL)
     return sc;
 
@@ -2207,10 +2653,10 @@ rtems_bdbuf_sync (rtems_bdbuf_buffer *bd)
     case RTEMS_BDBUF_STATE_ACCESS_CACHED:
     case RTEMS_BDBUF_STATE_ACCESS_EMPTY:
     case RTEMS_BDBUF_STATE_ACCESS_MODIFIED:
-      rtems_bdbuf_sync_after_access (bd);
+      rtems_bdbuf_sync_after_access (shard, bd);
       break;
     case RTEMS_BDBUF_STATE_ACCESS_PURGED:
-      rtems_bdbuf_discard_buffer_after_access (bd);
+      rtems_bdbuf_discard_buffer_after_access (shard, bd);
       break;
     default:
       rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_STATE_5);
@@ -2220,7 +2666,7 @@ rtems_bdbuf_sync (rtems_bdbuf_buffer *bd)
   if (rtems_bdbuf_tracer)
     rtems_bdbuf_show_usage ();
 
-  rtems_bdbuf_unlock_cache ();
+  rtems_bdbuf_unlock_shard (shard);
 
   return RTEMS_SUCCESSFUL;
 }
@@ -2228,49 +2674,194 @@ rtems_bdbuf_sync (rtems_bdbuf_buffer *bd)
 rtems_status_code
 rtems_bdbuf_syncdev (rtems_disk_device *dd)
 {
+  rtems_bdbuf_shard *shard = rtems_bdbuf_get_shard (dd);
+
   if (rtems_bdbuf_tracer)
     printf ("bdbuf:syncdev: %08x\n", (unsigned) dd->dev);
 
   /*
-   * Take the sync lock before locking the cache. Once we have the sync lock we
-   * can lock the cache. If another thread has the sync lock it will cause this
-   * thread to block until it owns the sync lock then it can own the cache. The
-   * sync lock can only be obtained with the cache unlocked.
+   * Take the sync lock before locking the shard. Once we have the sync lock we
+   * can lock the shard. If another thread has the sync lock it will cause this
+   * thread to block until it owns the sync lock then it can own the shard. The
+   * sync lock can only be obtained with the shard unlocked.
    */
   rtems_bdbuf_lock_sync ();
-  rtems_bdbuf_lock_cache ();
+  rtems_bdbuf_lock_shard (shard);
 
   /*
-   * Set the cache to have a sync active for a specific device and let the swap
+   * Set the shard to have a sync active for a specific device and let the swap
    * out task know the id of the requester to wake when done.
    *
    * The swap out task will negate the sync active flag when no more buffers
    * for the device are held on the "modified for sync" queues.
    */
-  bdbuf_cache.sync_active    = true;
-  bdbuf_cache.sync_requester = rtems_task_self ();
-  bdbuf_cache.sync_device    = dd;
+  shard->sync_active    = true;
+  shard->sync_requester = rtems_task_self ();
+  shard->sync_device    = dd;
 
   rtems_bdbuf_wake_swapper ();
-  rtems_bdbuf_unlock_cache ();
+  rtems_bdbuf_unlock_shard (shard);
   rtems_bdbuf_wait_for_transient_event ();
   rtems_bdbuf_unlock_sync ();
 
   return RTEMS_SUCCESSFUL;
 }
 
+/**
+ * Merge two NULL terminated lists of buffers linked through the next pointer
+ * of their chain nodes. The lists must be sorted in block order.
+ */
+static rtems_chain_node *
+rtems_bdbuf_swapout_merge (rtems_chain_node *a, rtems_chain_node *b)
+{
+  rtems_chain_node  head;
+  rtems_chain_node *tail = &head;
+
+  while (a != NULL && b != NULL)
+  {
+    if (((rtems_bdbuf_buffer *) a)->block <= ((rtems_bdbuf_buffer *) b)->block)
+    {
+      tail->next = a;
+      a = a->next;
+    }
+    else
+    {
+      tail->next = b;
+      b = b->next;
+    }
+
+    tail = tail->next;
+  }
+
+  tail->next = a != NULL ? a : b;
+
+  return head.next;
+}
+
+/**
+ * Sort the buffers of the transfer chain in block order. This means
+ * multi-block transfers for drivers that require consecutive blocks perform
+ * better with sorted blocks and for real disks it may help lower head
+ * movement. A bottom-up merge sort keeps this O(n log n) for large transfers.
+ * The shard is not locked.
+ *
+ * @param transfer The transfer transaction.
+ */
+static void
+rtems_bdbuf_swapout_sort (rtems_bdbuf_swapout_transfer* transfer)
+{
+  rtems_chain_control *chain = &transfer->bds;
+  rtems_chain_node    *runs [32];
+  rtems_chain_node    *node;
+  rtems_chain_node    *list = NULL;
+  size_t               r;
+
+  memset (runs, 0, sizeof (runs));
+
+  /*
+   * The runs [r] holds a sorted list of 2^r buffers or is empty. Merging a
+   * single buffer into it works like a binary counter increment.
+   */
+  while ((node = rtems_chain_get_unprotected (chain)) != NULL)
+  {
+    node->next = NULL;
+
+    for (r = 0; r < RTEMS_ARRAY_SIZE (runs) - 1 && runs [r] != NULL; ++r)
+    {
+      node = rtems_bdbuf_swapout_merge (runs [r], node);
+      runs [r] = NULL;
+    }
+
+    runs [r] = rtems_bdbuf_swapout_merge (runs [r], node);
+  }
+
+  for (r = 0; r < RTEMS_ARRAY_SIZE (runs); ++r)
+    list = rtems_bdbuf_swapout_merge (runs [r], list);
+
+  while (list != NULL)
+  {
+    node = list;
+    list = list->next;
+    rtems_chain_set_off_chain (node);
+    rtems_chain_append_unprotected (chain, node);
+  }
+}
+
+/**
+ * Fill a write request with buffers taken from the transfer chain. At most the
+ * configured maximum number of write blocks are taken. If the device only
+ * accepts consecutive buffers the request ends at the first gap. The shard is
+ * not locked.
+ *
+ * @param transfer The transfer transaction.
+ * @param req The write request to fill.
+ */
+static void
+rtems_bdbuf_swapout_fill_request (rtems_bdbuf_swapout_transfer* transfer,
+                                  rtems_blkdev_request*         req)
+{
+  rtems_chain_node  *node;
+  rtems_disk_device *dd = transfer->dd;
+  uint32_t           media_blocks_per_block = dd->media_blocks_per_block;
+  bool               need_continuous_blocks =
+    (dd->phys_dev->capabilities & RTEMS_BLKDEV_CAP_MULTISECTOR_CONT) != 0;
+
+  /*
+   * The last block number used when the driver only supports
+   * continuous blocks in a single request.
+   */
+  uint32_t last_block = 0;
+
+  req->status = RTEMS_RESOURCE_IN_USE;
+  req->bufnum = 0;
+
+  while (req->bufnum < bdbuf_config.max_write_blocks
+         && (node = rtems_chain_get_unprotected(&transfer->bds)) != NULL)
+  {
+    rtems_bdbuf_buffer*     bd = (rtems_bdbuf_buffer*) node;
+    rtems_blkdev_sg_buffer* buf;
+
+    if (rtems_bdbuf_tracer)
+      printf ("bdbuf:swapout write: bd:%" PRIu32 ", bufnum:%" PRIu32 " mode:%s\n",
+              bd->block, req->bufnum,
+              need_continuous_blocks ? "MULTI" : "SCAT");
+
+    /*
+     * If the device only accepts sequential buffers and this is not the
+     * first buffer (the first is always sequential, and the buffer is not
+     * sequential then put the buffer back on the transfer chain for the next
+     * request.
+     */
+    if (need_continuous_blocks && req->bufnum &&
+        bd->block != last_block + media_blocks_per_block)
+    {
+      rtems_chain_prepend_unprotected (&transfer->bds, &bd->link);
+      break;
+    }
+
+    buf = &req->bufs[req->bufnum];
+    req->bufnum++;
+    buf->user   = bd;
+    buf->block  = bd->block;
+    buf->length = dd->block_size;
+    buf->buffer = bd->buffer;
+    last_block  = bd->block;
+  }
+}
+
 /**
  * Swapout transfer to the driver. The driver will break this I/O into groups
  * of consecutive write requests is multiple consecutive buffers are required
- * by the driver. The cache is not locked.
+ * by the driver. Up to the configured maximum number of write requests are
+ * handed to the driver before the swapout task waits for their completion so
+ * that the device may work on several of them at once. The shard is not
+ * locked.
  *
  * @param transfer The transfer transaction.
  */
 static void
 rtems_bdbuf_swapout_write (rtems_bdbuf_swapout_transfer* transfer)
 {
-  rtems_chain_node *node;
-
   if (rtems_bdbuf_tracer)
     printf ("bdbuf:swapout transfer: %08x\n", (unsigned) transfer->dd->dev);
 
@@ -2279,80 +2870,63 @@ rtems_bdbuf_swapout_write (rtems_bdbuf_swapout_transfer* transfer)
    */
   if (!rtems_chain_is_empty (&transfer->bds))
   {
-    /*
-     * The last block number used when the driver only supports
-     * continuous blocks in a single request.
-     */
-    uint32_t last_block = 0;
-
     rtems_disk_device *dd = transfer->dd;
-    uint32_t media_blocks_per_block = dd->media_blocks_per_block;
-    bool need_continuous_blocks =
-      (dd->phys_dev->capabilities & RTEMS_BLKDEV_CAP_MULTISECTOR_CONT) != 0;
+    rtems_bdbuf_shard *shard = rtems_bdbuf_get_shard (dd);
+    uint32_t           max_write_requests = rtems_bdbuf_max_write_requests ();
 
-    /*
-     * Take as many buffers as configured and pass to the driver. Note, the
-     * API to the drivers has an array of buffers and if a chain was passed
-     * we could have just passed the list. If the driver API is updated it
-     * should be possible to make this change with little effect in this
-     * code. The array that is passed is broken in design and should be
-     * removed. Merging members of a struct into the first member is
-     * trouble waiting to happen.
-     */
-    transfer->write_req.status = RTEMS_RESOURCE_IN_USE;
-    transfer->write_req.bufnum = 0;
+    if (max_write_requests > dd->queue_depth)
+      max_write_requests = dd->queue_depth;
 
-    while ((node = rtems_chain_get_unprotected(&transfer->bds)) != NULL)
+    rtems_bdbuf_swapout_sort (transfer);
+
+    while (!rtems_chain_is_empty (&transfer->bds))
     {
-      rtems_bdbuf_buffer* bd = (rtems_bdbuf_buffer*) node;
-      bool                write = false;
+      uint32_t request_count = 0;
+      uint32_t r;
 
       /*
-       * If the device only accepts sequential buffers and this is not the
-       * first buffer (the first is always sequential, and the buffer is not
-       * sequential then put the buffer back on the transfer chain and write
-       * the committed buffers.
+       * Take as many buffers as configured and pass to the driver. Note, the
+       * API to the drivers has an array of buffers and if a chain was passed
+       * we could have just passed the list. If the driver API is updated it
+       * should be possible to make this change with little effect in this
+       * code. The array that is passed is broken in design and should be
+       * removed. Merging members of a struct into the first member is
+       * trouble waiting to happen.
        */
-
-      if (rtems_bdbuf_tracer)
-        printf ("bdbuf:swapout write: bd:%" PRIu32 ", bufnum:%" PRIu32 " mode:%s\n",
-                bd->block, transfer->write_req.bufnum,
-                need_continuous_blocks ? "MULTI" : "SCAT");
-
-      if (need_continuous_blocks && transfer->write_req.bufnum &&
-          bd->block != last_block + media_blocks_per_block)
+      while (request_count < max_write_requests
+             && !rtems_chain_is_empty (&transfer->bds))
       {
-        rtems_chain_prepend_unprotected (&transfer->bds, &bd->link);
-        write = true;
-      }
-      else
-      {
-        rtems_blkdev_sg_buffer* buf;
-        buf = &transfer->write_req.bufs[transfer->write_req.bufnum];
-        transfer->write_req.bufnum++;
-        buf->user   = bd;
-        buf->block  = bd->block;
-        buf->length = dd->block_size;
-        buf->buffer = bd->buffer;
-        last_block  = bd->block;
+        rtems_bdbuf_swapout_fill_request (
+          transfer,
+          rtems_bdbuf_swapout_write_request (transfer, request_count)
+        );
+        ++request_count;
       }
 
       /*
-       * Perform the transfer if there are no more buffers, or the transfer
-       * size has reached the configured max. value.
+       * The completion of a request may happen before the next one is
+       * submitted so account for all of them up front.
        */
+      transfer->in_flight = request_count;
 
-      if (rtems_chain_is_empty (&transfer->bds) ||
-          (transfer->write_req.bufnum >= bdbuf_config.max_write_blocks))
-        write = true;
+      /* The return value will be ignored for transfer requests */
+      for (r = 0; r < request_count; ++r)
+        dd->ioctl (dd->phys_dev, RTEMS_BLKIO_REQUEST,
+                   rtems_bdbuf_swapout_write_request (transfer, r));
 
-      if (write)
-      {
-        rtems_bdbuf_execute_transfer_request (dd, &transfer->write_req, false);
+      /* Wait for the completion of all requests */
+      rtems_bdbuf_wait_for_transient_event ();
 
-        transfer->write_req.status = RTEMS_RESOURCE_IN_USE;
-        transfer->write_req.bufnum = 0;
-      }
+      rtems_bdbuf_lock_shard (shard);
+
+      for (r = 0; r < request_count; ++r)
+        rtems_bdbuf_transfer_finish (
+          shard,
+          dd,
+          rtems_bdbuf_swapout_write_request (transfer, r)
+        );
+
+      rtems_bdbuf_unlock_shard (shard);
     }
 
     /*
@@ -2372,6 +2946,7 @@ rtems_bdbuf_swapout_write (rtems_bdbuf_swapout_transfer* transfer)
  * Process the modified list of buffers. There is a sync or modified list that
  * needs to be handled so we have a common function to do the work.
  *
+ * @param shard The shard of the modified chain.
  * @param dd_ptr Pointer to the device to handle. If BDBUF_INVALID_DEV no
  * device is selected so select the device of the first buffer to be written to
  * disk.
@@ -2383,7 +2958,8 @@ rtems_bdbuf_swapout_write (rtems_bdbuf_swapout_transfer* transfer)
  *                    amount.
  */
 static void
-rtems_bdbuf_swapout_modified_processing (rtems_disk_device  **dd_ptr,
+rtems_bdbuf_swapout_modified_processing (rtems_bdbuf_shard   *shard,
+                                         rtems_disk_device  **dd_ptr,
                                          rtems_chain_control* chain,
                                          rtems_chain_control* transfer,
                                          bool                 sync_active,
@@ -2394,6 +2970,7 @@ rtems_bdbuf_swapout_modified_processing (rtems_disk_device  **dd_ptr,
   {
     rtems_chain_node* node = rtems_chain_head (chain);
     bool              sync_all;
+    bool              write_behind = rtems_bdbuf_is_write_behind_due (shard);
 
     node = node->next;
 
@@ -2417,7 +2994,7 @@ rtems_bdbuf_swapout_modified_processing (rtems_disk_device  **dd_ptr,
        *       on TOD to be accurate. Does it matter ?
        */
       if (sync_all || (sync_active && (*dd_ptr == bd->dd))
-          || rtems_bdbuf_has_buffer_waiters ())
+          || write_behind || rtems_bdbuf_has_buffer_waiters (shard))
         bd->hold_timer = 0;
 
       if (bd->hold_timer)
@@ -2448,36 +3025,16 @@ rtems_bdbuf_swapout_modified_processing (rtems_disk_device  **dd_ptr,
       if (bd->dd == *dd_ptr)
       {
         rtems_chain_node* next_node = node->next;
-        rtems_chain_node* tnode = rtems_chain_tail (transfer);
 
         /*
-         * The blocks on the transfer list are sorted in block order. This
-         * means multi-block transfers for drivers that require consecutive
-         * blocks perform better with sorted blocks and for real disks it may
-         * help lower head movement.
+         * The transfer list is sorted in block order before it is written,
+         * see rtems_bdbuf_swapout_sort().
          */
 
         rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_TRANSFER);
 
         rtems_chain_extract_unprotected (node);
-
-        tnode = tnode->previous;
-
-        while (node && !rtems_chain_is_head (transfer, tnode))
-        {
-          rtems_bdbuf_buffer* tbd = (rtems_bdbuf_buffer*) tnode;
-
-          if (bd->block > tbd->block)
-          {
-            rtems_chain_insert_unprotected (tnode, node);
-            node = NULL;
-          }
-          else
-            tnode = tnode->previous;
-        }
-
-        if (node)
-          rtems_chain_prepend_unprotected (transfer, node);
+        rtems_chain_append_unprotected (transfer, node);
 
         node = next_node;
       }
@@ -2490,13 +3047,14 @@ rtems_bdbuf_swapout_modified_processing (rtems_disk_device  **dd_ptr,
 }
 
 /**
- * Process the cache's modified buffers. Check the sync list first then the
+ * Process the shard's modified buffers. Check the sync list first then the
  * modified list extracting the buffers suitable to be written to disk. We have
  * a device at a time. The task level loop will repeat this operation while
  * there are buffers to be written. If the transfer fails place the buffers
- * back on the modified list and try again later. The cache is unlocked while
+ * back on the modified list and try again later. The shard is unlocked while
  * the buffers are being written to disk.
  *
+ * @param shard The shard to process.
  * @param timer_delta It update_timers is true update the timers by this
  *                    amount.
  * @param update_timers If true update the timers.
@@ -2506,7 +3064,8 @@ rtems_bdbuf_swapout_modified_processing (rtems_disk_device  **dd_ptr,
  * @retval false No buffers where written to disk.
  */
 static bool
-rtems_bdbuf_swapout_processing (unsigned long                 timer_delta,
+rtems_bdbuf_swapout_processing (rtems_bdbuf_shard*            shard,
+                                unsigned long                 timer_delta,
                                 bool                          update_timers,
                                 rtems_bdbuf_swapout_transfer* transfer)
 {
@@ -2514,12 +3073,12 @@ rtems_bdbuf_swapout_processing (unsigned long                 timer_delta,
   bool                        transfered_buffers = false;
   bool                        sync_active;
 
-  rtems_bdbuf_lock_cache ();
+  rtems_bdbuf_lock_shard (shard);
 
   /*
-   * To set this to true you need the cache and the sync lock.
+   * To set this to true you need the shard and the sync lock.
    */
-  sync_active = bdbuf_cache.sync_active;
+  sync_active = shard->sync_active;
 
   /*
    * If a sync is active do not use a worker because the current code does not
@@ -2534,8 +3093,10 @@ rtems_bdbuf_swapout_processing (unsigned long                 timer_delta,
     worker = NULL;
   else
   {
+    rtems_bdbuf_lock_cache ();
     worker = (rtems_bdbuf_swapout_worker*)
       rtems_chain_get_unprotected (&bdbuf_cache.swapout_free_workers);
+    rtems_bdbuf_unlock_cache ();
     if (worker)
       transfer = &worker->transfer;
   }
@@ -2550,23 +3111,25 @@ rtems_bdbuf_swapout_processing (unsigned long                 timer_delta,
    * list. This means the dev is BDBUF_INVALID_DEV.
    */
   if (sync_active)
-    transfer->dd = bdbuf_cache.sync_device;
+    transfer->dd = shard->sync_device;
 
   /*
    * If we have any buffers in the sync queue move them to the modified
    * list. The first sync buffer will select the device we use.
    */
-  rtems_bdbuf_swapout_modified_processing (&transfer->dd,
-                                           &bdbuf_cache.sync,
+  rtems_bdbuf_swapout_modified_processing (shard,
+                                           &transfer->dd,
+                                           &shard->sync,
                                            &transfer->bds,
                                            true, false,
                                            timer_delta);
 
   /*
-   * Process the cache's modified list.
+   * Process the shard's modified list.
    */
-  rtems_bdbuf_swapout_modified_processing (&transfer->dd,
-                                           &bdbuf_cache.modified,
+  rtems_bdbuf_swapout_modified_processing (shard,
+                                           &transfer->dd,
+                                           &shard->modified,
                                            &transfer->bds,
                                            sync_active,
                                            update_timers,
@@ -2574,10 +3137,10 @@ rtems_bdbuf_swapout_processing (unsigned long                 timer_delta,
 
   /*
    * We have all the buffers that have been modified for this device so the
-   * cache can be unlocked because the state of each buffer has been set to
+   * shard can be unlocked because the state of each buffer has been set to
    * TRANSFER.
    */
-  rtems_bdbuf_unlock_cache ();
+  rtems_bdbuf_unlock_shard (shard);
 
   /*
    * If there are buffers to transfer to the media transfer them.
@@ -2598,15 +3161,22 @@ rtems_bdbuf_swapout_processing (unsigned long                 timer_delta,
 
     transfered_buffers = true;
   }
+  else if (worker)
+  {
+    rtems_bdbuf_lock_cache ();
+    rtems_chain_prepend_unprotected (&bdbuf_cache.swapout_free_workers,
+                                     &worker->link);
+    rtems_bdbuf_unlock_cache ();
+  }
 
   if (sync_active && !transfered_buffers)
   {
     rtems_id sync_requester;
-    rtems_bdbuf_lock_cache ();
-    sync_requester = bdbuf_cache.sync_requester;
-    bdbuf_cache.sync_active = false;
-    bdbuf_cache.sync_requester = 0;
-    rtems_bdbuf_unlock_cache ();
+    rtems_bdbuf_lock_shard (shard);
+    sync_requester = shard->sync_requester;
+    shard->sync_active = false;
+    shard->sync_requester = 0;
+    rtems_bdbuf_unlock_shard (shard);
     if (sync_requester)
       rtems_event_transient_send (sync_requester);
   }
@@ -2705,25 +3275,31 @@ rtems_bdbuf_swapout_task (rtems_task_argument arg)
 
     /*
      * If we write buffers to any disk perform a check again. We only write a
-     * single device at a time and the cache may have more than one device's
-     * buffers modified waiting to be written.
+     * single device of a shard at a time and each shard may have more than one
+     * device's buffers modified waiting to be written.
      */
     bool transfered_buffers;
 
     do
     {
+      size_t s;
+
       transfered_buffers = false;
 
       /*
-       * Extact all the buffers we find for a specific device. The device is
-       * the first one we find on a modified list. Process the sync queue of
-       * buffers first.
+       * Extact all the buffers we find for a specific device of each shard.
+       * The device is the first one we find on a modified list. Process the
+       * sync queue of buffers first.
        */
-      if (rtems_bdbuf_swapout_processing (timer_delta,
-                                          update_timers,
-                                          transfer))
+      for (s = 0; s < bdbuf_cache.shard_count; s++)
       {
-        transfered_buffers = true;
+        if (rtems_bdbuf_swapout_processing (&bdbuf_cache.shards[s],
+                                            timer_delta,
+                                            update_timers,
+                                            transfer))
+        {
+          transfered_buffers = true;
+        }
       }
 
       /*
@@ -2750,7 +3326,8 @@ rtems_bdbuf_swapout_task (rtems_task_argument arg)
 }
 
 static void
-rtems_bdbuf_purge_list (rtems_chain_control *purge_list)
+rtems_bdbuf_purge_list (rtems_bdbuf_shard   *shard,
+                        rtems_chain_control *purge_list)
 {
   bool wake_buffer_waiters = false;
   rtems_chain_node *node = NULL;
@@ -2762,26 +3339,29 @@ rtems_bdbuf_purge_list (rtems_chain_control *purge_list)
     if (bd->waiters == 0)
       wake_buffer_waiters = true;
 
-    rtems_bdbuf_discard_buffer (bd);
+    rtems_bdbuf_discard_buffer (shard, bd);
   }
 
   if (wake_buffer_waiters)
-    rtems_bdbuf_wake (&bdbuf_cache.buffer_waiters);
+    rtems_bdbuf_wake (&shard->buffer_waiters);
 }
 
 static void
-rtems_bdbuf_gather_for_purge (rtems_chain_control *purge_list,
+rtems_bdbuf_gather_for_purge (rtems_bdbuf_shard *shard,
+                              rtems_chain_control *purge_list,
                               const rtems_disk_device *dd)
 {
-  rtems_bdbuf_buffer *stack [RTEMS_BDBUF_AVL_MAX_HEIGHT];
-  rtems_bdbuf_buffer **prev = stack;
-  rtems_bdbuf_buffer *cur = bdbuf_cache.tree;
-
-  *prev = NULL;
+  size_t i;
 
-  while (cur != NULL)
+  /*
+   * The BDs do not leave the index while it is scanned, they are discarded
+   * later in rtems_bdbuf_purge_list().
+   */
+  for (i = 0; i <= shard->index_mask; ++i)
   {
-    if (cur->dd == dd)
+    rtems_bdbuf_buffer *cur = shard->index[i].bd;
+
+    if (cur != NULL && cur->dd == dd)
     {
       switch (cur->state)
       {
@@ -2791,7 +3371,7 @@ rtems_bdbuf_gather_for_purge (rtems_chain_control *purge_list,
         case RTEMS_BDBUF_STATE_TRANSFER_PURGED:
           break;
         case RTEMS_BDBUF_STATE_SYNC:
-          rtems_bdbuf_wake (&bdbuf_cache.transfer_waiters);
+          rtems_bdbuf_wake (&shard->transfer_waiters);
           /* Fall through */
         case RTEMS_BDBUF_STATE_MODIFIED:
           rtems_bdbuf_group_release (cur);
@@ -2812,56 +3392,43 @@ rtems_bdbuf_gather_for_purge (rtems_chain_control *purge_list,
           rtems_bdbuf_fatal (RTEMS_BDBUF_FATAL_STATE_11);
       }
     }
-
-    if (cur->avl.left != NULL)
-    {
-      /* Left */
-      ++prev;
-      *prev = cur;
-      cur = cur->avl.left;
-    }
-    else if (cur->avl.right != NULL)
-    {
-      /* Right */
-      ++prev;
-      *prev = cur;
-      cur = cur->avl.right;
-    }
-    else
-    {
-      while (*prev != NULL
-             && (cur == (*prev)->avl.right || (*prev)->avl.right == NULL))
-      {
-        /* Up */
-        cur = *prev;
-        --prev;
-      }
-      if (*prev != NULL)
-        /* Right */
-        cur = (*prev)->avl.right;
-      else
-        /* Finished */
-        cur = NULL;
-    }
   }
 }
 
 static void
-rtems_bdbuf_do_purge_dev (rtems_disk_device *dd)
+rtems_bdbuf_do_purge_dev (rtems_bdbuf_shard *shard, rtems_disk_device *dd)
 {
   rtems_chain_control purge_list;
 
   rtems_chain_initialize_empty (&purge_list);
   rtems_bdbuf_read_ahead_reset (dd);
-  rtems_bdbuf_gather_for_purge (&purge_list, dd);
-  rtems_bdbuf_purge_list (&purge_list);
+  rtems_bdbuf_gather_for_purge (shard, &purge_list, dd);
+  rtems_bdbuf_purge_list (shard, &purge_list);
 }
 
 void
 rtems_bdbuf_purge_dev (rtems_disk_device *dd)
+{
+  rtems_bdbuf_shard *shard = rtems_bdbuf_get_shard (dd);
+
+  rtems_bdbuf_lock_shard (shard);
+  rtems_bdbuf_do_purge_dev (shard, dd);
+  rtems_bdbuf_unlock_shard (shard);
+}
+
+void
+rtems_bdbuf_select_shard (rtems_disk_device *dd)
 {
   rtems_bdbuf_lock_cache ();
-  rtems_bdbuf_do_purge_dev (dd);
+  dd->bdbuf_shard = bdbuf_cache.next_shard;
+
+  /*
+   * Use the shard count of the cache, which is clamped to the group count,
+   * so that the index is always valid for rtems_bdbuf_get_shard().
+   */
+  if (bdbuf_cache.shard_count > 0)
+    bdbuf_cache.next_shard =
+      (bdbuf_cache.next_shard + 1) % bdbuf_cache.shard_count;
   rtems_bdbuf_unlock_cache ();
 }
 
@@ -2870,7 +3437,8 @@ rtems_bdbuf_set_block_size (rtems_disk_device *dd,
                             uint32_t           block_size,
                             bool               sync)
 {
-  rtems_status_code sc = RTEMS_SUCCESSFUL;
+  rtems_status_code  sc = RTEMS_SUCCESSFUL;
+  rtems_bdbuf_shard *shard = rtems_bdbuf_get_shard (dd);
 
   /*
    * We do not care about the synchronization status since we will purge the
@@ -2879,7 +3447,7 @@ rtems_bdbuf_set_block_size (rtems_disk_device *dd,
   if (sync)
     rtems_bdbuf_syncdev (dd);
 
-  rtems_bdbuf_lock_cache ();
+  rtems_bdbuf_lock_shard (shard);
 
   if (block_size > 0)
   {
@@ -2905,7 +3473,7 @@ rtems_bdbuf_set_block_size (rtems_disk_device *dd,
       dd->block_to_media_block_shift = block_to_media_block_shift;
       dd->bds_per_group = bds_per_group;
 
-      rtems_bdbuf_do_purge_dev (dd);
+      rtems_bdbuf_do_purge_dev (shard, dd);
     }
     else
     {
@@ -2917,66 +3485,190 @@ rtems_bdbuf_set_block_size (rtems_disk_device *dd,
     sc = RTEMS_INVALID_NUMBER;
   }
 
-  rtems_bdbuf_unlock_cache ();
+  rtems_bdbuf_unlock_shard (shard);
 
   return sc;
 }
 
-static rtems_task
-rtems_bdbuf_read_ahead_task (rtems_task_argument arg)
+RTEMS_INTERRUPT_LOCK_DEFINE (static, bdbuf_read_ahead_lock, "bdbuf read-ahead")
+
+/**
+ * Call back handler called by the low level driver when a read-ahead request
+ * has completed. The request is handed back to the read-ahead task. This
+ * function may be invoked from interrupt handler.
+ *
+ * @param req The read-ahead request.
+ * @param status I/O completion status
+ */
+static void
+rtems_bdbuf_read_ahead_done (rtems_blkdev_request* req,
+                             rtems_status_code     status)
 {
-  rtems_chain_control *chain = &bdbuf_cache.read_ahead_chain;
+  rtems_bdbuf_read_ahead_request *ra_req = req->done_arg;
+  rtems_interrupt_lock_context    lock_context;
+  rtems_status_code               sc;
 
-  while (bdbuf_cache.read_ahead_enabled)
+  req->status = status;
+
+  rtems_interrupt_lock_acquire (&bdbuf_read_ahead_lock, &lock_context);
+  rtems_chain_append_unprotected (&bdbuf_cache.read_ahead_done, &ra_req->link);
+  rtems_interrupt_lock_release (&bdbuf_read_ahead_lock, &lock_context);
+
+  sc = rtems_event_send (bdbuf_cache.read_ahead_task,
+                         RTEMS_BDBUF_READ_AHEAD_WAKE_UP);
+  if (sc != RTEMS_SUCCESSFUL)
+    rtems_bdbuf_fatal (RTEMS_BDBUF_FATAL_RA_WAKE_UP);
+}
+
+/**
+ * Finish the completed read-ahead requests and return them to the free chain.
+ * No shard is locked.
+ */
+static void
+rtems_bdbuf_read_ahead_complete (void)
+{
+  while (true)
   {
-    rtems_chain_node *node;
+    rtems_interrupt_lock_context    lock_context;
+    rtems_bdbuf_read_ahead_request *ra_req;
+    rtems_bdbuf_shard              *shard;
 
-    rtems_bdbuf_wait_for_event (RTEMS_BDBUF_READ_AHEAD_WAKE_UP);
-    rtems_bdbuf_lock_cache ();
+    rtems_interrupt_lock_acquire (&bdbuf_read_ahead_lock, &lock_context);
+    ra_req = (rtems_bdbuf_read_ahead_request *)
+      rtems_chain_get_unprotected (&bdbuf_cache.read_ahead_done);
+    rtems_interrupt_lock_release (&bdbuf_read_ahead_lock, &lock_context);
+
+    if (ra_req == NULL)
+      break;
+
+    shard = rtems_bdbuf_get_shard (ra_req->dd);
+
+    rtems_bdbuf_lock_shard (shard);
+    rtems_bdbuf_transfer_finish (shard, ra_req->dd, ra_req->req);
+    --ra_req->dd->read_ahead.requests;
+    rtems_bdbuf_unlock_shard (shard);
+
+    rtems_chain_append_unprotected (&bdbuf_cache.read_ahead_free,
+                                    &ra_req->link);
+  }
+}
+
+/**
+ * Pass a read-ahead request to the driver without waiting for its completion.
+ * The shard must be locked and there must be a free read-ahead request. The
+ * shard is unlocked while the driver is called.
+ */
+static void
+rtems_bdbuf_submit_read_ahead (rtems_bdbuf_shard              *shard,
+                               rtems_disk_device              *dd,
+                               rtems_bdbuf_buffer             *bd,
+                               uint32_t                        transfer_count,
+                               rtems_blkdev_read_ahead_stream *stream)
+{
+  rtems_bdbuf_read_ahead_request *ra_req = (rtems_bdbuf_read_ahead_request *)
+    rtems_chain_get_unprotected (&bdbuf_cache.read_ahead_free);
+
+  ra_req->dd = dd;
+  rtems_bdbuf_prepare_read_request (shard, dd, bd, transfer_count, stream,
+                                    ra_req->req);
+  ++dd->read_ahead.requests;
+
+  rtems_bdbuf_unlock_shard (shard);
+
+  /* The return value will be ignored for transfer requests */
+  dd->ioctl (dd->phys_dev, RTEMS_BLKIO_REQUEST, ra_req->req);
+
+  rtems_bdbuf_lock_shard (shard);
+}
+
+/**
+ * Issue the read-ahead requests of the shard's read-ahead streams. Requests
+ * of different streams and devices overlap. A device gets no more requests
+ * than its queue depth. The streams of busy devices and the streams left over
+ * once all read-ahead requests are in flight stay on the read-ahead chain.
+ * The completion of a request wakes up the read-ahead task to process them.
+ */
+static void
+rtems_bdbuf_read_ahead_processing (rtems_bdbuf_shard *shard)
+{
+  rtems_chain_control *chain = &shard->read_ahead_chain;
+  rtems_chain_control  busy;
+  rtems_chain_node    *node;
+
+  rtems_chain_initialize_empty (&busy);
+
+  rtems_bdbuf_lock_shard (shard);
 
-    while ((node = rtems_chain_get_unprotected (chain)) != NULL)
+  while (!rtems_chain_is_empty (&bdbuf_cache.read_ahead_free)
+         && (node = rtems_chain_get_unprotected (chain)) != NULL)
+  {
+    rtems_blkdev_read_ahead_stream *stream =
+      RTEMS_CONTAINER_OF (node, rtems_blkdev_read_ahead_stream, node);
+    rtems_disk_device *dd = stream->dd;
+    rtems_blkdev_bnum block = stream->next;
+    rtems_blkdev_bnum media_block = 0;
+    rtems_status_code sc;
+
+    rtems_chain_set_off_chain (node);
+
+    if (dd->read_ahead.requests >= dd->queue_depth)
     {
-      rtems_disk_device *dd =
-        RTEMS_CONTAINER_OF (node, rtems_disk_device, read_ahead.node);
-      rtems_blkdev_bnum block = dd->read_ahead.next;
-      rtems_blkdev_bnum media_block = 0;
-      rtems_status_code sc =
-        rtems_bdbuf_get_media_block (dd, block, &media_block);
+      rtems_chain_append_unprotected (&busy, node);
+      continue;
+    }
+
+    sc = rtems_bdbuf_get_media_block (dd, block, &media_block);
 
-      rtems_chain_set_off_chain (&dd->read_ahead.node);
+    if (sc == RTEMS_SUCCESSFUL)
+    {
+      rtems_bdbuf_buffer *bd =
+        rtems_bdbuf_get_buffer_for_read_ahead (shard, dd, media_block);
 
-      if (sc == RTEMS_SUCCESSFUL)
+      if (bd != NULL)
       {
-        rtems_bdbuf_buffer *bd =
-          rtems_bdbuf_get_buffer_for_read_ahead (dd, media_block);
+        uint32_t transfer_count = dd->block_count - block;
+        uint32_t max_transfer_count = rtems_bdbuf_read_ahead_window (stream);
 
-        if (bd != NULL)
+        if (transfer_count >= max_transfer_count)
         {
-          uint32_t transfer_count = dd->block_count - block;
-          uint32_t max_transfer_count = bdbuf_config.max_read_ahead_blocks;
-
-          if (transfer_count >= max_transfer_count)
-          {
-            transfer_count = max_transfer_count;
-            dd->read_ahead.trigger = block + transfer_count / 2;
-            dd->read_ahead.next = block + transfer_count;
-          }
-          else
-          {
-            dd->read_ahead.trigger = RTEMS_DISK_READ_AHEAD_NO_TRIGGER;
-          }
-
-          ++dd->stats.read_ahead_transfers;
-          rtems_bdbuf_execute_read_request (dd, bd, transfer_count);
+          transfer_count = max_transfer_count;
+          stream->trigger = block + transfer_count / 2;
+          stream->next = block + transfer_count;
         }
+        else
+        {
+          stream->trigger = RTEMS_DISK_READ_AHEAD_NO_TRIGGER;
+        }
+
+        ++dd->stats.read_ahead_transfers;
+        rtems_bdbuf_submit_read_ahead (shard, dd, bd, transfer_count, stream);
       }
-      else
-      {
-        dd->read_ahead.trigger = RTEMS_DISK_READ_AHEAD_NO_TRIGGER;
-      }
     }
+    else
+    {
+      stream->trigger = RTEMS_DISK_READ_AHEAD_NO_TRIGGER;
+    }
+  }
 
-    rtems_bdbuf_unlock_cache ();
+  while ((node = rtems_chain_get_unprotected (&busy)) != NULL)
+    rtems_chain_append_unprotected (chain, node);
+
+  rtems_bdbuf_unlock_shard (shard);
+}
+
+static rtems_task
+rtems_bdbuf_read_ahead_task (rtems_task_argument arg)
+{
+  while (bdbuf_cache.read_ahead_enabled)
+  {
+    size_t s;
+
+    rtems_bdbuf_wait_for_event (RTEMS_BDBUF_READ_AHEAD_WAKE_UP);
+
+    rtems_bdbuf_read_ahead_complete ();
+
+    for (s = 0; s < bdbuf_cache.shard_count; s++)
+      rtems_bdbuf_read_ahead_processing (&bdbuf_cache.shards[s]);
   }
 
   rtems_task_delete (RTEMS_SELF);
@@ -2985,14 +3677,18 @@ rtems_bdbuf_read_ahead_task (rtems_task_argument arg)
 void rtems_bdbuf_get_device_stats (const rtems_disk_device *dd,
                                    rtems_blkdev_stats      *stats)
 {
-  rtems_bdbuf_lock_cache ();
+  rtems_bdbuf_shard *shard = rtems_bdbuf_get_shard (dd);
+
+  rtems_bdbuf_lock_shard (shard);
   *stats = dd->stats;
-  rtems_bdbuf_unlock_cache ();
+  rtems_bdbuf_unlock_shard (shard);
 }
 
 void rtems_bdbuf_reset_device_stats (rtems_disk_device *dd)
 {
-  rtems_bdbuf_lock_cache ();
+  rtems_bdbuf_shard *shard = rtems_bdbuf_get_shard (dd);
+
+  rtems_bdbuf_lock_shard (shard);
   memset (&dd->stats, 0, sizeof(dd->stats));
-  rtems_bdbuf_unlock_cache ();
+  rtems_bdbuf_unlock_shard (shard);
 }
@@ -56,7 +56,29 @@ static ssize_t rtems_blkdev_imfs_read(
 
   while (remaining > 0) {
     rtems_bdbuf_buffer *bd;
-    rtems_status_code sc = rtems_bdbuf_read(dd, block, &bd);
+    rtems_status_code sc;
+
+    if (
+      block_offset == 0
+        && remaining >= block_size
+        && rtems_libio_iop_is_direct(iop)
+        && rtems_bdbuf_is_direct_buffer(dst)
+    ) {
+      uint32_t direct = (uint32_t) (remaining / block_size);
+
+      sc = rtems_bdbuf_read_direct(dd, block, direct, dst);
+      if (sc == RTEMS_SUCCESSFUL) {
+        remaining -= (ssize_t) direct * block_size;
+        dst += (ssize_t) direct * block_size;
+        block += direct;
+      } else {
+        remaining = -1;
+      }
+
+      continue;
+    }
+
+    sc = rtems_bdbuf_read(dd, block, &bd);
 
     if (sc == RTEMS_SUCCESSFUL) {
       ssize_t copy = block_size - block_offset;
@@ -112,6 +134,26 @@ static ssize_t rtems_blkdev_imfs_write(
     rtems_status_code sc;
     rtems_bdbuf_buffer *bd;
 
+    if (
+      block_offset == 0
+        && remaining >= block_size
+        && rtems_libio_iop_is_direct(iop)
+        && rtems_bdbuf_is_direct_buffer(src)
+    ) {
+      uint32_t direct = (uint32_t) (remaining / block_size);
+
+      sc = rtems_bdbuf_write_direct(dd, block, direct, src);
+      if (sc == RTEMS_SUCCESSFUL) {
+        remaining -= (ssize_t) direct * block_size;
+        src += (ssize_t) direct * block_size;
+        block += direct;
+      } else {
+        remaining = -1;
+      }
+
+      continue;
+    }
+
     if (block_offset == 0 && remaining >= block_size) {
        sc = rtems_bdbuf_get(dd, block, &bd);
     } else {
@@ -71,6 +71,10 @@ rtems_blkdev_ioctl(rtems_disk_device *dd, uint32_t req, void *argp)
             rtems_bdbuf_reset_device_stats(dd);
             break;
 
+        case RTEMS_BLKIO_GETQUEUEDEPTH:
+            *(uint32_t *) argp = dd->queue_depth;
+            break;
+
         default:
             errno = EINVAL;
             rc = -1;
@@ -121,6 +121,11 @@ ramdisk_ioctl(rtems_disk_device *dd, uint32_t req, void *argp)
             break;
         }
 
+        case RTEMS_BLKIO_GETQUEUEDEPTH:
+            /* Requests are finished within the IO control */
+            *(uint32_t *) argp = UINT32_MAX;
+            return 0;
+
         case RTEMS_BLKIO_DELETED:
             if (rd->free_at_delete_request) {
               ramdisk_free(rd);
@@ -283,6 +283,11 @@ static int sparse_disk_ioctl( rtems_disk_device *dd, uint32_t req, void *argp )
       default:
         break;
     }
+  } else if ( RTEMS_BLKIO_GETQUEUEDEPTH == req ) {
+    /* Requests are finished within the IO control */
+    *(uint32_t *) argp = UINT32_MAX;
+
+    return 0;
   } else if ( RTEMS_BLKIO_DELETED == req ) {
     rtems_mutex_destroy( &sd->mutex );
 
@@ -160,7 +160,7 @@ static int vfcntl(
 
     case F_SETFL:
       flags = rtems_libio_fcntl_flags( va_arg( ap, int ) );
-      mask = LIBIO_FLAGS_NO_DELAY | LIBIO_FLAGS_APPEND;
+      mask = LIBIO_FLAGS_NO_DELAY | LIBIO_FLAGS_APPEND | LIBIO_FLAGS_DIRECT;
 
       /*
        *  XXX If we are turning on append, should we seek to the end?
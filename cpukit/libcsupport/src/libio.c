@@ -55,6 +55,9 @@ static const rtems_assoc_t status_flags_assoc[] = {
 #endif
   { "NONBLOCK",  LIBIO_FLAGS_NO_DELAY,  O_NONBLOCK },
   { "APPEND",    LIBIO_FLAGS_APPEND,    O_APPEND },
+#ifdef O_DIRECT
+  { "DIRECT",    LIBIO_FLAGS_DIRECT,    O_DIRECT },
+#endif
   { 0, 0, 0 },
 };
 
@@ -103,6 +106,12 @@ int rtems_libio_to_fcntl_flags( unsigned int flags )
     fcntl_flags |= O_APPEND;
   }
 
+#ifdef O_DIRECT
+  if ( (flags & LIBIO_FLAGS_DIRECT) == LIBIO_FLAGS_DIRECT ) {
+    fcntl_flags |= O_DIRECT;
+  }
+#endif
+
   return fcntl_flags;
 }
 
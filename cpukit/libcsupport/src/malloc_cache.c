@@ -0,0 +1,383 @@
+/**
+ *  @file
+ *
+ *  @brief RTEMS Per-Processor Malloc Caches
+ *  @ingroup libcsupport
+ */
+
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "malloc_p.h"
+
+#include <rtems/score/heapimpl.h>
+#include <rtems/score/smp.h>
+
+#include <string.h>
+
+/*
+ * The objects of a size class can satisfy all requests up to the class size.
+ * An object freed to the caches goes to the greatest class its usable size
+ * can satisfy.  Objects with a usable size of at least twice the greatest
+ * class size are not cached.
+ */
+static const uintptr_t _Malloc_Cache_class_sizes[
+  RTEMS_MALLOC_CACHE_CLASS_COUNT
+] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+
+#define MALLOC_CACHE_MAX_SIZE \
+  _Malloc_Cache_class_sizes[ RTEMS_MALLOC_CACHE_CLASS_COUNT - 1 ]
+
+#define MALLOC_CACHE_BATCH_MAX 16
+
+static size_t _Malloc_Cache_batch_size( void )
+{
+  size_t batch = rtems_malloc_cache_size / 2;
+
+  if ( batch == 0 ) {
+    batch = 1;
+  } else if ( batch > MALLOC_CACHE_BATCH_MAX ) {
+    batch = MALLOC_CACHE_BATCH_MAX;
+  }
+
+  return batch;
+}
+
+static size_t _Malloc_Cache_class_of_request( size_t size )
+{
+  size_t k = 0;
+
+  while ( _Malloc_Cache_class_sizes[ k ] < size ) {
+    ++k;
+  }
+
+  return k;
+}
+
+static bool _Malloc_Cache_class_of_object( void *p, size_t *k )
+{
+  Heap_Control *heap = RTEMS_Malloc_Heap;
+  uintptr_t alloc_begin = (uintptr_t) p;
+  Heap_Block *block = _Heap_Block_of_alloc_area( alloc_begin, heap->page_size );
+  uintptr_t usable;
+  size_t i;
+
+  /*
+   * The block is owned by the caller, so its size is stable.  Invalid
+   * pointers are left to the heap, which detects them.
+   */
+  if ( !_Heap_Is_block_in_heap( heap, block ) || !_Heap_Is_used( block ) ) {
+    return false;
+  }
+
+  usable = (uintptr_t) block + _Heap_Block_size( block ) - alloc_begin
+    + HEAP_ALLOC_BONUS;
+
+  if (
+    usable < _Malloc_Cache_class_sizes[ 0 ]
+      || usable >= 2 * MALLOC_CACHE_MAX_SIZE
+  ) {
+    return false;
+  }
+
+  i = RTEMS_MALLOC_CACHE_CLASS_COUNT - 1;
+
+  while ( _Malloc_Cache_class_sizes[ i ] > usable ) {
+    --i;
+  }
+
+  *k = i;
+  return true;
+}
+
+static void **_Malloc_Cache_magazine( uint32_t cpu_index, size_t k )
+{
+  return &rtems_malloc_cache_objects[
+    ( cpu_index * RTEMS_MALLOC_CACHE_CLASS_COUNT + k ) * rtems_malloc_cache_size
+  ];
+}
+
+static uint32_t _Malloc_Cache_acquire(
+  rtems_interrupt_lock_context *lock_context
+)
+{
+  uint32_t cpu_index;
+
+  /*
+   * The current processor may change after the lock acquisition, however,
+   * this is harmless since the lock protects the cache.
+   */
+  rtems_interrupt_lock_interrupt_disable( lock_context );
+  cpu_index = _SMP_Get_current_processor();
+  rtems_interrupt_lock_acquire_isr(
+    &rtems_malloc_cache_table[ cpu_index ].Lock,
+    lock_context
+  );
+
+  return cpu_index;
+}
+
+static void _Malloc_Cache_release(
+  uint32_t cpu_index,
+  rtems_interrupt_lock_context *lock_context
+)
+{
+  rtems_interrupt_lock_release(
+    &rtems_malloc_cache_table[ cpu_index ].Lock,
+    lock_context
+  );
+}
+
+static void _Malloc_Cache_spill( void **objects, size_t n )
+{
+  Heap_Control *heap = RTEMS_Malloc_Heap;
+  size_t i;
+
+  _RTEMS_Lock_allocator();
+
+  for ( i = 0; i < n; ++i ) {
+    if ( !_Heap_Free( heap, objects[ i ] ) ) {
+      _RTEMS_Unlock_allocator();
+      rtems_fatal(
+        RTEMS_FATAL_SOURCE_INVALID_HEAP_FREE,
+        (rtems_fatal_code) objects[ i ]
+      );
+    }
+  }
+
+  _RTEMS_Unlock_allocator();
+}
+
+static void *_Malloc_Cache_refill( size_t k )
+{
+  Heap_Control *heap = RTEMS_Malloc_Heap;
+  void *batch[ MALLOC_CACHE_BATCH_MAX ];
+  size_t batch_size = _Malloc_Cache_batch_size();
+  rtems_interrupt_lock_context lock_context;
+  rtems_malloc_cache *cache;
+  uint32_t cpu_index;
+  void **magazine;
+  size_t n;
+  size_t i;
+
+  _RTEMS_Lock_allocator();
+  _Malloc_Process_deferred_frees();
+
+  for ( n = 0; n < batch_size; ++n ) {
+    batch[ n ] = _Heap_Allocate( heap, _Malloc_Cache_class_sizes[ k ] );
+
+    if ( batch[ n ] == NULL ) {
+      break;
+    }
+  }
+
+  _RTEMS_Unlock_allocator();
+
+  if ( n == 0 ) {
+    return NULL;
+  }
+
+  cpu_index = _Malloc_Cache_acquire( &lock_context );
+  cache = &rtems_malloc_cache_table[ cpu_index ];
+  magazine = _Malloc_Cache_magazine( cpu_index, k );
+  ++cache->refills;
+
+  /* The first object of the batch satisfies the request */
+  for ( i = 1; i < n && cache->count[ k ] < rtems_malloc_cache_size; ++i ) {
+    magazine[ cache->count[ k ] ] = batch[ i ];
+    ++cache->count[ k ];
+  }
+
+  _Malloc_Cache_release( cpu_index, &lock_context );
+
+  if ( i < n ) {
+    _Malloc_Cache_spill( &batch[ i ], n - i );
+  }
+
+  return batch[ 0 ];
+}
+
+void _Malloc_Cache_initialize( void )
+{
+  uint32_t cpu_max = rtems_configuration_get_maximum_processors();
+  uint32_t cpu_index;
+
+  if ( rtems_malloc_cache_size == 0 ) {
+    return;
+  }
+
+  for ( cpu_index = 0; cpu_index < cpu_max; ++cpu_index ) {
+    rtems_interrupt_lock_initialize(
+      &rtems_malloc_cache_table[ cpu_index ].Lock,
+      "Malloc Cache"
+    );
+  }
+}
+
+void *_Malloc_Cache_allocate( size_t size )
+{
+  rtems_interrupt_lock_context lock_context;
+  rtems_malloc_cache *cache;
+  uint32_t cpu_index;
+  uint32_t count;
+  size_t k;
+  void *p;
+
+  if (
+    rtems_malloc_cache_size == 0
+      || size > MALLOC_CACHE_MAX_SIZE
+      || _Malloc_System_state() != MALLOC_SYSTEM_STATE_NORMAL
+  ) {
+    return NULL;
+  }
+
+  k = _Malloc_Cache_class_of_request( size );
+
+  cpu_index = _Malloc_Cache_acquire( &lock_context );
+  cache = &rtems_malloc_cache_table[ cpu_index ];
+  count = cache->count[ k ];
+
+  if ( count > 0 ) {
+    --count;
+    p = _Malloc_Cache_magazine( cpu_index, k )[ count ];
+    cache->count[ k ] = count;
+    ++cache->allocation_hits;
+    _Malloc_Cache_release( cpu_index, &lock_context );
+  } else {
+    ++cache->allocation_misses;
+    _Malloc_Cache_release( cpu_index, &lock_context );
+    p = _Malloc_Cache_refill( k );
+  }
+
+  if ( p != NULL && rtems_malloc_dirty_helper != NULL ) {
+    (*rtems_malloc_dirty_helper)( p, size );
+  }
+
+  return p;
+}
+
+bool _Malloc_Cache_free( void *p )
+{
+  void *batch[ MALLOC_CACHE_BATCH_MAX + 1 ];
+  rtems_interrupt_lock_context lock_context;
+  rtems_malloc_cache *cache;
+  uint32_t cpu_index;
+  void **magazine;
+  uint32_t count;
+  size_t n;
+  size_t k;
+
+  if ( rtems_malloc_cache_size == 0 || !_Malloc_Cache_class_of_object( p, &k ) ) {
+    return false;
+  }
+
+  cpu_index = _Malloc_Cache_acquire( &lock_context );
+  cache = &rtems_malloc_cache_table[ cpu_index ];
+  magazine = _Malloc_Cache_magazine( cpu_index, k );
+  count = cache->count[ k ];
+
+  if ( count < rtems_malloc_cache_size ) {
+    magazine[ count ] = p;
+    cache->count[ k ] = count + 1;
+    ++cache->free_hits;
+    _Malloc_Cache_release( cpu_index, &lock_context );
+    return true;
+  }
+
+  /* The magazine is full, spill a batch together with this object */
+  n = _Malloc_Cache_batch_size();
+  count -= (uint32_t) n;
+  memcpy( &batch[ 0 ], &magazine[ count ], n * sizeof( batch[ 0 ] ) );
+  batch[ n ] = p;
+  cache->count[ k ] = count;
+  ++cache->spills;
+  _Malloc_Cache_release( cpu_index, &lock_context );
+
+  _Malloc_Cache_spill( &batch[ 0 ], n + 1 );
+  return true;
+}
+
+void rtems_malloc_cache_flush( void )
+{
+  uint32_t cpu_max = rtems_configuration_get_maximum_processors();
+  uint32_t cpu_index;
+
+  if ( rtems_malloc_cache_size == 0 ) {
+    return;
+  }
+
+  for ( cpu_index = 0; cpu_index < cpu_max; ++cpu_index ) {
+    rtems_malloc_cache *cache = &rtems_malloc_cache_table[ cpu_index ];
+    size_t k;
+
+    for ( k = 0; k < RTEMS_MALLOC_CACHE_CLASS_COUNT; ++k ) {
+      void **magazine = _Malloc_Cache_magazine( cpu_index, k );
+
+      while ( true ) {
+        void *batch[ MALLOC_CACHE_BATCH_MAX ];
+        rtems_interrupt_lock_context lock_context;
+        uint32_t count;
+        size_t n;
+
+        rtems_interrupt_lock_acquire( &cache->Lock, &lock_context );
+        count = cache->count[ k ];
+        n = count < MALLOC_CACHE_BATCH_MAX ? count : MALLOC_CACHE_BATCH_MAX;
+        count -= (uint32_t) n;
+        memcpy( &batch[ 0 ], &magazine[ count ], n * sizeof( batch[ 0 ] ) );
+        cache->count[ k ] = count;
+        rtems_interrupt_lock_release( &cache->Lock, &lock_context );
+
+        if ( n == 0 ) {
+          break;
+        }
+
+        _Malloc_Cache_spill( &batch[ 0 ], n );
+      }
+    }
+  }
+}
+
+void rtems_malloc_cache_get_information(
+  rtems_malloc_cache_information *info
+)
+{
+  uint32_t cpu_max = rtems_configuration_get_maximum_processors();
+  uint32_t cpu_index;
+
+  memset( info, 0, sizeof( *info ) );
+
+  if ( rtems_malloc_cache_size == 0 ) {
+    return;
+  }
+
+  for ( cpu_index = 0; cpu_index < cpu_max; ++cpu_index ) {
+    rtems_malloc_cache *cache = &rtems_malloc_cache_table[ cpu_index ];
+    rtems_interrupt_lock_context lock_context;
+    size_t k;
+
+    rtems_interrupt_lock_acquire( &cache->Lock, &lock_context );
+
+    for ( k = 0; k < RTEMS_MALLOC_CACHE_CLASS_COUNT; ++k ) {
+      info->cached_objects += cache->count[ k ];
+      info->cached_bytes += cache->count[ k ] * _Malloc_Cache_class_sizes[ k ];
+    }
+
+    info->allocation_hits += cache->allocation_hits;
+    info->allocation_misses += cache->allocation_misses;
+    info->free_hits += cache->free_hits;
+    info->refills += cache->refills;
+    info->spills += cache->spills;
+
+    rtems_interrupt_lock_release( &cache->Lock, &lock_context );
+  }
+}
@@ -26,13 +26,29 @@
 
 #include "malloc_p.h"
 
-#include <rtems/chain.h>
+#include <rtems/score/atomic.h>
+#include <rtems/score/smp.h>
 #include <rtems/score/sysstate.h>
 #include <rtems/score/threaddispatch.h>
 
-static RTEMS_CHAIN_DEFINE_EMPTY( _Malloc_GC_list );
+#if defined(RTEMS_SMP)
+  #define MALLOC_DEFERRED_FREE_LIST_COUNT CPU_MAXIMUM_PROCESSORS
+#else
+  #define MALLOC_DEFERRED_FREE_LIST_COUNT 1
+#endif
+
+/*
+ * The deferred frees are pushed to a lock-free stack of the current
+ * processor.  Any number of producers may push concurrently, the consumer
+ * takes the complete stack with a single atomic exchange, so there is no ABA
+ * problem.  The link to the next object is stored in the freed object itself.
+ */
+typedef struct {
+  Atomic_Uintptr head;
+} RTEMS_ALIGNED( CPU_CACHE_LINE_BYTES ) Malloc_Deferred_free_list;
 
-RTEMS_INTERRUPT_LOCK_DEFINE( static, _Malloc_GC_lock, "Malloc GC" )
+static Malloc_Deferred_free_list
+_Malloc_Deferred_free_lists[ MALLOC_DEFERRED_FREE_LIST_COUNT ];
 
 Malloc_System_state _Malloc_System_state( void )
 {
@@ -51,28 +67,68 @@ Malloc_System_state _Malloc_System_state( void )
   }
 }
 
-static void *_Malloc_Get_deferred_free( void )
+static void _Malloc_Process_deferred_free_list(
+  Malloc_Deferred_free_list *list
+)
 {
-  rtems_interrupt_lock_context lock_context;
-  void *p;
+  uintptr_t to_be_freed;
 
-  rtems_interrupt_lock_acquire( &_Malloc_GC_lock, &lock_context );
-  p = rtems_chain_get_unprotected( &_Malloc_GC_list );
-  rtems_interrupt_lock_release( &_Malloc_GC_lock, &lock_context );
+  /*
+   *  Avoid the read-modify-write operation in the common case of an empty
+   *  list.
+   */
+  if ( _Atomic_Load_uintptr( &list->head, ATOMIC_ORDER_RELAXED ) == 0 ) {
+    return;
+  }
 
-  return p;
+  to_be_freed = _Atomic_Exchange_uintptr(
+    &list->head,
+    0,
+    ATOMIC_ORDER_ACQUIRE
+  );
+
+  while ( to_be_freed != 0 ) {
+    uintptr_t next = *(uintptr_t *) to_be_freed;
+
+    free( (void *) to_be_freed );
+    to_be_freed = next;
+  }
 }
 
 void _Malloc_Process_deferred_frees( void )
 {
-  rtems_chain_node *to_be_freed;
+  uint32_t cpu_index;
 
   /*
-   *  If some free's have been deferred, then do them now.
+   *  If some free's have been deferred on this processor, then do them now.
+   *  The lists of the other processors are processed by their own
+   *  allocations, by rtems_malloc_process_deferred_frees(), or if an
+   *  allocation fails.  The current processor may change, this is harmless.
    */
-  while ( ( to_be_freed = _Malloc_Get_deferred_free() ) != NULL ) {
-    free( to_be_freed );
+  cpu_index = _SMP_Get_current_processor();
+  _Malloc_Process_deferred_free_list(
+    &_Malloc_Deferred_free_lists[ cpu_index ]
+  );
+}
+
+void rtems_malloc_process_deferred_frees( void )
+{
+  uint32_t cpu_max = rtems_configuration_get_maximum_processors();
+  uint32_t cpu_index;
+
+  if ( _Malloc_System_state() != MALLOC_SYSTEM_STATE_NORMAL ) {
+    return;
+  }
+
+  _RTEMS_Lock_allocator();
+
+  for ( cpu_index = 0; cpu_index < cpu_max; ++cpu_index ) {
+    _Malloc_Process_deferred_free_list(
+      &_Malloc_Deferred_free_lists[ cpu_index ]
+    );
   }
+
+  _RTEMS_Unlock_allocator();
 }
 
 void *rtems_heap_allocate_aligned_with_boundary(
@@ -94,6 +150,22 @@ void *rtems_heap_allocate_aligned_with_boundary(
         alignment,
         boundary
       );
+
+      if ( p == NULL ) {
+        /*
+         * Return the deferred frees of all processors and the objects of the
+         * per-processor caches and try again.
+         */
+        rtems_malloc_process_deferred_frees();
+        rtems_malloc_cache_flush();
+        p = _Heap_Allocate_aligned_with_boundary(
+          heap,
+          size,
+          alignment,
+          boundary
+        );
+      }
+
       _RTEMS_Unlock_allocator();
       break;
     case MALLOC_SYSTEM_STATE_NO_PROTECTION:
@@ -126,14 +198,29 @@ void *rtems_heap_allocate_aligned_with_boundary(
 
 void _Malloc_Deferred_free( void *p )
 {
-  rtems_interrupt_lock_context lock_context;
-  rtems_chain_node *node;
+  Malloc_Deferred_free_list *list;
+  uintptr_t *node;
+  uintptr_t head;
 
-  node = (rtems_chain_node *) p;
-
-  rtems_interrupt_lock_acquire( &_Malloc_GC_lock, &lock_context );
-  rtems_chain_initialize_node( node );
-  rtems_chain_append_unprotected( &_Malloc_GC_list, node );
-  rtems_interrupt_lock_release( &_Malloc_GC_lock, &lock_context );
+  /*
+   *  We are in an interrupt or thread dispatch disabled context, so the
+   *  current processor cannot change.
+   */
+  list = &_Malloc_Deferred_free_lists[ _SMP_Get_current_processor() ];
+
+  node = p;
+  head = _Atomic_Load_uintptr( &list->head, ATOMIC_ORDER_RELAXED );
+
+  do {
+    *node = head;
+  } while (
+    !_Atomic_Compare_exchange_uintptr(
+      &list->head,
+      &head,
+      (uintptr_t) node,
+      ATOMIC_ORDER_RELEASE,
+      ATOMIC_ORDER_RELAXED
+    )
+  );
 }
 #endif
@@ -30,6 +30,8 @@ void RTEMS_Malloc_Initialize(
 {
   Heap_Control *heap = RTEMS_Malloc_Heap;
 
+  _Malloc_Cache_initialize();
+
   if ( !rtems_configuration_get_unified_work_area() ) {
     Heap_Initialization_or_extend_handler init_or_extend = _Heap_Initialize;
     uintptr_t page_size = CPU_HEAP_ALIGNMENT;
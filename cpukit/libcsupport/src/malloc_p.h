@@ -29,6 +29,12 @@ void _Malloc_Deferred_free( void * );
 
 void _Malloc_Process_deferred_frees( void );
 
+void _Malloc_Cache_initialize( void );
+
+void *_Malloc_Cache_allocate( size_t size );
+
+bool _Malloc_Cache_free( void *p );
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
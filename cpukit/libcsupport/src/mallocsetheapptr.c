@@ -26,5 +26,7 @@ void malloc_set_heap_pointer(
   Heap_Control *new_heap
 )
 {
+  /* The cached objects belong to the previous heap */
+  rtems_malloc_cache_flush();
   RTEMS_Malloc_Heap = new_heap;
 }
@@ -126,6 +126,8 @@ void rtems_resource_snapshot_take(rtems_resource_snapshot *snapshot)
 
   memset(snapshot, 0, sizeof(*snapshot));
 
+  rtems_malloc_cache_flush();
+
   _RTEMS_Lock_allocator();
 
   _Thread_Kill_zombies();
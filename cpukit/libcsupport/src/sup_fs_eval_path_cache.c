@@ -0,0 +1,173 @@
+/**
+ *  @file
+ *
+ *  @brief RTEMS File System Eval Path Cache
+ *  @ingroup LibIOInternal
+ */
+
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <rtems/libio_.h>
+#include <rtems/thread.h>
+
+#include <string.h>
+
+static rtems_mutex eval_path_cache_mutex =
+  RTEMS_MUTEX_INITIALIZER( "eval path cache" );
+
+static rtems_filesystem_eval_path_cache_entry *get_entry(
+  const rtems_filesystem_mount_table_entry_t *mt_entry,
+  uintptr_t dir,
+  const char *name,
+  size_t namelen
+)
+{
+  uint32_t hash = 2166136261U;
+  size_t i;
+
+  hash = ( hash ^ (uint32_t) ( (uintptr_t) mt_entry >> 3 ) ) * 16777619U;
+  hash = ( hash ^ (uint32_t) dir ) * 16777619U;
+
+  for ( i = 0; i < namelen; ++i ) {
+    hash = ( hash ^ (uint8_t) name[ i ] ) * 16777619U;
+  }
+
+  return &rtems_filesystem_eval_path_cache_table[
+    hash & ( rtems_filesystem_eval_path_cache_size - 1 )
+  ];
+}
+
+static bool is_cacheable( size_t namelen )
+{
+  return rtems_filesystem_eval_path_cache_size > 0
+    && namelen <= RTEMS_FILESYSTEM_EVAL_PATH_CACHE_NAME_MAX;
+}
+
+rtems_filesystem_eval_path_cache_status rtems_filesystem_eval_path_cache_lookup(
+  const rtems_filesystem_mount_table_entry_t *mt_entry,
+  uintptr_t dir,
+  const char *name,
+  size_t namelen,
+  uintptr_t *node,
+  uintptr_t *data
+)
+{
+  rtems_filesystem_eval_path_cache_status status =
+    RTEMS_FILESYSTEM_EVAL_PATH_CACHE_MISS;
+  const rtems_filesystem_eval_path_cache_entry *entry;
+
+  if ( !is_cacheable( namelen ) ) {
+    return status;
+  }
+
+  entry = get_entry( mt_entry, dir, name, namelen );
+
+  rtems_mutex_lock( &eval_path_cache_mutex );
+
+  if (
+    entry->mt_entry == mt_entry
+      && entry->dir == dir
+      && entry->namelen == namelen
+      && memcmp( entry->name, name, namelen ) == 0
+  ) {
+    if ( entry->no_entry ) {
+      status = RTEMS_FILESYSTEM_EVAL_PATH_CACHE_NO_ENTRY;
+    } else {
+      *node = entry->node;
+      *data = entry->data;
+      status = RTEMS_FILESYSTEM_EVAL_PATH_CACHE_HIT;
+    }
+  }
+
+  rtems_mutex_unlock( &eval_path_cache_mutex );
+
+  return status;
+}
+
+static void insert(
+  const rtems_filesystem_mount_table_entry_t *mt_entry,
+  uintptr_t dir,
+  const char *name,
+  size_t namelen,
+  uintptr_t node,
+  uintptr_t data,
+  bool no_entry
+)
+{
+  rtems_filesystem_eval_path_cache_entry *entry;
+
+  if ( !is_cacheable( namelen ) ) {
+    return;
+  }
+
+  entry = get_entry( mt_entry, dir, name, namelen );
+
+  rtems_mutex_lock( &eval_path_cache_mutex );
+
+  entry->mt_entry = mt_entry;
+  entry->dir = dir;
+  entry->node = node;
+  entry->data = data;
+  entry->no_entry = no_entry;
+  entry->namelen = (uint8_t) namelen;
+  memcpy( entry->name, name, namelen );
+
+  rtems_mutex_unlock( &eval_path_cache_mutex );
+}
+
+void rtems_filesystem_eval_path_cache_insert(
+  const rtems_filesystem_mount_table_entry_t *mt_entry,
+  uintptr_t dir,
+  const char *name,
+  size_t namelen,
+  uintptr_t node,
+  uintptr_t data
+)
+{
+  insert( mt_entry, dir, name, namelen, node, data, false );
+}
+
+void rtems_filesystem_eval_path_cache_insert_no_entry(
+  const rtems_filesystem_mount_table_entry_t *mt_entry,
+  uintptr_t dir,
+  const char *name,
+  size_t namelen
+)
+{
+  insert( mt_entry, dir, name, namelen, 0, 0, true );
+}
+
+void rtems_filesystem_eval_path_cache_invalidate(
+  const rtems_filesystem_mount_table_entry_t *mt_entry
+)
+{
+  size_t i;
+
+  if ( rtems_filesystem_eval_path_cache_size == 0 ) {
+    return;
+  }
+
+  rtems_mutex_lock( &eval_path_cache_mutex );
+
+  for ( i = 0; i < rtems_filesystem_eval_path_cache_size; ++i ) {
+    rtems_filesystem_eval_path_cache_entry *entry =
+      &rtems_filesystem_eval_path_cache_table[ i ];
+
+    if ( entry->mt_entry == mt_entry ) {
+      entry->mt_entry = NULL;
+    }
+  }
+
+  rtems_mutex_unlock( &eval_path_cache_mutex );
+}
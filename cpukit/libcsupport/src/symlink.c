@@ -38,6 +38,7 @@ int symlink( const char *path1, const char *path2 )
     rtems_filesystem_eval_path_get_tokenlen( &ctx ),
     path1
   );
+  rtems_filesystem_eval_path_cache_invalidate( currentloc->mt_entry );
 
   rtems_filesystem_eval_path_cleanup( &ctx );
 
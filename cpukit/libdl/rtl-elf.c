@@ -68,7 +68,7 @@ bool
 rtems_rtl_elf_find_symbol (rtems_rtl_obj* obj,
                            const Elf_Sym* sym,
                            const char*    symname,
-                           Elf_Word*      value)
+                           Elf_Addr*      value)
 {
   rtems_rtl_obj_sect* sect;
 
@@ -161,7 +161,7 @@ rtems_rtl_elf_relocator (rtems_rtl_obj*      obj,
     const char*     symname = NULL;
     off_t           off;
     Elf_Word        type;
-    Elf_Word        symvalue = 0;
+    Elf_Addr        symvalue = 0;
     bool            relocate;
 
     off = obj->ooffset + sect->offset + (reloc * reloc_size);
@@ -287,7 +287,7 @@ rtems_rtl_obj_relocate_unresolved (rtems_rtl_unresolv_reloc* reloc,
 {
   rtems_rtl_obj_sect* sect;
   bool                is_rela;
-  Elf_Word            symvalue;
+  Elf_Addr            symvalue;
 
   is_rela =reloc->flags & 1;
 
@@ -298,7 +298,7 @@ rtems_rtl_obj_relocate_unresolved (rtems_rtl_unresolv_reloc* reloc,
     return false;
   }
 
-  symvalue = (Elf_Word) (intptr_t) sym->value;
+  symvalue = (Elf_Addr) (intptr_t) sym->value;
   if (is_rela)
   {
     Elf_Rela rela;
@@ -553,7 +553,6 @@ rtems_rtl_elf_symbols (rtems_rtl_obj*      obj,
             ++lsym;
           }
 
-          rtems_chain_set_off_chain (&osym->node);
           memcpy (string, name, strlen (name) + 1);
           osym->name = string;
           osym->value = symbol.st_value + (uint8_t*) symsect->base;
@@ -571,8 +570,8 @@ rtems_rtl_elf_symbols (rtems_rtl_obj*      obj,
       }
   }
 
-  if (globals)
-    rtems_rtl_symbol_obj_add (obj);
+  if (globals && !rtems_rtl_symbol_obj_add (obj))
+    return false;
 
   return true;
 }
@@ -31,7 +31,7 @@ extern "C" {
 /*
  * Do not add '()'. Leave plain.
  */
-#if defined(__powerpc64__) || defined(__arch64__)
+#if defined(__powerpc64__) || defined(__arch64__) || defined(__x86_64__)
 #define ELFSIZE 64
 #else
 #define ELFSIZE 32
@@ -99,7 +99,7 @@ bool rtems_rtl_elf_relocate_rel (const rtems_rtl_obj*      obj,
                                  const rtems_rtl_obj_sect* sect,
                                  const char*               symname,
                                  const Elf_Byte            syminfo,
-                                 const Elf_Word            symvalue);
+                                 const Elf_Addr            symvalue);
 
 /**
  * Architecture specific relocation handler compiled in for a specific
@@ -120,7 +120,7 @@ bool rtems_rtl_elf_relocate_rela (const rtems_rtl_obj*      obj,
                                   const rtems_rtl_obj_sect* sect,
                                   const char*               symname,
                                   const Elf_Byte            syminfo,
-                                  const Elf_Word            symvalue);
+                                  const Elf_Addr            symvalue);
 
 /**
  * Find the symbol. The symbol is passed as an ELF type symbol with the name
@@ -142,7 +142,7 @@ bool rtems_rtl_elf_relocate_rela (const rtems_rtl_obj*      obj,
 bool rtems_rtl_elf_find_symbol (rtems_rtl_obj* obj,
                                 const Elf_Sym* sym,
                                 const char*    symname,
-                                Elf_Word*      value);
+                                Elf_Addr*      value);
 
 /**
  * The ELF format check handler.
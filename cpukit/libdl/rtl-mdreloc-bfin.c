@@ -38,7 +38,7 @@ rtems_rtl_elf_relocate_rela (const rtems_rtl_obj*      obj,
                              const rtems_rtl_obj_sect* sect,
                              const char*               symname,
                              const Elf_Byte            syminfo,
-                             const Elf_Word            symvalue)
+                             const Elf_Addr            symvalue)
 {
   Elf_Addr target = 0;
   Elf_Addr *where;
@@ -117,7 +117,7 @@ rtems_rtl_elf_relocate_rel (const rtems_rtl_obj*      obj,
                             const rtems_rtl_obj_sect* sect,
                             const char*               symname,
                             const Elf_Byte            syminfo,
-                            const Elf_Word            symvalue)
+                            const Elf_Addr            symvalue)
 {
   rtems_rtl_set_error (EINVAL, "rel type record not supported");
   return false;
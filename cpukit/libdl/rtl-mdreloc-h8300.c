@@ -31,7 +31,7 @@ rtems_rtl_elf_relocate_rela (const rtems_rtl_obj*      obj,
                              const rtems_rtl_obj_sect* sect,
                              const char*               symname,
                              const Elf_Byte            syminfo,
-                             const Elf_Word            symvalue)
+                             const Elf_Addr            symvalue)
 {
   Elf_Addr *where;
   Elf_Word tmp;
@@ -103,7 +103,7 @@ rtems_rtl_elf_relocate_rel (const rtems_rtl_obj*      obj,
                             const rtems_rtl_obj_sect* sect,
                             const char*               symname,
                             const Elf_Byte            syminfo,
-                            const Elf_Word            symvalue)
+                            const Elf_Addr            symvalue)
 {
   rtems_rtl_set_error (EINVAL, "rel type record not supported");
   return false;
@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+/*
+ * The x86_64 relocations for object files built with the small code model.
+ * There is no GOT or PLT in a loaded object. PLT32 is applied as a direct
+ * PC relative reference and the GOTPCREL family is relaxed in place to a
+ * direct PC relative reference, the same relaxation the static linker
+ * performs when the symbol is local.
+ */
+
+#include <sys/cdefs.h>
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <rtems/rtl/rtl.h>
+#include "rtl-elf.h"
+#include "rtl-error.h"
+#include <rtems/rtl/rtl-trace.h>
+#include "rtl-unwind.h"
+#include "rtl-unwind-dw2.h"
+
+/*
+ * Instruction opcodes the GOTPCREL relocations are relaxed from and to.
+ */
+#define X86_64_OP_MOV        0x8b
+#define X86_64_OP_LEA        0x8d
+#define X86_64_OP_INDIRECT   0xff
+#define X86_64_MODRM_CALL    0x15
+#define X86_64_MODRM_JMP     0x25
+#define X86_64_OP_ADDR32     0x67
+#define X86_64_OP_CALL       0xe8
+#define X86_64_OP_JMP        0xe9
+#define X86_64_OP_NOP        0x90
+
+static bool
+rtems_rtl_elf_reloc_fits_s32 (int64_t value)
+{
+  return value >= INT32_MIN && value <= INT32_MAX;
+}
+
+static bool
+rtems_rtl_elf_reloc_fits_u32 (int64_t value)
+{
+  return value >= 0 && value <= (int64_t) UINT32_MAX;
+}
+
+static void
+rtems_rtl_elf_reloc_write_32 (uint8_t* where, uint32_t value)
+{
+  memcpy (where, &value, sizeof (value));
+}
+
+static void
+rtems_rtl_elf_reloc_write_64 (uint8_t* where, uint64_t value)
+{
+  memcpy (where, &value, sizeof (value));
+}
+
+static bool
+rtems_rtl_elf_reloc_overflow (const rtems_rtl_obj*      obj,
+                              const rtems_rtl_obj_sect* sect,
+                              const char*               symname,
+                              const char*               type)
+{
+  rtems_rtl_set_error (EINVAL,
+                       "%s: %s relocation overflow for %s in %s",
+                       sect->name, type, symname ? symname : "(null)",
+                       rtems_rtl_obj_oname (obj));
+  return false;
+}
+
+/*
+ * Relax a GOT load to a direct reference. The relocation offset points at
+ * the 32bit displacement and the opcode and ModR/M bytes precede it. Return
+ * the location of the relaxed instruction's displacement or NULL if the
+ * instruction cannot be relaxed.
+ */
+static uint8_t*
+rtems_rtl_elf_reloc_relax_gotpcrel (uint8_t* where, int64_t* value)
+{
+  uint8_t* op = where - 2;
+
+  if (op[0] == X86_64_OP_MOV)
+  {
+    /*
+     * mov foo@GOTPCREL(%rip), %reg -> lea foo(%rip), %reg
+     */
+    op[0] = X86_64_OP_LEA;
+    return where;
+  }
+
+  if (op[0] == X86_64_OP_INDIRECT && op[1] == X86_64_MODRM_CALL)
+  {
+    /*
+     * call *foo@GOTPCREL(%rip) -> addr32 call foo
+     */
+    op[0] = X86_64_OP_ADDR32;
+    op[1] = X86_64_OP_CALL;
+    return where;
+  }
+
+  if (op[0] == X86_64_OP_INDIRECT && op[1] == X86_64_MODRM_JMP)
+  {
+    /*
+     * jmp *foo@GOTPCREL(%rip) -> jmp foo; nop
+     *
+     * The displacement moves back one byte so the value is adjusted by the
+     * byte the instruction is now shorter.
+     */
+    op[0] = X86_64_OP_JMP;
+    where[3] = X86_64_OP_NOP;
+    *value += 1;
+    return where - 1;
+  }
+
+  return NULL;
+}
+
+uint32_t
+rtems_rtl_elf_section_flags (const rtems_rtl_obj* obj,
+                             const Elf_Shdr*      shdr)
+{
+  return 0;
+}
+
+bool
+rtems_rtl_elf_rel_resolve_sym (Elf_Word type)
+{
+  return true;
+}
+
+bool
+rtems_rtl_elf_relocate_rela (const rtems_rtl_obj*      obj,
+                             const Elf_Rela*           rela,
+                             const rtems_rtl_obj_sect* sect,
+                             const char*               symname,
+                             const Elf_Byte            syminfo,
+                             const Elf_Addr            symvalue)
+{
+  uint8_t* where;
+  uint8_t* disp;
+  int64_t  value;
+
+  where = (uint8_t*) sect->base + rela->r_offset;
+
+  switch (ELF_R_TYPE(rela->r_info)) {
+    case R_TYPE(NONE):
+      break;
+
+    case R_TYPE(64):
+      value = (int64_t) symvalue + rela->r_addend;
+      rtems_rtl_elf_reloc_write_64 (where, (uint64_t) value);
+      if (rtems_rtl_trace (RTEMS_RTL_TRACE_RELOC))
+        printf ("rtl: reloc 64 in %s --> %p @ %p in %s\n",
+                sect->name, (void*) (uintptr_t) value, where,
+                rtems_rtl_obj_oname (obj));
+      break;
+
+    case R_TYPE(PC32):
+    case R_TYPE(PLT32):
+      value = (int64_t) symvalue + rela->r_addend - (intptr_t) where;
+      if (!rtems_rtl_elf_reloc_fits_s32 (value))
+        return rtems_rtl_elf_reloc_overflow (obj, sect, symname, "PC32");
+      rtems_rtl_elf_reloc_write_32 (where, (uint32_t) value);
+      if (rtems_rtl_trace (RTEMS_RTL_TRACE_RELOC))
+        printf ("rtl: reloc PC32/PLT32 in %s --> %p (%" PRId64 " @ %p) "
+                "in %s\n",
+                sect->name, (void*) symvalue, value, where,
+                rtems_rtl_obj_oname (obj));
+      break;
+
+    case R_TYPE(PC64):
+      value = (int64_t) symvalue + rela->r_addend - (intptr_t) where;
+      rtems_rtl_elf_reloc_write_64 (where, (uint64_t) value);
+      if (rtems_rtl_trace (RTEMS_RTL_TRACE_RELOC))
+        printf ("rtl: reloc PC64 in %s --> %p (%" PRId64 " @ %p) in %s\n",
+                sect->name, (void*) symvalue, value, where,
+                rtems_rtl_obj_oname (obj));
+      break;
+
+    case R_TYPE(GOTPCREL):
+    case R_TYPE(GOTPCRELX):
+    case R_TYPE(REX_GOTPCRELX):
+      value = (int64_t) symvalue + rela->r_addend - (intptr_t) where;
+      disp = rtems_rtl_elf_reloc_relax_gotpcrel (where, &value);
+      if (disp == NULL)
+      {
+        rtems_rtl_set_error (EINVAL,
+                             "%s: GOTPCREL instruction cannot be relaxed "
+                             "for %s in %s",
+                             sect->name, symname ? symname : "(null)",
+                             rtems_rtl_obj_oname (obj));
+        return false;
+      }
+      if (!rtems_rtl_elf_reloc_fits_s32 (value))
+        return rtems_rtl_elf_reloc_overflow (obj, sect, symname, "GOTPCREL");
+      rtems_rtl_elf_reloc_write_32 (disp, (uint32_t) value);
+      if (rtems_rtl_trace (RTEMS_RTL_TRACE_RELOC))
+        printf ("rtl: reloc GOTPCREL in %s --> %p (%" PRId64 " @ %p) "
+                "in %s\n",
+                sect->name, (void*) symvalue, value, where,
+                rtems_rtl_obj_oname (obj));
+      break;
+
+    case R_TYPE(32):
+      value = (int64_t) symvalue + rela->r_addend;
+      if (!rtems_rtl_elf_reloc_fits_u32 (value))
+        return rtems_rtl_elf_reloc_overflow (obj, sect, symname, "32");
+      rtems_rtl_elf_reloc_write_32 (where, (uint32_t) value);
+      if (rtems_rtl_trace (RTEMS_RTL_TRACE_RELOC))
+        printf ("rtl: reloc 32 in %s --> %p @ %p in %s\n",
+                sect->name, (void*) (uintptr_t) value, where,
+                rtems_rtl_obj_oname (obj));
+      break;
+
+    case R_TYPE(32S):
+      value = (int64_t) symvalue + rela->r_addend;
+      if (!rtems_rtl_elf_reloc_fits_s32 (value))
+        return rtems_rtl_elf_reloc_overflow (obj, sect, symname, "32S");
+      rtems_rtl_elf_reloc_write_32 (where, (uint32_t) value);
+      if (rtems_rtl_trace (RTEMS_RTL_TRACE_RELOC))
+        printf ("rtl: reloc 32S in %s --> %p @ %p in %s\n",
+                sect->name, (void*) (uintptr_t) value, where,
+                rtems_rtl_obj_oname (obj));
+      break;
+
+    case R_TYPE(GLOB_DAT):
+    case R_TYPE(JUMP_SLOT):
+      rtems_rtl_elf_reloc_write_64 (where, symvalue);
+      if (rtems_rtl_trace (RTEMS_RTL_TRACE_RELOC))
+        printf ("rtl: reloc GLOB_DAT/JUMP_SLOT in %s --> %p @ %p in %s\n",
+                sect->name, (void*) symvalue, where,
+                rtems_rtl_obj_oname (obj));
+      break;
+
+    case R_TYPE(RELATIVE):
+      value = (intptr_t) sect->base + rela->r_addend;
+      rtems_rtl_elf_reloc_write_64 (where, (uint64_t) value);
+      if (rtems_rtl_trace (RTEMS_RTL_TRACE_RELOC))
+        printf ("rtl: reloc RELATIVE in %s --> %p @ %p\n",
+                rtems_rtl_obj_oname (obj), (void*) (uintptr_t) value, where);
+      break;
+
+    case R_TYPE(COPY):
+      printf ("rtl: reloc COPY (please report)\n");
+      break;
+
+    default:
+      printf ("rtl: reloc unknown: sym = %" PRIu64 ", type = %" PRIu64
+              ", offset = %p\n",
+              (uint64_t) ELF_R_SYM(rela->r_info),
+              (uint64_t) ELF_R_TYPE(rela->r_info),
+              (void*) rela->r_offset);
+      rtems_rtl_set_error (EINVAL,
+                           "%s: Unsupported relocation type %" PRIu64
+                           " in non-PLT relocations",
+                           sect->name, (uint64_t) ELF_R_TYPE(rela->r_info));
+      return false;
+  }
+
+  return true;
+}
+
+bool
+rtems_rtl_elf_relocate_rel (const rtems_rtl_obj*      obj,
+                            const Elf_Rel*            rel,
+                            const rtems_rtl_obj_sect* sect,
+                            const char*               symname,
+                            const Elf_Byte            syminfo,
+                            const Elf_Addr            symvalue)
+{
+  rtems_rtl_set_error (EINVAL, "rel type record not supported");
+  return false;
+}
+
+bool
+rtems_rtl_elf_unwind_parse (const rtems_rtl_obj* obj,
+                            const char*          name,
+                            uint32_t             flags)
+{
+  return rtems_rtl_elf_unwind_dw2_parse (obj, name, flags);
+}
+
+bool
+rtems_rtl_elf_unwind_register (rtems_rtl_obj* obj)
+{
+  return rtems_rtl_elf_unwind_dw2_register (obj);
+}
+
+bool
+rtems_rtl_elf_unwind_deregister (rtems_rtl_obj* obj)
+{
+  return rtems_rtl_elf_unwind_dw2_deregister (obj);
+}
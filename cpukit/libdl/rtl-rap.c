@@ -276,7 +276,7 @@ rtems_rtl_rap_relocate (rtems_rtl_rap* rap, rtems_rtl_obj* obj)
       const char* symname = NULL;
       uint32_t    symname_size;
       Elf_Word    symtype = 0;
-      Elf_Word    symvalue = 0;
+      Elf_Addr    symvalue = 0;
 
       if (!rtems_rtl_rap_read_uint32 (rap->decomp, &info))
       {
@@ -646,7 +646,6 @@ rtems_rtl_rap_load_symbols (rtems_rtl_rap* rap, rtems_rtl_obj* obj)
       return false;
     }
 
-    rtems_chain_set_off_chain (&gsym->node);
     gsym->name = rap->strtab + name;
     gsym->value = (uint8_t*) (value + symsect->base);
     gsym->data = data & 0xffff;
@@ -661,8 +660,8 @@ rtems_rtl_rap_load_symbols (rtems_rtl_rap* rap, rtems_rtl_obj* obj)
     ++gsym;
   }
 
-  if (obj->global_syms)
-    rtems_rtl_symbol_obj_add (obj);
+  if (obj->global_syms && !rtems_rtl_symbol_obj_add (obj))
+    return false;
 
   return true;
 }
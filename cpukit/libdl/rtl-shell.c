@@ -75,11 +75,7 @@ rtems_rtl_obj_summary_iterator (rtems_chain_node* node, void* data)
 static int
 rtems_rtl_count_symbols (rtems_rtl_data* rtl)
 {
-  int count;
-  int bucket;
-  for (count = 0, bucket = 0; bucket < rtl->globals.nbuckets; ++bucket)
-    count += rtems_rtl_chain_count (&rtl->globals.buckets[bucket]);
-  return count;
+  return rtl->globals.count;
 }
 
 static int
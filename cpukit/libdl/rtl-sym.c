@@ -38,48 +38,356 @@ static rtems_rtl_obj_sym global_sym_add =
   .value = (void*) rtems_rtl_base_sym_global_add
 };
 
-static uint_fast32_t
+/**
+ * The marker for a deleted slot in the global symbol table.
+ */
+static rtems_rtl_obj_sym deleted_sym;
+
+/**
+ * The number of Bloom filter bits per symbol in an object file's index.
+ */
+#define RTEMS_RTL_SYMBOL_BLOOM_BITS (8)
+
+/**
+ * The bits in a Bloom filter word.
+ */
+#define RTEMS_RTL_SYMBOL_BLOOM_WORD_BITS (sizeof (uintptr_t) * 8)
+
+/**
+ * The log2 of the bits in a Bloom filter word. The hash bits below it select
+ * the first bit in a word.
+ */
+#define RTEMS_RTL_SYMBOL_BLOOM_WORD_SHIFT (sizeof (uintptr_t) == 8 ? 6 : 5)
+
+static uint32_t
 rtems_rtl_symbol_hash (const char *s)
 {
-  uint_fast32_t h = 5381;
+  uint32_t      h = 5381;
   unsigned char c;
   for (c = *s; c != '\0'; c = *++s)
     h = h * 33 + c;
-  return h & 0xffffffff;
+  return h;
+}
+
+static void
+rtems_rtl_symbol_set_hash (rtems_rtl_obj_sym* sym)
+{
+  sym->hash = rtems_rtl_symbol_hash (sym->name);
+}
+
+/*
+ * The low bits of the hash are weak for short names. Mix the hash before
+ * masking it to the table size.
+ */
+static size_t
+rtems_rtl_symbol_slot_first (const rtems_rtl_symbols* symbols, uint32_t hash)
+{
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3bU;
+  hash ^= hash >> 16;
+  return hash & (symbols->nslots - 1);
+}
+
+static size_t
+rtems_rtl_symbol_slot_next (const rtems_rtl_symbols* symbols, size_t slot)
+{
+  return (slot + 1) & (symbols->nslots - 1);
+}
+
+static rtems_rtl_symbol_slot*
+rtems_rtl_symbol_slot_find (rtems_rtl_symbols* symbols,
+                            const char*        name,
+                            uint32_t           hash)
+{
+  size_t slot = rtems_rtl_symbol_slot_first (symbols, hash);
+
+  while (symbols->slots[slot].sym != NULL)
+  {
+    rtems_rtl_symbol_slot* s = &symbols->slots[slot];
+    if ((s->sym != &deleted_sym) &&
+        (s->hash == hash) &&
+        (strcmp (name, s->sym->name) == 0))
+      return s;
+    slot = rtems_rtl_symbol_slot_next (symbols, slot);
+  }
+
+  return NULL;
 }
 
 static void
+rtems_rtl_symbol_slot_insert (rtems_rtl_symbols* symbols,
+                              rtems_rtl_obj_sym* symbol)
+{
+  size_t slot = rtems_rtl_symbol_slot_first (symbols, symbol->hash);
+
+  while ((symbols->slots[slot].sym != NULL) &&
+         (symbols->slots[slot].sym != &deleted_sym))
+    slot = rtems_rtl_symbol_slot_next (symbols, slot);
+
+  if (symbols->slots[slot].sym == &deleted_sym)
+    --symbols->deleted;
+
+  symbols->slots[slot].hash = symbol->hash;
+  symbols->slots[slot].sym = symbol;
+  ++symbols->count;
+}
+
+/*
+ * Make sure there is room for one more symbol. The table doubles when it
+ * would be more than three quarters full of symbols and is rebuilt at the
+ * same size if deleted slots fill it. If the memory for the new slots cannot
+ * be allocated the insert still works as long as an empty slot remains.
+ */
+static bool
+rtems_rtl_symbol_table_reserve (rtems_rtl_symbols* symbols)
+{
+  rtems_rtl_symbol_slot* slots;
+  rtems_rtl_symbol_slot* old_slots;
+  size_t                 old_nslots;
+  size_t                 nslots;
+  size_t                 used;
+  size_t                 s;
+
+  used = symbols->count + symbols->deleted + 1;
+  if ((used * 4) <= (symbols->nslots * 3))
+    return true;
+
+  nslots = symbols->nslots;
+  if (((symbols->count + 1) * 2) > nslots)
+    nslots *= 2;
+
+  slots = rtems_rtl_alloc_new (RTEMS_RTL_ALLOC_SYMBOL,
+                               nslots * sizeof (rtems_rtl_symbol_slot),
+                               true);
+  if (!slots)
+  {
+    if (used < symbols->nslots)
+      return true;
+    rtems_rtl_set_error (ENOMEM, "no memory to grow global symbol table");
+    return false;
+  }
+
+  if (rtems_rtl_trace (RTEMS_RTL_TRACE_GLOBAL_SYM))
+    printf ("rtl: global symbol table resize: %zu -> %zu\n",
+            symbols->nslots, nslots);
+
+  old_slots = symbols->slots;
+  old_nslots = symbols->nslots;
+
+  symbols->slots = slots;
+  symbols->nslots = nslots;
+  symbols->count = 0;
+  symbols->deleted = 0;
+
+  for (s = 0; s < old_nslots; ++s)
+  {
+    rtems_rtl_obj_sym* sym = old_slots[s].sym;
+    if ((sym != NULL) && (sym != &deleted_sym))
+      rtems_rtl_symbol_slot_insert (symbols, sym);
+  }
+
+  rtems_rtl_alloc_del (RTEMS_RTL_ALLOC_SYMBOL, old_slots);
+
+  return true;
+}
+
+/*
+ * Insert the symbol into the global table if the name is not already
+ * present. The first symbol exported with a name is the one found.
+ */
+static bool
 rtems_rtl_symbol_global_insert (rtems_rtl_symbols* symbols,
                                 rtems_rtl_obj_sym* symbol)
 {
-  uint_fast32_t hash = rtems_rtl_symbol_hash (symbol->name);
-  rtems_chain_append (&symbols->buckets[hash % symbols->nbuckets],
-                      &symbol->node);
+  if (rtems_rtl_symbol_slot_find (symbols, symbol->name, symbol->hash))
+    return true;
+  if (!rtems_rtl_symbol_table_reserve (symbols))
+    return false;
+  rtems_rtl_symbol_slot_insert (symbols, symbol);
+  return true;
 }
 
 bool
 rtems_rtl_symbol_table_open (rtems_rtl_symbols* symbols,
                              size_t             buckets)
 {
-  symbols->buckets = rtems_rtl_alloc_new (RTEMS_RTL_ALLOC_SYMBOL,
-                                          buckets * sizeof (rtems_chain_control),
-                                          true);
-  if (!symbols->buckets)
+  size_t nslots = 4;
+  while (nslots < buckets)
+    nslots *= 2;
+  symbols->slots = rtems_rtl_alloc_new (RTEMS_RTL_ALLOC_SYMBOL,
+                                        nslots * sizeof (rtems_rtl_symbol_slot),
+                                        true);
+  if (!symbols->slots)
   {
     rtems_rtl_set_error (ENOMEM, "no memory for global symbol table");
     return false;
   }
-  symbols->nbuckets = buckets;
-  for (buckets = 0; buckets < symbols->nbuckets; ++buckets)
-    rtems_chain_initialize_empty (&symbols->buckets[buckets]);
-  rtems_rtl_symbol_global_insert (symbols, &global_sym_add);
+  symbols->nslots = nslots;
+  symbols->count = 0;
+  symbols->deleted = 0;
+  rtems_rtl_symbol_set_hash (&global_sym_add);
+  rtems_rtl_symbol_slot_insert (symbols, &global_sym_add);
   return true;
 }
 
 void
 rtems_rtl_symbol_table_close (rtems_rtl_symbols* symbols)
 {
-  rtems_rtl_alloc_del (RTEMS_RTL_ALLOC_SYMBOL, symbols->buckets);
+  rtems_rtl_alloc_del (RTEMS_RTL_ALLOC_SYMBOL, symbols->slots);
+}
+
+static rtems_rtl_obj_sym*
+rtems_rtl_symbol_obj_sym (rtems_rtl_obj* obj, size_t index)
+{
+  if (index < obj->local_syms)
+    return &obj->local_table[index];
+  return &obj->global_table[index - obj->local_syms];
+}
+
+static void
+rtems_rtl_symbol_obj_index_free (rtems_rtl_obj* obj)
+{
+  if (obj->sym_index.bloom)
+  {
+    rtems_rtl_alloc_del (RTEMS_RTL_ALLOC_SYMBOL, obj->sym_index.bloom);
+    memset (&obj->sym_index, 0, sizeof (obj->sym_index));
+  }
+}
+
+static uintptr_t
+rtems_rtl_symbol_bloom_bits (const rtems_rtl_symbol_index* index,
+                             uint32_t                      hash)
+{
+  return ((uintptr_t) 1 << (hash % RTEMS_RTL_SYMBOL_BLOOM_WORD_BITS)) |
+    ((uintptr_t) 1 << ((hash >> index->bloom_shift) %
+                       RTEMS_RTL_SYMBOL_BLOOM_WORD_BITS));
+}
+
+static uintptr_t*
+rtems_rtl_symbol_bloom_word (const rtems_rtl_symbol_index* index,
+                             uint32_t                      hash)
+{
+  return &index->bloom[(hash / RTEMS_RTL_SYMBOL_BLOOM_WORD_BITS) &
+                       index->bloom_mask];
+}
+
+/*
+ * Build the object file's lookup index if it is not present. Return false if
+ * there is no memory for the index and the symbol tables have to be searched.
+ */
+static bool
+rtems_rtl_symbol_obj_index (rtems_rtl_obj* obj)
+{
+  rtems_rtl_symbol_index* index = &obj->sym_index;
+  size_t                  syms = obj->local_syms + obj->global_syms;
+  size_t                  words;
+  uint32_t                shift;
+  size_t                  size;
+  size_t                  s;
+
+  if (index->bloom)
+    return true;
+
+  if (syms == 0)
+    return false;
+
+  words = 1;
+  shift = RTEMS_RTL_SYMBOL_BLOOM_WORD_SHIFT;
+  while ((words * RTEMS_RTL_SYMBOL_BLOOM_WORD_BITS) <
+         (syms * RTEMS_RTL_SYMBOL_BLOOM_BITS))
+  {
+    words *= 2;
+    ++shift;
+  }
+
+  size = (words * sizeof (uintptr_t)) + (2 * syms * sizeof (uint32_t));
+  index->bloom = rtems_rtl_alloc_new (RTEMS_RTL_ALLOC_SYMBOL, size, true);
+  if (!index->bloom)
+    return false;
+
+  index->bloom_mask = words - 1;
+  /*
+   * The word index uses the hash bits up to the shift. Take the second bit
+   * from the bits above them like the GNU hash shift2, otherwise it depends
+   * on the word index and the filter rejects fewer names.
+   */
+  index->bloom_shift = shift;
+  index->nbuckets = syms;
+  index->buckets = (uint32_t*) &index->bloom[words];
+  index->chains = index->buckets + syms;
+
+  /*
+   * Insert in reverse so a chain holds the symbols in table order and the
+   * local symbols are found before the global symbols.
+   */
+  for (s = syms; s > 0; --s)
+  {
+    rtems_rtl_obj_sym* sym = rtems_rtl_symbol_obj_sym (obj, s - 1);
+    uint32_t           bucket;
+
+    rtems_rtl_symbol_set_hash (sym);
+    *rtems_rtl_symbol_bloom_word (index, sym->hash) |=
+      rtems_rtl_symbol_bloom_bits (index, sym->hash);
+
+    bucket = sym->hash % index->nbuckets;
+    index->chains[s - 1] = index->buckets[bucket];
+    index->buckets[bucket] = s;
+  }
+
+  return true;
+}
+
+/*
+ * Find a symbol in the object file's tables. The search can be limited to
+ * the global symbols.
+ */
+static rtems_rtl_obj_sym*
+rtems_rtl_symbol_obj_lookup (rtems_rtl_obj* obj,
+                             const char*    name,
+                             uint32_t       hash,
+                             bool           globals_only)
+{
+  rtems_rtl_obj_sym* sym;
+  size_t             s;
+
+  if (rtems_rtl_symbol_obj_index (obj))
+  {
+    const rtems_rtl_symbol_index* index = &obj->sym_index;
+    uintptr_t                     bits;
+    uint32_t                      next;
+
+    bits = rtems_rtl_symbol_bloom_bits (index, hash);
+
+    if ((*rtems_rtl_symbol_bloom_word (index, hash) & bits) != bits)
+      return NULL;
+
+    next = index->buckets[hash % index->nbuckets];
+    while (next != 0)
+    {
+      s = next - 1;
+      sym = rtems_rtl_symbol_obj_sym (obj, s);
+      if ((sym->hash == hash) &&
+          (!globals_only || (s >= obj->local_syms)) &&
+          (strcmp (name, sym->name) == 0))
+        return sym;
+      next = index->chains[s];
+    }
+
+    return NULL;
+  }
+
+  if (!globals_only)
+  {
+    for (s = 0, sym = obj->local_table; s < obj->local_syms; ++s, ++sym)
+      if (strcmp (name, sym->name) == 0)
+        return sym;
+  }
+
+  for (s = 0, sym = obj->global_table; s < obj->global_syms; ++s, ++sym)
+    if (strcmp (name, sym->name) == 0)
+      return sym;
+
+  return NULL;
 }
 
 bool
@@ -160,10 +468,15 @@ rtems_rtl_symbol_global_add (rtems_rtl_obj*       obj,
     for (b = 0; b < sizeof (void*); ++b, ++s)
       copy_voidp.data[b] = esyms[s];
     sym->value = copy_voidp.value;
+    rtems_rtl_symbol_set_hash (sym);
     if (rtems_rtl_trace (RTEMS_RTL_TRACE_GLOBAL_SYM))
       printf ("rtl: esyms: %s -> %8p\n", sym->name, sym->value);
-    if (rtems_rtl_symbol_global_find (sym->name) == NULL)
-      rtems_rtl_symbol_global_insert (symbols, sym);
+    if (!rtems_rtl_symbol_global_insert (symbols, sym))
+    {
+      obj->global_syms = sym - obj->global_table;
+      rtems_rtl_symbol_obj_erase (obj);
+      return false;
+    }
     ++sym;
   }
 
@@ -175,27 +488,15 @@ rtems_rtl_symbol_global_add (rtems_rtl_obj*       obj,
 rtems_rtl_obj_sym*
 rtems_rtl_symbol_global_find (const char* name)
 {
-  rtems_rtl_symbols*   symbols;
-  uint_fast32_t        hash;
-  rtems_chain_control* bucket;
-  rtems_chain_node*    node;
+  rtems_rtl_symbols*     symbols;
+  rtems_rtl_symbol_slot* slot;
 
   symbols = rtems_rtl_global_symbols ();
 
-  hash = rtems_rtl_symbol_hash (name);
-  bucket = &symbols->buckets[hash % symbols->nbuckets];
-  node = rtems_chain_first (bucket);
-
-  while (!rtems_chain_is_tail (bucket, node))
-  {
-    rtems_rtl_obj_sym* sym = (rtems_rtl_obj_sym*) node;
-    /*
-     * Use the hash. I could add this to the symbol but it uses more memory.
-     */
-    if (strcmp (name, sym->name) == 0)
-      return sym;
-    node = rtems_chain_next (node);
-  }
+  slot = rtems_rtl_symbol_slot_find (symbols, name,
+                                     rtems_rtl_symbol_hash (name));
+  if (slot)
+    return slot->sym;
 
   return NULL;
 }
@@ -204,27 +505,18 @@ rtems_rtl_obj_sym*
 rtems_rtl_symbol_obj_find (rtems_rtl_obj* obj, const char* name)
 {
   rtems_rtl_obj_sym* sym;
-  size_t             s;
   /*
    * Check the object file's symbols first. If not found search the
    * global symbol table.
    */
-  if (obj->local_syms)
-  {
-    for (s = 0, sym = obj->local_table; s < obj->local_syms; ++s, ++sym)
-      if (strcmp (name, sym->name) == 0)
-        return sym;
-  }
-  if (obj->global_syms)
-  {
-    for (s = 0, sym = obj->global_table; s < obj->global_syms; ++s, ++sym)
-      if (strcmp (name, sym->name) == 0)
-        return sym;
-  }
+  sym = rtems_rtl_symbol_obj_lookup (obj, name,
+                                     rtems_rtl_symbol_hash (name), false);
+  if (sym)
+    return sym;
   return rtems_rtl_symbol_global_find (name);
 }
 
-void
+bool
 rtems_rtl_symbol_obj_add (rtems_rtl_obj* obj)
 {
   rtems_rtl_symbols* symbols;
@@ -233,8 +525,22 @@ rtems_rtl_symbol_obj_add (rtems_rtl_obj* obj)
 
   symbols = rtems_rtl_global_symbols ();
 
+  /*
+   * Building the index sets the hashes of the symbols.
+   */
+  if (!rtems_rtl_symbol_obj_index (obj))
+  {
+    for (s = 0, sym = obj->global_table; s < obj->global_syms; ++s, ++sym)
+      rtems_rtl_symbol_set_hash (sym);
+  }
+
   for (s = 0, sym = obj->global_table; s < obj->global_syms; ++s, ++sym)
-    rtems_rtl_symbol_global_insert (symbols, sym);
+  {
+    if (!rtems_rtl_symbol_global_insert (symbols, sym))
+      return false;
+  }
+
+  return true;
 }
 
 void
@@ -242,6 +548,7 @@ rtems_rtl_symbol_obj_erase_local (rtems_rtl_obj* obj)
 {
   if (obj->local_table)
   {
+    rtems_rtl_symbol_obj_index_free (obj);
     rtems_rtl_alloc_del (RTEMS_RTL_ALLOC_SYMBOL, obj->local_table);
     obj->local_table = NULL;
     obj->local_size = 0;
@@ -249,17 +556,66 @@ rtems_rtl_symbol_obj_erase_local (rtems_rtl_obj* obj)
   }
 }
 
+/*
+ * Remove the symbol from the global table if it is the symbol the table
+ * holds and look for another object file exporting the name to take its
+ * place.
+ */
+static void
+rtems_rtl_symbol_global_remove (rtems_rtl_symbols* symbols,
+                                rtems_rtl_obj*     obj,
+                                rtems_rtl_obj_sym* sym)
+{
+  rtems_rtl_symbol_slot* slot;
+  rtems_rtl_data*        rtl;
+  rtems_chain_node*      node;
+
+  slot = rtems_rtl_symbol_slot_find (symbols, sym->name, sym->hash);
+  if ((slot == NULL) || (slot->sym != sym))
+    return;
+
+  slot->sym = &deleted_sym;
+  --symbols->count;
+  ++symbols->deleted;
+
+  rtl = rtems_rtl_data_unprotected ();
+  if (rtl == NULL)
+    return;
+
+  node = rtems_chain_first (&rtl->objects);
+  while (!rtems_chain_is_tail (&rtl->objects, node))
+  {
+    rtems_rtl_obj* other = (rtems_rtl_obj*) node;
+    if (other != obj)
+    {
+      rtems_rtl_obj_sym* replacement;
+      replacement = rtems_rtl_symbol_obj_lookup (other, sym->name,
+                                                 sym->hash, true);
+      if (replacement)
+      {
+        /*
+         * The slot just deleted means there is room.
+         */
+        rtems_rtl_symbol_slot_insert (symbols, replacement);
+        return;
+      }
+    }
+    node = rtems_chain_next (node);
+  }
+}
+
 void
 rtems_rtl_symbol_obj_erase (rtems_rtl_obj* obj)
 {
   rtems_rtl_symbol_obj_erase_local (obj);
+  rtems_rtl_symbol_obj_index_free (obj);
   if (obj->global_table)
   {
+    rtems_rtl_symbols* symbols = rtems_rtl_global_symbols ();
     rtems_rtl_obj_sym* sym;
     size_t             s;
     for (s = 0, sym = obj->global_table; s < obj->global_syms; ++s, ++sym)
-        if (!rtems_chain_is_node_off_chain (&sym->node))
-          rtems_chain_extract (&sym->node);
+      rtems_rtl_symbol_global_remove (symbols, obj, sym);
     rtems_rtl_alloc_del (RTEMS_RTL_ALLOC_SYMBOL, obj->global_table);
     obj->global_table = NULL;
     obj->global_size = 0;
@@ -46,19 +46,28 @@ rtems_rtl_unresolved_block_alloc (rtems_rtl_unresolved* unresolved)
   return block;
 }
 
+/*
+ * The number of records a name of the length, including the nul, occupies.
+ * Round up.
+ */
 static size_t
-rtems_rtl_unresolved_name_recs (const char* name)
+rtems_rtl_unresolved_length_recs (size_t length)
 {
-  size_t length = strlen (name);
   return ((length + sizeof(rtems_rtl_unresolv_name) - 1) /
           sizeof(rtems_rtl_unresolv_name));
 }
 
+static size_t
+rtems_rtl_unresolved_name_recs (const char* name)
+{
+  return rtems_rtl_unresolved_length_recs (strlen (name) + 1);
+}
+
 static int
 rtems_rtl_unresolved_rec_index (rtems_rtl_unresolv_block* block,
                                 rtems_rtl_unresolv_rec* rec)
 {
-  return (rec - &block->rec) / sizeof (rtems_rtl_unresolv_rec);
+  return rec - &block->rec;
 }
 
 static rtems_rtl_unresolv_rec*
@@ -81,11 +90,7 @@ rtems_rtl_unresolved_rec_next (rtems_rtl_unresolv_rec* rec)
       break;
 
     case rtems_rtl_unresolved_name:
-      /*
-       * Determine how many records the name occupies. Round up.
-       */
-      rec += ((rec->rec.name.length + sizeof(rtems_rtl_unresolv_name) - 1) /
-              sizeof(rtems_rtl_unresolv_name));
+      rec += rtems_rtl_unresolved_length_recs (rec->rec.name.length);
       break;
 
     case rtems_rtl_unresolved_reloc:
@@ -103,8 +108,9 @@ static bool
 rtems_rtl_unresolved_rec_is_last (rtems_rtl_unresolv_block* block,
                                   rtems_rtl_unresolv_rec*   rec)
 {
-  int index = (rec - &block->rec) / sizeof (rec);
-  return !rec || (index >= block->recs) || (rec->type == rtems_rtl_unresolved_empty);
+  return !rec ||
+    (rtems_rtl_unresolved_rec_index (block, rec) >= block->recs) ||
+    (rec->type == rtems_rtl_unresolved_empty);
 }
 
 static rtems_rtl_unresolv_rec*
@@ -131,8 +137,8 @@ rtems_rtl_unresolved_find_name (rtems_rtl_unresolved* unresolved,
     {
       if (rec->type == rtems_rtl_unresolved_name)
       {
-        if ((rec->rec.name.length == length)
-            && (strcmp (rec->rec.name.name, name)))
+        if ((rec->rec.name.length == (length + 1))
+            && (strcmp (rec->rec.name.name, name) == 0))
         {
           if (update_refcount)
             ++rec->rec.name.refs;
@@ -222,6 +228,147 @@ rtems_rtl_unresolved_resolve_iterator (rtems_rtl_unresolv_rec* rec,
   return false;
 }
 
+/**
+ * A name in a batch resolve.
+ */
+typedef struct rtems_rtl_unresolved_batch_name
+{
+  rtems_rtl_unresolv_rec* rec;    /**< The name record. */
+  rtems_rtl_obj_sym*      sym;    /**< The symbol, NULL if not found. */
+  uint16_t                index;  /**< The name's index after compacting. */
+} rtems_rtl_unresolved_batch_name;
+
+/**
+ * Struct to pass the batch resolve data in the iterator.
+ */
+typedef struct rtems_rtl_unresolved_batch_data
+{
+  rtems_rtl_unresolved_batch_name* names;  /**< The names in index order. */
+  size_t                           count;  /**< The number of names. */
+} rtems_rtl_unresolved_batch_data;
+
+static bool
+rtems_rtl_unresolved_batch_count (rtems_rtl_unresolv_rec* rec,
+                                  void*                   data)
+{
+  if (rec->type == rtems_rtl_unresolved_name)
+  {
+    rtems_rtl_unresolved_batch_data* bd;
+    bd = (rtems_rtl_unresolved_batch_data*) data;
+    ++bd->count;
+  }
+  return false;
+}
+
+static bool
+rtems_rtl_unresolved_batch_lookup (rtems_rtl_unresolv_rec* rec,
+                                   void*                   data)
+{
+  if (rec->type == rtems_rtl_unresolved_name)
+  {
+    rtems_rtl_unresolved_batch_data* bd;
+    rtems_rtl_unresolved_batch_name* name;
+    bd = (rtems_rtl_unresolved_batch_data*) data;
+    name = &bd->names[bd->count];
+    ++bd->count;
+
+    name->rec = rec;
+    name->sym = rtems_rtl_symbol_global_find (rec->rec.name.name);
+
+    if (rtems_rtl_trace (RTEMS_RTL_TRACE_UNRESOLVED))
+      printf ("rtl: unresolv: lookup: %zu: %s: %s\n",
+              bd->count, rec->rec.name.name, name->sym ? "found" : "missing");
+  }
+  return false;
+}
+
+static bool
+rtems_rtl_unresolved_batch_reloc (rtems_rtl_unresolv_rec* rec,
+                                  void*                   data)
+{
+  if ((rec->type == rtems_rtl_unresolved_reloc) && rec->rec.reloc.obj)
+  {
+    rtems_rtl_unresolved_batch_data* bd;
+    rtems_rtl_unresolved_batch_name* name;
+    bd = (rtems_rtl_unresolved_batch_data*) data;
+
+    if ((rec->rec.reloc.name == 0) || (rec->rec.reloc.name > bd->count))
+      return false;
+
+    name = &bd->names[rec->rec.reloc.name - 1];
+    if (name->sym)
+    {
+      if (rtems_rtl_trace (RTEMS_RTL_TRACE_UNRESOLVED))
+        printf ("rtl: unresolv: resolve reloc: %s\n",
+                name->rec->rec.name.name);
+
+      rtems_rtl_obj_relocate_unresolved (&rec->rec.reloc, name->sym);
+
+      rec->rec.reloc.obj = NULL;
+      if (name->rec->rec.name.refs)
+        --name->rec->rec.name.refs;
+    }
+  }
+  return false;
+}
+
+static bool
+rtems_rtl_unresolved_batch_renumber (rtems_rtl_unresolv_rec* rec,
+                                     void*                   data)
+{
+  if ((rec->type == rtems_rtl_unresolved_reloc) && rec->rec.reloc.obj)
+  {
+    rtems_rtl_unresolved_batch_data* bd;
+    bd = (rtems_rtl_unresolved_batch_data*) data;
+    if ((rec->rec.reloc.name != 0) && (rec->rec.reloc.name <= bd->count))
+      rec->rec.reloc.name = bd->names[rec->rec.reloc.name - 1].index;
+  }
+  return false;
+}
+
+/*
+ * Resolve the table in a fixed number of passes. Each name is looked up once
+ * and each relocation record is visited once, where resolving name by name
+ * visits every record for each name found. The names left are given their
+ * index after compacting so the relocation records still reference them.
+ */
+static bool
+rtems_rtl_unresolved_resolve_batch (void)
+{
+  rtems_rtl_unresolved_batch_data bd;
+  uint16_t                        index;
+  size_t                          n;
+
+  bd.names = NULL;
+  bd.count = 0;
+  rtems_rtl_unresolved_interate (rtems_rtl_unresolved_batch_count, &bd);
+
+  if (bd.count == 0)
+    return true;
+
+  bd.names = rtems_rtl_alloc_new (RTEMS_RTL_ALLOC_OBJECT,
+                                  bd.count * sizeof (bd.names[0]),
+                                  true);
+  if (!bd.names)
+    return false;
+
+  bd.count = 0;
+  rtems_rtl_unresolved_interate (rtems_rtl_unresolved_batch_lookup, &bd);
+  rtems_rtl_unresolved_interate (rtems_rtl_unresolved_batch_reloc, &bd);
+
+  for (n = 0, index = 0; n < bd.count; ++n)
+  {
+    if (bd.names[n].rec->rec.name.refs != 0)
+      bd.names[n].index = ++index;
+  }
+
+  rtems_rtl_unresolved_interate (rtems_rtl_unresolved_batch_renumber, &bd);
+
+  rtems_rtl_alloc_del (RTEMS_RTL_ALLOC_OBJECT, bd.names);
+
+  return true;
+}
+
 static void
 rtems_rtl_unresolved_clean_block (rtems_rtl_unresolv_block* block,
                                   rtems_rtl_unresolv_rec*   rec,
@@ -233,13 +380,17 @@ rtems_rtl_unresolved_clean_block (rtems_rtl_unresolv_block* block,
     (block->recs - index - count) * sizeof (rtems_rtl_unresolv_rec);
   if (bytes)
     memmove (rec, rec + count, bytes);
-  --block->recs;
+  block->recs -= count;
   bytes = count * sizeof (rtems_rtl_unresolv_rec);
   memset (&block->rec + block->recs, 0, bytes);
 }
 
+/*
+ * Remove the resolved relocation records and if the names have been
+ * renumbered the names no longer referenced.
+ */
 static void
-rtems_rtl_unresolved_compact (void)
+rtems_rtl_unresolved_compact (bool names)
 {
   rtems_rtl_unresolved* unresolved = rtems_rtl_unresolved_unprotected ();
   if (unresolved)
@@ -261,7 +412,7 @@ rtems_rtl_unresolved_compact (void)
 
         if (rec->type == rtems_rtl_unresolved_name)
         {
-          if (rec->rec.name.refs == 0)
+          if (names && (rec->rec.name.refs == 0))
           {
             size_t name_recs = rtems_rtl_unresolved_name_recs (rec->rec.name.name);
             rtems_rtl_unresolved_clean_block (block, rec, name_recs,
@@ -286,7 +437,7 @@ rtems_rtl_unresolved_compact (void)
       if (block->recs == 0)
       {
         rtems_chain_extract (node);
-        free (block);
+        rtems_rtl_alloc_del (RTEMS_RTL_ALLOC_EXTERNAL, block);
       }
 
       node = prev;
@@ -311,7 +462,7 @@ rtems_rtl_unresolved_table_close (rtems_rtl_unresolved* unresolved)
   while (!rtems_chain_is_tail (&unresolved->blocks, node))
   {
     rtems_chain_node* next = rtems_chain_next (node);
-    free (node);
+    rtems_rtl_alloc_del (RTEMS_RTL_ALLOC_EXTERNAL, node);
     node = next;
   }
 }
@@ -397,12 +548,16 @@ rtems_rtl_unresolved_add (rtems_rtl_obj*        obj,
    */
   if (name_index < 0)
   {
-    rtems_rtl_unresolv_block* name_block = block;
+    rtems_rtl_unresolv_block* name_block;
 
     /*
-     * Is there enough room to fit the name ? It not add a new block.
+     * A name's index is its position in the table so new names are only
+     * added to the last block. Is there enough room to fit the name ? It not
+     * add a new block.
      */
-    if (name_recs > (unresolved->block_recs - block->recs))
+    name_block =
+      (rtems_rtl_unresolv_block*) rtems_chain_last (&unresolved->blocks);
+    if (name_recs > (unresolved->block_recs - name_block->recs))
     {
       name_block = rtems_rtl_unresolved_block_alloc (unresolved);
       if (!name_block)
@@ -413,8 +568,8 @@ rtems_rtl_unresolved_add (rtems_rtl_obj*        obj,
     rec->type = rtems_rtl_unresolved_name;
     rec->rec.name.refs = 1;
     rec->rec.name.length = strlen (name) + 1;
-    memcpy ((void*) &rec->rec.name.name[0], name, rec->rec.name.length + 1);
-    block->recs += name_recs;
+    memcpy ((void*) &rec->rec.name.name[0], name, rec->rec.name.length);
+    name_block->recs += name_recs;
     name_index = 0 - name_index;
 
     /*
@@ -450,11 +605,20 @@ rtems_rtl_unresolved_resolve (void)
   rtems_rtl_unresolved_reloc_data rd;
   if (rtems_rtl_trace (RTEMS_RTL_TRACE_UNRESOLVED))
     printf ("rtl: unresolv: global resolve\n");
+  if (rtems_rtl_unresolved_resolve_batch ())
+  {
+    rtems_rtl_unresolved_compact (true);
+    return;
+  }
+  /*
+   * No memory for the batch. Resolve name by name and keep the names so the
+   * name indices in the relocation records stay valid.
+   */
   rd.name = 0;
   rd.name_rec = NULL;
   rd.sym = NULL;
   rtems_rtl_unresolved_interate (rtems_rtl_unresolved_resolve_iterator, &rd);
-  rtems_rtl_unresolved_compact ();
+  rtems_rtl_unresolved_compact (false);
 }
 
 bool
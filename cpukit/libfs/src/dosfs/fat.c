@@ -449,6 +449,49 @@ fat_cluster_write(
       return bytes_written;
 }
 
+/* fat_cluster_direct --
+ *     This function transfers a whole cluster between the device filesystem
+ *     is mounted on and a user buffer without copying it through the bdbuf
+ *     cache. Resident blocks of the cluster are kept coherent by bdbuf.
+ *
+ * PARAMETERS:
+ *     fs_info            - FS info
+ *     cln                - cluster number to transfer
+ *     buff               - buffer provided by user
+ *     read               - true to read the cluster, false to write it
+ *
+ * RETURNS:
+ *     bytes transferred on success, 0 if the buffer is not suitable for a
+ *     direct transfer, or -1 if error occured and errno set appropriately
+ */
+ssize_t
+fat_cluster_direct(
+    fat_fs_info_t                        *fs_info,
+    const uint32_t                        cln,
+    void                                 *buff,
+    const bool                            read)
+{
+    rtems_status_code sc;
+    uint32_t          blk = fat_cluster_num_to_block_num(fs_info, cln);
+    uint32_t          blocks = fs_info->vol.bpc >> fs_info->vol.bytes_per_block_log2;
+
+    if (!rtems_bdbuf_is_direct_buffer(buff))
+        return 0;
+
+    /* the sector cache may hold a block of the cluster */
+    if (fat_buf_release(fs_info) != RC_OK)
+        return -1;
+
+    if (read)
+        sc = rtems_bdbuf_read_direct(fs_info->vol.dd, blk, blocks, buff);
+    else
+        sc = rtems_bdbuf_write_direct(fs_info->vol.dd, blk, blocks, buff);
+    if (sc != RTEMS_SUCCESSFUL)
+        rtems_set_errno_and_return_minus_one(EIO);
+
+    return fs_info->vol.bpc;
+}
+
 static bool is_cluster_aligned(const fat_vol_t *vol, uint32_t sec_num)
 {
     return (sec_num & (vol->spc - 1)) == 0;
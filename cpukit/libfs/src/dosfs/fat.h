@@ -505,6 +505,12 @@ fat_cluster_write(fat_fs_info_t                    *fs_info,
                     uint32_t                          count,
                     const void                       *buff);
 
+ssize_t
+fat_cluster_direct(fat_fs_info_t                    *fs_info,
+                   uint32_t                          cln,
+                   void                             *buff,
+                   bool                              read);
+
 ssize_t
 fat_sector_write(fat_fs_info_t                        *fs_info,
                  uint32_t                              start,
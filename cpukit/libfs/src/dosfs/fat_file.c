@@ -266,10 +266,9 @@ fat_file_close(
     return rc;
 }
 
-/* fat_file_read --
- *     Read 'count' bytes from 'start' position from fat-file. This
- *     interface hides the architecture of fat-file, represents it as
- *     linear file
+/* fat_file_do_read --
+ *     Read 'count' bytes from 'start' position from fat-file. Whole
+ *     clusters are read directly into the user buffer if 'direct' is set.
  *
  * PARAMETERS:
  *     fs_info  - FS info
@@ -277,18 +276,20 @@ fat_file_close(
  *     start    - offset in fat-file (in bytes) to read from
  *     count    - count of bytes to read
  *     buf      - buffer provided by user
+ *     direct   - bypass the bdbuf cache for whole clusters
  *
  * RETURNS:
  *     the number of bytes read on success, or -1 if error occured (errno
  *     set appropriately)
  */
-ssize_t
-fat_file_read(
+static ssize_t
+fat_file_do_read(
     fat_fs_info_t                        *fs_info,
     fat_file_fd_t                        *fat_fd,
     uint32_t                              start,
     uint32_t                              count,
-    uint8_t                              *buf
+    uint8_t                              *buf,
+    bool                                  direct
 )
 {
     int            rc = RC_OK;
@@ -343,11 +344,18 @@ fat_file_read(
     {
         c = MIN(count, (fs_info->vol.bpc - ofs));
 
-        sec = fat_cluster_num_to_sector_num(fs_info, cur_cln);
-        sec += (ofs >> fs_info->vol.sec_log2);
-        byte = ofs & (fs_info->vol.bps - 1);
+        ret = 0;
+        if (direct && c == fs_info->vol.bpc)
+            ret = fat_cluster_direct(fs_info, cur_cln, buf + cmpltd, true);
 
-        ret = _fat_block_read(fs_info, sec, byte, c, buf + cmpltd);
+        if (ret == 0)
+        {
+            sec = fat_cluster_num_to_sector_num(fs_info, cur_cln);
+            sec += (ofs >> fs_info->vol.sec_log2);
+            byte = ofs & (fs_info->vol.bps - 1);
+
+            ret = _fat_block_read(fs_info, sec, byte, c, buf + cmpltd);
+        }
         if ( ret < 0 )
             return -1;
 
@@ -370,6 +378,62 @@ fat_file_read(
     return cmpltd;
 }
 
+/* fat_file_read --
+ *     Read 'count' bytes from 'start' position from fat-file. This
+ *     interface hides the architecture of fat-file, represents it as
+ *     linear file
+ *
+ * PARAMETERS:
+ *     fs_info  - FS info
+ *     fat_fd   - fat-file descriptor
+ *     start    - offset in fat-file (in bytes) to read from
+ *     count    - count of bytes to read
+ *     buf      - buffer provided by user
+ *
+ * RETURNS:
+ *     the number of bytes read on success, or -1 if error occured (errno
+ *     set appropriately)
+ */
+ssize_t
+fat_file_read(
+    fat_fs_info_t                        *fs_info,
+    fat_file_fd_t                        *fat_fd,
+    uint32_t                              start,
+    uint32_t                              count,
+    uint8_t                              *buf
+)
+{
+    return fat_file_do_read(fs_info, fat_fd, start, count, buf, false);
+}
+
+/* fat_file_read_direct --
+ *     Read 'count' bytes from 'start' position from fat-file like
+ *     fat_file_read(), but whole clusters are read directly into the user
+ *     buffer bypassing the bdbuf cache if the buffer is suitably aligned
+ *
+ * PARAMETERS:
+ *     fs_info  - FS info
+ *     fat_fd   - fat-file descriptor
+ *     start    - offset in fat-file (in bytes) to read from
+ *     count    - count of bytes to read
+ *     buf      - buffer provided by user
+ *
+ * RETURNS:
+ *     the number of bytes read on success, or -1 if error occured (errno
+ *     set appropriately)
+ */
+ssize_t
+fat_file_read_direct(
+    fat_fs_info_t                        *fs_info,
+    fat_file_fd_t                        *fat_fd,
+    uint32_t                              start,
+    uint32_t                              count,
+    uint8_t                              *buf
+)
+{
+    return fat_file_do_read(fs_info, fat_fd, start, count, buf, true);
+}
+
 /* fat_is_fat12_or_fat16_root_dir --
  *     Returns true for FAT12 root directories respectively FAT16
  *     root directories. Returns false for everything else.
@@ -399,6 +463,7 @@ static bool
  *     start            - offset(in bytes) to write from
  *     count            - count
  *     buf              - buffer provided by user
+ *     direct           - bypass the bdbuf cache for whole clusters
  *
  * RETURNS:
  *     number of bytes actually written to the file on success, or -1 if
@@ -410,7 +475,8 @@ fat_file_write_fat32_or_non_root_dir(
      fat_file_fd_t                        *fat_fd,
      const uint32_t                        start,
      const uint32_t                        count,
-     const uint8_t                        *buf)
+     const uint8_t                        *buf,
+     const bool                            direct)
 {
     int            rc = RC_OK;
     uint32_t       cmpltd = 0;
@@ -431,11 +497,19 @@ fat_file_write_fat32_or_non_root_dir(
         {
             c = MIN(bytes_to_write, (fs_info->vol.bpc - ofs_cln));
 
-            ret = fat_cluster_write(fs_info,
-                                      cur_cln,
-                                      ofs_cln,
-                                      c,
-                                      &buf[cmpltd]);
+            ret = 0;
+            if (direct && c == fs_info->vol.bpc)
+              ret = fat_cluster_direct(fs_info,
+                                       cur_cln,
+                                       RTEMS_DECONST(uint8_t *, &buf[cmpltd]),
+                                       false);
+
+            if (0 == ret)
+              ret = fat_cluster_write(fs_info,
+                                        cur_cln,
+                                        ofs_cln,
+                                        c,
+                                        &buf[cmpltd]);
             if (0 > ret)
               rc = -1;
 
@@ -464,10 +538,10 @@ fat_file_write_fat32_or_non_root_dir(
       return cmpltd;
 }
 
-/* fat_file_write --
+/* fat_file_do_write --
  *     Write 'count' bytes of data from user supplied buffer to fat-file
- *     starting at offset 'start'. This interface hides the architecture
- *     of fat-file, represents it as linear file
+ *     starting at offset 'start'. Whole clusters are written directly from
+ *     the user buffer if 'direct' is set.
  *
  * PARAMETERS:
  *     fs_info  - FS info
@@ -475,18 +549,20 @@ fat_file_write_fat32_or_non_root_dir(
  *     start    - offset(in bytes) to write from
  *     count    - count
  *     buf      - buffer provided by user
+ *     direct   - bypass the bdbuf cache for whole clusters
  *
  * RETURNS:
  *     number of bytes actually written to the file on success, or -1 if
  *     error occured (errno set appropriately)
  */
-ssize_t
-fat_file_write(
+static ssize_t
+fat_file_do_write(
     fat_fs_info_t                        *fs_info,
     fat_file_fd_t                        *fat_fd,
     uint32_t                              start,
     uint32_t                              count,
-    const uint8_t                        *buf
+    const uint8_t                        *buf,
+    bool                                  direct
     )
 {
     int            rc = RC_OK;
@@ -540,7 +616,8 @@ fat_file_write(
                                                        fat_fd,
                                                        start,
                                                        count,
-                                                       buf);
+                                                       buf,
+                                                       direct);
             if (0 > ret)
               rc = -1;
             else
@@ -553,6 +630,63 @@ fat_file_write(
         return cmpltd;
 }
 
+/* fat_file_write --
+ *     Write 'count' bytes of data from user supplied buffer to fat-file
+ *     starting at offset 'start'. This interface hides the architecture
+ *     of fat-file, represents it as linear file
+ *
+ * PARAMETERS:
+ *     fs_info  - FS info
+ *     fat_fd   - fat-file descriptor
+ *     start    - offset(in bytes) to write from
+ *     count    - count
+ *     buf      - buffer provided by user
+ *
+ * RETURNS:
+ *     number of bytes actually written to the file on success, or -1 if
+ *     error occured (errno set appropriately)
+ */
+ssize_t
+fat_file_write(
+    fat_fs_info_t                        *fs_info,
+    fat_file_fd_t                        *fat_fd,
+    uint32_t                              start,
+    uint32_t                              count,
+    const uint8_t                        *buf
+    )
+{
+    return fat_file_do_write(fs_info, fat_fd, start, count, buf, false);
+}
+
+/* fat_file_write_direct --
+ *     Write 'count' bytes of data from user supplied buffer to fat-file
+ *     starting at offset 'start' like fat_file_write(), but whole clusters
+ *     are written directly from the user buffer bypassing the bdbuf cache if
+ *     the buffer is suitably aligned
+ *
+ * PARAMETERS:
+ *     fs_info  - FS info
+ *     fat_fd   - fat-file descriptor
+ *     start    - offset(in bytes) to write from
+ *     count    - count
+ *     buf      - buffer provided by user
+ *
+ * RETURNS:
+ *     number of bytes actually written to the file on success, or -1 if
+ *     error occured (errno set appropriately)
+ */
+ssize_t
+fat_file_write_direct(
+    fat_fs_info_t                        *fs_info,
+    fat_file_fd_t                        *fat_fd,
+    uint32_t                              start,
+    uint32_t                              count,
+    const uint8_t                        *buf
+    )
+{
+    return fat_file_do_write(fs_info, fat_fd, start, count, buf, true);
+}
+
 /* fat_file_extend --
  *     Extend fat-file. If new length less than current fat-file size -
  *     do nothing. Otherwise calculate necessary count of clusters to add,
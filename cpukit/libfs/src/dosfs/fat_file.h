@@ -209,6 +209,20 @@ fat_file_write(fat_fs_info_t                        *fs_info,
                uint32_t                              count,
                const uint8_t                        *buf);
 
+ssize_t
+fat_file_read_direct(fat_fs_info_t                        *fs_info,
+                     fat_file_fd_t                        *fat_fd,
+                     uint32_t                              start,
+                     uint32_t                              count,
+                     uint8_t                              *buf);
+
+ssize_t
+fat_file_write_direct(fat_fs_info_t                        *fs_info,
+                      fat_file_fd_t                        *fat_fd,
+                      uint32_t                              start,
+                      uint32_t                              count,
+                      const uint8_t                        *buf);
+
 int
 fat_file_extend(fat_fs_info_t                        *fs_info,
                 fat_file_fd_t                        *fat_fd,
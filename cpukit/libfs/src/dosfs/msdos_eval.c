@@ -83,7 +83,39 @@ static rtems_filesystem_eval_path_generic_status msdos_eval_token(
   } else {
     rtems_filesystem_location_info_t *currentloc =
       rtems_filesystem_eval_path_get_currentloc(ctx);
-    int rc = msdos_find_name(currentloc, token, tokenlen);
+    fat_file_fd_t *fat_fd = currentloc->node_access;
+    uintptr_t dir = fat_fd->cln;
+    uintptr_t node;
+    uintptr_t data;
+    int rc;
+
+    /*
+     * Only missing names are cached.  The directory is identified by its
+     * first cluster.
+     */
+    if (
+      rtems_filesystem_eval_path_cache_lookup(
+        currentloc->mt_entry,
+        dir,
+        token,
+        tokenlen,
+        &node,
+        &data
+      ) == RTEMS_FILESYSTEM_EVAL_PATH_CACHE_NO_ENTRY
+    ) {
+      rc = MSDOS_NAME_NOT_FOUND_ERR;
+    } else {
+      rc = msdos_find_name(currentloc, token, tokenlen);
+
+      if (rc == MSDOS_NAME_NOT_FOUND_ERR) {
+        rtems_filesystem_eval_path_cache_insert_no_entry(
+          currentloc->mt_entry,
+          dir,
+          token,
+          tokenlen
+        );
+      }
+    }
 
     if (rc == RC_OK) {
       rtems_filesystem_eval_path_clear_token(ctx);
@@ -52,8 +52,12 @@ msdos_file_read(rtems_libio_t *iop, void *buffer, size_t count)
 
     msdos_fs_lock(fs_info);
 
-    ret = fat_file_read(&fs_info->fat, fat_fd, iop->offset, count,
-                        buffer);
+    if (rtems_libio_iop_is_direct(iop))
+        ret = fat_file_read_direct(&fs_info->fat, fat_fd, iop->offset, count,
+                                   buffer);
+    else
+        ret = fat_file_read(&fs_info->fat, fat_fd, iop->offset, count,
+                            buffer);
     if (ret > 0)
         iop->offset += ret;
 
@@ -86,8 +90,12 @@ msdos_file_write(rtems_libio_t *iop,const void *buffer, size_t count)
     if (rtems_libio_iop_is_append(iop))
         iop->offset = fat_fd->fat_file_size;
 
-    ret = fat_file_write(&fs_info->fat, fat_fd, iop->offset, count,
-                         buffer);
+    if (rtems_libio_iop_is_direct(iop))
+        ret = fat_file_write_direct(&fs_info->fat, fat_fd, iop->offset, count,
+                                    buffer);
+    else
+        ret = fat_file_write(&fs_info->fat, fat_fd, iop->offset, count,
+                             buffer);
     if (ret < 0)
     {
         msdos_fs_unlock(fs_info);
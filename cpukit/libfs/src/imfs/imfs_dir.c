@@ -19,6 +19,9 @@
 
 #include <rtems/imfs.h>
 
+#include <stdlib.h>
+#include <string.h>
+
 IMFS_jnode_t *IMFS_node_initialize_directory(
   IMFS_jnode_t *node,
   void *arg
@@ -50,3 +53,150 @@ IMFS_jnode_t *IMFS_node_remove_directory( IMFS_jnode_t *node )
 
   return &dir->Node;
 }
+
+IMFS_jnode_t *IMFS_node_initialize_hashed_directory(
+  IMFS_jnode_t *node,
+  void *arg
+)
+{
+  node->flags |= IMFS_NODE_FLAG_HASHED_DIRECTORY;
+
+  return IMFS_node_initialize_directory( node, arg );
+}
+
+void IMFS_node_destroy_hashed_directory( IMFS_jnode_t *node )
+{
+  IMFS_directory_t *dir = (IMFS_directory_t *) node;
+
+  free( dir->buckets );
+  IMFS_node_destroy_default( node );
+}
+
+static uint32_t IMFS_directory_hash( const char *name, size_t namelen )
+{
+  uint32_t hash = 2166136261U;
+  size_t i;
+
+  for ( i = 0; i < namelen; ++i ) {
+    hash = ( hash ^ (uint8_t) name[ i ] ) * 16777619U;
+  }
+
+  return hash;
+}
+
+static IMFS_jnode_t **IMFS_directory_bucket(
+  const IMFS_directory_t *dir,
+  const char *name,
+  size_t namelen
+)
+{
+  uint32_t hash = IMFS_directory_hash( name, namelen );
+
+  return &dir->buckets[ hash & ( dir->bucket_count - 1 ) ];
+}
+
+static void IMFS_directory_hash_link(
+  IMFS_directory_t *dir,
+  IMFS_jnode_t *entry_node
+)
+{
+  IMFS_jnode_t **bucket =
+    IMFS_directory_bucket( dir, entry_node->name, entry_node->namelen );
+
+  entry_node->hash_next = *bucket;
+  *bucket = entry_node;
+}
+
+/*
+ *  Rehashes all entries of the directory.  In case no memory is available
+ *  the directory keeps its current buckets, or the linear search if it has
+ *  none.
+ */
+static bool IMFS_directory_hash_resize(
+  IMFS_directory_t *dir,
+  size_t bucket_count
+)
+{
+  IMFS_jnode_t **buckets;
+  rtems_chain_node *current;
+  rtems_chain_node *tail;
+
+  buckets = calloc( bucket_count, sizeof( *buckets ) );
+  if ( buckets == NULL ) {
+    return false;
+  }
+
+  free( dir->buckets );
+  dir->buckets = buckets;
+  dir->bucket_count = bucket_count;
+
+  current = rtems_chain_first( &dir->Entries );
+  tail = rtems_chain_tail( &dir->Entries );
+
+  while ( current != tail ) {
+    IMFS_directory_hash_link( dir, (IMFS_jnode_t *) current );
+    current = rtems_chain_next( current );
+  }
+
+  return true;
+}
+
+void IMFS_directory_hash_insert(
+  IMFS_directory_t *dir,
+  IMFS_jnode_t *entry_node
+)
+{
+  if (
+    dir->entry_count >= IMFS_DIRECTORY_HASH_MIN_ENTRIES
+      && dir->entry_count > dir->bucket_count
+  ) {
+    size_t bucket_count = dir->bucket_count != 0 ?
+      2 * dir->bucket_count : 2 * IMFS_DIRECTORY_HASH_MIN_ENTRIES;
+
+    /* The new buckets contain all entries including the new one */
+    if ( IMFS_directory_hash_resize( dir, bucket_count ) ) {
+      return;
+    }
+  }
+
+  if ( dir->buckets != NULL ) {
+    IMFS_directory_hash_link( dir, entry_node );
+  }
+}
+
+void IMFS_directory_hash_remove(
+  IMFS_directory_t *dir,
+  IMFS_jnode_t *entry_node
+)
+{
+  IMFS_jnode_t **link =
+    IMFS_directory_bucket( dir, entry_node->name, entry_node->namelen );
+
+  while ( *link != entry_node ) {
+    IMFS_assert( *link != NULL );
+    link = &( *link )->hash_next;
+  }
+
+  *link = entry_node->hash_next;
+  entry_node->hash_next = NULL;
+}
+
+IMFS_jnode_t *IMFS_directory_hash_lookup(
+  const IMFS_directory_t *dir,
+  const char *name,
+  size_t namelen
+)
+{
+  IMFS_jnode_t *entry = *IMFS_directory_bucket( dir, name, namelen );
+
+  while ( entry != NULL ) {
+    if ( entry->namelen == namelen
+      && memcmp( entry->name, name, namelen ) == 0 ) {
+      return entry;
+    }
+
+    entry = entry->hash_next;
+  }
+
+  return NULL;
+}
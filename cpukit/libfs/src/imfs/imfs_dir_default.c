@@ -91,18 +91,9 @@ static ssize_t IMFS_dir_read(
 
 static size_t IMFS_directory_size( const IMFS_jnode_t *node )
 {
-  size_t size = 0;
   const IMFS_directory_t *dir = (const IMFS_directory_t *) node;
-  const rtems_chain_control *chain = &dir->Entries;
-  const rtems_chain_node *current = rtems_chain_immutable_first( chain );
-  const rtems_chain_node *tail = rtems_chain_immutable_tail( chain );
 
-  while ( current != tail ) {
-    size += sizeof( struct dirent );
-    current = rtems_chain_immutable_next( current );
-  }
-
-  return size;
+  return dir->entry_count * sizeof( struct dirent );
 }
 
 static int IMFS_stat_directory(
@@ -145,3 +136,13 @@ const IMFS_mknod_control IMFS_mknod_control_dir_default = {
   },
   .node_size = sizeof( IMFS_directory_t )
 };
+
+const IMFS_mknod_control IMFS_mknod_control_dir_hashed = {
+  {
+    .handlers = &IMFS_dir_default_handlers,
+    .node_initialize = IMFS_node_initialize_hashed_directory,
+    .node_remove = IMFS_node_remove_directory,
+    .node_destroy = IMFS_node_destroy_hashed_directory
+  },
+  .node_size = sizeof( IMFS_directory_t )
+};
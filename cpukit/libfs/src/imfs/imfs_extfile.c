@@ -0,0 +1,518 @@
+/**
+ * @file
+ *
+ * @brief IMFS Extent File Handlers
+ * @ingroup IMFS
+ */
+
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <rtems/imfs.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static IMFS_extfile_t *IMFS_iop_to_extfile( const rtems_libio_t *iop )
+{
+  return (IMFS_extfile_t *) iop->pathinfo.node_access;
+}
+
+/*
+ *  IMFS_extfile_locate
+ *
+ *  This routine maps a file position to its extent and the offset within
+ *  the extent.  It returns the size of the extent.
+ */
+static size_t IMFS_extfile_locate(
+  off_t     position,
+  uint32_t *extent,
+  size_t   *offset
+)
+{
+  uint32_t k;
+  off_t    begin;
+
+  if ( position < IMFS_EXTFILE_GROWTH_SIZE ) {
+    k = 0;
+
+    while (
+      position >= (off_t) IMFS_EXTFILE_MIN_EXTENT_SIZE * ((2 << k) - 1)
+    ) {
+      ++k;
+    }
+
+    *extent = k;
+    *offset = (size_t) ( position -
+      (off_t) IMFS_EXTFILE_MIN_EXTENT_SIZE * ((1 << k) - 1) );
+
+    return (size_t) IMFS_EXTFILE_MIN_EXTENT_SIZE << k;
+  }
+
+  begin = position - IMFS_EXTFILE_GROWTH_SIZE;
+  *extent = IMFS_EXTFILE_GROWTH_EXTENTS +
+    (uint32_t) ( begin / IMFS_EXTFILE_MAX_EXTENT_SIZE );
+  *offset = (size_t) ( begin % IMFS_EXTFILE_MAX_EXTENT_SIZE );
+
+  return IMFS_EXTFILE_MAX_EXTENT_SIZE;
+}
+
+/*
+ *  IMFS_extfile_publish
+ *
+ *  Installs the memory in an empty slot.  In case another writer was faster
+ *  the memory is freed and the already installed memory is returned.
+ */
+static void *IMFS_extfile_publish( Atomic_Uintptr *slot, void *memory )
+{
+  uintptr_t expected = 0;
+
+  if (
+    _Atomic_Compare_exchange_uintptr(
+      slot,
+      &expected,
+      (uintptr_t) memory,
+      ATOMIC_ORDER_RELEASE,
+      ATOMIC_ORDER_ACQUIRE
+    )
+  ) {
+    return memory;
+  }
+
+  free( memory );
+
+  return (void *) expected;
+}
+
+static Atomic_Uintptr *IMFS_extfile_get_table(
+  Atomic_Uintptr *slot,
+  bool            malloc_it
+)
+{
+  void *table;
+
+  table = (void *) _Atomic_Load_uintptr( slot, ATOMIC_ORDER_ACQUIRE );
+
+  if ( table == NULL && malloc_it ) {
+    table = calloc( IMFS_EXTFILE_TABLE_SLOTS, sizeof( Atomic_Uintptr ) );
+    if ( table == NULL )
+      return NULL;
+
+    table = IMFS_extfile_publish( slot, table );
+  }
+
+  return table;
+}
+
+/*
+ *  IMFS_extfile_get_slot
+ *
+ *  This routine looks up the slot of an extent.  Missing extent tables are
+ *  allocated if "malloc_it" is true.
+ */
+static Atomic_Uintptr *IMFS_extfile_get_slot(
+  IMFS_extfile_t *extfile,
+  uint32_t        extent,
+  bool            malloc_it
+)
+{
+  Atomic_Uintptr *table;
+
+  if ( extent < IMFS_EXTFILE_DIRECT_EXTENTS )
+    return &extfile->direct[ extent ];
+
+  extent -= IMFS_EXTFILE_DIRECT_EXTENTS;
+
+  if ( extent < IMFS_EXTFILE_TABLE_SLOTS ) {
+    table = IMFS_extfile_get_table( &extfile->indirect, malloc_it );
+    if ( table == NULL )
+      return NULL;
+
+    return &table[ extent ];
+  }
+
+  extent -= IMFS_EXTFILE_TABLE_SLOTS;
+
+  if ( extent >= IMFS_EXTFILE_TABLE_SLOTS * IMFS_EXTFILE_TABLE_SLOTS )
+    return NULL;
+
+  table = IMFS_extfile_get_table( &extfile->doubly_indirect, malloc_it );
+  if ( table == NULL )
+    return NULL;
+
+  table = IMFS_extfile_get_table(
+    &table[ extent / IMFS_EXTFILE_TABLE_SLOTS ],
+    malloc_it
+  );
+  if ( table == NULL )
+    return NULL;
+
+  return &table[ extent % IMFS_EXTFILE_TABLE_SLOTS ];
+}
+
+static char *IMFS_extfile_get_extent(
+  IMFS_extfile_t *extfile,
+  uint32_t        extent
+)
+{
+  Atomic_Uintptr *slot;
+
+  slot = IMFS_extfile_get_slot( extfile, extent, false );
+  if ( slot == NULL )
+    return NULL;
+
+  return (char *) _Atomic_Load_uintptr( slot, ATOMIC_ORDER_ACQUIRE );
+}
+
+/*
+ *  IMFS_extfile_zero
+ *
+ *  Clears the range of the file between the positions.  Only allocated
+ *  extents need to be cleared, missing extents read as zeros.
+ */
+static void IMFS_extfile_zero(
+  IMFS_extfile_t *extfile,
+  off_t           begin,
+  off_t           end
+)
+{
+  while ( begin < end ) {
+    uint32_t  extent;
+    size_t    offset;
+    size_t    extent_size;
+    size_t    to_zero;
+    char     *data;
+
+    extent_size = IMFS_extfile_locate( begin, &extent, &offset );
+    to_zero = extent_size - offset;
+    if ( (off_t) to_zero > end - begin )
+      to_zero = (size_t) ( end - begin );
+
+    data = IMFS_extfile_get_extent( extfile, extent );
+    if ( data != NULL )
+      memset( &data[ offset ], 0, to_zero );
+
+    begin += to_zero;
+  }
+}
+
+/*
+ *  IMFS_extfile_limit
+ *
+ *  The file size is limited by the extent tables and the size_t file size.
+ */
+static off_t IMFS_extfile_limit( void )
+{
+  off_t limit = IMFS_EXTFILE_MAXIMUM_SIZE;
+
+  if ( (uintmax_t) limit > SIZE_MAX )
+    limit = (off_t) SIZE_MAX;
+
+  return limit;
+}
+
+static ssize_t extfile_read(
+  rtems_libio_t *iop,
+  void          *buffer,
+  size_t         count
+)
+{
+  IMFS_extfile_t *extfile = IMFS_iop_to_extfile( iop );
+  char           *dest = buffer;
+  off_t           start = iop->offset;
+  off_t           position;
+  size_t          size;
+  size_t          copied;
+
+  /*
+   *  The data up to the file size is valid once the size is visible.
+   */
+  size = extfile->File.size;
+  _Atomic_Fence( ATOMIC_ORDER_ACQUIRE );
+
+  if ( start >= (off_t) size )
+    return 0;
+
+  if ( (off_t) count > (off_t) size - start )
+    count = (size_t) ( (off_t) size - start );
+
+  position = start;
+  copied = 0;
+
+  while ( copied < count ) {
+    uint32_t  extent;
+    size_t    offset;
+    size_t    extent_size;
+    size_t    to_copy;
+    char     *data;
+
+    extent_size = IMFS_extfile_locate( position, &extent, &offset );
+    to_copy = extent_size - offset;
+    if ( to_copy > count - copied )
+      to_copy = count - copied;
+
+    data = IMFS_extfile_get_extent( extfile, extent );
+    if ( data != NULL )
+      memcpy( &dest[ copied ], &data[ offset ], to_copy );
+    else
+      memset( &dest[ copied ], 0, to_copy );
+
+    position += to_copy;
+    copied += to_copy;
+  }
+
+  IMFS_update_atime( &extfile->File.Node );
+
+  iop->offset += copied;
+
+  return (ssize_t) copied;
+}
+
+/*
+ *  IMFS_extfile_store
+ *
+ *  Copies data into one extent.  A new extent is completely initialized
+ *  before it becomes visible to readers.
+ */
+static int IMFS_extfile_store(
+  IMFS_extfile_t *extfile,
+  uint32_t        extent,
+  size_t          extent_size,
+  size_t          offset,
+  const char     *src,
+  size_t          to_copy
+)
+{
+  Atomic_Uintptr *slot;
+  char           *data;
+
+  slot = IMFS_extfile_get_slot( extfile, extent, true );
+  if ( slot == NULL )
+    return ENOSPC;
+
+  data = (char *) _Atomic_Load_uintptr( slot, ATOMIC_ORDER_ACQUIRE );
+
+  if ( data == NULL ) {
+    char *memory = malloc( extent_size );
+
+    if ( memory == NULL )
+      return ENOSPC;
+
+    memset( memory, 0, offset );
+    memcpy( &memory[ offset ], src, to_copy );
+    memset(
+      &memory[ offset + to_copy ],
+      0,
+      extent_size - offset - to_copy
+    );
+
+    data = IMFS_extfile_publish( slot, memory );
+    if ( data == memory )
+      return 0;
+  }
+
+  memcpy( &data[ offset ], src, to_copy );
+
+  return 0;
+}
+
+static ssize_t extfile_write(
+  rtems_libio_t *iop,
+  const void    *buffer,
+  size_t         count
+)
+{
+  IMFS_extfile_t *extfile = IMFS_iop_to_extfile( iop );
+  const char     *src = buffer;
+  off_t           start;
+  off_t           position;
+  off_t           limit;
+  size_t          size;
+  size_t          copied;
+  int             eno;
+
+  size = extfile->File.size;
+
+  if ( rtems_libio_iop_is_append( iop ) )
+    iop->offset = (off_t) size;
+
+  start = iop->offset;
+  limit = IMFS_extfile_limit();
+
+  if ( start > limit || (off_t) count > limit - start )
+    rtems_set_errno_and_return_minus_one( EFBIG );
+
+  /*
+   *  Stale data of a previous truncation may be left beyond the end of the
+   *  file.
+   */
+  if ( start > (off_t) size )
+    IMFS_extfile_zero( extfile, (off_t) size, start );
+
+  position = start;
+  copied = 0;
+  eno = 0;
+
+  while ( copied < count ) {
+    uint32_t extent;
+    size_t   offset;
+    size_t   extent_size;
+    size_t   to_copy;
+
+    extent_size = IMFS_extfile_locate( position, &extent, &offset );
+    to_copy = extent_size - offset;
+    if ( to_copy > count - copied )
+      to_copy = count - copied;
+
+    eno = IMFS_extfile_store(
+      extfile,
+      extent,
+      extent_size,
+      offset,
+      &src[ copied ],
+      to_copy
+    );
+    if ( eno != 0 )
+      break;
+
+    position += to_copy;
+    copied += to_copy;
+  }
+
+  if ( copied == 0 && eno != 0 )
+    rtems_set_errno_and_return_minus_one( eno );
+
+  /*
+   *  Make the data visible before the new size.
+   */
+  _Atomic_Fence( ATOMIC_ORDER_RELEASE );
+
+  if ( position > (off_t) size )
+    extfile->File.size = (size_t) position;
+
+  IMFS_mtime_ctime_update( &extfile->File.Node );
+
+  iop->offset += copied;
+
+  return (ssize_t) copied;
+}
+
+static int extfile_ftruncate(
+  rtems_libio_t *iop,
+  off_t          length
+)
+{
+  IMFS_extfile_t *extfile = IMFS_iop_to_extfile( iop );
+  size_t          size = extfile->File.size;
+
+  /*
+   *  Extending the file is done like for the memfiles.  The extents are
+   *  kept on truncation, since readers may still access them without a
+   *  lock.  They are freed when the file is destroyed.
+   */
+  if ( length > (off_t) size ) {
+    if ( length > IMFS_extfile_limit() )
+      rtems_set_errno_and_return_minus_one( EFBIG );
+
+    IMFS_extfile_zero( extfile, (off_t) size, length );
+    _Atomic_Fence( ATOMIC_ORDER_RELEASE );
+  }
+
+  extfile->File.size = (size_t) length;
+
+  IMFS_mtime_ctime_update( &extfile->File.Node );
+
+  return 0;
+}
+
+static int extfile_stat(
+  const rtems_filesystem_location_info_t *loc,
+  struct stat                            *buf
+)
+{
+  int rv = IMFS_stat_file( loc, buf );
+
+  buf->st_blksize = IMFS_EXTFILE_MAX_EXTENT_SIZE;
+
+  return rv;
+}
+
+static void *IMFS_extfile_load( const Atomic_Uintptr *slot )
+{
+  return (void *) _Atomic_Load_uintptr( slot, ATOMIC_ORDER_RELAXED );
+}
+
+static void IMFS_extfile_free_table( Atomic_Uintptr *slot, int depth )
+{
+  Atomic_Uintptr *table;
+  int             i;
+
+  table = IMFS_extfile_load( slot );
+  if ( table == NULL )
+    return;
+
+  for ( i = 0 ; i < IMFS_EXTFILE_TABLE_SLOTS ; i++ ) {
+    if ( depth > 0 ) {
+      IMFS_extfile_free_table( &table[ i ], depth - 1 );
+    } else {
+      free( IMFS_extfile_load( &table[ i ] ) );
+    }
+  }
+
+  free( table );
+}
+
+static void IMFS_extfile_destroy( IMFS_jnode_t *the_jnode )
+{
+  IMFS_extfile_t *extfile = (IMFS_extfile_t *) the_jnode;
+  int             i;
+
+  for ( i = 0 ; i < IMFS_EXTFILE_DIRECT_EXTENTS ; i++ ) {
+    free( IMFS_extfile_load( &extfile->direct[ i ] ) );
+  }
+
+  IMFS_extfile_free_table( &extfile->indirect, 0 );
+  IMFS_extfile_free_table( &extfile->doubly_indirect, 1 );
+
+  IMFS_node_destroy_default( the_jnode );
+}
+
+static const rtems_filesystem_file_handlers_r IMFS_extfile_handlers = {
+  .open_h = rtems_filesystem_default_open,
+  .close_h = rtems_filesystem_default_close,
+  .read_h = extfile_read,
+  .write_h = extfile_write,
+  .ioctl_h = rtems_filesystem_default_ioctl,
+  .lseek_h = rtems_filesystem_default_lseek_file,
+  .fstat_h = extfile_stat,
+  .ftruncate_h = extfile_ftruncate,
+  .fsync_h = rtems_filesystem_default_fsync_or_fdatasync_success,
+  .fdatasync_h = rtems_filesystem_default_fsync_or_fdatasync_success,
+  .fcntl_h = rtems_filesystem_default_fcntl,
+  .kqfilter_h = rtems_filesystem_default_kqfilter,
+  .mmap_h = rtems_filesystem_default_mmap,
+  .poll_h = rtems_filesystem_default_poll,
+  .readv_h = rtems_filesystem_default_readv,
+  .writev_h = rtems_filesystem_default_writev
+};
+
+const IMFS_mknod_control IMFS_mknod_control_extfile = {
+  {
+    .handlers = &IMFS_extfile_handlers,
+    .node_initialize = IMFS_node_initialize_default,
+    .node_remove = IMFS_node_remove_default,
+    .node_destroy = IMFS_extfile_destroy
+  },
+  .node_size = sizeof( IMFS_extfile_t )
+};
@@ -89,4 +89,31 @@ rtems_rfs_buffer_bdbuf_release (rtems_rfs_buffer* buffer,
   return rc;
 }
 
+int
+rtems_rfs_buffer_bdbuf_direct (rtems_rfs_file_system* fs,
+                               rtems_rfs_buffer_block block,
+                               size_t                 count,
+                               void*                  data,
+                               bool                   read)
+{
+  rtems_status_code sc;
+  int               rc = 0;
+
+  if (read)
+    sc = rtems_bdbuf_read_direct (rtems_rfs_fs_device (fs), block, count, data);
+  else
+    sc = rtems_bdbuf_write_direct (rtems_rfs_fs_device (fs), block, count, data);
+
+  if (sc != RTEMS_SUCCESSFUL)
+  {
+#if RTEMS_RFS_BUFFER_ERRORS
+    printf ("rtems-rfs: buffer-bdbuf-direct: block=%lu count=%zu: %s: %d: %s\n",
+            block, count, read ? "read" : "write", sc, rtems_status_text (sc));
+#endif
+    rc = EIO;
+  }
+
+  return rc;
+}
+
 #endif
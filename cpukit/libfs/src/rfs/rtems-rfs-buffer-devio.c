@@ -55,4 +55,14 @@ rtems_rfs_buffer_device_handle_close (rtems_rfs_buffer_handle* handle,
 {
 }
 
+int
+rtems_rfs_buffer_deviceio_direct (rtems_rfs_file_system* fs,
+                                  rtems_rfs_buffer_block block,
+                                  size_t                 count,
+                                  void*                  data,
+                                  bool                   read)
+{
+  return ENOTSUP;
+}
+
 #endif
@@ -305,14 +305,60 @@ rtems_rfs_file_io_start (rtems_rfs_file_handle* handle,
   return 0;
 }
 
+/**
+ * Update the file's times and length after I/O moved the position.
+ */
+static void
+rtems_rfs_file_io_update (rtems_rfs_file_handle* handle,
+                          bool                   read)
+{
+  bool atime;
+  bool mtime;
+  bool length;
+
+  length = false;
+  mtime = !read;
+
+  if (!read &&
+      rtems_rfs_block_map_past_end (rtems_rfs_file_map (handle),
+                                    rtems_rfs_file_bpos (handle)))
+  {
+    rtems_rfs_block_map_set_size_offset (rtems_rfs_file_map (handle),
+                                         handle->bpos.boff);
+    length = true;
+  }
+
+  atime  = rtems_rfs_file_update_atime (handle);
+  mtime  = rtems_rfs_file_update_mtime (handle) && mtime;
+  length = rtems_rfs_file_update_length (handle) && length;
+
+  if (rtems_rfs_trace (RTEMS_RFS_TRACE_FILE_IO))
+    printf ("rtems-rfs: file-io:   end: pos=%" PRIu32 ":%" PRIu32 " %c %c %c\n",
+            handle->bpos.bno, handle->bpos.boff,
+            atime ? 'A' : '-', mtime ? 'M' : '-', length ? 'L' : '-');
+
+  if (atime || mtime)
+  {
+    time_t now = time (NULL);
+    if (read && atime)
+      handle->shared->atime = now;
+    if (!read && mtime)
+      handle->shared->mtime = now;
+  }
+  if (length)
+  {
+    handle->shared->size.count =
+      rtems_rfs_block_map_count (rtems_rfs_file_map (handle));
+    handle->shared->size.offset =
+      rtems_rfs_block_map_size_offset (rtems_rfs_file_map (handle));
+  }
+}
+
 int
 rtems_rfs_file_io_end (rtems_rfs_file_handle* handle,
                        size_t                 size,
                        bool                   read)
 {
-  bool atime;
-  bool mtime;
-  bool length;
   int  rc = 0;
 
   if (rtems_rfs_trace (RTEMS_RFS_TRACE_FILE_IO))
@@ -352,44 +398,131 @@ rtems_rfs_file_io_end (rtems_rfs_file_handle* handle,
     handle->bpos.boff -= rtems_rfs_fs_block_size (rtems_rfs_file_fs (handle));
   }
 
-  length = false;
-  mtime = !read;
+  rtems_rfs_file_io_update (handle, read);
 
-  if (!read &&
-      rtems_rfs_block_map_past_end (rtems_rfs_file_map (handle),
-                                    rtems_rfs_file_bpos (handle)))
+  return rc;
+}
+
+/**
+ * Find the media block of a block in the file. A write past the end of the
+ * file grows the file.
+ */
+static int
+rtems_rfs_file_io_direct_block (rtems_rfs_file_handle*  handle,
+                                rtems_rfs_block_no      bno,
+                                bool                    read,
+                                rtems_rfs_buffer_block* block)
+{
+  rtems_rfs_block_pos bpos;
+  int                 rc;
+
+  rtems_rfs_block_set_bpos_zero (&bpos);
+  bpos.bno = bno;
+
+  rc = rtems_rfs_block_map_find (rtems_rfs_file_fs (handle),
+                                 rtems_rfs_file_map (handle),
+                                 &bpos, block);
+  if (!read && (rc == ENXIO))
+    rc = rtems_rfs_block_map_grow (rtems_rfs_file_fs (handle),
+                                   rtems_rfs_file_map (handle),
+                                   1, block);
+
+  return rc;
+}
+
+int
+rtems_rfs_file_io_direct (rtems_rfs_file_handle* handle,
+                          void*                  data,
+                          size_t*                size,
+                          bool                   read)
+{
+  rtems_rfs_file_system* fs = rtems_rfs_file_fs (handle);
+  rtems_rfs_block_map*   map = rtems_rfs_file_map (handle);
+  size_t                 block_size = rtems_rfs_fs_block_size (fs);
+  size_t                 blocks = *size / block_size;
+  size_t                 done = 0;
+  uint8_t*               buffer = data;
+  int                    rc;
+
+  *size = 0;
+
+  if (rtems_rfs_file_block_offset (handle) ||
+      !rtems_rfs_buffer_io_direct_buffer (data))
+    return 0;
+
+  /*
+   * A read stops at the last whole block, the cache handles a partial last
+   * block.
+   */
+  if (read)
   {
-    rtems_rfs_block_map_set_size_offset (rtems_rfs_file_map (handle),
-                                         handle->bpos.boff);
-    length = true;
+    rtems_rfs_block_no count = rtems_rfs_block_map_count (map);
+    size_t             whole;
+
+    if (handle->bpos.bno >= count)
+      return 0;
+
+    whole = count - handle->bpos.bno;
+    if (rtems_rfs_block_map_size_offset (map))
+      --whole;
+
+    if (blocks > whole)
+      blocks = whole;
   }
 
-  atime  = rtems_rfs_file_update_atime (handle);
-  mtime  = rtems_rfs_file_update_mtime (handle) && mtime;
-  length = rtems_rfs_file_update_length (handle) && length;
+  if (blocks == 0)
+    return 0;
 
-  if (rtems_rfs_trace (RTEMS_RFS_TRACE_FILE_IO))
-    printf ("rtems-rfs: file-io:   end: pos=%" PRIu32 ":%" PRIu32 " %c %c %c\n",
-            handle->bpos.bno, handle->bpos.boff,
-            atime ? 'A' : '-', mtime ? 'M' : '-', length ? 'L' : '-');
+  rc = rtems_rfs_file_io_release (handle);
+  if (rc > 0)
+    return rc;
 
-  if (atime || mtime)
+  while (done < blocks)
   {
-    time_t now = time (NULL);
-    if (read && atime)
-      handle->shared->atime = now;
-    if (!read && mtime)
-      handle->shared->mtime = now;
+    rtems_rfs_buffer_block block;
+    size_t                 run = 1;
+
+    rc = rtems_rfs_file_io_direct_block (handle, handle->bpos.bno, read, &block);
+    if (rc > 0)
+      break;
+
+    while ((done + run) < blocks)
+    {
+      rtems_rfs_buffer_block next;
+
+      rc = rtems_rfs_file_io_direct_block (handle, handle->bpos.bno + run,
+                                           read, &next);
+      if (rc > 0 || next != (block + run))
+        break;
+
+      ++run;
+    }
+
+    if (rtems_rfs_trace (RTEMS_RFS_TRACE_FILE_IO))
+      printf ("rtems-rfs: file-io: direct: %s bno=%" PRIu32
+              " block=%" PRIu32 " count=%zu\n",
+              read ? "read" : "write", handle->bpos.bno, block, run);
+
+    rc = rtems_rfs_buffer_io_direct (fs, block, run, buffer, read);
+    if (rc > 0)
+      break;
+
+    buffer += run * block_size;
+    done += run;
+    handle->bpos.bno += run;
   }
-  if (length)
+
+  if (done > 0)
   {
-    handle->shared->size.count =
-      rtems_rfs_block_map_count (rtems_rfs_file_map (handle));
-    handle->shared->size.offset =
-      rtems_rfs_block_map_size_offset (rtems_rfs_file_map (handle));
+    *size = done * block_size;
+    rtems_rfs_file_io_update (handle, read);
   }
 
-  return rc;
+  /*
+   * Report an error only if nothing was transferred, the caller accounts for
+   * the data first.
+   */
+  return done > 0 ? 0 : rc;
 }
 
 int
@@ -129,6 +129,25 @@ rtems_rfs_rtems_file_read (rtems_libio_t* iop,
     {
       size_t size;
 
+      if (rtems_libio_iop_is_direct (iop))
+      {
+        size = count;
+        rc = rtems_rfs_file_io_direct (file, data, &size, true);
+        if (rc > 0)
+        {
+          read = rtems_rfs_rtems_error ("file-read: read: direct", rc);
+          break;
+        }
+
+        if (size > 0)
+        {
+          data  += size;
+          count -= size;
+          read  += size;
+          continue;
+        }
+      }
+
       rc = rtems_rfs_file_io_start (file, &size, true);
       if (rc > 0)
       {
@@ -223,6 +242,28 @@ rtems_rfs_rtems_file_write (rtems_libio_t* iop,
   {
     size_t size = count;
 
+    if (rtems_libio_iop_is_direct (iop))
+    {
+      rc = rtems_rfs_file_io_direct (file, RTEMS_DECONST (uint8_t*, data),
+                                     &size, false);
+      if (rc)
+      {
+        if (!write)
+          write = rtems_rfs_rtems_error ("file-write: write direct", rc);
+        break;
+      }
+
+      if (size > 0)
+      {
+        data  += size;
+        count -= size;
+        write += size;
+        continue;
+      }
+
+      size = count;
+    }
+
     rc = rtems_rfs_file_io_start (file, &size, false);
     if (rc)
     {
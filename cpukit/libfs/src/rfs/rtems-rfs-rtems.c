@@ -101,6 +101,51 @@ static void rtems_rfs_rtems_follow_link(
   }
 }
 
+/**
+ * Look up a directory entry.  The path evaluation cache is consulted first
+ * to avoid the directory search.
+ */
+static int
+rtems_rfs_rtems_lookup_ino (const rtems_filesystem_location_info_t* loc,
+                            rtems_rfs_inode_handle*                 inode,
+                            const char*                             token,
+                            size_t                                  tokenlen,
+                            rtems_rfs_ino*                          entry_ino,
+                            uint32_t*                               entry_doff)
+{
+  rtems_rfs_file_system* fs = rtems_rfs_rtems_pathloc_dev (loc);
+  uintptr_t              dir = rtems_rfs_inode_ino (inode);
+  uintptr_t              node;
+  uintptr_t              data;
+  int                    rc;
+
+  switch (rtems_filesystem_eval_path_cache_lookup (loc->mt_entry, dir,
+                                                   token, tokenlen,
+                                                   &node, &data))
+  {
+    case RTEMS_FILESYSTEM_EVAL_PATH_CACHE_HIT:
+      *entry_ino = (rtems_rfs_ino) node;
+      *entry_doff = (uint32_t) data;
+      return 0;
+    case RTEMS_FILESYSTEM_EVAL_PATH_CACHE_NO_ENTRY:
+      return ENOENT;
+    default:
+      break;
+  }
+
+  rc = rtems_rfs_dir_lookup_ino (fs, inode, token, tokenlen,
+                                 entry_ino, entry_doff);
+  if (rc == 0)
+    rtems_filesystem_eval_path_cache_insert (loc->mt_entry, dir,
+                                             token, tokenlen,
+                                             *entry_ino, *entry_doff);
+  else if (rc == ENOENT)
+    rtems_filesystem_eval_path_cache_insert_no_entry (loc->mt_entry, dir,
+                                                      token, tokenlen);
+
+  return rc;
+}
+
 static rtems_filesystem_eval_path_generic_status
 rtems_rfs_rtems_eval_token(
   rtems_filesystem_eval_path_context_t *ctx,
@@ -123,8 +168,8 @@ rtems_rfs_rtems_eval_token(
       rtems_rfs_file_system* fs = rtems_rfs_rtems_pathloc_dev (currentloc);
       rtems_rfs_ino entry_ino;
       uint32_t entry_doff;
-      int rc = rtems_rfs_dir_lookup_ino (
-        fs,
+      int rc = rtems_rfs_rtems_lookup_ino (
+        currentloc,
         inode,
         token,
         tokenlen,
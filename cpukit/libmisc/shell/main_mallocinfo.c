@@ -14,6 +14,7 @@
 #endif
 
 #include <inttypes.h>
+#include <stdio.h>
 #include <string.h>
 
 #include <rtems.h>
@@ -38,6 +39,28 @@ static int rtems_shell_main_malloc_info(
     rtems_shell_print_heap_info( "free", &info.Free );
     rtems_shell_print_heap_info( "used", &info.Used );
     rtems_shell_print_heap_stats( &info.Stats );
+
+    if ( rtems_malloc_cache_size > 0 ) {
+      rtems_malloc_cache_information cache_info;
+
+      rtems_malloc_cache_get_information( &cache_info );
+      printf(
+        "Objects in per-processor caches:          %12" PRIu32 "\n"
+        "Bytes in per-processor caches:            %12" PRIuPTR "\n"
+        "Allocations from per-processor caches:    %12" PRIu32 "\n"
+        "Allocations with empty magazine:          %12" PRIu32 "\n"
+        "Frees to per-processor caches:            %12" PRIu32 "\n"
+        "Refills of per-processor caches:          %12" PRIu32 "\n"
+        "Spills of per-processor caches:           %12" PRIu32 "\n",
+        cache_info.cached_objects,
+        cache_info.cached_bytes,
+        cache_info.allocation_hits,
+        cache_info.allocation_misses,
+        cache_info.free_hits,
+        cache_info.refills,
+        cache_info.spills
+      );
+    }
   }
 
   return 0;
@@ -39,22 +39,177 @@
 
 #include <rtems/system.h>
 #include <rtems/score/isr.h>
+#include <rtems/score/idt.h>
 #include <rtems/score/wkspace.h>
 #include <rtems/score/tls.h>
+#include <rtems/score/cpuimpl.h>
+#include <rtems/score/percpu.h>
+#include <rtems/bspIo.h>
+#include <inttypes.h>
 
-Context_Control_fp _CPU_Null_fp_context;
+#define CPUID_7_EBX_FSGSBASE (1 << 0)
+
+interrupt_descriptor amd64_idt[IDT_SIZE] RTEMS_ALIGNED(16);
 
 void _CPU_Exception_frame_print(const CPU_Exception_frame *ctx)
 {
+  printk(
+    "\n"
+    "vector = %" PRIu64 ", error code = 0x%016" PRIx64 "\n"
+    "rip    = 0x%016" PRIx64 ", cs     = 0x%04" PRIx64 "\n"
+    "rflags = 0x%016" PRIx64 "\n"
+    "rsp    = 0x%016" PRIx64 ", ss     = 0x%04" PRIx64 "\n"
+    "rax    = 0x%016" PRIx64 ", rbx    = 0x%016" PRIx64 "\n"
+    "rcx    = 0x%016" PRIx64 ", rdx    = 0x%016" PRIx64 "\n"
+    "rsi    = 0x%016" PRIx64 ", rdi    = 0x%016" PRIx64 "\n"
+    "rbp    = 0x%016" PRIx64 ", r8     = 0x%016" PRIx64 "\n"
+    "r9     = 0x%016" PRIx64 ", r10    = 0x%016" PRIx64 "\n"
+    "r11    = 0x%016" PRIx64 ", r12    = 0x%016" PRIx64 "\n"
+    "r13    = 0x%016" PRIx64 ", r14    = 0x%016" PRIx64 "\n"
+    "r15    = 0x%016" PRIx64 "\n",
+    ctx->vector, ctx->error_code,
+    ctx->rip, ctx->cs,
+    ctx->rflags,
+    ctx->rsp, ctx->ss,
+    ctx->rax, ctx->rbx,
+    ctx->rcx, ctx->rdx,
+    ctx->rsi, ctx->rdi,
+    ctx->rbp, ctx->r8,
+    ctx->r9, ctx->r10,
+    ctx->r11, ctx->r12,
+    ctx->r13, ctx->r14,
+    ctx->r15
+  );
+}
+
+static void amd64_install_idt_gate(uint32_t vector, uintptr_t offset)
+{
+  interrupt_descriptor *desc = &amd64_idt[vector];
+  uint16_t cs;
+
+  __asm__ volatile ( "movw %%cs, %0" : "=r" (cs) );
+
+  desc->offset_0 = (uint16_t) offset;
+  desc->segment_selector = cs;
+  desc->ist = 0;
+  desc->type_attributes = IDT_INTERRUPT_GATE;
+  desc->offset_1 = (uint16_t) (offset >> 16);
+  desc->offset_2 = (uint32_t) (offset >> 32);
+  desc->reserved = 0;
+}
+
+bool _X86_64_Has_fsgsbase;
+
+void _X86_64_TLS_Initialize_processor(void)
+{
+  uint32_t eax, ebx, ecx, edx;
+  uint64_t cr4;
+
+  cpuid(0, &eax, &ebx, &ecx, &edx);
+  if (eax < 7) {
+    return;
+  }
+
+  cpuid_subleaf(7, 0, &eax, &ebx, &ecx, &edx);
+  if ((ebx & CPUID_7_EBX_FSGSBASE) == 0) {
+    return;
+  }
+
+  __asm__ volatile ( "movq %%cr4, %0" : "=r" (cr4) );
+  cr4 |= X86_64_CR4_FSGSBASE;
+  __asm__ volatile ( "movq %0, %%cr4" : : "r" (cr4) );
+
+  _X86_64_Has_fsgsbase = true;
 }
 
 void _CPU_Initialize(void)
 {
+  uint32_t vector;
+
+  _X86_64_FP_Initialize_processor();
+  _X86_64_TLS_Initialize_processor();
+
+#if defined(X86_64_USE_LAZY_FP_SWITCH)
+  amd64_install_idt_gate(
+    IDT_DEVICE_NOT_AVAILABLE,
+    (uintptr_t) _X86_64_FP_Device_not_available
+  );
+#endif
+
+  /*
+   * Vectors the BSP installed during bsp_start() are kept, all remaining
+   * exceptions end up in _X86_64_Exception_default(). Other vectors stay
+   * not present, so that unexpected interrupts raise a #NP exception.
+   */
+  for (vector = 0; vector < IDT_EXCEPTION_VECTORS; ++vector) {
+    if (!amd64_idt_is_present(&amd64_idt[vector])) {
+      amd64_install_idt_gate(
+        vector,
+        (uintptr_t) _X86_64_Exception_prologues +
+          vector * X86_64_ISR_PROLOGUE_SIZE
+      );
+    }
+  }
+
+  amd64_idt_load();
+}
+
+void amd64_idt_load(void)
+{
+  idt_register idtr;
+
+  idtr.limit = sizeof(amd64_idt) - 1;
+  idtr.base = (uintptr_t) amd64_idt;
+  __asm__ volatile ( "lidt %0" : : "m" (idtr) );
 }
 
+#define X86_64_ASSERT_CONTEXT_OFFSET(field, off) \
+  RTEMS_STATIC_ASSERT( \
+    offsetof(Context_Control, field) == X86_64_CONTEXT_CONTROL_ ## off, \
+    Context_Control_offset_ ## field \
+  )
+
+X86_64_ASSERT_CONTEXT_OFFSET(rflags, RFLAGS);
+X86_64_ASSERT_CONTEXT_OFFSET(rbx, RBX);
+X86_64_ASSERT_CONTEXT_OFFSET(rsp, RSP);
+X86_64_ASSERT_CONTEXT_OFFSET(rbp, RBP);
+X86_64_ASSERT_CONTEXT_OFFSET(r12, R12);
+X86_64_ASSERT_CONTEXT_OFFSET(r13, R13);
+X86_64_ASSERT_CONTEXT_OFFSET(r14, R14);
+X86_64_ASSERT_CONTEXT_OFFSET(r15, R15);
+X86_64_ASSERT_CONTEXT_OFFSET(fs_base, FS_BASE);
+
+#ifdef RTEMS_SMP
+X86_64_ASSERT_CONTEXT_OFFSET(is_executing, IS_EXECUTING);
+
+RTEMS_STATIC_ASSERT(
+  offsetof(Per_CPU_Control, cpu_per_cpu.self) == X86_64_PER_CPU_SELF_OFFSET,
+  X86_64_PER_CPU_SELF_OFFSET
+);
+
+RTEMS_STATIC_ASSERT(
+  offsetof(Per_CPU_Control, cpu_per_cpu.cpu_index) ==
+    X86_64_PER_CPU_INDEX_OFFSET,
+  X86_64_PER_CPU_INDEX_OFFSET
+);
+
+void _X86_64_SMP_Initialize_processor(uint32_t cpu_index)
+{
+  Per_CPU_Control *cpu = _Per_CPU_Get_by_index(cpu_index);
+
+  cpu->cpu_per_cpu.self = cpu;
+  cpu->cpu_per_cpu.cpu_index = cpu_index;
+  wrmsr(X86_64_MSR_GS_BASE, (uintptr_t) cpu);
+}
+#endif
+
 uint32_t _CPU_ISR_Get_level(void)
 {
-  return 0;
+  uint64_t rflags;
+
+  __asm__ volatile ( "pushfq; popq %0" : "=rm" (rflags) );
+
+  return (rflags & EFLAGS_INTR_ENABLE) != 0 ? 0 : 1;
 }
 
 void _CPU_ISR_install_raw_handler(
@@ -63,6 +218,19 @@ void _CPU_ISR_install_raw_handler(
   proc_ptr   *old_handler
 )
 {
+  ISR_Level level;
+
+  _ISR_Local_disable(level);
+
+  if (amd64_idt_is_present(&amd64_idt[vector])) {
+    *old_handler = (proc_ptr) amd64_idt_get_offset(&amd64_idt[vector]);
+  } else {
+    *old_handler = NULL;
+  }
+
+  amd64_install_idt_gate(vector, (uintptr_t) new_handler);
+
+  _ISR_Local_enable(level);
 }
 
 void _CPU_ISR_install_vector(
@@ -71,10 +239,15 @@ void _CPU_ISR_install_vector(
   proc_ptr   *old_handler
 )
 {
-}
+  proc_ptr prologue;
+  proc_ptr ignored;
 
-void _CPU_Install_interrupt_stack(void)
-{
+  *old_handler = _ISR_Vector_table[vector];
+  _ISR_Vector_table[vector] = new_handler;
+
+  prologue = (proc_ptr)
+    (_X86_64_Interrupt_prologues + vector * X86_64_ISR_PROLOGUE_SIZE);
+  _CPU_ISR_install_raw_handler(vector, prologue, &ignored);
 }
 
 void *_CPU_Thread_Idle_body(uintptr_t ignored)
@@ -84,7 +84,14 @@
 #define r14 REG (r14)
 #define r15 REG (r15)
 
-// XXX: eax, ax, etc., segment registers
+#define eax REG (eax)
+#define ebx REG (ebx)
+#define ecx REG (ecx)
+#define edx REG (edx)
+#define edi REG (edi)
+#define esi REG (esi)
+
+// XXX: ax, etc., segment registers
 
 /*
  *  Define macros to handle section beginning and ends.
@@ -131,4 +138,17 @@
  */
 #define EXTERN(sym) .globl SYM (sym)
 
+/**
+ *  Loads the address of the executing processor's Per_CPU_Control into REG.
+ */
+#ifdef RTEMS_SMP
+.macro GET_SELF_CPU_CONTROL REG
+  movq    %gs:X86_64_PER_CPU_SELF_OFFSET, \REG
+.endm
+#else
+.macro GET_SELF_CPU_CONTROL REG
+  movabsq $SYM(_Per_CPU_Information), \REG
+.endm
+#endif
+
 #endif
@@ -42,14 +42,33 @@ extern "C" {
 #include <rtems/score/basedefs.h>
 #include <rtems/score/x86_64.h>
 
-#define CPU_SIMPLE_VECTORED_INTERRUPTS FALSE
+#define CPU_SIMPLE_VECTORED_INTERRUPTS TRUE
 #define CPU_ISR_PASSES_FRAME_POINTER FALSE
-// XXX: Enable FPU support
-#define CPU_HARDWARE_FP     FALSE
+
+/*
+ * All code may use the SSE registers, and all of them are caller-saved in the
+ * SysV ABI, so the interrupt frame's FXSAVE area covers what interrupted
+ * threads need.  Threads created with the floating point attribute also get
+ * their full XSAVE state (e.g. the upper halves of the AVX registers)
+ * preserved across thread dispatches.
+ *
+ * In uniprocessor configurations the FP context is switched lazily: a switch
+ * only sets CR0.TS and the resulting #NM exception saves the previous owner's
+ * state and loads the executing thread's.  Threads which do not use the FPU
+ * after a switch never pay for it.  SMP configurations, or ones defining
+ * X86_64_USE_EAGER_FP_SWITCH, save and restore the context on every switch
+ * instead, since a thread's state must not stay behind in another processor's
+ * registers.
+ */
+#if !defined(RTEMS_SMP) && !defined(X86_64_USE_EAGER_FP_SWITCH)
+  #define X86_64_USE_LAZY_FP_SWITCH
+#endif
+
+#define CPU_HARDWARE_FP     TRUE
 #define CPU_SOFTWARE_FP     FALSE
 #define CPU_ALL_TASKS_ARE_FP     FALSE
 #define CPU_IDLE_TASK_IS_FP      FALSE
-#define CPU_USE_DEFERRED_FP_SWITCH       TRUE
+#define CPU_USE_DEFERRED_FP_SWITCH       FALSE
 #define CPU_ENABLE_ROBUST_THREAD_DISPATCH FALSE
 #define CPU_PROVIDES_IDLE_THREAD_BODY    FALSE
 #define CPU_STACK_GROWS_UP               FALSE
@@ -62,6 +81,23 @@ extern "C" {
 #define CPU_EFLAGS_INTERRUPTS_ON  0x00003202
 #define CPU_EFLAGS_INTERRUPTS_OFF 0x00003002
 
+#define EFLAGS_INTR_ENABLE        0x00000200
+
+/* Offsets into Context_Control, see x86_64-context-switch.S */
+#define X86_64_CONTEXT_CONTROL_RFLAGS       0
+#define X86_64_CONTEXT_CONTROL_RBX          8
+#define X86_64_CONTEXT_CONTROL_RSP          16
+#define X86_64_CONTEXT_CONTROL_RBP          24
+#define X86_64_CONTEXT_CONTROL_R12          32
+#define X86_64_CONTEXT_CONTROL_R13          40
+#define X86_64_CONTEXT_CONTROL_R14          48
+#define X86_64_CONTEXT_CONTROL_R15          56
+#define X86_64_CONTEXT_CONTROL_FS_BASE      64
+
+#ifdef RTEMS_SMP
+  #define X86_64_CONTEXT_CONTROL_IS_EXECUTING 72
+#endif
+
 #ifndef ASM
 
 typedef struct {
@@ -79,7 +115,11 @@ typedef struct {
   uint64_t r14;
   uint64_t r15;
 
-  // XXX: FS segment descriptor for TLS
+  /**
+   * FS base, i.e. the thread control block of the TLS variant II layout which
+   * %fs relative thread-local accesses are resolved against.
+   */
+  uint64_t fs_base;
 
 #ifdef RTEMS_SMP
     volatile bool is_executing;
@@ -89,23 +129,79 @@ typedef struct {
 #define _CPU_Context_Get_SP( _context ) \
   (_context)->rsp
 
+/*
+ * Large enough for the x87, SSE, AVX and AVX-512 components in the standard
+ * (non-compacted) XSAVE format.  The last AVX-512 component (Hi16_ZMM) is at
+ * offset 1664 with a size of 1024 bytes.  Only the components enabled in XCR0
+ * are saved; see _X86_64_FP_Initialize_processor().
+ */
+#define X86_64_FP_CONTEXT_AREA_SIZE       2688
+#define X86_64_FP_CONTEXT_AREA_ALIGNMENT  64
+
 typedef struct {
-  /* XXX: MMX, XMM, others?
-   *
-   * All x87 registers are caller-saved, so callees that make use of the MMX
-   * registers may use the faster femms instruction
+  /**
+   * The XSAVE/FXSAVE area, which starts at the first
+   * X86_64_FP_CONTEXT_AREA_ALIGNMENT aligned byte since the workspace only
+   * guarantees CPU_HEAP_ALIGNMENT.
    */
-
-  /** FPU registers are listed here */
-  double      some_float_register;
+  uint8_t area[X86_64_FP_CONTEXT_AREA_SIZE + X86_64_FP_CONTEXT_AREA_ALIGNMENT - 1];
 } Context_Control_fp;
 
+/*
+ * Interrupt frame built by _ISR_Handler on top of the hardware frame and the
+ * vector number pushed by the vector's prologue. Only the registers which are
+ * caller-saved in the SysV ABI (and the callee-saved registers _ISR_Handler
+ * uses itself) are saved; the C handlers preserve everything else.
+ */
 typedef struct {
-    uint32_t   special_interrupt_register;
+#ifdef __SSE__
+  /** Caller-saved XMM/x87 state, saved through FXSAVE */
+  uint8_t  fxsave_area[512];
+#endif
+  uint64_t rax;
+  uint64_t rcx;
+  uint64_t rdx;
+  uint64_t rsi;
+  uint64_t rdi;
+  uint64_t r8;
+  uint64_t r9;
+  uint64_t r10;
+  uint64_t r11;
+  uint64_t rbx;
+  uint64_t rbp;
+#if defined(X86_64_USE_LAZY_FP_SWITCH)
+  /** CR0.TS on entry; if set, the FPU state was not saved */
+  uint64_t cr0_ts;
+#else
+  uint64_t reserved_for_alignment;
+#endif
 } CPU_Interrupt_frame;
 
 #endif /* ASM */
 
+#ifdef __SSE__
+  #define X86_64_INTERRUPT_FRAME_FXSAVE_SIZE 512
+#else
+  #define X86_64_INTERRUPT_FRAME_FXSAVE_SIZE 0
+#endif
+
+#define X86_64_INTERRUPT_FRAME_FXSAVE 0
+#define X86_64_INTERRUPT_FRAME_RAX (X86_64_INTERRUPT_FRAME_FXSAVE_SIZE + 0)
+#define X86_64_INTERRUPT_FRAME_RCX (X86_64_INTERRUPT_FRAME_FXSAVE_SIZE + 8)
+#define X86_64_INTERRUPT_FRAME_RDX (X86_64_INTERRUPT_FRAME_FXSAVE_SIZE + 16)
+#define X86_64_INTERRUPT_FRAME_RSI (X86_64_INTERRUPT_FRAME_FXSAVE_SIZE + 24)
+#define X86_64_INTERRUPT_FRAME_RDI (X86_64_INTERRUPT_FRAME_FXSAVE_SIZE + 32)
+#define X86_64_INTERRUPT_FRAME_R8  (X86_64_INTERRUPT_FRAME_FXSAVE_SIZE + 40)
+#define X86_64_INTERRUPT_FRAME_R9  (X86_64_INTERRUPT_FRAME_FXSAVE_SIZE + 48)
+#define X86_64_INTERRUPT_FRAME_R10 (X86_64_INTERRUPT_FRAME_FXSAVE_SIZE + 56)
+#define X86_64_INTERRUPT_FRAME_R11 (X86_64_INTERRUPT_FRAME_FXSAVE_SIZE + 64)
+#define X86_64_INTERRUPT_FRAME_RBX (X86_64_INTERRUPT_FRAME_FXSAVE_SIZE + 72)
+#define X86_64_INTERRUPT_FRAME_RBP (X86_64_INTERRUPT_FRAME_FXSAVE_SIZE + 80)
+#define X86_64_INTERRUPT_FRAME_CR0_TS (X86_64_INTERRUPT_FRAME_FXSAVE_SIZE + 88)
+
+/* Must keep the stack 16-byte aligned, see _ISR_Handler */
+#define CPU_INTERRUPT_FRAME_SIZE (X86_64_INTERRUPT_FRAME_FXSAVE_SIZE + 96)
+
 
 #define CPU_CONTEXT_FP_SIZE sizeof( Context_Control_fp )
 #define CPU_MPCI_RECEIVE_SERVER_EXTRA_STACK 0
@@ -122,42 +218,86 @@ typedef struct {
  *  ISR handler macros
  */
 
+#define CPU_INTERRUPT_NUMBER_OF_VECTORS      256
+#define CPU_INTERRUPT_MAXIMUM_VECTOR_NUMBER  (CPU_INTERRUPT_NUMBER_OF_VECTORS - 1)
+
 #ifndef ASM
 
+/*
+ * The IDT itself is set up by _CPU_Initialize() and the vectors installed
+ * through _CPU_ISR_install_vector(), which the BSP may already call from
+ * bsp_start(), i.e. before _ISR_Handler_initialization().
+ */
 #define _CPU_Initialize_vectors()
 
-// XXX: For RTEMS critical sections
+/*
+ * The ISR level cookie is the lower half of RFLAGS; only its interrupt enable
+ * flag is ever restored, which avoids the expensive popf.
+ */
 #define _CPU_ISR_Disable( _isr_cookie ) \
-  { \
-    (_isr_cookie) = 0;   /* do something to prevent warnings */ \
-  }
+  do { \
+    uint64_t _rflags; \
+    __asm__ volatile ( "pushfq; cli; popq %0" : "=rm" (_rflags) : : "memory" ); \
+    (_isr_cookie) = (uint32_t) _rflags; \
+  } while (0)
 
 #define _CPU_ISR_Enable( _isr_cookie )  \
-  { \
-    (void) (_isr_cookie);   /* prevent warnings from -Wunused-but-set-variable */ \
-  }
+  do { \
+    if ( ( (_isr_cookie) & EFLAGS_INTR_ENABLE ) != 0 ) { \
+      __asm__ volatile ( "sti" : : : "memory" ); \
+    } \
+  } while (0)
 
+/*
+ * The sti instruction only takes effect after the instruction following it,
+ * hence the nop.
+ */
 #define _CPU_ISR_Flash( _isr_cookie ) \
-  { \
-  }
+  do { \
+    if ( ( (_isr_cookie) & EFLAGS_INTR_ENABLE ) != 0 ) { \
+      __asm__ volatile ( "sti; nop; cli" : : : "memory" ); \
+    } \
+  } while (0)
 
 RTEMS_INLINE_ROUTINE bool _CPU_ISR_Is_enabled( uint32_t level )
 {
-  return false;
+  return ( level & EFLAGS_INTR_ENABLE ) != 0;
 }
 
-#define _CPU_ISR_Set_level( new_level ) \
-  { \
-  }
+#define _CPU_ISR_Set_level( _new_level ) \
+  do { \
+    if ( _new_level ) __asm__ volatile ( "cli" : : : "memory" ); \
+    else              __asm__ volatile ( "sti" : : : "memory" ); \
+  } while (0)
 
 uint32_t   _CPU_ISR_Get_level( void );
 
+/*
+ * The outermost interrupt switches to the per-CPU interrupt stack in
+ * _ISR_Handler; keep its top aligned for the SysV ABI and for FXSAVE.
+ */
+#define _CPU_Interrupt_stack_setup( _lo, _hi ) \
+  do { \
+    (void) (_lo); \
+    _hi = (void *) ( (uintptr_t) (_hi) & ~( CPU_INTERRUPT_STACK_ALIGNMENT - 1 ) ); \
+  } while (0)
+
 /* end of ISR handler macros */
 
 /* Context handler macros */
+#if defined(X86_64_USE_LAZY_FP_SWITCH)
+#define _CPU_Context_Destroy( _the_thread, _the_context ) \
+  do { \
+    Per_CPU_Control *cpu_self = _Per_CPU_Get(); \
+    if ( cpu_self->cpu_per_cpu.fp_owner == (_the_thread)->fp_context ) { \
+      cpu_self->cpu_per_cpu.fp_owner = NULL; \
+    } \
+  } while ( 0 )
+#else
 #define _CPU_Context_Destroy( _the_thread, _the_context ) \
   { \
   }
+#endif
 
 void _CPU_Context_Initialize(
   Context_Control *the_context,
@@ -172,10 +312,7 @@ void _CPU_Context_Initialize(
 #define _CPU_Context_Restart_self( _the_context ) \
    _CPU_Context_restore( (_the_context) );
 
-#define _CPU_Context_Initialize_fp( _destination )  \
-  { \
-   *(*(_destination)) = _CPU_Null_fp_context; \
-  }
+void _CPU_Context_Initialize_fp( Context_Control_fp **fp_context_ptr );
 
 /* end of Context handler macros */
 
@@ -228,8 +365,6 @@ void _CPU_ISR_install_vector(
   proc_ptr   *old_handler
 );
 
-void _CPU_Install_interrupt_stack( void );
-
 void *_CPU_Thread_Idle_body( uintptr_t ignored );
 
 void _CPU_Context_switch(
@@ -249,6 +384,25 @@ void _CPU_Context_restore_fp(
   Context_Control_fp **fp_context_ptr
 );
 
+/**
+ * @brief Enables the FPU features used for the FP contexts (FXSR, XSAVE and
+ * the XCR0 state components) on the calling processor.
+ *
+ * Called by _CPU_Initialize() on the boot processor; secondary processors
+ * must call it before they run threads.
+ */
+void _X86_64_FP_Initialize_processor( void );
+
+/**
+ * @brief Enables the FSGSBASE instructions on the calling processor if they
+ * are available, so that the context switch loads the FS base with WRFSBASE
+ * instead of writing the MSR.
+ *
+ * Called by _CPU_Initialize() on the boot processor; secondary processors
+ * must call it before they run threads.
+ */
+void _X86_64_TLS_Initialize_processor( void );
+
 static inline void _CPU_Context_volatile_clobber( uintptr_t pattern );
 
 static inline void _CPU_Context_validate( uintptr_t pattern );
@@ -265,10 +419,34 @@ static inline void _CPU_Context_validate( uintptr_t pattern )
   }
 }
 
+/*
+ * Layout as built by _Exception_Handler: general purpose registers, then the
+ * vector number and error code (zero if the exception provides none), then
+ * the frame pushed by the processor.
+ */
 typedef struct {
-  uint32_t processor_state_register;
-  uint32_t integer_registers [1];
-  double float_registers [1];
+  uint64_t rax;
+  uint64_t rbx;
+  uint64_t rcx;
+  uint64_t rdx;
+  uint64_t rsi;
+  uint64_t rdi;
+  uint64_t rbp;
+  uint64_t r8;
+  uint64_t r9;
+  uint64_t r10;
+  uint64_t r11;
+  uint64_t r12;
+  uint64_t r13;
+  uint64_t r14;
+  uint64_t r15;
+  uint64_t vector;
+  uint64_t error_code;
+  uint64_t rip;
+  uint64_t cs;
+  uint64_t rflags;
+  uint64_t rsp;
+  uint64_t ss;
 } CPU_Exception_frame;
 
 void _CPU_Exception_frame_print( const CPU_Exception_frame *frame );
@@ -307,7 +485,6 @@ static inline CPU_Counter_ticks _CPU_Counter_difference(
 }
 
 #ifdef RTEMS_SMP
-   *
   uint32_t _CPU_SMP_Initialize( void );
 
   bool _CPU_SMP_Start_processor( uint32_t cpu_index );
@@ -318,7 +495,15 @@ static inline CPU_Counter_ticks _CPU_Counter_difference(
 
   static inline uint32_t _CPU_SMP_Get_current_processor( void )
   {
-    return 123;
+    uint32_t cpu_index;
+
+    __asm__ volatile (
+      "movl %%gs:%c1, %0"
+      : "=r" ( cpu_index )
+      : "i" ( X86_64_PER_CPU_INDEX_OFFSET )
+    );
+
+    return cpu_index;
   }
 
   void _CPU_SMP_Send_interrupt( uint32_t target_processor_index );
@@ -336,6 +521,7 @@ static inline CPU_Counter_ticks _CPU_Counter_difference(
   static inline bool _CPU_Context_Get_is_executing(
     const Context_Control *context
   )
+  {
     return context->is_executing;
   }
 
@@ -344,8 +530,18 @@ static inline CPU_Counter_ticks _CPU_Counter_difference(
     bool is_executing
   )
   {
+    context->is_executing = is_executing;
   }
 
+  /**
+   * @brief Makes the GS base of the calling processor point to its
+   * Per_CPU_Control.
+   *
+   * Must be called on each processor before it uses _Per_CPU_Get(), i.e. by
+   * the BSP's start code for the boot processor.
+   */
+  void _X86_64_SMP_Initialize_processor( uint32_t cpu_index );
+
 #endif /* RTEMS_SMP */
 
 typedef uintptr_t CPU_Uint32ptr;
@@ -20,7 +20,13 @@
 
 #include <rtems/score/cpu.h>
 
-#define CPU_PER_CPU_CONTROL_SIZE 0
+#if defined(RTEMS_SMP)
+  #define CPU_PER_CPU_CONTROL_SIZE 16
+#elif defined(X86_64_USE_LAZY_FP_SWITCH)
+  #define CPU_PER_CPU_CONTROL_SIZE 8
+#else
+  #define CPU_PER_CPU_CONTROL_SIZE 0
+#endif
 
 #ifndef ASM
 
@@ -28,6 +34,30 @@
 extern "C" {
 #endif
 
+typedef struct {
+#if defined(RTEMS_SMP)
+  /**
+   * @brief Points to the enclosing Per_CPU_Control, so that it can be loaded
+   * with a single GS relative move.
+   */
+  struct Per_CPU_Control *self;
+
+  /**
+   * @brief The index of this processor.
+   */
+  uint32_t cpu_index;
+
+  uint32_t reserved_for_alignment;
+#endif
+#if defined(X86_64_USE_LAZY_FP_SWITCH)
+  /**
+   * @brief The FP context whose state is currently held in the FPU, if it
+   * has not been saved yet.
+   */
+  Context_Control_fp *fp_owner;
+#endif
+} CPU_Per_CPU_control;
+
 static inline uint8_t inport_byte(uint16_t port)
 {
     uint8_t ret;
@@ -42,6 +72,70 @@ static inline void outport_byte(uint16_t port, uint8_t val)
     __asm__ volatile ( "outb %0, %1" : : "a" (val), "Nd" (port) );
 }
 
+static inline uint64_t rdmsr(uint32_t msr)
+{
+  uint32_t low, high;
+  __asm__ volatile ( "rdmsr" : "=a" (low), "=d" (high) : "c" (msr) );
+  return low | (uint64_t) high << 32;
+}
+
+static inline void wrmsr(uint32_t msr, uint64_t val)
+{
+  uint32_t low = (uint32_t) val;
+  uint32_t high = (uint32_t) (val >> 32);
+  __asm__ volatile ( "wrmsr" : : "a" (low), "d" (high), "c" (msr) );
+}
+
+static inline uint64_t rdtsc(void)
+{
+  uint32_t low, high;
+  __asm__ volatile ( "rdtsc" : "=a" (low), "=d" (high) );
+  return low | (uint64_t) high << 32;
+}
+
+static inline void cpuid_subleaf(
+  uint32_t code, uint32_t subleaf,
+  uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx
+) {
+  __asm__ volatile ( "cpuid"
+                     : "=a" (*eax), "=b" (*ebx), "=c" (*ecx), "=d" (*edx)
+                     : "a" (code), "c" (subleaf) );
+}
+
+static inline void cpuid(
+  uint32_t code, uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx
+) {
+  cpuid_subleaf(code, 0, eax, ebx, ecx, edx);
+}
+
+/**
+ * @brief True if the processors support and enabled WRFSBASE, see
+ * _X86_64_TLS_Initialize_processor().
+ */
+extern bool _X86_64_Has_fsgsbase;
+
+#ifdef RTEMS_SMP
+
+static inline struct Per_CPU_Control *_X86_64_Get_current_per_CPU_control(
+  void
+)
+{
+  struct Per_CPU_Control *cpu_self;
+
+  __asm__ volatile (
+    "movq %%gs:%c1, %0"
+    : "=r" ( cpu_self )
+    : "i" ( X86_64_PER_CPU_SELF_OFFSET )
+  );
+
+  return cpu_self;
+}
+
+#define _CPU_Get_current_per_CPU_control() \
+  _X86_64_Get_current_per_CPU_control()
+
+#endif /* RTEMS_SMP */
+
 #ifdef __cplusplus
 }
 #endif
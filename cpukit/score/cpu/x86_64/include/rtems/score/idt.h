@@ -0,0 +1,127 @@
+/**
+ * @file
+ *
+ * @brief x86_64 Interrupt Descriptor Table
+ */
+
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _RTEMS_SCORE_IDT_H
+#define _RTEMS_SCORE_IDT_H
+
+#include <rtems/score/cpu.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IDT_SIZE                  CPU_INTERRUPT_NUMBER_OF_VECTORS
+
+/* Number of vectors the architecture reserves for exceptions */
+#define IDT_EXCEPTION_VECTORS     32
+
+/* Present, DPL 0, 64-bit interrupt gate (interrupts disabled on entry) */
+#define IDT_INTERRUPT_GATE        0x8E
+
+/*
+ * Every vector has a fixed-size prologue which pushes the vector number and
+ * jumps to the common handler, see x86_64-isr-handler.S.
+ */
+#define X86_64_ISR_PROLOGUE_SIZE  16
+
+#ifndef ASM
+
+typedef struct {
+  uint16_t offset_0;
+  uint16_t segment_selector;
+  /* Bits 0-2 hold the interrupt stack table index, the rest is zero */
+  uint8_t  ist;
+  uint8_t  type_attributes;
+  uint16_t offset_1;
+  uint32_t offset_2;
+  uint32_t reserved;
+} RTEMS_PACKED interrupt_descriptor;
+
+RTEMS_STATIC_ASSERT(
+  sizeof(interrupt_descriptor) == 16,
+  interrupt_descriptor_size
+);
+
+typedef struct {
+  uint16_t limit;
+  uintptr_t base;
+} RTEMS_PACKED idt_register;
+
+extern interrupt_descriptor amd64_idt[IDT_SIZE];
+
+/**
+ * @brief Loads amd64_idt into the IDT register of the calling processor.
+ */
+void amd64_idt_load(void);
+
+/**
+ * @brief Prologues for the architectural exceptions, which enter
+ * _Exception_Handler.
+ */
+extern char _X86_64_Exception_prologues[];
+
+/**
+ * @brief Prologues for all vectors, which enter _ISR_Handler and dispatch
+ * through _ISR_Vector_table.
+ *
+ * The error code of exceptions which push one is discarded.
+ */
+extern char _X86_64_Interrupt_prologues[];
+
+#if defined(X86_64_USE_LAZY_FP_SWITCH)
+#define IDT_DEVICE_NOT_AVAILABLE 7
+
+/**
+ * @brief The #NM handler which switches the FP context lazily.
+ */
+extern char _X86_64_FP_Device_not_available[];
+#endif
+
+static inline uintptr_t amd64_idt_get_offset(const interrupt_descriptor *desc)
+{
+  return (uintptr_t) desc->offset_0 |
+    ((uintptr_t) desc->offset_1 << 16) |
+    ((uintptr_t) desc->offset_2 << 32);
+}
+
+static inline bool amd64_idt_is_present(const interrupt_descriptor *desc)
+{
+  return (desc->type_attributes & 0x80) != 0;
+}
+
+#endif /* !ASM */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTEMS_SCORE_IDT_H */
@@ -37,6 +37,29 @@ extern "C" {
 #define COM1_BASE_IO 0x3F8
 #define COM1_CLOCK_RATE (115200 * 16)
 
+/* Control register bits */
+#define X86_64_CR0_MP          (1 << 1)
+#define X86_64_CR0_EM          (1 << 2)
+#define X86_64_CR0_TS          (1 << 3)
+#define X86_64_CR4_OSFXSR      (1 << 9)
+#define X86_64_CR4_OSXMMEXCPT  (1 << 10)
+#define X86_64_CR4_FSGSBASE    (1 << 16)
+#define X86_64_CR4_OSXSAVE     (1 << 18)
+
+/* Model specific registers */
+#define X86_64_MSR_EFER        0xC0000080
+#define X86_64_MSR_FS_BASE     0xC0000100
+#define X86_64_MSR_GS_BASE     0xC0000101
+
+#ifdef RTEMS_SMP
+/*
+ * The GS base of each processor points to its Per_CPU_Control, which begins
+ * with the CPU_Per_CPU_control, see <rtems/score/cpuimpl.h>.
+ */
+#define X86_64_PER_CPU_SELF_OFFSET  0
+#define X86_64_PER_CPU_INDEX_OFFSET 8
+#endif
+
 #ifdef __cplusplus
 }
 #endif
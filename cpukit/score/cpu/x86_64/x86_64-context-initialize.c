@@ -75,12 +75,11 @@ void _CPU_Context_Initialize(
   /* avoid warning for being unused */
   (void) is_fp;
 
-  // XXX: Should be used in the future
-  (void) new_level;
-  (void) tls_area;
-
-  // XXX: Leaving interrupts off regardless of `new_level` for now
-  the_context->rflags = CPU_EFLAGS_INTERRUPTS_OFF;
+  if ( new_level ) {
+    the_context->rflags = CPU_EFLAGS_INTERRUPTS_OFF;
+  } else {
+    the_context->rflags = CPU_EFLAGS_INTERRUPTS_ON;
+  }
 
   _stack  = ((uintptr_t) stack_area_begin) + stack_area_size;
   _stack &= ~(CPU_STACK_ALIGNMENT - 1);
@@ -91,5 +90,10 @@ void _CPU_Context_Initialize(
   the_context->rbp     = (void *) 0;
   the_context->rsp     = (void *) _stack;
 
-  // XXX: Initialize thread-local storage area (TLS / TCB)
+  if ( tls_area != NULL ) {
+    the_context->fs_base =
+      (uintptr_t) _TLS_TCB_after_TLS_block_initialize( tls_area );
+  } else {
+    the_context->fs_base = 0;
+  }
 }
@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <rtems/score/cpuimpl.h>
+#include <rtems/score/isr.h>
+#include <rtems/score/percpu.h>
+#include <rtems/score/thread.h>
+#include <string.h>
+
+#define CPUID_01_ECX_XSAVE  (1 << 26)
+#define CPUID_01_ECX_AVX    (1 << 28)
+#define CPUID_0D_01_EAX_XSAVEOPT (1 << 0)
+
+#define XCR0_X87          0x01
+#define XCR0_SSE          0x02
+#define XCR0_AVX          0x04
+#define XCR0_AVX512       0xe0
+
+/* Offsets in the legacy region shared by FXSAVE and XSAVE */
+#define FP_AREA_FCW       0
+#define FP_AREA_MXCSR     24
+
+#define FCW_DEFAULT       0x037f
+#define MXCSR_DEFAULT     0x1f80
+
+static bool x86_64_fp_has_xsave;
+
+static bool x86_64_fp_has_xsaveopt;
+
+static uint64_t x86_64_fp_xcr0;
+
+static size_t x86_64_fp_area_size = 512;
+
+static inline uint64_t x86_64_read_cr0(void)
+{
+  uint64_t cr0;
+  __asm__ volatile ( "movq %%cr0, %0" : "=r" (cr0) );
+  return cr0;
+}
+
+static inline void x86_64_write_cr0(uint64_t cr0)
+{
+  __asm__ volatile ( "movq %0, %%cr0" : : "r" (cr0) : "memory" );
+}
+
+static inline uint64_t x86_64_read_cr4(void)
+{
+  uint64_t cr4;
+  __asm__ volatile ( "movq %%cr4, %0" : "=r" (cr4) );
+  return cr4;
+}
+
+static inline void x86_64_write_cr4(uint64_t cr4)
+{
+  __asm__ volatile ( "movq %0, %%cr4" : : "r" (cr4) : "memory" );
+}
+
+static inline void x86_64_xsetbv(uint32_t xcr, uint64_t val)
+{
+  __asm__ volatile (
+    "xsetbv"
+    :
+    : "c" (xcr), "a" ((uint32_t) val), "d" ((uint32_t) (val >> 32))
+  );
+}
+
+static inline void *x86_64_fp_area(const Context_Control_fp *fp_context)
+{
+  return (void *) (((uintptr_t) fp_context->area +
+    X86_64_FP_CONTEXT_AREA_ALIGNMENT - 1) &
+    ~((uintptr_t) X86_64_FP_CONTEXT_AREA_ALIGNMENT - 1));
+}
+
+static inline void x86_64_fp_save(const Context_Control_fp *fp_context)
+{
+  void *area = x86_64_fp_area(fp_context);
+  uint32_t low = (uint32_t) x86_64_fp_xcr0;
+  uint32_t high = (uint32_t) (x86_64_fp_xcr0 >> 32);
+
+  if (x86_64_fp_has_xsaveopt) {
+    __asm__ volatile (
+      "xsaveopt64 (%0)" : : "r" (area), "a" (low), "d" (high) : "memory"
+    );
+  } else if (x86_64_fp_has_xsave) {
+    __asm__ volatile (
+      "xsave64 (%0)" : : "r" (area), "a" (low), "d" (high) : "memory"
+    );
+  } else {
+    __asm__ volatile ( "fxsave64 (%0)" : : "r" (area) : "memory" );
+  }
+}
+
+static inline void x86_64_fp_restore(const Context_Control_fp *fp_context)
+{
+  void *area = x86_64_fp_area(fp_context);
+  uint32_t low = (uint32_t) x86_64_fp_xcr0;
+  uint32_t high = (uint32_t) (x86_64_fp_xcr0 >> 32);
+
+  if (x86_64_fp_has_xsave) {
+    __asm__ volatile (
+      "xrstor64 (%0)" : : "r" (area), "a" (low), "d" (high) : "memory"
+    );
+  } else {
+    __asm__ volatile ( "fxrstor64 (%0)" : : "r" (area) : "memory" );
+  }
+}
+
+void _X86_64_FP_Initialize_processor(void)
+{
+  uint32_t eax, ebx, ecx, edx;
+  uint64_t cr0;
+  uint64_t cr4;
+
+  cr0 = x86_64_read_cr0();
+  cr0 &= ~(uint64_t) X86_64_CR0_EM;
+  cr0 |= X86_64_CR0_MP;
+#if defined(X86_64_USE_LAZY_FP_SWITCH)
+  /* Let the first user of the FPU load its context */
+  cr0 |= X86_64_CR0_TS;
+#endif
+  x86_64_write_cr0(cr0);
+
+  cr4 = x86_64_read_cr4() | X86_64_CR4_OSFXSR | X86_64_CR4_OSXMMEXCPT;
+
+  cpuid(1, &eax, &ebx, &ecx, &edx);
+  if ((ecx & CPUID_01_ECX_XSAVE) == 0) {
+    x86_64_write_cr4(cr4);
+    return;
+  }
+
+  x86_64_write_cr4(cr4 | X86_64_CR4_OSXSAVE);
+
+  x86_64_fp_xcr0 = XCR0_X87 | XCR0_SSE;
+  if ((ecx & CPUID_01_ECX_AVX) != 0) {
+    x86_64_fp_xcr0 |= XCR0_AVX;
+
+    /* The AVX-512 state is only usable as a whole */
+    cpuid_subleaf(0xd, 0, &eax, &ebx, &ecx, &edx);
+    if ((eax & XCR0_AVX512) == XCR0_AVX512) {
+      x86_64_fp_xcr0 |= XCR0_AVX512;
+    }
+  }
+
+  x86_64_xsetbv(0, x86_64_fp_xcr0);
+
+  /* EBX is the area size needed by the components enabled in XCR0 */
+  cpuid_subleaf(0xd, 0, &eax, &ebx, &ecx, &edx);
+  if (ebx > X86_64_FP_CONTEXT_AREA_SIZE) {
+    x86_64_fp_xcr0 &= ~(uint64_t) XCR0_AVX512;
+    x86_64_xsetbv(0, x86_64_fp_xcr0);
+    cpuid_subleaf(0xd, 0, &eax, &ebx, &ecx, &edx);
+  }
+  x86_64_fp_area_size = ebx;
+
+  cpuid_subleaf(0xd, 1, &eax, &ebx, &ecx, &edx);
+  x86_64_fp_has_xsaveopt = (eax & CPUID_0D_01_EAX_XSAVEOPT) != 0;
+  x86_64_fp_has_xsave = true;
+}
+
+void _CPU_Context_Initialize_fp(Context_Control_fp **fp_context_ptr)
+{
+  Context_Control_fp *fp_context = *fp_context_ptr;
+  uint8_t *area = x86_64_fp_area(fp_context);
+  uint16_t fcw = FCW_DEFAULT;
+  uint32_t mxcsr = MXCSR_DEFAULT;
+
+#if defined(X86_64_USE_LAZY_FP_SWITCH)
+  Per_CPU_Control *cpu_self = _Per_CPU_Get();
+
+  /* The FPU may still hold the state of a restarted thread */
+  if (cpu_self->cpu_per_cpu.fp_owner == fp_context) {
+    cpu_self->cpu_per_cpu.fp_owner = NULL;
+  }
+#endif
+
+  /*
+   * An all-zero XSAVE header puts every component into its initial state on
+   * XRSTOR; the MXCSR is always taken from the legacy region.
+   */
+  memset(area, 0, x86_64_fp_area_size);
+  memcpy(&area[FP_AREA_FCW], &fcw, sizeof(fcw));
+  memcpy(&area[FP_AREA_MXCSR], &mxcsr, sizeof(mxcsr));
+}
+
+#if defined(X86_64_USE_LAZY_FP_SWITCH)
+
+void _CPU_Context_save_fp(Context_Control_fp **fp_context_ptr)
+{
+  (void) fp_context_ptr;
+
+  /*
+   * The state stays in the FPU until some other thread uses it, see
+   * _X86_64_FP_Lazy_switch().
+   */
+  x86_64_write_cr0(x86_64_read_cr0() | X86_64_CR0_TS);
+}
+
+void _CPU_Context_restore_fp(Context_Control_fp **fp_context_ptr)
+{
+  Per_CPU_Control *cpu_self;
+  ISR_Level level;
+  uint64_t cr0;
+
+  _ISR_Local_disable(level);
+
+  cpu_self = _Per_CPU_Get();
+  cr0 = x86_64_read_cr0();
+
+  if (cpu_self->cpu_per_cpu.fp_owner == *fp_context_ptr) {
+    cr0 &= ~(uint64_t) X86_64_CR0_TS;
+  } else {
+    cr0 |= X86_64_CR0_TS;
+  }
+
+  x86_64_write_cr0(cr0);
+
+  _ISR_Local_enable(level);
+}
+
+/*
+ * Called by the #NM handler with interrupts disabled, so it must not use the
+ * FPU itself.
+ */
+void _X86_64_FP_Lazy_switch(void) __attribute__((target("general-regs-only")));
+
+void _X86_64_FP_Lazy_switch(void)
+{
+  Per_CPU_Control *cpu_self;
+  Thread_Control *executing;
+  Context_Control_fp *owner;
+  Context_Control_fp *next;
+
+  __asm__ volatile ( "clts" : : : "memory" );
+
+  cpu_self = _Per_CPU_Get();
+  executing = cpu_self->executing;
+  owner = cpu_self->cpu_per_cpu.fp_owner;
+
+  /*
+   * Interrupt handlers and threads without an FP context may use the SSE
+   * registers as scratch registers only.
+   */
+  if (executing != NULL && cpu_self->isr_nest_level == 0) {
+    next = executing->fp_context;
+  } else {
+    next = NULL;
+  }
+
+  if (owner == next) {
+    return;
+  }
+
+  if (owner != NULL) {
+    x86_64_fp_save(owner);
+  }
+
+  if (next != NULL) {
+    x86_64_fp_restore(next);
+  }
+
+  cpu_self->cpu_per_cpu.fp_owner = next;
+}
+
+#else /* X86_64_USE_LAZY_FP_SWITCH */
+
+void _CPU_Context_save_fp(Context_Control_fp **fp_context_ptr)
+{
+  x86_64_fp_save(*fp_context_ptr);
+}
+
+void _CPU_Context_restore_fp(Context_Control_fp **fp_context_ptr)
+{
+  x86_64_fp_restore(*fp_context_ptr);
+}
+
+#endif /* X86_64_USE_LAZY_FP_SWITCH */
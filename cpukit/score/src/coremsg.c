@@ -50,26 +50,20 @@ bool _CORE_message_queue_Initialize(
 )
 {
   size_t message_buffering_required = 0;
-  size_t aligned_message_size;
-  size_t align_mask;
+  size_t buffer_size;
 
   the_message_queue->maximum_pending_messages   = maximum_pending_messages;
   the_message_queue->number_of_pending_messages = 0;
   the_message_queue->maximum_message_size       = maximum_message_size;
   _CORE_message_queue_Set_notify( the_message_queue, NULL );
 
-  /*
-   * Align up the maximum message size to be an integral multiple of the
-   * pointer size.
-   */
-  align_mask = sizeof(uintptr_t) - 1;
-  aligned_message_size = ( maximum_message_size + align_mask ) & ~align_mask;
+  buffer_size = _CORE_message_queue_Buffer_control_size( maximum_message_size );
 
   /*
    * Check for an integer overflow.  It can occur while aligning up the maximum
    * message size.
    */
-  if (aligned_message_size < maximum_message_size)
+  if (buffer_size < maximum_message_size)
     return false;
 
   /*
@@ -78,7 +72,7 @@ bool _CORE_message_queue_Initialize(
    */
   if ( !size_t_mult32_with_overflow(
         (size_t) maximum_pending_messages,
-        aligned_message_size + sizeof(CORE_message_queue_Buffer_control),
+        buffer_size,
         &message_buffering_required ) ) 
     return false;
 
@@ -99,7 +93,7 @@ bool _CORE_message_queue_Initialize(
     &the_message_queue->Inactive_messages,
     the_message_queue->message_buffers,
     (size_t) maximum_pending_messages,
-    aligned_message_size + sizeof( CORE_message_queue_Buffer_control )
+    buffer_size
   );
 
   _Chain_Initialize_empty( &the_message_queue->Pending_messages );
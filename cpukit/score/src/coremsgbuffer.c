@@ -0,0 +1,226 @@
+/**
+ * @file
+ *
+ * @brief CORE Message Queue Lent Buffers
+ *
+ * @ingroup ScoreMessageQueue
+ */
+
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <rtems/score/coremsgimpl.h>
+#include <rtems/score/threadimpl.h>
+#include <rtems/score/statesimpl.h>
+
+/*
+ * A lent message buffer is off chain.  This distinguishes it from the
+ * message buffers on the inactive and pending message chains, see
+ * _CORE_message_queue_Get_lent_buffer().
+ */
+static void _CORE_message_queue_Lend_buffer(
+  CORE_message_queue_Buffer_control  *the_message,
+  CORE_message_queue_Buffer_control **the_message_p
+)
+{
+  _Chain_Set_off_chain( &the_message->Node );
+  *the_message_p = the_message;
+}
+
+Status_Control _CORE_message_queue_Get_buffer(
+  CORE_message_queue_Control         *the_message_queue,
+  CORE_message_queue_Buffer_control **the_message_p,
+  Thread_queue_Context               *queue_context
+)
+{
+  CORE_message_queue_Buffer_control *the_message;
+
+  the_message =
+    _CORE_message_queue_Allocate_message_buffer( the_message_queue );
+  if ( the_message == NULL ) {
+    _CORE_message_queue_Release( the_message_queue, queue_context );
+    return STATUS_TOO_MANY;
+  }
+
+  _CORE_message_queue_Lend_buffer( the_message, the_message_p );
+  _CORE_message_queue_Release( the_message_queue, queue_context );
+  return STATUS_SUCCESSFUL;
+}
+
+Status_Control _CORE_message_queue_Submit_buffer(
+  CORE_message_queue_Control        *the_message_queue,
+  CORE_message_queue_Buffer_control *the_message,
+  size_t                             size,
+  CORE_message_queue_Submit_types    submit_type,
+  Thread_queue_Context              *queue_context
+)
+{
+  Thread_Control *the_thread;
+
+  if ( size > the_message_queue->maximum_message_size ) {
+    _CORE_message_queue_Release( the_message_queue, queue_context );
+    return STATUS_MESSAGE_INVALID_SIZE;
+  }
+
+  the_message->Contents.size = size;
+
+  /*
+   *  If there are pending messages, then there can't be threads
+   *  waiting for us to send them a message.
+   */
+  if ( the_message_queue->number_of_pending_messages == 0 ) {
+    the_thread = _Thread_queue_First_locked(
+      &the_message_queue->Wait_queue,
+      the_message_queue->operations
+    );
+  } else {
+    the_thread = NULL;
+  }
+
+  if ( the_thread == NULL ) {
+    _CORE_message_queue_Insert_buffer(
+      the_message_queue,
+      the_message,
+      submit_type
+    );
+    _CORE_message_queue_Release_and_notify( the_message_queue, queue_context );
+    return STATUS_SUCCESSFUL;
+  }
+
+  if ( the_thread->Wait.return_argument == NULL ) {
+    /*
+     *  The receiver waits in _CORE_message_queue_Seize_buffer(), so hand
+     *  over the message buffer itself.
+     */
+    _CORE_message_queue_Lend_buffer(
+      the_message,
+      the_thread->Wait.return_argument_second.mutable_object
+    );
+  } else {
+    /*
+     *  The receiver provided its own buffer, so this is the one copy of the
+     *  message content.
+     */
+    *(size_t *) the_thread->Wait.return_argument = size;
+    _CORE_message_queue_Copy_buffer(
+      the_message->Contents.buffer,
+      the_thread->Wait.return_argument_second.mutable_object,
+      size
+    );
+    _CORE_message_queue_Free_message_buffer( the_message_queue, the_message );
+  }
+
+  the_thread->Wait.count = (uint32_t) submit_type;
+
+  _Thread_queue_Extract_critical(
+    &the_message_queue->Wait_queue.Queue,
+    the_message_queue->operations,
+    the_thread,
+    queue_context
+  );
+  return STATUS_SUCCESSFUL;
+}
+
+Status_Control _CORE_message_queue_Seize_buffer(
+  CORE_message_queue_Control         *the_message_queue,
+  Thread_Control                     *executing,
+  CORE_message_queue_Buffer_control **the_message_p,
+  bool                                wait,
+  Thread_queue_Context               *queue_context
+)
+{
+  CORE_message_queue_Buffer_control *the_message;
+
+  the_message = _CORE_message_queue_Get_pending_message( the_message_queue );
+  if ( the_message != NULL ) {
+    the_message_queue->number_of_pending_messages -= 1;
+
+    executing->Wait.count =
+      _CORE_message_queue_Get_message_priority( the_message );
+    _CORE_message_queue_Lend_buffer( the_message, the_message_p );
+
+    /*
+     *  The message buffer stays lent, so a thread waiting to send is
+     *  served once the buffer is returned.
+     */
+    _CORE_message_queue_Release( the_message_queue, queue_context );
+    return STATUS_SUCCESSFUL;
+  }
+
+  if ( !wait ) {
+    _CORE_message_queue_Release( the_message_queue, queue_context );
+    return STATUS_UNSATISFIED;
+  }
+
+  /*
+   *  A NULL return argument tells the senders that this thread borrows the
+   *  message buffer instead of providing a buffer for a copy.
+   */
+  executing->Wait.return_argument_second.mutable_object = the_message_p;
+  executing->Wait.return_argument = NULL;
+  /* Wait.count will be filled in with the message priority */
+
+  _Thread_queue_Context_set_thread_state(
+    queue_context,
+    STATES_WAITING_FOR_MESSAGE
+  );
+  _Thread_queue_Enqueue(
+    &the_message_queue->Wait_queue.Queue,
+    the_message_queue->operations,
+    executing,
+    queue_context
+  );
+  return _Thread_Wait_get_status( executing );
+}
+
+void _CORE_message_queue_Return_buffer(
+  CORE_message_queue_Control        *the_message_queue,
+  CORE_message_queue_Buffer_control *the_message,
+  Thread_queue_Context              *queue_context
+)
+{
+#if defined(RTEMS_SCORE_COREMSG_ENABLE_BLOCKING_SEND)
+  /*
+   *  Threads waiting to receive imply that there are no pending messages,
+   *  so with pending messages a waiting thread waits to send.  This code
+   *  puts its message in the message queue on behalf of the waiting task.
+   */
+  if ( the_message_queue->number_of_pending_messages != 0 ) {
+    Thread_Control *the_thread;
+
+    the_thread = _Thread_queue_First_locked(
+      &the_message_queue->Wait_queue,
+      the_message_queue->operations
+    );
+    if ( the_thread != NULL ) {
+      _CORE_message_queue_Insert_message(
+        the_message_queue,
+        the_message,
+        the_thread->Wait.return_argument_second.immutable_object,
+        (size_t) the_thread->Wait.option,
+        (CORE_message_queue_Submit_types) the_thread->Wait.count
+      );
+      _Thread_queue_Extract_critical(
+        &the_message_queue->Wait_queue.Queue,
+        the_message_queue->operations,
+        the_thread,
+        queue_context
+      );
+      return;
+    }
+  }
+#endif
+
+  _CORE_message_queue_Free_message_buffer( the_message_queue, the_message );
+  _CORE_message_queue_Release( the_message_queue, queue_context );
+}
@@ -73,28 +73,7 @@ Status_Control _CORE_message_queue_Submit(
       size,
       submit_type
     );
-
-#if defined(RTEMS_SCORE_COREMSG_ENABLE_NOTIFICATION)
-    /*
-     *  According to POSIX, does this happen before or after the message
-     *  is actually enqueued.  It is logical to think afterwards, because
-     *  the message is actually in the queue at this point.
-     */
-    if (
-      the_message_queue->number_of_pending_messages == 1
-        && the_message_queue->notify_handler != NULL
-    ) {
-      ( *the_message_queue->notify_handler )(
-        the_message_queue,
-        queue_context
-      );
-    } else {
-      _CORE_message_queue_Release( the_message_queue, queue_context );
-    }
-#else
-    _CORE_message_queue_Release( the_message_queue, queue_context );
-#endif
-
+    _CORE_message_queue_Release_and_notify( the_message_queue, queue_context );
     return STATUS_SUCCESSFUL;
   }
 
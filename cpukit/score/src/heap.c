@@ -256,8 +256,6 @@ uintptr_t _Heap_Initialize(
   /* First block */
   first_block->prev_size = heap_area_end;
   first_block->size_and_flag = first_block_size | HEAP_PREV_BLOCK_USED;
-  first_block->next = _Heap_Free_list_tail( heap );
-  first_block->prev = _Heap_Free_list_head( heap );
   _Heap_Protection_block_initialize( heap, first_block );
 
   /* Heap control */
@@ -267,8 +265,9 @@ uintptr_t _Heap_Initialize(
   heap->area_end = heap_area_end;
   heap->first_block = first_block;
   heap->last_block = last_block;
-  _Heap_Free_list_head( heap )->next = first_block;
-  _Heap_Free_list_tail( heap )->prev = first_block;
+  _Heap_Free_list_head( heap )->next = _Heap_Free_list_tail( heap );
+  _Heap_Free_list_tail( heap )->prev = _Heap_Free_list_head( heap );
+  _Heap_Free_list_insert( heap, first_block );
 
   /* Last block */
   last_block->prev_size = first_block_size;
@@ -297,10 +296,121 @@ uintptr_t _Heap_Initialize(
   return first_block_size;
 }
 
+static Heap_Block *_Heap_Free_list_search(
+  Heap_Control *heap,
+  unsigned int fl,
+  unsigned int sl
+)
+{
+  Heap_Free_list_index *const index = &heap->free_list_index;
+  unsigned long sl_map = 0;
+
+  if ( sl < HEAP_FREE_LIST_SECOND_LEVEL_COUNT ) {
+    sl_map = index->second_level[ fl ] & ( ~0UL << sl );
+  }
+
+  if ( sl_map == 0 ) {
+    unsigned long fl_map = 0;
+
+    if ( fl + 1 < HEAP_FREE_LIST_FIRST_LEVEL_COUNT ) {
+      fl_map = index->first_level & ( ~0UL << ( fl + 1 ) );
+    }
+
+    if ( fl_map == 0 ) {
+      return _Heap_Free_list_tail( heap );
+    }
+
+    fl = (unsigned int) __builtin_ctzl( fl_map );
+    sl_map = index->second_level[ fl ];
+  }
+
+  sl = (unsigned int) __builtin_ctzl( sl_map );
+
+  return index->first[ fl * HEAP_FREE_LIST_SECOND_LEVEL_COUNT + sl ];
+}
+
+Heap_Block *_Heap_Free_list_first_of_class(
+  Heap_Control *heap,
+  uintptr_t size
+)
+{
+  unsigned int fl;
+  unsigned int sl;
+
+  _Heap_Free_list_mapping( size, &fl, &sl );
+
+  return _Heap_Free_list_search( heap, fl, sl );
+}
+
+Heap_Block *_Heap_Free_list_first_above_class(
+  Heap_Control *heap,
+  uintptr_t size
+)
+{
+  unsigned int fl;
+  unsigned int sl;
+
+  _Heap_Free_list_mapping( size, &fl, &sl );
+
+  return _Heap_Free_list_search( heap, fl, sl + 1 );
+}
+
+void _Heap_Free_list_insert( Heap_Control *heap, Heap_Block *block )
+{
+  Heap_Free_list_index *const index = &heap->free_list_index;
+  unsigned int fl;
+  unsigned int sl;
+  unsigned int c;
+  Heap_Block *next;
+
+  _Heap_Free_list_mapping( _Heap_Block_size( block ), &fl, &sl );
+  c = fl * HEAP_FREE_LIST_SECOND_LEVEL_COUNT + sl;
+  next = index->first[ c ];
+
+  if ( next == NULL ) {
+    next = _Heap_Free_list_search( heap, fl, sl + 1 );
+    index->second_level[ fl ] |= (uint8_t) ( 1U << sl );
+    index->first_level |= (uintptr_t) 1 << fl;
+  }
+
+  index->first[ c ] = block;
+  _Heap_Free_list_insert_before( next, block );
+}
+
+void _Heap_Free_list_extract( Heap_Control *heap, Heap_Block *block )
+{
+  Heap_Free_list_index *const index = &heap->free_list_index;
+  unsigned int fl;
+  unsigned int sl;
+  unsigned int c;
+
+  _Heap_Free_list_mapping( _Heap_Block_size( block ), &fl, &sl );
+  c = fl * HEAP_FREE_LIST_SECOND_LEVEL_COUNT + sl;
+
+  if ( index->first[ c ] == block ) {
+    Heap_Block *const next = block->next;
+
+    if (
+      next != _Heap_Free_list_tail( heap )
+        && _Heap_Free_list_class( _Heap_Block_size( next ) ) == c
+    ) {
+      index->first[ c ] = next;
+    } else {
+      index->first[ c ] = NULL;
+      index->second_level[ fl ] &= (uint8_t) ~( 1U << sl );
+
+      if ( index->second_level[ fl ] == 0 ) {
+        index->first_level &= ~( (uintptr_t) 1 << fl );
+      }
+    }
+  }
+
+  _Heap_Free_list_remove( block );
+}
+
 static void _Heap_Block_split(
   Heap_Control *heap,
   Heap_Block *block,
-  Heap_Block *free_list_anchor,
   uintptr_t alloc_size
 )
 {
@@ -336,14 +446,12 @@ static void _Heap_Block_split(
     stats->free_size += free_block_size;
 
     if ( _Heap_Is_used( next_block ) ) {
-      _Heap_Free_list_insert_after( free_list_anchor, free_block );
-
       /* Statistics */
       ++stats->free_blocks;
     } else {
       uintptr_t const next_block_size = _Heap_Block_size( next_block );
 
-      _Heap_Free_list_replace( next_block, free_block );
+      _Heap_Free_list_extract( heap, next_block );
 
       free_block_size += next_block_size;
 
@@ -351,6 +459,7 @@ static void _Heap_Block_split(
     }
 
     free_block->size_and_flag = free_block_size | HEAP_PREV_BLOCK_USED;
+    _Heap_Free_list_insert( heap, free_block );
 
     next_block->prev_size = free_block_size;
     next_block->size_and_flag &= ~HEAP_PREV_BLOCK_USED;
@@ -364,11 +473,10 @@ static void _Heap_Block_split(
 static Heap_Block *_Heap_Block_allocate_from_begin(
   Heap_Control *heap,
   Heap_Block *block,
-  Heap_Block *free_list_anchor,
   uintptr_t alloc_size
 )
 {
-  _Heap_Block_split( heap, block, free_list_anchor, alloc_size );
+  _Heap_Block_split( heap, block, alloc_size );
 
   return block;
 }
@@ -376,7 +484,6 @@ static Heap_Block *_Heap_Block_allocate_from_begin(
 static Heap_Block *_Heap_Block_allocate_from_end(
   Heap_Control *heap,
   Heap_Block *block,
-  Heap_Block *free_list_anchor,
   uintptr_t alloc_begin,
   uintptr_t alloc_size
 )
@@ -402,26 +509,25 @@ static Heap_Block *_Heap_Block_allocate_from_end(
   stats->free_size += block_size;
 
   if ( _Heap_Is_prev_used( block ) ) {
-    _Heap_Free_list_insert_after( free_list_anchor, block );
-
-    free_list_anchor = block;
-
     /* Statistics */
     ++stats->free_blocks;
   } else {
     Heap_Block *const prev_block = _Heap_Prev_block( block );
     uintptr_t const prev_block_size = _Heap_Block_size( prev_block );
 
+    _Heap_Free_list_extract( heap, prev_block );
+
     block = prev_block;
     block_size += prev_block_size;
   }
 
   block->size_and_flag = block_size | HEAP_PREV_BLOCK_USED;
+  _Heap_Free_list_insert( heap, block );
 
   new_block->prev_size = block_size;
   new_block->size_and_flag = new_block_size;
 
-  _Heap_Block_split( heap, new_block, free_list_anchor, alloc_size );
+  _Heap_Block_split( heap, new_block, alloc_size );
 
   return new_block;
 }
@@ -438,21 +544,15 @@ Heap_Block *_Heap_Block_allocate(
   uintptr_t const alloc_area_begin = _Heap_Alloc_area_of_block( block );
   uintptr_t const alloc_area_offset = alloc_begin - alloc_area_begin;
 
-  Heap_Block *free_list_anchor = NULL;
-
   _HAssert( alloc_area_begin <= alloc_begin );
 
   if ( _Heap_Is_free( block ) ) {
-    free_list_anchor = block->prev;
-
-    _Heap_Free_list_remove( block );
+    _Heap_Free_list_extract( heap, block );
 
     /* Statistics */
     --stats->free_blocks;
     ++stats->used_blocks;
     stats->free_size -= _Heap_Block_size( block );
-  } else {
-    free_list_anchor = _Heap_Free_list_head( heap );
   }
 
   if ( alloc_area_offset < heap->page_size ) {
@@ -461,14 +561,12 @@ Heap_Block *_Heap_Block_allocate(
     block = _Heap_Block_allocate_from_begin(
       heap,
       block,
-      free_list_anchor,
       alloc_size
     );
   } else {
     block = _Heap_Block_allocate_from_end(
       heap,
       block,
-      free_list_anchor,
       alloc_begin,
       alloc_size
     );
@@ -220,7 +220,11 @@ void *_Heap_Allocate_aligned_with_boundary(
   do {
     Heap_Block *const free_list_tail = _Heap_Free_list_tail( heap );
 
-    block = _Heap_Free_list_first( heap );
+    /*
+     * The free list is ordered by size classes.  Free blocks of a size class
+     * less than the size class of the block size floor are too small.
+     */
+    block = _Heap_Free_list_first_of_class( heap, block_size_floor );
     while ( block != free_list_tail ) {
       _HAssert( _Heap_Is_prev_used( block ) );
 
@@ -252,7 +256,17 @@ void *_Heap_Allocate_aligned_with_boundary(
         break;
       }
 
-      block = block->next;
+      if ( alignment == 0 ) {
+        /*
+         * The first free block of a greater size class is large enough.  This
+         * bounds the search to two blocks.  Other blocks of the size class of
+         * the block size floor may be large enough, however, they are not
+         * examined, see _Heap_Allocate().
+         */
+        block = _Heap_Free_list_first_above_class( heap, block_size_floor );
+      } else {
+        block = block->next;
+      }
     }
 
     search_again = _Heap_Protection_free_delayed_blocks( heap, alloc_begin );
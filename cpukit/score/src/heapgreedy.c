@@ -80,17 +80,57 @@ Heap_Block *_Heap_Greedy_allocate_all_except_largest(
   uintptr_t *allocatable_size
 )
 {
-  Heap_Information info;
+  Heap_Block *const free_list_tail = _Heap_Free_list_tail( heap );
+  Heap_Block *largest = NULL;
+  Heap_Block *blocks = NULL;
+  Heap_Block *current;
+  Heap_Block *next;
+
+  _Heap_Protection_free_all_delayed_blocks( heap );
+
+  /*
+   * Do not use _Heap_Allocate() to keep the largest block.  It may miss the
+   * largest block if this block is not the first block of its size class.
+   */
+  current = _Heap_Free_list_first( heap );
+  while ( current != free_list_tail ) {
+    if (
+      largest == NULL
+        || _Heap_Block_size( current ) > _Heap_Block_size( largest )
+    ) {
+      largest = current;
+    }
 
-  _Heap_Get_free_information( heap, &info );
+    current = current->next;
+  }
 
-  if ( info.largest > 0 ) {
-    *allocatable_size = info.largest - HEAP_BLOCK_HEADER_SIZE + HEAP_ALLOC_BONUS;
+  if ( largest != NULL ) {
+    *allocatable_size = _Heap_Block_size( largest ) - HEAP_BLOCK_HEADER_SIZE
+      + HEAP_ALLOC_BONUS;
   } else {
     *allocatable_size = 0;
   }
 
-  return _Heap_Greedy_allocate( heap, allocatable_size, 1 );
+  current = _Heap_Free_list_first( heap );
+  while ( current != free_list_tail ) {
+    next = current->next;
+
+    if ( current != largest ) {
+      _Heap_Block_allocate(
+        heap,
+        current,
+        _Heap_Alloc_area_of_block( current ),
+        _Heap_Block_size( current ) - HEAP_BLOCK_HEADER_SIZE
+      );
+
+      current->next = blocks;
+      blocks = current;
+    }
+
+    current = next;
+  }
+
+  return blocks;
 }
 
 void _Heap_Greedy_free(
@@ -60,9 +60,9 @@ static Heap_Resize_status _Heap_Resize_block_checked(
   }
 
   if ( next_block_is_free ) {
-    _Heap_Block_set_size( block, block_size );
+    _Heap_Free_list_extract( heap, next_block );
 
-    _Heap_Free_list_remove( next_block );
+    _Heap_Block_set_size( block, block_size );
 
     next_block = _Heap_Block_at( block, block_size );
     next_block->size_and_flag |= HEAP_PREV_BLOCK_USED;
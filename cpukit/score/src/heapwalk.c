@@ -120,6 +120,123 @@ static bool _Heap_Walk_check_free_list(
   return true;
 }
 
+static bool _Heap_Walk_check_free_list_index(
+  int source,
+  Heap_Walk_printer printer,
+  Heap_Control *heap
+)
+{
+  const Heap_Free_list_index *const index = &heap->free_list_index;
+  const Heap_Block *const free_list_tail = _Heap_Free_list_tail( heap );
+  const Heap_Block *free_block = _Heap_Free_list_first( heap );
+  unsigned int class_count = 0;
+  unsigned int index_count = 0;
+  unsigned int prev_class = 0;
+  unsigned int fl;
+  unsigned int sl;
+
+  while ( free_block != free_list_tail ) {
+    uintptr_t const block_size = _Heap_Block_size( free_block );
+    unsigned int c;
+
+    if ( block_size < heap->min_block_size ) {
+      (*printer)(
+        source,
+        true,
+        "free block 0x%08x: size %u < min block size %u\n",
+        free_block,
+        block_size,
+        heap->min_block_size
+      );
+
+      return false;
+    }
+
+    c = _Heap_Free_list_class( block_size );
+
+    if ( class_count > 0 && c < prev_class ) {
+      (*printer)(
+        source,
+        true,
+        "free block 0x%08x: size class %u < previous size class %u\n",
+        free_block,
+        c,
+        prev_class
+      );
+
+      return false;
+    }
+
+    if ( class_count == 0 || c != prev_class ) {
+      if ( index->first[ c ] != free_block ) {
+        (*printer)(
+          source,
+          true,
+          "free block 0x%08x: not first in size class %u\n",
+          free_block,
+          c
+        );
+
+        return false;
+      }
+
+      ++class_count;
+      prev_class = c;
+    }
+
+    free_block = free_block->next;
+  }
+
+  for ( fl = 0; fl < HEAP_FREE_LIST_FIRST_LEVEL_COUNT; ++fl ) {
+    bool const fl_bit = ( index->first_level & ( (uintptr_t) 1 << fl ) ) != 0;
+
+    if ( fl_bit != ( index->second_level[ fl ] != 0 ) ) {
+      (*printer)(
+        source,
+        true,
+        "free list index: invalid first level bitmap 0x%08x\n",
+        index->first_level
+      );
+
+      return false;
+    }
+
+    for ( sl = 0; sl < HEAP_FREE_LIST_SECOND_LEVEL_COUNT; ++sl ) {
+      unsigned int const c = fl * HEAP_FREE_LIST_SECOND_LEVEL_COUNT + sl;
+      bool const sl_bit = ( index->second_level[ fl ] & ( 1U << sl ) ) != 0;
+
+      if ( sl_bit != ( index->first[ c ] != NULL ) ) {
+        (*printer)(
+          source,
+          true,
+          "free list index: invalid second level bitmap for size class %u\n",
+          c
+        );
+
+        return false;
+      }
+
+      if ( sl_bit ) {
+        ++index_count;
+      }
+    }
+  }
+
+  if ( index_count != class_count ) {
+    (*printer)(
+      source,
+      true,
+      "free list index: %u size classes != %u size classes in free list\n",
+      index_count,
+      class_count
+    );
+
+    return false;
+  }
+
+  return true;
+}
+
 static bool _Heap_Walk_is_in_free_list(
   Heap_Control *heap,
   Heap_Block *block
@@ -237,7 +354,11 @@ static bool _Heap_Walk_check_control(
     return false;
   }
 
-  return _Heap_Walk_check_free_list( source, printer, heap );
+  if ( !_Heap_Walk_check_free_list( source, printer, heap ) ) {
+    return false;
+  }
+
+  return _Heap_Walk_check_free_list_index( source, printer, heap );
 }
 
 static bool _Heap_Walk_check_free_block(
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <rtems/bdbuf.h>
+#include <rtems/blkdev.h>
+#include <rtems/dosfs.h>
+#include <rtems/libio.h>
+#include <rtems/rtems-rfs-format.h>
+
+const char rtems_test_name[] = "FSDIRECTIO 1";
+
+#define DISK "/dev/disk"
+
+#define MNT "/mnt"
+
+#define FILE_PATH "/mnt/file"
+
+#define MEDIA_BLOCK_SIZE 512
+
+#define MEDIA_BLOCK_COUNT 1024
+
+#define FILE_SIZE (8 * MEDIA_BLOCK_SIZE)
+
+static char disk_data [MEDIA_BLOCK_COUNT][MEDIA_BLOCK_SIZE];
+
+static const char *user_begin;
+
+static const char *user_end;
+
+static size_t direct_reads;
+
+static size_t direct_writes;
+
+/*
+ * A transfer is direct if the driver gets a buffer inside the user buffer
+ * instead of a buffer of the bdbuf cache.
+ */
+static bool is_user_buffer(const void *buffer)
+{
+  const char *b = buffer;
+
+  return b >= user_begin && b < user_end;
+}
+
+static int disk_ioctl(rtems_disk_device *dd, uint32_t req, void *arg)
+{
+  int rv = 0;
+
+  if (req == RTEMS_BLKIO_REQUEST) {
+    rtems_blkdev_request *breq = arg;
+    uint32_t i;
+
+    for (i = 0; i < breq->bufnum; ++i) {
+      rtems_blkdev_sg_buffer *sg = &breq->bufs [i];
+      char *data = disk_data [sg->block];
+
+      rtems_test_assert(
+        sg->block + sg->length / MEDIA_BLOCK_SIZE <= MEDIA_BLOCK_COUNT
+      );
+
+      if (breq->req == RTEMS_BLKDEV_REQ_READ) {
+        memcpy(sg->buffer, data, sg->length);
+
+        if (is_user_buffer(sg->buffer)) {
+          ++direct_reads;
+        }
+      } else {
+        memcpy(data, sg->buffer, sg->length);
+
+        if (is_user_buffer(sg->buffer)) {
+          ++direct_writes;
+        }
+      }
+    }
+
+    rtems_blkdev_request_done(breq, RTEMS_SUCCESSFUL);
+  } else {
+    rv = rtems_blkdev_ioctl(dd, req, arg);
+  }
+
+  return rv;
+}
+
+static void set_user_buffer(const char *buf, size_t size)
+{
+  user_begin = buf;
+  user_end = buf + size;
+  direct_reads = 0;
+  direct_writes = 0;
+}
+
+static void fill(char *buf, char c)
+{
+  size_t i;
+
+  for (i = 0; i < FILE_SIZE; ++i) {
+    buf [i] = (char) (c + i / MEDIA_BLOCK_SIZE);
+  }
+}
+
+static bool is_filled(const char *buf, char c)
+{
+  size_t i;
+
+  for (i = 0; i < FILE_SIZE; ++i) {
+    if (buf [i] != (char) (c + i / MEDIA_BLOCK_SIZE)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void write_file(int fd, const char *buf)
+{
+  off_t pos;
+  ssize_t n;
+
+  pos = lseek(fd, 0, SEEK_SET);
+  rtems_test_assert(pos == 0);
+
+  n = write(fd, buf, FILE_SIZE);
+  rtems_test_assert(n == FILE_SIZE);
+}
+
+static void read_file(int fd, char *buf)
+{
+  off_t pos;
+  ssize_t n;
+
+  memset(buf, 0, FILE_SIZE);
+
+  pos = lseek(fd, 0, SEEK_SET);
+  rtems_test_assert(pos == 0);
+
+  n = read(fd, buf, FILE_SIZE);
+  rtems_test_assert(n == FILE_SIZE);
+}
+
+static void test_direct_round_trip(char *buf)
+{
+  int fd;
+  int rv;
+
+  fd = open(FILE_PATH, O_RDWR | O_CREAT | O_TRUNC | O_DIRECT, 0666);
+  rtems_test_assert(fd >= 0);
+
+  rv = fcntl(fd, F_GETFL);
+  rtems_test_assert((rv & O_DIRECT) != 0);
+
+  fill(buf, 'a');
+  set_user_buffer(buf, FILE_SIZE);
+
+  write_file(fd, buf);
+  rtems_test_assert(direct_writes > 0);
+
+  read_file(fd, buf);
+  rtems_test_assert(direct_reads > 0);
+  rtems_test_assert(is_filled(buf, 'a'));
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  /* The cached path sees the data of the direct write */
+  fd = open(FILE_PATH, O_RDONLY);
+  rtems_test_assert(fd >= 0);
+
+  set_user_buffer(buf, FILE_SIZE);
+
+  read_file(fd, buf);
+  rtems_test_assert(direct_reads == 0);
+  rtems_test_assert(is_filled(buf, 'a'));
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static void test_unaligned_fallback(char *buf)
+{
+  char *unaligned = buf + 1;
+  int fd;
+  int rv;
+
+  if (rtems_bdbuf_is_direct_buffer(unaligned)) {
+    return;
+  }
+
+  fd = open(FILE_PATH, O_RDWR | O_DIRECT);
+  rtems_test_assert(fd >= 0);
+
+  fill(unaligned, 'A');
+  set_user_buffer(unaligned, FILE_SIZE);
+
+  write_file(fd, unaligned);
+  rtems_test_assert(direct_writes == 0);
+
+  read_file(fd, unaligned);
+  rtems_test_assert(direct_reads == 0);
+  rtems_test_assert(is_filled(unaligned, 'A'));
+
+  /* A direct read sees the data of the cached write */
+  set_user_buffer(buf, FILE_SIZE);
+
+  read_file(fd, buf);
+  rtems_test_assert(direct_reads > 0);
+  rtems_test_assert(is_filled(buf, 'A'));
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static void test_file_system(const char *type, char *buf)
+{
+  int rv;
+
+  rv = mount_and_make_target_path(
+    DISK,
+    MNT,
+    type,
+    RTEMS_FILESYSTEM_READ_WRITE,
+    NULL
+  );
+  rtems_test_assert(rv == 0);
+
+  test_direct_round_trip(buf);
+  test_unaligned_fallback(buf);
+
+  rv = unlink(FILE_PATH);
+  rtems_test_assert(rv == 0);
+
+  rv = unmount(MNT);
+  rtems_test_assert(rv == 0);
+}
+
+static void test_dosfs(char *buf)
+{
+  static const msdos_format_request_param_t rqdata = {
+    .sectors_per_cluster = 2,
+    .quick_format = true,
+    .sync_device = true
+  };
+
+  int rv;
+
+  puts("dosfs");
+
+  rv = msdos_format(DISK, &rqdata);
+  rtems_test_assert(rv == 0);
+
+  test_file_system(RTEMS_FILESYSTEM_TYPE_DOSFS, buf);
+}
+
+static void test_rfs(char *buf)
+{
+  static const rtems_rfs_format_config config = {
+    .block_size = MEDIA_BLOCK_SIZE
+  };
+
+  int rv;
+
+  puts("rfs");
+
+  rv = rtems_rfs_format(DISK, &config);
+  rtems_test_assert(rv == 0);
+
+  test_file_system(RTEMS_FILESYSTEM_TYPE_RFS, buf);
+}
+
+static void test(void)
+{
+  rtems_status_code sc;
+  char *buf;
+
+  /* One more byte for the unaligned buffer */
+  buf = rtems_cache_aligned_malloc(FILE_SIZE + 1);
+  rtems_test_assert(buf != NULL);
+  rtems_test_assert(rtems_bdbuf_is_direct_buffer(buf));
+
+  sc = rtems_disk_io_initialize();
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_blkdev_create(
+    DISK,
+    MEDIA_BLOCK_SIZE,
+    MEDIA_BLOCK_COUNT,
+    disk_ioctl,
+    NULL
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  test_dosfs(buf);
+  test_rfs(buf);
+
+  free(buf);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 6
+
+#define CONFIGURE_FILESYSTEM_DOSFS
+#define CONFIGURE_FILESYSTEM_RFS
+
+#define CONFIGURE_MAXIMUM_TASKS 2
+
+#define CONFIGURE_EXTRA_TASK_STACKS (8 * 1024)
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT_TASK_STACK_SIZE (32 * 1024)
+#define CONFIGURE_INIT_TASK_ATTRIBUTES RTEMS_FLOATING_POINT
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
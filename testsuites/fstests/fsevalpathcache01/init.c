@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <rtems/blkdev.h>
+#include <rtems/libio_.h>
+#include <rtems/ramdisk.h>
+#include <rtems/rtems-rfs-format.h>
+
+const char rtems_test_name[] = "FSEVALPATHCACHE 1";
+
+#define RFS_DISK "/dev/rda"
+
+#define RFS_MNT "/mnt"
+
+#define RFS_BLOCK_SIZE 512
+
+#define RFS_BLOCK_COUNT 1024
+
+#define RFS_CONTENT "content"
+
+static rtems_filesystem_eval_path_cache_status lookup(
+  const rtems_filesystem_mount_table_entry_t *mt_entry,
+  uintptr_t dir,
+  const char *name,
+  uintptr_t *node,
+  uintptr_t *data
+)
+{
+  return rtems_filesystem_eval_path_cache_lookup(
+    mt_entry,
+    dir,
+    name,
+    strlen(name),
+    node,
+    data
+  );
+}
+
+static void test_entries(const rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+  rtems_filesystem_eval_path_cache_status status;
+  char long_name[RTEMS_FILESYSTEM_EVAL_PATH_CACHE_NAME_MAX + 2];
+  uintptr_t node;
+  uintptr_t data;
+
+  puts("entries");
+
+  status = lookup(mt_entry, 1, "a", &node, &data);
+  rtems_test_assert(status == RTEMS_FILESYSTEM_EVAL_PATH_CACHE_MISS);
+
+  rtems_filesystem_eval_path_cache_insert(mt_entry, 1, "a", 1, 2, 3);
+
+  node = 0;
+  data = 0;
+  status = lookup(mt_entry, 1, "a", &node, &data);
+  rtems_test_assert(status == RTEMS_FILESYSTEM_EVAL_PATH_CACHE_HIT);
+  rtems_test_assert(node == 2);
+  rtems_test_assert(data == 3);
+
+  status = lookup(mt_entry, 2, "a", &node, &data);
+  rtems_test_assert(status == RTEMS_FILESYSTEM_EVAL_PATH_CACHE_MISS);
+
+  status = lookup(mt_entry, 1, "ab", &node, &data);
+  rtems_test_assert(status == RTEMS_FILESYSTEM_EVAL_PATH_CACHE_MISS);
+
+  status = lookup(NULL, 1, "a", &node, &data);
+  rtems_test_assert(status == RTEMS_FILESYSTEM_EVAL_PATH_CACHE_MISS);
+
+  rtems_filesystem_eval_path_cache_insert_no_entry(mt_entry, 1, "b", 1);
+
+  status = lookup(mt_entry, 1, "b", &node, &data);
+  rtems_test_assert(status == RTEMS_FILESYSTEM_EVAL_PATH_CACHE_NO_ENTRY);
+
+  memset(long_name, 'x', sizeof(long_name) - 1);
+  long_name[sizeof(long_name) - 1] = '\0';
+
+  rtems_filesystem_eval_path_cache_insert_no_entry(
+    mt_entry,
+    1,
+    long_name,
+    strlen(long_name)
+  );
+
+  status = lookup(mt_entry, 1, long_name, &node, &data);
+  rtems_test_assert(status == RTEMS_FILESYSTEM_EVAL_PATH_CACHE_MISS);
+
+  rtems_filesystem_eval_path_cache_invalidate(mt_entry);
+
+  status = lookup(mt_entry, 1, "a", &node, &data);
+  rtems_test_assert(status == RTEMS_FILESYSTEM_EVAL_PATH_CACHE_MISS);
+
+  status = lookup(mt_entry, 1, "b", &node, &data);
+  rtems_test_assert(status == RTEMS_FILESYSTEM_EVAL_PATH_CACHE_MISS);
+}
+
+static void insert_and_check(
+  const rtems_filesystem_mount_table_entry_t *mt_entry,
+  bool cached
+)
+{
+  rtems_filesystem_eval_path_cache_status status;
+  uintptr_t node;
+  uintptr_t data;
+
+  status = lookup(mt_entry, 1, "a", &node, &data);
+
+  if (cached) {
+    rtems_test_assert(status == RTEMS_FILESYSTEM_EVAL_PATH_CACHE_NO_ENTRY);
+  } else {
+    rtems_test_assert(status == RTEMS_FILESYSTEM_EVAL_PATH_CACHE_MISS);
+    rtems_filesystem_eval_path_cache_insert_no_entry(mt_entry, 1, "a", 1);
+  }
+}
+
+static void test_invalidation(
+  const rtems_filesystem_mount_table_entry_t *mt_entry
+)
+{
+  int rv;
+  int fd;
+
+  puts("invalidation");
+
+  insert_and_check(mt_entry, false);
+  insert_and_check(mt_entry, true);
+
+  fd = creat("file", S_IRWXU);
+  rtems_test_assert(fd >= 0);
+  insert_and_check(mt_entry, false);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+  insert_and_check(mt_entry, true);
+
+  rv = mkdir("dir", S_IRWXU);
+  rtems_test_assert(rv == 0);
+  insert_and_check(mt_entry, false);
+
+  rv = rename("file", "dir/file");
+  rtems_test_assert(rv == 0);
+  insert_and_check(mt_entry, false);
+
+  rv = link("dir/file", "link");
+  rtems_test_assert(rv == 0);
+  insert_and_check(mt_entry, false);
+
+  rv = symlink("dir/file", "symlink");
+  rtems_test_assert(rv == 0);
+  insert_and_check(mt_entry, false);
+
+  rv = unlink("symlink");
+  rtems_test_assert(rv == 0);
+  insert_and_check(mt_entry, false);
+
+  rv = unlink("link");
+  rtems_test_assert(rv == 0);
+  rv = unlink("dir/file");
+  rtems_test_assert(rv == 0);
+  insert_and_check(mt_entry, false);
+
+  rv = rmdir("dir");
+  rtems_test_assert(rv == 0);
+  insert_and_check(mt_entry, false);
+  insert_and_check(mt_entry, true);
+}
+
+static const rtems_filesystem_mount_table_entry_t *get_mt_entry(
+  const char *path
+)
+{
+  const rtems_filesystem_mount_table_entry_t *mt_entry;
+  int fd;
+  int rv;
+
+  fd = open(path, O_RDONLY);
+  rtems_test_assert(fd >= 0);
+
+  mt_entry = rtems_libio_iop(fd)->pathinfo.mt_entry;
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  return mt_entry;
+}
+
+static void check_file(const char *path, ino_t ino)
+{
+  char buf[sizeof(RFS_CONTENT)];
+  struct stat st;
+  ssize_t n;
+  int fd;
+  int rv;
+
+  rv = stat(path, &st);
+  rtems_test_assert(rv == 0);
+  rtems_test_assert(st.st_ino == ino);
+
+  /* This evaluation uses the cache entry of the stat() */
+  fd = open(path, O_RDONLY);
+  rtems_test_assert(fd >= 0);
+
+  n = read(fd, buf, sizeof(buf));
+  rtems_test_assert(n == (ssize_t) sizeof(buf));
+  rtems_test_assert(memcmp(buf, RFS_CONTENT, sizeof(buf)) == 0);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static void check_no_file(
+  const rtems_filesystem_mount_table_entry_t *mt_entry,
+  uintptr_t dir,
+  const char *path,
+  const char *name
+)
+{
+  rtems_filesystem_eval_path_cache_status status;
+  struct stat st;
+  uintptr_t node;
+  uintptr_t data;
+  int rv;
+
+  errno = 0;
+  rv = stat(path, &st);
+  rtems_test_assert(rv == -1);
+  rtems_test_assert(errno == ENOENT);
+
+  status = lookup(mt_entry, dir, name, &node, &data);
+  rtems_test_assert(status == RTEMS_FILESYSTEM_EVAL_PATH_CACHE_NO_ENTRY);
+
+  /* This evaluation uses the cache entry */
+  errno = 0;
+  rv = stat(path, &st);
+  rtems_test_assert(rv == -1);
+  rtems_test_assert(errno == ENOENT);
+}
+
+static void test_rfs(void)
+{
+  static const rtems_rfs_format_config config = {
+    .block_size = RFS_BLOCK_SIZE
+  };
+
+  const rtems_filesystem_mount_table_entry_t *mt_entry;
+  rtems_filesystem_eval_path_cache_status status;
+  rtems_status_code sc;
+  ramdisk *rd;
+  struct stat st;
+  uintptr_t dir;
+  uintptr_t node;
+  uintptr_t data;
+  ino_t ino;
+  ssize_t n;
+  int fd;
+  int rv;
+
+  puts("rfs");
+
+  rd = ramdisk_allocate(NULL, RFS_BLOCK_SIZE, RFS_BLOCK_COUNT, false);
+  rtems_test_assert(rd != NULL);
+
+  sc = rtems_blkdev_create(
+    RFS_DISK,
+    RFS_BLOCK_SIZE,
+    RFS_BLOCK_COUNT,
+    ramdisk_ioctl,
+    rd
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  rv = rtems_rfs_format(RFS_DISK, &config);
+  rtems_test_assert(rv == 0);
+
+  rv = mount_and_make_target_path(
+    RFS_DISK,
+    RFS_MNT,
+    RTEMS_FILESYSTEM_TYPE_RFS,
+    RTEMS_FILESYSTEM_READ_WRITE,
+    NULL
+  );
+  rtems_test_assert(rv == 0);
+
+  mt_entry = get_mt_entry(RFS_MNT);
+
+  /* The RFS uses the inode number of the directory */
+  rv = stat(RFS_MNT, &st);
+  rtems_test_assert(rv == 0);
+  dir = (uintptr_t) st.st_ino;
+
+  fd = creat(RFS_MNT "/file", S_IRWXU);
+  rtems_test_assert(fd >= 0);
+
+  n = write(fd, RFS_CONTENT, sizeof(RFS_CONTENT));
+  rtems_test_assert(n == (ssize_t) sizeof(RFS_CONTENT));
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  /* Lookup */
+  rv = stat(RFS_MNT "/file", &st);
+  rtems_test_assert(rv == 0);
+  ino = st.st_ino;
+
+  status = lookup(mt_entry, dir, "file", &node, &data);
+  rtems_test_assert(status == RTEMS_FILESYSTEM_EVAL_PATH_CACHE_HIT);
+  rtems_test_assert(node == (uintptr_t) ino);
+
+  check_file(RFS_MNT "/file", ino);
+  check_no_file(mt_entry, dir, RFS_MNT "/other", "other");
+
+  /* Rename to a name cached as missing */
+  rv = rename(RFS_MNT "/file", RFS_MNT "/other");
+  rtems_test_assert(rv == 0);
+
+  status = lookup(mt_entry, dir, "file", &node, &data);
+  rtems_test_assert(status == RTEMS_FILESYSTEM_EVAL_PATH_CACHE_MISS);
+  status = lookup(mt_entry, dir, "other", &node, &data);
+  rtems_test_assert(status == RTEMS_FILESYSTEM_EVAL_PATH_CACHE_MISS);
+
+  check_file(RFS_MNT "/other", ino);
+  check_no_file(mt_entry, dir, RFS_MNT "/file", "file");
+
+  /* Unlink a name cached as present */
+  rv = stat(RFS_MNT "/other", &st);
+  rtems_test_assert(rv == 0);
+
+  status = lookup(mt_entry, dir, "other", &node, &data);
+  rtems_test_assert(status == RTEMS_FILESYSTEM_EVAL_PATH_CACHE_HIT);
+
+  rv = unlink(RFS_MNT "/other");
+  rtems_test_assert(rv == 0);
+
+  status = lookup(mt_entry, dir, "other", &node, &data);
+  rtems_test_assert(status == RTEMS_FILESYSTEM_EVAL_PATH_CACHE_MISS);
+
+  check_no_file(mt_entry, dir, RFS_MNT "/other", "other");
+
+  rv = unmount(RFS_MNT);
+  rtems_test_assert(rv == 0);
+
+  status = lookup(mt_entry, dir, "other", &node, &data);
+  rtems_test_assert(status == RTEMS_FILESYSTEM_EVAL_PATH_CACHE_MISS);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  const rtems_filesystem_mount_table_entry_t *mt_entry;
+
+  TEST_BEGIN();
+
+  rtems_test_assert(rtems_filesystem_eval_path_cache_size == 8);
+
+  mt_entry = rtems_filesystem_root->location.mt_entry;
+
+  test_entries(mt_entry);
+  test_invalidation(mt_entry);
+  test_rfs();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 6
+
+#define CONFIGURE_FILESYSTEM_RFS
+
+#define CONFIGURE_FILESYSTEM_EVAL_PATH_CACHE_ENTRIES 8
+
+#define CONFIGURE_MAXIMUM_TASKS 2
+
+#define CONFIGURE_EXTRA_TASK_STACKS (8 * 1024)
+
+#define CONFIGURE_INIT_TASK_STACK_SIZE (32 * 1024)
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <sys/stat.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <rtems/imfs.h>
+
+const char rtems_test_name[] = "FSIMFSCONFIG 4";
+
+#define ENTRY_COUNT 100
+
+static void make_path(char *path, size_t size, char prefix, int i)
+{
+  snprintf(path, size, "dir/%c%03i", prefix, i);
+}
+
+static void check_entries(int renamed)
+{
+  struct dirent *d;
+  DIR *dir;
+  int i;
+  int rv;
+
+  dir = opendir("dir");
+  rtems_test_assert(dir != NULL);
+
+  for (i = 0; i < ENTRY_COUNT; ++i) {
+    char name[5];
+
+    if (i == renamed) {
+      continue;
+    }
+
+    d = readdir(dir);
+    rtems_test_assert(d != NULL);
+
+    snprintf(name, sizeof(name), "f%03i", i);
+    rtems_test_assert(strcmp(d->d_name, name) == 0);
+  }
+
+  if (renamed >= 0) {
+    char name[5];
+
+    d = readdir(dir);
+    rtems_test_assert(d != NULL);
+
+    snprintf(name, sizeof(name), "g%03i", renamed);
+    rtems_test_assert(strcmp(d->d_name, name) == 0);
+  }
+
+  d = readdir(dir);
+  rtems_test_assert(d == NULL);
+
+  rv = closedir(dir);
+  rtems_test_assert(rv == 0);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  char path[16];
+  struct stat st;
+  int renamed = ENTRY_COUNT / 2;
+  int rv;
+  int fd;
+  int i;
+
+  TEST_BEGIN();
+
+  rv = mkdir("dir", S_IRWXU);
+  rtems_test_assert(rv == 0);
+
+  for (i = 0; i < ENTRY_COUNT; ++i) {
+    make_path(path, sizeof(path), 'f', i);
+    fd = creat(path, S_IRWXU);
+    rtems_test_assert(fd >= 0);
+
+    rv = close(fd);
+    rtems_test_assert(rv == 0);
+  }
+
+  rv = stat("dir", &st);
+  rtems_test_assert(rv == 0);
+  rtems_test_assert(
+    st.st_size == (off_t) (ENTRY_COUNT * sizeof(struct dirent))
+  );
+
+  for (i = 0; i < ENTRY_COUNT; ++i) {
+    make_path(path, sizeof(path), 'f', i);
+    rv = stat(path, &st);
+    rtems_test_assert(rv == 0);
+    rtems_test_assert(S_ISREG(st.st_mode));
+  }
+
+  errno = 0;
+  rv = stat("dir/f100", &st);
+  rtems_test_assert(rv == -1);
+  rtems_test_assert(errno == ENOENT);
+
+  check_entries(-1);
+
+  rv = rename("dir/f050", "dir/g050");
+  rtems_test_assert(rv == 0);
+
+  errno = 0;
+  rv = stat("dir/f050", &st);
+  rtems_test_assert(rv == -1);
+  rtems_test_assert(errno == ENOENT);
+
+  rv = stat("dir/g050", &st);
+  rtems_test_assert(rv == 0);
+
+  check_entries(renamed);
+
+  errno = 0;
+  rv = rmdir("dir");
+  rtems_test_assert(rv == -1);
+  rtems_test_assert(errno == ENOTEMPTY);
+
+  for (i = 0; i < ENTRY_COUNT; ++i) {
+    make_path(path, sizeof(path), i == renamed ? 'g' : 'f', i);
+    rv = unlink(path);
+    rtems_test_assert(rv == 0);
+
+    errno = 0;
+    rv = stat(path, &st);
+    rtems_test_assert(rv == -1);
+    rtems_test_assert(errno == ENOENT);
+  }
+
+  rv = rmdir("dir");
+  rtems_test_assert(rv == 0);
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_DOES_NOT_NEED_CLOCK_DRIVER
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 2
+
+#define CONFIGURE_IMFS_ENABLE_HASHED_DIRECTORIES
+
+#define CONFIGURE_MAXIMUM_TASKS 1
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
@@ -137,6 +137,25 @@ static int test_disk_ioctl(rtems_disk_device *dd, uint32_t req, void *arg)
   return rv;
 }
 
+static const rtems_blkdev_read_ahead_stream *last_used_stream(
+  const rtems_disk_device *dd
+)
+{
+  size_t i;
+
+  for (i = 0; i < RTEMS_DISK_READ_AHEAD_STREAM_COUNT; ++i) {
+    const rtems_blkdev_read_ahead_stream *stream = &dd->read_ahead.streams [i];
+
+    if (stream->last_use == dd->read_ahead.use_count) {
+      return stream;
+    }
+  }
+
+  rtems_test_assert(0);
+
+  return NULL;
+}
+
 static void test_read_ahead(rtems_disk_device *dd)
 {
   int i;
@@ -171,13 +190,57 @@ static void test_read_ahead(rtems_disk_device *dd)
       memset(&block_access_counts, 0, sizeof(block_access_counts));
     }
 
-    rtems_test_assert(trigger [i] == dd->read_ahead.trigger);
-    rtems_test_assert(next [i] == dd->read_ahead.next);
+    rtems_test_assert(trigger [i] == last_used_stream(dd)->trigger);
+    rtems_test_assert(next [i] == last_used_stream(dd)->next);
   }
 
   printf("\n");
 }
 
+static void test_interleaved_read_ahead(rtems_disk_device *dd)
+{
+  static const rtems_blkdev_bnum blocks [] = { 0, 5, 1, 6, 2, 7 };
+  static const int expected_counts [BLOCK_COUNT] =
+    { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0 };
+  rtems_blkdev_stats stats;
+  size_t i;
+
+  printf("interleaved\n");
+
+  rtems_bdbuf_purge_dev(dd);
+  rtems_bdbuf_reset_device_stats(dd);
+  memset(&block_access_counts, 0, sizeof(block_access_counts));
+
+  /*
+   * Two sequential readers, each must get a read-ahead stream of its own.
+   */
+  for (i = 0; i < RTEMS_ARRAY_SIZE(blocks); ++i) {
+    rtems_status_code sc;
+    rtems_bdbuf_buffer *bd;
+
+    sc = rtems_bdbuf_read(dd, blocks [i], &bd);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+    sc = rtems_bdbuf_release(bd);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  }
+
+  rtems_test_assert(
+    memcmp(
+      block_access_counts,
+      expected_counts,
+      sizeof(block_access_counts)
+    ) == 0
+  );
+
+  rtems_bdbuf_get_device_stats(dd, &stats);
+  rtems_test_assert(stats.read_hits == 2);
+  rtems_test_assert(stats.read_misses == 4);
+  rtems_test_assert(stats.read_ahead_transfers == 2);
+  rtems_test_assert(stats.read_ahead_hits == 2);
+  rtems_test_assert(stats.read_ahead_misses == 0);
+}
+
 static void test(void)
 {
   rtems_status_code sc;
@@ -201,6 +264,7 @@ static void test(void)
   rtems_test_assert(dd != NULL);
 
   test_read_ahead(dd);
+  test_interleaved_read_ahead(dd);
 
   sc = rtems_disk_release(dd);
   rtems_test_assert(sc == RTEMS_SUCCESSFUL);
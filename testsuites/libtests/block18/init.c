@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <rtems/ramdisk.h>
+#include <rtems/bdbuf.h>
+
+const char rtems_test_name[] = "BLOCK 18";
+
+#define ASSERT_SC(sc) rtems_test_assert((sc) == RTEMS_SUCCESSFUL)
+
+#define DISK_COUNT 4
+
+#define WORKER_COUNT DISK_COUNT
+
+#define BLOCK_SIZE 512
+
+#define BLOCK_COUNT 16
+
+#define ACCESS_COUNT 20000
+
+#define WORKER_PRIORITY 2
+
+typedef struct {
+  rtems_id main_task;
+  rtems_id worker_tasks[WORKER_COUNT];
+  rtems_disk_device *dd[DISK_COUNT];
+  rtems_disk_device *worker_dd[WORKER_COUNT];
+  int fd[DISK_COUNT];
+} test_context;
+
+static test_context test_instance;
+
+static void worker_task(rtems_task_argument arg)
+{
+  test_context *ctx = &test_instance;
+  size_t w = arg;
+
+  while (true) {
+    rtems_status_code sc;
+    uint32_t i;
+
+    sc = rtems_event_transient_receive(RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+    ASSERT_SC(sc);
+
+    /*
+     * Workers sharing a disk use disjoint blocks, so they contend for the
+     * cache lock only and never wait for a buffer.
+     */
+    for (i = 0; i < ACCESS_COUNT; ++i) {
+      rtems_blkdev_bnum block = (w + i * WORKER_COUNT) % BLOCK_COUNT;
+      rtems_bdbuf_buffer *bd;
+
+      sc = rtems_bdbuf_read(ctx->worker_dd[w], block, &bd);
+      ASSERT_SC(sc);
+
+      sc = rtems_bdbuf_release(bd);
+      ASSERT_SC(sc);
+    }
+
+    sc = rtems_event_send(ctx->main_task, RTEMS_EVENT_0 << w);
+    ASSERT_SC(sc);
+  }
+}
+
+static uint64_t run_workers(test_context *ctx)
+{
+  rtems_event_set all = (RTEMS_EVENT_0 << WORKER_COUNT) - 1;
+  rtems_event_set events;
+  rtems_status_code sc;
+  uint64_t begin;
+  size_t w;
+
+  begin = rtems_clock_get_uptime_nanoseconds();
+
+  for (w = 0; w < WORKER_COUNT; ++w) {
+    sc = rtems_event_transient_send(ctx->worker_tasks[w]);
+    ASSERT_SC(sc);
+  }
+
+  sc = rtems_event_receive(all, RTEMS_EVENT_ALL | RTEMS_WAIT,
+    RTEMS_NO_TIMEOUT, &events);
+  ASSERT_SC(sc);
+  rtems_test_assert(events == all);
+
+  return rtems_clock_get_uptime_nanoseconds() - begin;
+}
+
+static void measure(test_context *ctx, const char *name, bool own_disk)
+{
+  uint64_t accesses = (uint64_t) WORKER_COUNT * ACCESS_COUNT;
+  uint64_t duration;
+  size_t w;
+
+  for (w = 0; w < WORKER_COUNT; ++w) {
+    ctx->worker_dd[w] = own_disk ? ctx->dd[w] : ctx->dd[0];
+  }
+
+  /* Fill the cache, so that all later accesses are read hits */
+  run_workers(ctx);
+
+  duration = run_workers(ctx);
+
+  printf(
+    "%s: %" PRIu64 " accesses in %" PRIu64 "ns, %" PRIu64 " per second\n",
+    name,
+    accesses,
+    duration,
+    duration > 0 ? (accesses * 1000000000) / duration : 0
+  );
+}
+
+static void create_disks(test_context *ctx)
+{
+  rtems_status_code sc;
+  size_t d;
+
+  sc = rtems_disk_io_initialize();
+  ASSERT_SC(sc);
+
+  for (d = 0; d < DISK_COUNT; ++d) {
+    char device[] = "/dev/rda";
+    ramdisk *rd;
+    size_t e;
+    int rv;
+
+    device[sizeof(device) - 2] += d;
+
+    rd = ramdisk_allocate(NULL, BLOCK_SIZE, BLOCK_COUNT, false);
+    rtems_test_assert(rd != NULL);
+
+    sc = rtems_blkdev_create(
+      device,
+      BLOCK_SIZE,
+      BLOCK_COUNT,
+      ramdisk_ioctl,
+      rd
+    );
+    ASSERT_SC(sc);
+
+    ctx->fd[d] = open(device, O_RDWR);
+    rtems_test_assert(ctx->fd[d] >= 0);
+
+    rv = rtems_disk_fd_get_disk_device(ctx->fd[d], &ctx->dd[d]);
+    rtems_test_assert(rv == 0);
+
+    /* Each disk must get a shard of its own */
+    for (e = 0; e < d; ++e) {
+      rtems_test_assert(ctx->dd[d]->bdbuf_shard != ctx->dd[e]->bdbuf_shard);
+    }
+  }
+}
+
+static void test(test_context *ctx)
+{
+  rtems_status_code sc;
+  size_t w;
+
+  ctx->main_task = rtems_task_self();
+
+  create_disks(ctx);
+
+  for (w = 0; w < WORKER_COUNT; ++w) {
+    sc = rtems_task_create(
+      rtems_build_name('W', 'O', 'R', 'K'),
+      WORKER_PRIORITY,
+      RTEMS_MINIMUM_STACK_SIZE,
+      RTEMS_DEFAULT_MODES,
+      RTEMS_DEFAULT_ATTRIBUTES,
+      &ctx->worker_tasks[w]
+    );
+    ASSERT_SC(sc);
+
+    sc = rtems_task_start(ctx->worker_tasks[w], worker_task, w);
+    ASSERT_SC(sc);
+  }
+
+  measure(ctx, "one disk, one shard", false);
+  measure(ctx, "one disk per worker, one shard each", true);
+
+  for (w = 0; w < WORKER_COUNT; ++w) {
+    sc = rtems_task_delete(ctx->worker_tasks[w]);
+    ASSERT_SC(sc);
+  }
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test(&test_instance);
+
+  TEST_END();
+
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+#define CONFIGURE_BDBUF_BUFFER_MIN_SIZE BLOCK_SIZE
+#define CONFIGURE_BDBUF_BUFFER_MAX_SIZE BLOCK_SIZE
+#define CONFIGURE_BDBUF_CACHE_MEMORY_SIZE \
+  (DISK_COUNT * BLOCK_COUNT * BLOCK_SIZE)
+#define CONFIGURE_BDBUF_SHARD_COUNT DISK_COUNT
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS (3 + DISK_COUNT)
+
+#define CONFIGURE_MAXIMUM_TASKS (1 + WORKER_COUNT)
+
+#define CONFIGURE_MAXIMUM_PROCESSORS WORKER_COUNT
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
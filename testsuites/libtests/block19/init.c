@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <rtems/ramdisk.h>
+#include <rtems/bdbuf.h>
+
+const char rtems_test_name[] = "BLOCK 19";
+
+#define ASSERT_SC(sc) rtems_test_assert((sc) == RTEMS_SUCCESSFUL)
+
+#define BLOCK_SIZE 512
+
+#define BLOCK_COUNT 4096
+
+#define ACCESS_COUNT 100000
+
+/* Odd, so that the accesses visit all resident blocks in a scattered order */
+#define BLOCK_STRIDE 7919
+
+static void read_block(rtems_disk_device *dd, rtems_blkdev_bnum block)
+{
+  rtems_status_code sc;
+  rtems_bdbuf_buffer *bd;
+
+  sc = rtems_bdbuf_read(dd, block, &bd);
+  ASSERT_SC(sc);
+
+  sc = rtems_bdbuf_release(bd);
+  ASSERT_SC(sc);
+}
+
+static void measure(rtems_disk_device *dd, uint32_t resident)
+{
+  uint64_t begin;
+  uint64_t duration;
+  uint32_t block;
+  uint32_t i;
+
+  /* Make the blocks resident, so that all later accesses are cache hits */
+  for (block = 0; block < resident; ++block) {
+    read_block(dd, block);
+  }
+
+  block = 0;
+  begin = rtems_clock_get_uptime_nanoseconds();
+
+  for (i = 0; i < ACCESS_COUNT; ++i) {
+    read_block(dd, block);
+    block = (block + BLOCK_STRIDE) % resident;
+  }
+
+  duration = rtems_clock_get_uptime_nanoseconds() - begin;
+
+  printf(
+    "%5" PRIu32 " resident buffers: %" PRIu64 "ns per cache hit\n",
+    resident,
+    duration / ACCESS_COUNT
+  );
+}
+
+static void test(void)
+{
+  rtems_status_code sc;
+  rtems_disk_device *dd;
+  uint32_t resident;
+  ramdisk *rd;
+  int fd;
+  int rv;
+
+  sc = rtems_disk_io_initialize();
+  ASSERT_SC(sc);
+
+  rd = ramdisk_allocate(NULL, BLOCK_SIZE, BLOCK_COUNT, false);
+  rtems_test_assert(rd != NULL);
+
+  sc = rtems_blkdev_create(
+    "/dev/rda",
+    BLOCK_SIZE,
+    BLOCK_COUNT,
+    ramdisk_ioctl,
+    rd
+  );
+  ASSERT_SC(sc);
+
+  fd = open("/dev/rda", O_RDWR);
+  rtems_test_assert(fd >= 0);
+
+  rv = rtems_disk_fd_get_disk_device(fd, &dd);
+  rtems_test_assert(rv == 0);
+
+  /*
+   * The lookup cost of the cache should not grow with the number of resident
+   * buffers.
+   */
+  for (resident = 16; resident <= BLOCK_COUNT; resident *= 4) {
+    measure(dd, resident);
+  }
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+#define CONFIGURE_BDBUF_BUFFER_MIN_SIZE BLOCK_SIZE
+#define CONFIGURE_BDBUF_BUFFER_MAX_SIZE BLOCK_SIZE
+#define CONFIGURE_BDBUF_CACHE_MEMORY_SIZE (BLOCK_COUNT * BLOCK_SIZE)
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 4
+
+#define CONFIGURE_MAXIMUM_TASKS 1
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
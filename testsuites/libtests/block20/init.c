@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <rtems/blkdev.h>
+#include <rtems/bdbuf.h>
+
+const char rtems_test_name[] = "BLOCK 20";
+
+#define BLOCK_COUNT 12
+
+#define MAX_WRITE_BLOCKS 1
+
+#define MAX_WRITE_REQUESTS 3
+
+#define WRITE_BEHIND_BLOCKS 4
+
+#define INIT_PRIORITY 20
+
+#define DISK_PRIORITY 25
+
+#define QUEUE_SIZE 8
+
+#define WRITE_COUNT 32
+
+/*
+ * The disk task has a lower priority than the Init task, so the write requests
+ * stay queued until the Init task blocks.  The swap-out task has a higher
+ * priority than both.
+ */
+static rtems_id disk_task_id;
+
+static rtems_blkdev_request *queue [QUEUE_SIZE];
+
+static size_t queue_head;
+
+static size_t queue_tail;
+
+static size_t max_queue_depth;
+
+static rtems_blkdev_bnum written_blocks [WRITE_COUNT];
+
+static size_t write_count;
+
+static void disk_task(rtems_task_argument arg)
+{
+  while (true) {
+    rtems_status_code sc;
+
+    sc = rtems_event_transient_receive(RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+    while (queue_tail != queue_head) {
+      rtems_blkdev_request *breq = queue [queue_tail % QUEUE_SIZE];
+      uint32_t i;
+
+      ++queue_tail;
+
+      for (i = 0; i < breq->bufnum; ++i) {
+        rtems_test_assert(write_count < WRITE_COUNT);
+        written_blocks [write_count] = breq->bufs [i].block;
+        ++write_count;
+      }
+
+      rtems_blkdev_request_done(breq, RTEMS_SUCCESSFUL);
+    }
+  }
+}
+
+static int test_disk_ioctl(rtems_disk_device *dd, uint32_t req, void *arg)
+{
+  int rv = 0;
+
+  if (req == RTEMS_BLKIO_REQUEST) {
+    rtems_blkdev_request *breq = arg;
+    rtems_status_code sc;
+    size_t depth;
+
+    rtems_test_assert(breq->req == RTEMS_BLKDEV_REQ_WRITE);
+    rtems_test_assert(breq->bufnum <= MAX_WRITE_BLOCKS);
+    rtems_test_assert(queue_head - queue_tail < QUEUE_SIZE);
+
+    queue [queue_head % QUEUE_SIZE] = breq;
+    ++queue_head;
+
+    depth = queue_head - queue_tail;
+    if (depth > max_queue_depth) {
+      max_queue_depth = depth;
+    }
+
+    sc = rtems_event_transient_send(disk_task_id);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  } else if (req == RTEMS_BLKIO_CAPABILITIES) {
+    *(uint32_t *) arg = RTEMS_BLKDEV_CAP_MULTISECTOR_CONT;
+  } else if (req == RTEMS_BLKIO_GETQUEUEDEPTH) {
+    *(uint32_t *) arg = QUEUE_SIZE;
+  } else {
+    errno = EINVAL;
+    rv = -1;
+  }
+
+  return rv;
+}
+
+static void release_modified(rtems_disk_device *dd, rtems_blkdev_bnum block)
+{
+  rtems_status_code sc;
+  rtems_bdbuf_buffer *bd;
+
+  sc = rtems_bdbuf_get(dd, block, &bd);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_bdbuf_release_modified(bd);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+}
+
+static void test_sorted_requests_in_flight(rtems_disk_device *dd)
+{
+  rtems_status_code sc;
+
+  puts("sorted requests in flight");
+
+  release_modified(dd, 2);
+  release_modified(dd, 0);
+  release_modified(dd, 1);
+
+  rtems_test_assert(write_count == 0);
+
+  sc = rtems_bdbuf_syncdev(dd);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  rtems_test_assert(max_queue_depth == MAX_WRITE_REQUESTS);
+  rtems_test_assert(write_count == 3);
+  rtems_test_assert(written_blocks [0] == 0);
+  rtems_test_assert(written_blocks [1] == 1);
+  rtems_test_assert(written_blocks [2] == 2);
+}
+
+static void test_write_behind(rtems_disk_device *dd)
+{
+  rtems_status_code sc;
+  rtems_blkdev_bnum block;
+
+  puts("write-behind");
+
+  for (block = 3; block < 3 + WRITE_BEHIND_BLOCKS; ++block) {
+    release_modified(dd, block);
+  }
+
+  /* Far less than the block hold time */
+  sc = rtems_task_wake_after(2);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  rtems_test_assert(write_count == 3 + WRITE_BEHIND_BLOCKS);
+
+  for (block = 3; block < 3 + WRITE_BEHIND_BLOCKS; ++block) {
+    rtems_test_assert(written_blocks [block] == block);
+  }
+}
+
+static void test_throttle(rtems_disk_device *dd)
+{
+  rtems_status_code sc;
+  rtems_blkdev_bnum block;
+  size_t writes_before = write_count;
+
+  puts("throttle");
+
+  /*
+   * The fourth release starts the write-behind of blocks 0 up to 3.  The disk
+   * task cannot complete them as long as the Init task runs.  Block 11 is the
+   * eighth modified buffer and the release blocks until the write-behind
+   * caught up.
+   */
+  for (block = 0; block < BLOCK_COUNT - 1; ++block) {
+    release_modified(dd, block);
+  }
+
+  rtems_test_assert(write_count == writes_before);
+
+  release_modified(dd, BLOCK_COUNT - 1);
+
+  rtems_test_assert(write_count >= writes_before + WRITE_BEHIND_BLOCKS);
+
+  sc = rtems_bdbuf_syncdev(dd);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  rtems_test_assert(write_count == writes_before + BLOCK_COUNT);
+}
+
+static void test(void)
+{
+  rtems_status_code sc;
+  dev_t dev = 0;
+  rtems_disk_device *dd;
+
+  sc = rtems_task_create(
+    rtems_build_name('D', 'I', 'S', 'K'),
+    DISK_PRIORITY,
+    RTEMS_MINIMUM_STACK_SIZE,
+    RTEMS_DEFAULT_MODES,
+    RTEMS_DEFAULT_ATTRIBUTES,
+    &disk_task_id
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_task_start(disk_task_id, disk_task, 0);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_disk_io_initialize();
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_disk_create_phys(
+    dev,
+    1,
+    BLOCK_COUNT,
+    test_disk_ioctl,
+    NULL,
+    NULL
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  dd = rtems_disk_obtain(dev);
+  rtems_test_assert(dd != NULL);
+
+  test_sorted_requests_in_flight(dd);
+  test_write_behind(dd);
+  test_throttle(dd);
+
+  sc = rtems_disk_release(dd);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_disk_delete(dev);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+#define CONFIGURE_BDBUF_BUFFER_MIN_SIZE 1
+#define CONFIGURE_BDBUF_BUFFER_MAX_SIZE 1
+#define CONFIGURE_BDBUF_CACHE_MEMORY_SIZE BLOCK_COUNT
+#define CONFIGURE_BDBUF_MAX_WRITE_BLOCKS MAX_WRITE_BLOCKS
+#define CONFIGURE_BDBUF_MAX_WRITE_REQUESTS MAX_WRITE_REQUESTS
+#define CONFIGURE_BDBUF_WRITE_BEHIND_BLOCKS WRITE_BEHIND_BLOCKS
+
+#define CONFIGURE_MAXIMUM_TASKS 2
+
+#define CONFIGURE_INIT_TASK_PRIORITY INIT_PRIORITY
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
@@ -0,0 +1,369 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <rtems/blkdev.h>
+#include <rtems/bdbuf.h>
+
+const char rtems_test_name[] = "BLOCK 21";
+
+#define BLOCK_COUNT 256
+
+#define BUFFER_COUNT 32
+
+#define MAX_READ_AHEAD_BLOCKS 4
+
+#define MAX_READ_AHEAD_REQUESTS 2
+
+#define QUEUE_DEPTH 4
+
+#define STREAM_COUNT 3
+
+#define INIT_PRIORITY 20
+
+#define DISK_PRIORITY 25
+
+/*
+ * The disk finishes single block reads within the IO control.  The
+ * read-ahead requests stay queued until the disk task runs, which has a lower
+ * priority than the Init and read-ahead tasks.
+ */
+static rtems_id disk_task_id;
+
+static rtems_blkdev_request *queue [QUEUE_DEPTH];
+
+static size_t queue_head;
+
+static size_t queue_tail;
+
+static size_t max_queue_depth;
+
+static const rtems_blkdev_bnum stream_begin [STREAM_COUNT] = { 0, 100, 200 };
+
+static void complete_read(rtems_blkdev_request *breq)
+{
+  uint32_t i;
+
+  for (i = 0; i < breq->bufnum; ++i) {
+    rtems_blkdev_sg_buffer *sg = &breq->bufs [i];
+
+    rtems_test_assert(sg->length == 1);
+    *(uint8_t *) sg->buffer = (uint8_t) sg->block;
+  }
+
+  rtems_blkdev_request_done(breq, RTEMS_SUCCESSFUL);
+}
+
+static void disk_task(rtems_task_argument arg)
+{
+  while (true) {
+    rtems_status_code sc;
+
+    sc = rtems_event_transient_receive(RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+    while (queue_tail != queue_head) {
+      rtems_blkdev_request *breq = queue [queue_tail % QUEUE_DEPTH];
+
+      ++queue_tail;
+      complete_read(breq);
+    }
+  }
+}
+
+static int test_disk_ioctl(rtems_disk_device *dd, uint32_t req, void *arg)
+{
+  int rv = 0;
+
+  if (req == RTEMS_BLKIO_REQUEST) {
+    rtems_blkdev_request *breq = arg;
+
+    rtems_test_assert(breq->req == RTEMS_BLKDEV_REQ_READ);
+
+    if (breq->bufnum == 1) {
+      complete_read(breq);
+    } else {
+      rtems_status_code sc;
+      size_t depth;
+
+      rtems_test_assert(queue_head - queue_tail < QUEUE_DEPTH);
+
+      queue [queue_head % QUEUE_DEPTH] = breq;
+      ++queue_head;
+
+      depth = queue_head - queue_tail;
+      if (depth > max_queue_depth) {
+        max_queue_depth = depth;
+      }
+
+      sc = rtems_event_transient_send(disk_task_id);
+      rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+    }
+  } else if (req == RTEMS_BLKIO_GETQUEUEDEPTH) {
+    *(uint32_t *) arg = QUEUE_DEPTH;
+  } else {
+    rv = rtems_blkdev_ioctl(dd, req, arg);
+  }
+
+  return rv;
+}
+
+static void read_block(rtems_disk_device *dd, rtems_blkdev_bnum block)
+{
+  rtems_status_code sc;
+  rtems_bdbuf_buffer *bd;
+
+  sc = rtems_bdbuf_read(dd, block, &bd);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(*(uint8_t *) bd->buffer == (uint8_t) block);
+
+  sc = rtems_bdbuf_release(bd);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+}
+
+static void test_overlapping_read_ahead(rtems_disk_device *dd)
+{
+  rtems_status_code sc;
+  rtems_blkdev_stats stats;
+  size_t i;
+
+  puts("overlapping read-ahead");
+
+  /*
+   * The second read of each stream triggers a read-ahead request.  The first
+   * two requests are in flight at once.  The third waits for a free
+   * read-ahead request.
+   */
+  for (i = 0; i < STREAM_COUNT; ++i) {
+    read_block(dd, stream_begin [i]);
+    read_block(dd, stream_begin [i] + 1);
+  }
+
+  rtems_test_assert(max_queue_depth == MAX_READ_AHEAD_REQUESTS);
+  rtems_test_assert(queue_head - queue_tail == MAX_READ_AHEAD_REQUESTS);
+
+  sc = rtems_task_wake_after(2);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  rtems_test_assert(max_queue_depth == MAX_READ_AHEAD_REQUESTS);
+  rtems_test_assert(queue_head == STREAM_COUNT);
+  rtems_test_assert(queue_tail == STREAM_COUNT);
+
+  rtems_bdbuf_get_device_stats(dd, &stats);
+  rtems_test_assert(stats.read_ahead_transfers == STREAM_COUNT);
+  rtems_test_assert(stats.read_misses == 2 * STREAM_COUNT);
+  rtems_test_assert(stats.read_hits == 0);
+
+  for (i = 0; i < STREAM_COUNT; ++i) {
+    read_block(dd, stream_begin [i] + 2);
+  }
+
+  rtems_bdbuf_get_device_stats(dd, &stats);
+  rtems_test_assert(stats.read_misses == 2 * STREAM_COUNT);
+  rtems_test_assert(stats.read_hits == STREAM_COUNT);
+}
+
+static void wait_for_read_ahead_completion(void)
+{
+  rtems_status_code sc;
+
+  sc = rtems_task_wake_after(2);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  rtems_test_assert(queue_head == queue_tail);
+}
+
+static void test_read_ahead_past_first_window(rtems_disk_device *dd)
+{
+  rtems_blkdev_stats stats;
+  size_t i;
+
+  puts("read-ahead past the first window");
+
+  /*
+   * The first read-ahead request of each stream fetched the blocks two up to
+   * five and moved the trigger to block four.  Reading it must start the
+   * next read-ahead request of the stream.
+   */
+  for (i = 0; i < STREAM_COUNT; ++i) {
+    read_block(dd, stream_begin [i] + 3);
+    read_block(dd, stream_begin [i] + 4);
+  }
+
+  rtems_test_assert(max_queue_depth == MAX_READ_AHEAD_REQUESTS);
+  rtems_test_assert(queue_head - queue_tail == MAX_READ_AHEAD_REQUESTS);
+
+  wait_for_read_ahead_completion();
+  rtems_test_assert(queue_head == 2 * STREAM_COUNT);
+
+  rtems_bdbuf_get_device_stats(dd, &stats);
+  rtems_test_assert(stats.read_ahead_transfers == 2 * STREAM_COUNT);
+
+  for (i = 0; i < STREAM_COUNT; ++i) {
+    read_block(dd, stream_begin [i] + 5);
+    read_block(dd, stream_begin [i] + 6);
+    read_block(dd, stream_begin [i] + 7);
+  }
+
+  rtems_bdbuf_get_device_stats(dd, &stats);
+  rtems_test_assert(stats.read_ahead_transfers == 2 * STREAM_COUNT);
+  rtems_test_assert(stats.read_misses == 2 * STREAM_COUNT);
+  rtems_test_assert(stats.read_hits == 6 * STREAM_COUNT);
+}
+
+static void test_cancel_running_read_ahead(rtems_disk_device *dd)
+{
+  rtems_blkdev_stats stats;
+  size_t i;
+
+  puts("cancel running read-ahead");
+
+  rtems_bdbuf_purge_dev(dd);
+  rtems_bdbuf_reset_device_stats(dd);
+
+  queue_head = 0;
+  queue_tail = 0;
+
+  /*
+   * Two streams have their read-ahead request in flight and the third waits
+   * on the read-ahead chain.  The purge cancels all of them.
+   */
+  for (i = 0; i < STREAM_COUNT; ++i) {
+    read_block(dd, stream_begin [i]);
+    read_block(dd, stream_begin [i] + 1);
+  }
+
+  rtems_test_assert(queue_head - queue_tail == MAX_READ_AHEAD_REQUESTS);
+
+  rtems_bdbuf_purge_dev(dd);
+
+  wait_for_read_ahead_completion();
+  rtems_test_assert(queue_head == MAX_READ_AHEAD_REQUESTS);
+
+  rtems_bdbuf_get_device_stats(dd, &stats);
+  rtems_test_assert(stats.read_ahead_transfers == MAX_READ_AHEAD_REQUESTS);
+
+  /*
+   * The purge dropped the blocks of the cancelled requests and the triggers
+   * of the streams.
+   */
+  for (i = 0; i < STREAM_COUNT; ++i) {
+    read_block(dd, stream_begin [i] + 2);
+  }
+
+  wait_for_read_ahead_completion();
+  rtems_test_assert(queue_head == MAX_READ_AHEAD_REQUESTS);
+
+  rtems_bdbuf_get_device_stats(dd, &stats);
+  rtems_test_assert(stats.read_ahead_transfers == MAX_READ_AHEAD_REQUESTS);
+  rtems_test_assert(stats.read_misses == 3 * STREAM_COUNT);
+  rtems_test_assert(stats.read_hits == 0);
+
+  /* The new streams start as usual */
+  read_block(dd, stream_begin [0] + 3);
+
+  wait_for_read_ahead_completion();
+  rtems_test_assert(queue_head == MAX_READ_AHEAD_REQUESTS + 1);
+
+  read_block(dd, stream_begin [0] + 4);
+
+  rtems_bdbuf_get_device_stats(dd, &stats);
+  rtems_test_assert(stats.read_ahead_transfers == MAX_READ_AHEAD_REQUESTS + 1);
+  rtems_test_assert(stats.read_misses == 3 * STREAM_COUNT + 1);
+  rtems_test_assert(stats.read_hits == 1);
+}
+
+static void test(void)
+{
+  rtems_status_code sc;
+  dev_t dev = 0;
+  rtems_disk_device *dd;
+
+  sc = rtems_task_create(
+    rtems_build_name('D', 'I', 'S', 'K'),
+    DISK_PRIORITY,
+    RTEMS_MINIMUM_STACK_SIZE,
+    RTEMS_DEFAULT_MODES,
+    RTEMS_DEFAULT_ATTRIBUTES,
+    &disk_task_id
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_task_start(disk_task_id, disk_task, 0);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_disk_io_initialize();
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_disk_create_phys(
+    dev,
+    1,
+    BLOCK_COUNT,
+    test_disk_ioctl,
+    NULL,
+    NULL
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  dd = rtems_disk_obtain(dev);
+  rtems_test_assert(dd != NULL);
+  rtems_test_assert(dd->queue_depth == QUEUE_DEPTH);
+
+  test_overlapping_read_ahead(dd);
+  test_read_ahead_past_first_window(dd);
+  test_cancel_running_read_ahead(dd);
+
+  sc = rtems_disk_release(dd);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_disk_delete(dev);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+#define CONFIGURE_BDBUF_BUFFER_MIN_SIZE 1
+#define CONFIGURE_BDBUF_BUFFER_MAX_SIZE 1
+#define CONFIGURE_BDBUF_CACHE_MEMORY_SIZE BUFFER_COUNT
+#define CONFIGURE_BDBUF_MAX_READ_AHEAD_BLOCKS MAX_READ_AHEAD_BLOCKS
+#define CONFIGURE_BDBUF_MAX_READ_AHEAD_REQUESTS MAX_READ_AHEAD_REQUESTS
+
+#define CONFIGURE_MAXIMUM_TASKS 2
+
+#define CONFIGURE_INIT_TASK_PRIORITY INIT_PRIORITY
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
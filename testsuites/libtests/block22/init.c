@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rtems/blkdev.h>
+#include <rtems/bdbuf.h>
+
+const char rtems_test_name[] = "BLOCK 22";
+
+#define BLOCK_SIZE 512
+
+#define BLOCK_COUNT 8
+
+#define BUFFER_COUNT 4
+
+static char disk_data [BLOCK_COUNT][BLOCK_SIZE];
+
+static rtems_blkdev_sg_buffer last_bufs [BLOCK_COUNT];
+
+static uint32_t last_bufnum;
+
+static rtems_blkdev_request_op last_req;
+
+static size_t write_requests;
+
+static int test_disk_ioctl(rtems_disk_device *dd, uint32_t req, void *arg)
+{
+  int rv = 0;
+
+  if (req == RTEMS_BLKIO_REQUEST) {
+    rtems_blkdev_request *breq = arg;
+    uint32_t i;
+
+    rtems_test_assert(breq->bufnum <= BLOCK_COUNT);
+
+    for (i = 0; i < breq->bufnum; ++i) {
+      rtems_blkdev_sg_buffer *sg = &breq->bufs [i];
+
+      rtems_test_assert(sg->block < BLOCK_COUNT);
+      rtems_test_assert(sg->length == BLOCK_SIZE);
+
+      if (breq->req == RTEMS_BLKDEV_REQ_READ) {
+        memcpy(sg->buffer, disk_data [sg->block], BLOCK_SIZE);
+      } else {
+        memcpy(disk_data [sg->block], sg->buffer, BLOCK_SIZE);
+      }
+
+      last_bufs [i] = *sg;
+    }
+
+    last_bufnum = breq->bufnum;
+    last_req = breq->req;
+
+    if (breq->req == RTEMS_BLKDEV_REQ_WRITE) {
+      ++write_requests;
+    }
+
+    rtems_blkdev_request_done(breq, RTEMS_SUCCESSFUL);
+  } else if (req == RTEMS_BLKIO_CAPABILITIES) {
+    *(uint32_t *) arg = RTEMS_BLKDEV_CAP_MULTISECTOR_CONT;
+  } else {
+    errno = EINVAL;
+    rv = -1;
+  }
+
+  return rv;
+}
+
+static void fill_disk(rtems_blkdev_bnum block, char c)
+{
+  memset(disk_data [block], c, BLOCK_SIZE);
+}
+
+static bool is_filled(const char *data, char c)
+{
+  size_t i;
+
+  for (i = 0; i < BLOCK_SIZE; ++i) {
+    if (data [i] != c) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void test_direct_read(rtems_disk_device *dd, char *buf)
+{
+  rtems_status_code sc;
+  rtems_blkdev_stats stats;
+  rtems_blkdev_bnum block;
+
+  puts("direct read");
+
+  for (block = 0; block < BLOCK_COUNT; ++block) {
+    fill_disk(block, (char) ('a' + block));
+  }
+
+  rtems_bdbuf_reset_device_stats(dd);
+
+  sc = rtems_bdbuf_read_direct(dd, 2, 3, buf);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  rtems_test_assert(last_req == RTEMS_BLKDEV_REQ_READ);
+  rtems_test_assert(last_bufnum == 3);
+
+  for (block = 0; block < 3; ++block) {
+    rtems_test_assert(last_bufs [block].block == 2 + block);
+    rtems_test_assert(last_bufs [block].buffer == buf + block * BLOCK_SIZE);
+    rtems_test_assert(last_bufs [block].user == NULL);
+    rtems_test_assert(
+      is_filled(buf + block * BLOCK_SIZE, (char) ('c' + block))
+    );
+  }
+
+  rtems_bdbuf_get_device_stats(dd, &stats);
+  rtems_test_assert(stats.read_hits == 0);
+  rtems_test_assert(stats.read_misses == 0);
+  rtems_test_assert(stats.read_blocks == 3);
+}
+
+static void test_direct_read_coherency(rtems_disk_device *dd, char *buf)
+{
+  rtems_status_code sc;
+  rtems_bdbuf_buffer *bd;
+  size_t writes_before = write_requests;
+
+  puts("direct read coherency");
+
+  sc = rtems_bdbuf_get(dd, 1, &bd);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  memset(bd->buffer, 'M', BLOCK_SIZE);
+
+  sc = rtems_bdbuf_release_modified(bd);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  rtems_test_assert(write_requests == writes_before);
+
+  sc = rtems_bdbuf_read_direct(dd, 0, 2, buf);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  rtems_test_assert(write_requests == writes_before + 1);
+  rtems_test_assert(is_filled(disk_data [1], 'M'));
+  rtems_test_assert(is_filled(buf, 'a'));
+  rtems_test_assert(is_filled(buf + BLOCK_SIZE, 'M'));
+}
+
+static void test_direct_write_coherency(rtems_disk_device *dd, char *buf)
+{
+  rtems_status_code sc;
+  rtems_bdbuf_buffer *bd;
+  rtems_blkdev_stats stats;
+
+  puts("direct write coherency");
+
+  /* Block 4 is cached and block 5 is modified */
+  sc = rtems_bdbuf_read(dd, 4, &bd);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(is_filled((const char *) bd->buffer, 'e'));
+
+  sc = rtems_bdbuf_release(bd);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_bdbuf_get(dd, 5, &bd);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  memset(bd->buffer, 'X', BLOCK_SIZE);
+
+  sc = rtems_bdbuf_release_modified(bd);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  memset(buf, 'D', 2 * BLOCK_SIZE);
+
+  sc = rtems_bdbuf_write_direct(dd, 4, 2, buf);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  rtems_test_assert(last_req == RTEMS_BLKDEV_REQ_WRITE);
+  rtems_test_assert(last_bufs [0].buffer == buf);
+  rtems_test_assert(is_filled(disk_data [4], 'D'));
+  rtems_test_assert(is_filled(disk_data [5], 'D'));
+
+  /* The modified block 5 was discarded, so nothing is left to write */
+  sc = rtems_bdbuf_syncdev(dd);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(is_filled(disk_data [5], 'D'));
+
+  rtems_bdbuf_reset_device_stats(dd);
+
+  sc = rtems_bdbuf_read(dd, 4, &bd);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(is_filled((const char *) bd->buffer, 'D'));
+
+  sc = rtems_bdbuf_release(bd);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  rtems_bdbuf_get_device_stats(dd, &stats);
+  rtems_test_assert(stats.read_hits == 0);
+  rtems_test_assert(stats.read_misses == 1);
+}
+
+static void test_invalid_direct_transfers(rtems_disk_device *dd, char *buf)
+{
+  rtems_status_code sc;
+
+  puts("invalid direct transfers");
+
+  sc = rtems_bdbuf_read_direct(dd, BLOCK_COUNT - 1, 2, buf);
+  rtems_test_assert(sc == RTEMS_INVALID_ID);
+
+  sc = rtems_bdbuf_write_direct(dd, BLOCK_COUNT, 1, buf);
+  rtems_test_assert(sc == RTEMS_INVALID_ID);
+
+  sc = rtems_bdbuf_read_direct(dd, BLOCK_COUNT, 0, buf);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  if (rtems_cache_get_maximal_line_size() > 1) {
+    rtems_test_assert(!rtems_bdbuf_is_direct_buffer(buf + 1));
+
+    sc = rtems_bdbuf_read_direct(dd, 0, 1, buf + 1);
+    rtems_test_assert(sc == RTEMS_INVALID_ADDRESS);
+
+    sc = rtems_bdbuf_write_direct(dd, 0, 1, buf + 1);
+    rtems_test_assert(sc == RTEMS_INVALID_ADDRESS);
+  }
+}
+
+static void test(void)
+{
+  rtems_status_code sc;
+  dev_t dev = 0;
+  rtems_disk_device *dd;
+  char *buf;
+
+  buf = rtems_cache_aligned_malloc(BUFFER_COUNT * BLOCK_SIZE);
+  rtems_test_assert(buf != NULL);
+  rtems_test_assert(rtems_bdbuf_is_direct_buffer(buf));
+
+  sc = rtems_disk_io_initialize();
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_disk_create_phys(
+    dev,
+    BLOCK_SIZE,
+    BLOCK_COUNT,
+    test_disk_ioctl,
+    NULL,
+    NULL
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  dd = rtems_disk_obtain(dev);
+  rtems_test_assert(dd != NULL);
+
+  test_direct_read(dd, buf);
+  test_direct_read_coherency(dd, buf);
+  test_direct_write_coherency(dd, buf);
+  test_invalid_direct_transfers(dd, buf);
+
+  sc = rtems_disk_release(dd);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_disk_delete(dev);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  free(buf);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+#define CONFIGURE_BDBUF_BUFFER_MIN_SIZE BLOCK_SIZE
+#define CONFIGURE_BDBUF_BUFFER_MAX_SIZE BLOCK_SIZE
+#define CONFIGURE_BDBUF_CACHE_MEMORY_SIZE (BLOCK_COUNT * BLOCK_SIZE)
+
+#define CONFIGURE_MAXIMUM_TASKS 1
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
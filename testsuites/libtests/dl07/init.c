@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rtems/counter.h>
+#include <rtems/rtl/rtl.h>
+#include <rtems/rtl/rtl-allocator.h>
+#include <rtems/rtl/rtl-obj.h>
+#include <rtems/rtl/rtl-sym.h>
+
+const char rtems_test_name[] = "libdl (RTL) 7";
+
+#define LOCAL_COUNT 64
+
+#define GLOBAL_COUNT 960
+
+#define NAME_SIZE 16
+
+#define LOOKUP_COUNT 1024
+
+static char local_names[LOCAL_COUNT][NAME_SIZE];
+
+static char global_names[GLOBAL_COUNT][NAME_SIZE];
+
+static char missing_names[LOOKUP_COUNT][NAME_SIZE];
+
+static int values[LOCAL_COUNT + GLOBAL_COUNT];
+
+static rtems_rtl_obj_sym *new_table(
+  char (*names)[NAME_SIZE],
+  const char *prefix,
+  size_t count,
+  int *value
+)
+{
+  rtems_rtl_obj_sym *table;
+  size_t i;
+
+  table = rtems_rtl_alloc_new(
+    RTEMS_RTL_ALLOC_SYMBOL,
+    count * sizeof(*table),
+    true
+  );
+  rtems_test_assert(table != NULL);
+
+  for (i = 0; i < count; ++i) {
+    snprintf(names[i], NAME_SIZE, "%s_%04zu", prefix, i);
+    table[i].name = names[i];
+    table[i].value = &value[i];
+  }
+
+  return table;
+}
+
+static rtems_rtl_obj *new_obj(void)
+{
+  rtems_rtl_obj *obj;
+  size_t i;
+  bool ok;
+
+  obj = rtems_rtl_obj_alloc();
+  rtems_test_assert(obj != NULL);
+
+  obj->local_table = new_table(local_names, "dl07_l", LOCAL_COUNT, &values[0]);
+  obj->local_syms = LOCAL_COUNT;
+  obj->local_size = LOCAL_COUNT * sizeof(rtems_rtl_obj_sym);
+
+  obj->global_table =
+    new_table(global_names, "dl07_g", GLOBAL_COUNT, &values[LOCAL_COUNT]);
+  obj->global_syms = GLOBAL_COUNT;
+  obj->global_size = GLOBAL_COUNT * sizeof(rtems_rtl_obj_sym);
+
+  for (i = 0; i < LOOKUP_COUNT; ++i) {
+    snprintf(missing_names[i], NAME_SIZE, "dl07_m_%04zu", i);
+  }
+
+  ok = rtems_rtl_symbol_obj_add(obj);
+  rtems_test_assert(ok);
+
+  return obj;
+}
+
+static void test_lookup(rtems_rtl_obj *obj)
+{
+  rtems_rtl_obj_sym *sym;
+  size_t i;
+
+  puts("lookup");
+
+  for (i = 0; i < LOCAL_COUNT; ++i) {
+    sym = rtems_rtl_symbol_obj_find(obj, local_names[i]);
+    rtems_test_assert(sym == &obj->local_table[i]);
+    rtems_test_assert(sym->value == &values[i]);
+
+    /* Local symbols are not exported */
+    sym = rtems_rtl_symbol_global_find(local_names[i]);
+    rtems_test_assert(sym == NULL);
+  }
+
+  for (i = 0; i < GLOBAL_COUNT; ++i) {
+    sym = rtems_rtl_symbol_obj_find(obj, global_names[i]);
+    rtems_test_assert(sym == &obj->global_table[i]);
+    rtems_test_assert(sym->value == &values[LOCAL_COUNT + i]);
+
+    sym = rtems_rtl_symbol_global_find(global_names[i]);
+    rtems_test_assert(sym == &obj->global_table[i]);
+  }
+
+  for (i = 0; i < LOOKUP_COUNT; ++i) {
+    sym = rtems_rtl_symbol_obj_find(obj, missing_names[i]);
+    rtems_test_assert(sym == NULL);
+  }
+}
+
+/*
+ * This is the search of the object file's symbol tables without the index.
+ */
+static rtems_rtl_obj_sym *scan(rtems_rtl_obj *obj, const char *name)
+{
+  size_t i;
+
+  for (i = 0; i < obj->local_syms; ++i) {
+    if (strcmp(name, obj->local_table[i].name) == 0) {
+      return &obj->local_table[i];
+    }
+  }
+
+  for (i = 0; i < obj->global_syms; ++i) {
+    if (strcmp(name, obj->global_table[i].name) == 0) {
+      return &obj->global_table[i];
+    }
+  }
+
+  return NULL;
+}
+
+static uint64_t ns_per_lookup(rtems_counter_ticks ticks)
+{
+  return rtems_counter_ticks_to_nanoseconds(ticks) / LOOKUP_COUNT;
+}
+
+static void test_missing_name_lookup_time(rtems_rtl_obj *obj)
+{
+  rtems_counter_ticks t0;
+  rtems_counter_ticks index_ticks;
+  rtems_counter_ticks scan_ticks;
+  rtems_rtl_obj_sym *sym;
+  size_t i;
+
+  puts("missing name lookup time");
+
+  /*
+   * A relocation of an unresolved name searches every loaded object file.
+   * The Bloom filter of the index rejects most names without a hash chain
+   * walk.
+   */
+  t0 = rtems_counter_read();
+  for (i = 0; i < LOOKUP_COUNT; ++i) {
+    sym = rtems_rtl_symbol_obj_find(obj, missing_names[i]);
+    rtems_test_assert(sym == NULL);
+  }
+  index_ticks = rtems_counter_difference(rtems_counter_read(), t0);
+
+  t0 = rtems_counter_read();
+  for (i = 0; i < LOOKUP_COUNT; ++i) {
+    sym = scan(obj, missing_names[i]);
+    rtems_test_assert(sym == NULL);
+  }
+  scan_ticks = rtems_counter_difference(rtems_counter_read(), t0);
+
+  printf(
+    "index: %" PRIu64 "ns\n"
+    "scan: %" PRIu64 "ns\n",
+    ns_per_lookup(index_ticks),
+    ns_per_lookup(scan_ticks)
+  );
+
+  rtems_test_assert(index_ticks < scan_ticks);
+}
+
+static void test(void)
+{
+  rtems_rtl_obj *obj;
+  bool ok;
+
+  rtems_test_assert(rtems_rtl_lock() != NULL);
+
+  obj = new_obj();
+
+  test_lookup(obj);
+  test_missing_name_lookup_time(obj);
+
+  ok = rtems_rtl_obj_free(obj);
+  rtems_test_assert(ok);
+
+  rtems_test_assert(rtems_rtl_symbol_global_find(global_names[0]) == NULL);
+
+  rtems_rtl_unlock();
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_MAXIMUM_TASKS 1
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
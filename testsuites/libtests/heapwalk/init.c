@@ -148,6 +148,7 @@ static void test_check_free_list(void)
   Heap_Block *first_free_block = NULL;
   Heap_Block *secound_free_block = NULL;
   Heap_Block *third_free_block = NULL;
+  Heap_Block *last_free_block = NULL;
   Heap_Block *used_block = NULL;
 
   puts( "testing the _Heap_Walk_check_free_list() function" );
@@ -191,6 +192,23 @@ static void test_check_free_list(void)
   used_block = _Heap_Block_of_alloc_area( (uintptr_t) p1, TestHeap.page_size );
   _Heap_Free_list_insert_after( first_free_block, used_block );
   test_call_heap_walk( false );
+
+  puts( "\tmove the last free block to the front of the free list" );
+  test_heap_init_custom();
+  test_create_heap_with_gaps();
+  last_free_block = _Heap_Free_list_last( &TestHeap );
+  _Heap_Free_list_remove( last_free_block );
+  _Heap_Free_list_insert_after( _Heap_Free_list_head( &TestHeap ), last_free_block );
+  test_call_heap_walk( false );
+
+  puts( "\tclear the first block of a size class in the free list index" );
+  test_heap_init_custom();
+  test_create_heap_with_gaps();
+  first_free_block = _Heap_Free_list_first( &TestHeap );
+  TestHeap.free_list_index.first[
+    _Heap_Free_list_class( _Heap_Block_size( first_free_block ) )
+  ] = NULL;
+  test_call_heap_walk( false );
 }
 
 static void test_freshly_initialized(void)
@@ -13,6 +13,8 @@
 
 #include <tmacros.h>
 
+#include <rtems/malloc.h>
+
 const char rtems_test_name[] = "MALLOC 2";
 
 /* forward declarations to avoid warnings */
@@ -41,6 +43,9 @@ rtems_task Init(
   rtems_status_code     status;
   rtems_id              timer;
   void                 *pointer2;
+  Heap_Information_block before;
+  Heap_Information_block after;
+  int                   sc;
 
   TEST_BEGIN();
 
@@ -75,6 +80,30 @@ rtems_task Init(
   pointer2 = malloc(20);
   rtems_test_assert( pointer2 );
 
+  puts( "malloc memory to free from ISR and process by task" );
+  Pointer1 = malloc( 20 );
+  rtems_test_assert( Pointer1 );
+
+  operation_performed_from_tsr = false;
+
+  status = rtems_timer_fire_after( timer, 10, test_operation_from_isr, NULL );
+  directive_failed( status, "timer_fire_after failed" );
+
+  status = rtems_task_wake_after( 20 );
+  directive_failed( status, "timer_wake_after failed" );
+  rtems_test_assert( operation_performed_from_tsr );
+
+  sc = malloc_info( &before );
+  rtems_test_assert( sc == 0 );
+
+  rtems_malloc_process_deferred_frees();
+
+  sc = malloc_info( &after );
+  rtems_test_assert( sc == 0 );
+  rtems_test_assert( after.Used.number == before.Used.number - 1 );
+
+  puts( "Deferred free processed by task" );
+
   TEST_END();
   rtems_test_exit( 0 );
 }
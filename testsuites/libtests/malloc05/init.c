@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <stdlib.h>
+
+#include <rtems/libcsupport.h>
+#include <rtems/malloc.h>
+
+const char rtems_test_name[] = "MALLOC 5";
+
+#define CACHE_SIZE 8
+
+#define OBJECT_COUNT 32
+
+static void *objects[OBJECT_COUNT];
+
+static void get_info(rtems_malloc_cache_information *info)
+{
+  rtems_malloc_cache_get_information(info);
+}
+
+static void test_refill_and_hit(void)
+{
+  rtems_malloc_cache_information base;
+  rtems_malloc_cache_information info;
+  void *p;
+
+  puts("refill and hit");
+
+  /* Start with empty magazines */
+  rtems_malloc_cache_flush();
+  get_info(&base);
+  rtems_test_assert(base.cached_objects == 0);
+
+  p = malloc(24);
+  rtems_test_assert(p != NULL);
+
+  get_info(&info);
+  rtems_test_assert(info.allocation_misses == base.allocation_misses + 1);
+  rtems_test_assert(info.refills == base.refills + 1);
+  rtems_test_assert(info.cached_objects == CACHE_SIZE / 2 - 1);
+  rtems_test_assert(info.cached_bytes > 0);
+
+  free(p);
+
+  get_info(&info);
+  rtems_test_assert(info.free_hits == base.free_hits + 1);
+  rtems_test_assert(info.cached_objects == CACHE_SIZE / 2);
+
+  p = malloc(24);
+  rtems_test_assert(p != NULL);
+
+  get_info(&info);
+  rtems_test_assert(info.allocation_hits == base.allocation_hits + 1);
+  rtems_test_assert(info.refills == base.refills + 1);
+  rtems_test_assert(info.cached_objects == CACHE_SIZE / 2 - 1);
+
+  free(p);
+}
+
+static void test_spill(void)
+{
+  rtems_malloc_cache_information info;
+  size_t i;
+
+  puts("spill");
+
+  for (i = 0; i < OBJECT_COUNT; ++i) {
+    objects[i] = malloc(24);
+    rtems_test_assert(objects[i] != NULL);
+  }
+
+  for (i = 0; i < OBJECT_COUNT; ++i) {
+    free(objects[i]);
+  }
+
+  get_info(&info);
+  rtems_test_assert(info.spills > 0);
+  rtems_test_assert(
+    info.cached_objects <= CACHE_SIZE * RTEMS_MALLOC_CACHE_CLASS_COUNT
+  );
+}
+
+static void test_large_objects(void)
+{
+  rtems_malloc_cache_information before;
+  rtems_malloc_cache_information after;
+  void *p;
+
+  puts("large objects");
+
+  get_info(&before);
+
+  p = malloc(1024);
+  rtems_test_assert(p != NULL);
+  free(p);
+
+  get_info(&after);
+  rtems_test_assert(after.allocation_hits == before.allocation_hits);
+  rtems_test_assert(after.allocation_misses == before.allocation_misses);
+  rtems_test_assert(after.free_hits == before.free_hits);
+}
+
+static void test_flush(void)
+{
+  rtems_malloc_cache_information info;
+  Heap_Information_block heap_before;
+  Heap_Information_block heap_after;
+  int rv;
+
+  puts("flush");
+
+  get_info(&info);
+  rtems_test_assert(info.cached_objects > 0);
+
+  rv = malloc_info(&heap_before);
+  rtems_test_assert(rv == 0);
+
+  rtems_malloc_cache_flush();
+
+  get_info(&info);
+  rtems_test_assert(info.cached_objects == 0);
+  rtems_test_assert(info.cached_bytes == 0);
+
+  rv = malloc_info(&heap_after);
+  rtems_test_assert(rv == 0);
+  rtems_test_assert(heap_after.Used.number < heap_before.Used.number);
+  rtems_test_assert(heap_after.Free.total > heap_before.Free.total);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  rtems_resource_snapshot snapshot;
+
+  TEST_BEGIN();
+
+  rtems_test_assert(rtems_malloc_cache_size == CACHE_SIZE);
+
+  rtems_resource_snapshot_take(&snapshot);
+
+  test_refill_and_hit();
+  test_spill();
+  test_large_objects();
+  test_flush();
+
+  /* The snapshot returns the cached objects to the heap */
+  objects[0] = malloc(24);
+  rtems_test_assert(objects[0] != NULL);
+  free(objects[0]);
+  rtems_test_assert(rtems_resource_snapshot_check(&snapshot));
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_DOES_NOT_NEED_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_MALLOC_PER_CPU_CACHE_SIZE CACHE_SIZE
+
+#define CONFIGURE_MAXIMUM_TASKS 1
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
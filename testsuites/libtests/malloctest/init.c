@@ -1245,6 +1245,99 @@ static void test_greedy_allocate(void)
   rtems_test_assert( p == NULL );
 }
 
+static void *test_allocate_block( uintptr_t block_size )
+{
+  void *p;
+  Heap_Block *block;
+
+  p = _Heap_Allocate( &TestHeap, block_size - HEAP_BLOCK_HEADER_SIZE );
+  rtems_test_assert( p != NULL );
+
+  block = _Heap_Block_of_alloc_area( (uintptr_t) p, TestHeap.page_size );
+  rtems_test_assert( _Heap_Block_size( block ) == block_size );
+
+  return p;
+}
+
+static void test_heap_allocate_same_class(void)
+{
+  Heap_Control *heap = &TestHeap;
+  uintptr_t small_size = 512;
+  uintptr_t large_size = 576;
+  uintptr_t block_size_floor = 544;
+  uintptr_t allocatable_size;
+  Heap_Information info;
+  Heap_Block *block;
+  Heap_Block *blocks;
+  void *small;
+  void *large;
+  void *p;
+
+  rtems_test_assert(
+    _Heap_Free_list_class( small_size ) == _Heap_Free_list_class( large_size )
+  );
+  rtems_test_assert(
+    _Heap_Free_list_class( small_size )
+      == _Heap_Free_list_class( block_size_floor )
+  );
+
+  _Heap_Initialize( heap, &TestHeapMemory[0], sizeof(TestHeapMemory), 0 );
+
+  /* The used blocks in between prevent the coalescing of the free blocks */
+  small = test_allocate_block( small_size );
+  p = _Heap_Allocate( heap, 1 );
+  rtems_test_assert( p != NULL );
+  large = test_allocate_block( large_size );
+  p = _Heap_Allocate( heap, 1 );
+  rtems_test_assert( p != NULL );
+
+  block = _Heap_Free_list_first( heap );
+  p = _Heap_Allocate(
+    heap,
+    _Heap_Block_size( block ) - HEAP_BLOCK_HEADER_SIZE
+  );
+  rtems_test_assert( p != NULL );
+  rtems_test_assert(
+    _Heap_Free_list_first( heap ) == _Heap_Free_list_tail( heap )
+  );
+
+  /*
+   * A block is inserted as the first block of its size class, so the small
+   * block which does not fit is the first one.  There is no free block of a
+   * greater size class.
+   */
+  test_free( large );
+  test_free( small );
+
+  block = _Heap_Block_of_alloc_area( (uintptr_t) small, heap->page_size );
+  rtems_test_assert( _Heap_Free_list_first( heap ) == block );
+
+  /* The search does not examine the second block of the size class */
+  p = _Heap_Allocate(
+    heap,
+    block_size_floor - HEAP_BLOCK_HEADER_SIZE + HEAP_ALLOC_BONUS
+  );
+  rtems_test_assert( p == NULL );
+  rtems_test_assert( heap->stats.max_search <= 2 );
+
+  blocks = _Heap_Greedy_allocate_all_except_largest( heap, &allocatable_size );
+  rtems_test_assert(
+    allocatable_size == large_size - HEAP_BLOCK_HEADER_SIZE + HEAP_ALLOC_BONUS
+  );
+
+  _Heap_Get_free_information( heap, &info );
+  rtems_test_assert( info.number == 1 );
+  rtems_test_assert( info.largest == large_size );
+
+  p = _Heap_Allocate( heap, allocatable_size );
+  rtems_test_assert( p == large );
+
+  test_free( p );
+
+  _Heap_Greedy_free( heap, blocks );
+  rtems_test_assert( _Heap_Walk( heap, 0, false ) );
+}
+
 rtems_task Init(
   rtems_task_argument argument
 )
@@ -1285,6 +1378,7 @@ rtems_task Init(
   test_heap_initialize();
   test_heap_block_allocate();
   test_heap_allocate();
+  test_heap_allocate_same_class();
   test_heap_free();
   test_heap_resize_block();
   test_realloc();
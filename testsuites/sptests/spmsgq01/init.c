@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <string.h>
+
+#include "tmacros.h"
+
+const char rtems_test_name[] = "SPMSGQ 1";
+
+#define MAX_MESSAGES 2
+
+#define MAX_MESSAGE_SIZE 64
+
+static rtems_id queue;
+
+static void *received_buffer;
+
+static size_t received_size;
+
+static char received_content[MAX_MESSAGE_SIZE];
+
+static void *get_buffer(void)
+{
+  rtems_status_code sc;
+  void *buffer;
+
+  sc = rtems_message_queue_get_buffer(queue, &buffer);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(buffer != NULL);
+
+  return buffer;
+}
+
+static void return_buffer(void *buffer)
+{
+  rtems_status_code sc;
+
+  sc = rtems_message_queue_return_buffer(queue, buffer);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+}
+
+static void check_all_buffers_available(void)
+{
+  rtems_status_code sc;
+  void *buffers[MAX_MESSAGES];
+  void *buffer;
+  size_t i;
+
+  for (i = 0; i < MAX_MESSAGES; ++i) {
+    buffers[i] = get_buffer();
+  }
+
+  sc = rtems_message_queue_get_buffer(queue, &buffer);
+  rtems_test_assert(sc == RTEMS_TOO_MANY);
+
+  for (i = 0; i < MAX_MESSAGES; ++i) {
+    return_buffer(buffers[i]);
+  }
+}
+
+static void test_errors(void)
+{
+  rtems_status_code sc;
+  char not_a_buffer[MAX_MESSAGE_SIZE];
+  void *buffer;
+  size_t size;
+
+  puts("errors");
+
+  sc = rtems_message_queue_get_buffer(queue, NULL);
+  rtems_test_assert(sc == RTEMS_INVALID_ADDRESS);
+
+  sc = rtems_message_queue_get_buffer(0, &buffer);
+  rtems_test_assert(sc == RTEMS_INVALID_ID);
+
+  sc = rtems_message_queue_send_buffer(queue, NULL, 1);
+  rtems_test_assert(sc == RTEMS_INVALID_ADDRESS);
+
+  sc = rtems_message_queue_send_buffer(queue, not_a_buffer, 1);
+  rtems_test_assert(sc == RTEMS_INVALID_ADDRESS);
+
+  sc = rtems_message_queue_return_buffer(queue, not_a_buffer);
+  rtems_test_assert(sc == RTEMS_INVALID_ADDRESS);
+
+  sc = rtems_message_queue_receive_buffer(
+    queue,
+    NULL,
+    &size,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_INVALID_ADDRESS);
+
+  sc = rtems_message_queue_receive_buffer(
+    queue,
+    &buffer,
+    NULL,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_INVALID_ADDRESS);
+
+  sc = rtems_message_queue_receive_buffer(
+    queue,
+    &buffer,
+    &size,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_UNSATISFIED);
+
+  buffer = get_buffer();
+
+  sc = rtems_message_queue_send_buffer(queue, buffer, MAX_MESSAGE_SIZE + 1);
+  rtems_test_assert(sc == RTEMS_INVALID_SIZE);
+
+  /* The buffer is still lent after a failed send */
+  return_buffer(buffer);
+
+  sc = rtems_message_queue_return_buffer(queue, buffer);
+  rtems_test_assert(sc == RTEMS_INVALID_ADDRESS);
+
+  sc = rtems_message_queue_send_buffer(queue, buffer, 1);
+  rtems_test_assert(sc == RTEMS_INVALID_ADDRESS);
+
+  check_all_buffers_available();
+}
+
+static void test_pending(void)
+{
+  static const char message[] = "pending";
+  rtems_status_code sc;
+  void *buffer;
+  void *buffer_2;
+  size_t size;
+  char copy[MAX_MESSAGE_SIZE];
+
+  puts("pending messages");
+
+  /* Lent send and lent receive */
+  buffer = get_buffer();
+  memcpy(buffer, message, sizeof(message));
+
+  sc = rtems_message_queue_send_buffer(queue, buffer, sizeof(message));
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_message_queue_receive_buffer(
+    queue,
+    &buffer_2,
+    &size,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(buffer_2 == buffer);
+  rtems_test_assert(size == sizeof(message));
+  rtems_test_assert(memcmp(buffer_2, message, sizeof(message)) == 0);
+
+  /* A lent buffer can be sent again */
+  sc = rtems_message_queue_send_buffer(queue, buffer_2, sizeof(message));
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  /* Lent send and copy receive */
+  size = 0;
+  sc = rtems_message_queue_receive(queue, copy, &size, RTEMS_NO_WAIT, 0);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(size == sizeof(message));
+  rtems_test_assert(memcmp(copy, message, sizeof(message)) == 0);
+
+  /* Copy send and lent receive */
+  sc = rtems_message_queue_send(queue, message, sizeof(message));
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_message_queue_receive_buffer(
+    queue,
+    &buffer,
+    &size,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(size == sizeof(message));
+  rtems_test_assert(memcmp(buffer, message, sizeof(message)) == 0);
+
+  return_buffer(buffer);
+
+  check_all_buffers_available();
+}
+
+static void lent_receiver(rtems_task_argument arg)
+{
+  while (true) {
+    rtems_status_code sc;
+    void *buffer;
+    size_t size;
+
+    sc = rtems_message_queue_receive_buffer(
+      queue,
+      &buffer,
+      &size,
+      RTEMS_WAIT,
+      RTEMS_NO_TIMEOUT
+    );
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+    received_buffer = buffer;
+    received_size = size;
+    memcpy(received_content, buffer, size);
+
+    return_buffer(buffer);
+  }
+}
+
+static void copy_receiver(rtems_task_argument arg)
+{
+  while (true) {
+    rtems_status_code sc;
+    size_t size;
+
+    sc = rtems_message_queue_receive(
+      queue,
+      received_content,
+      &size,
+      RTEMS_WAIT,
+      RTEMS_NO_TIMEOUT
+    );
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+    received_size = size;
+  }
+}
+
+static rtems_id start_receiver(rtems_task_entry entry)
+{
+  rtems_status_code sc;
+  rtems_id id;
+
+  /* The receiver has a higher priority, so it waits on the queue */
+  sc = rtems_task_create(
+    rtems_build_name('R', 'E', 'C', 'V'),
+    1,
+    RTEMS_MINIMUM_STACK_SIZE,
+    RTEMS_DEFAULT_MODES,
+    RTEMS_DEFAULT_ATTRIBUTES,
+    &id
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_task_start(id, entry, 0);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  return id;
+}
+
+static void delete_receiver(rtems_id id)
+{
+  rtems_status_code sc;
+
+  sc = rtems_task_delete(id);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+}
+
+static void test_waiting_receiver(void)
+{
+  static const char message[] = "waiting";
+  rtems_status_code sc;
+  rtems_id id;
+  void *buffer;
+
+  puts("waiting receivers");
+
+  id = start_receiver(lent_receiver);
+
+  /* Lent send to a lent receiver hands over the buffer */
+  buffer = get_buffer();
+  memcpy(buffer, message, sizeof(message));
+
+  sc = rtems_message_queue_send_buffer(queue, buffer, sizeof(message));
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(received_buffer == buffer);
+  rtems_test_assert(received_size == sizeof(message));
+  rtems_test_assert(memcmp(received_content, message, sizeof(message)) == 0);
+
+  /* Copy send to a lent receiver */
+  memset(received_content, 0, sizeof(received_content));
+  received_buffer = NULL;
+  received_size = 0;
+
+  sc = rtems_message_queue_send(queue, message, sizeof(message));
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(received_buffer != NULL);
+  rtems_test_assert(received_size == sizeof(message));
+  rtems_test_assert(memcmp(received_content, message, sizeof(message)) == 0);
+
+  delete_receiver(id);
+
+  id = start_receiver(copy_receiver);
+
+  /* Lent send to a copy receiver */
+  memset(received_content, 0, sizeof(received_content));
+  received_size = 0;
+
+  buffer = get_buffer();
+  memcpy(buffer, message, sizeof(message));
+
+  sc = rtems_message_queue_send_buffer(queue, buffer, sizeof(message));
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(received_size == sizeof(message));
+  rtems_test_assert(memcmp(received_content, message, sizeof(message)) == 0);
+
+  delete_receiver(id);
+
+  check_all_buffers_available();
+}
+
+static void Init(rtems_task_argument arg)
+{
+  rtems_status_code sc;
+
+  TEST_BEGIN();
+
+  sc = rtems_message_queue_create(
+    rtems_build_name('M', 'S', 'G', 'Q'),
+    MAX_MESSAGES,
+    MAX_MESSAGE_SIZE,
+    RTEMS_DEFAULT_ATTRIBUTES,
+    &queue
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  test_errors();
+  test_pending();
+  test_waiting_receiver();
+
+  sc = rtems_message_queue_delete(queue);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_DOES_NOT_NEED_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_MAXIMUM_TASKS 3
+
+#define CONFIGURE_MAXIMUM_MESSAGE_QUEUES 1
+
+#define CONFIGURE_MESSAGE_BUFFER_MEMORY \
+  CONFIGURE_MESSAGE_BUFFERS_FOR_QUEUE(MAX_MESSAGES, MAX_MESSAGE_SIZE)
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
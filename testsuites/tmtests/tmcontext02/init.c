@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <rtems/counter.h>
+#include <rtems/malloc.h>
+#include <rtems/score/context.h>
+#include <rtems.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include "tmacros.h"
+
+#define SAMPLES 123
+
+#define HELPER_STACK_SIZE (8 * 1024)
+
+/*
+ * Used if the BSP does not know the data cache size, large enough to evict
+ * the last level cache of common processors.
+ */
+#define DEFAULT_DATA_SIZE (8 * 1024 * 1024)
+
+const char rtems_test_name[] = "TMCONTEXT 2";
+
+static rtems_counter_ticks t[SAMPLES];
+
+static size_t cache_line_size;
+
+static size_t data_size;
+
+static volatile int *data;
+
+static Context_Control main_ctx;
+
+static Context_Control helper_ctx;
+
+static char helper_stack[HELPER_STACK_SIZE]
+  RTEMS_ALIGNED(CPU_STACK_ALIGNMENT);
+
+static rtems_id pong_id;
+
+static volatile int sample;
+
+static volatile rtems_counter_ticks switch_begin;
+
+static void dirty_data_cache(void)
+{
+  size_t m = data_size / sizeof(*data);
+  size_t k = cache_line_size / sizeof(*data);
+  size_t i;
+
+  for (i = 0; i < m; i += k) {
+    data[i] = i;
+  }
+
+  rtems_cache_invalidate_entire_instruction();
+}
+
+/*
+ * The buffer used to evict the data cache is limited to half of the largest
+ * free block of the heap, so that small heap configurations still work.  If
+ * no buffer is available, then the cold cache measurements are skipped.
+ */
+static void allocate_data(void)
+{
+  Heap_Information_block info;
+  int rv;
+
+  data_size = rtems_cache_get_data_cache_size(0);
+  if (data_size == 0) {
+    data_size = DEFAULT_DATA_SIZE;
+  }
+
+  rv = malloc_info(&info);
+  rtems_test_assert(rv == 0);
+
+  if (data_size > info.Free.largest / 2) {
+    data_size = info.Free.largest / 2;
+  }
+
+  data = malloc(data_size);
+  if (data == NULL) {
+    data_size = 0;
+  }
+}
+
+static void prepare_sample(bool cold)
+{
+  if (cold) {
+    dirty_data_cache();
+  }
+}
+
+static void helper(void)
+{
+  while (true) {
+    t[sample] = rtems_counter_difference(rtems_counter_read(), switch_begin);
+    _Context_Switch(&helper_ctx, &main_ctx);
+  }
+}
+
+static void pong_task(rtems_task_argument arg)
+{
+  (void) arg;
+
+  while (true) {
+    t[sample] = rtems_counter_difference(rtems_counter_read(), switch_begin);
+    rtems_task_wake_after(RTEMS_YIELD_PROCESSOR);
+  }
+}
+
+static void measure_context_switch(bool cold)
+{
+  RTEMS_INTERRUPT_LOCK_DECLARE(, lock)
+  rtems_interrupt_lock_context lock_context;
+  int s;
+
+  _Context_Initialize(
+    &helper_ctx,
+    helper_stack,
+    sizeof(helper_stack),
+    1,
+    helper,
+    false,
+    NULL
+  );
+
+  rtems_interrupt_lock_initialize(&lock, "test");
+  rtems_interrupt_lock_acquire(&lock, &lock_context);
+
+  for (s = 0; s < SAMPLES; ++s) {
+    prepare_sample(cold);
+    sample = s;
+    switch_begin = rtems_counter_read();
+    _Context_Switch(&main_ctx, &helper_ctx);
+  }
+
+  rtems_interrupt_lock_release(&lock, &lock_context);
+  rtems_interrupt_lock_destroy(&lock);
+}
+
+static void measure_thread_dispatch(bool cold)
+{
+  int s;
+
+  for (s = 0; s < SAMPLES; ++s) {
+    prepare_sample(cold);
+    sample = s;
+    switch_begin = rtems_counter_read();
+    rtems_task_wake_after(RTEMS_YIELD_PROCESSOR);
+  }
+}
+
+static int cmp(const void *ap, const void *bp)
+{
+  rtems_counter_ticks a = *(const rtems_counter_ticks *) ap;
+  rtems_counter_ticks b = *(const rtems_counter_ticks *) bp;
+
+  return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+static void print_value(const char *name, rtems_counter_ticks ticks)
+{
+  printf(
+    "<%s unit=\"ticks\">%" PRIu64 "</%s>"
+      "<%s unit=\"ns\">%" PRIu64 "</%s>",
+    name,
+    (uint64_t) ticks,
+    name,
+    name,
+    rtems_counter_ticks_to_nanoseconds(ticks),
+    name
+  );
+}
+
+static void test(const char *name, void (*measure)(bool), bool cold)
+{
+  (*measure)(cold);
+
+  qsort(&t[0], SAMPLES, sizeof(t[0]), cmp);
+
+  printf(
+    "  <%s cache=\"%s\">\n    ",
+    name,
+    cold ? "cold" : "warm"
+  );
+  print_value("Min", t[0]);
+  print_value("Q1", t[(1 * SAMPLES) / 4]);
+  print_value("Q2", t[SAMPLES / 2]);
+  print_value("Q3", t[(3 * SAMPLES) / 4]);
+  print_value("Max", t[SAMPLES - 1]);
+  printf("\n  </%s>\n", name);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  rtems_status_code sc;
+  rtems_task_priority priority;
+
+  TEST_BEGIN();
+
+  cache_line_size = rtems_cache_get_data_line_size();
+  if (cache_line_size == 0) {
+    cache_line_size = 64;
+  }
+
+  allocate_data();
+
+  sc = rtems_task_set_priority(RTEMS_SELF, RTEMS_CURRENT_PRIORITY, &priority);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_task_create(
+    rtems_build_name('P', 'O', 'N', 'G'),
+    priority,
+    RTEMS_MINIMUM_STACK_SIZE,
+    RTEMS_DEFAULT_MODES,
+    RTEMS_DEFAULT_ATTRIBUTES,
+    &pong_id
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_task_start(pong_id, pong_task, 0);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  /* Let the pong task reach its loop */
+  rtems_task_wake_after(RTEMS_YIELD_PROCESSOR);
+
+  printf(
+    "<Test>\n"
+    "  <Counter unit=\"Hz\">%" PRIu32 "</Counter>\n",
+    rtems_counter_frequency()
+  );
+
+  test("ContextSwitch", measure_context_switch, false);
+
+  if (data != NULL) {
+    test("ContextSwitch", measure_context_switch, true);
+  }
+
+  test("ThreadDispatch", measure_thread_dispatch, false);
+
+  if (data != NULL) {
+    test("ThreadDispatch", measure_thread_dispatch, true);
+  }
+
+  printf("</Test>\n");
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+/*
+ * Do not use a clock driver, since its interrupts would disturb the
+ * measurements.
+ */
+#define CONFIGURE_APPLICATION_DOES_NOT_NEED_CLOCK_DRIVER
+
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_MAXIMUM_TASKS 2
+
+#define CONFIGURE_MAXIMUM_PROCESSORS 1
+
+#define CONFIGURE_INIT_TASK_STACK_SIZE (32 * 1024)
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rtems/counter.h>
+#include <rtems/score/heapimpl.h>
+
+#include "tmacros.h"
+
+const char rtems_test_name[] = "TMHEAP 1";
+
+#define AREA_SIZE (512 * 1024)
+
+#define BLOCK_COUNT 512
+
+#define SAMPLES 4096
+
+#define BIN_COUNT 32
+
+static Heap_Control heap;
+
+static char area[AREA_SIZE] RTEMS_ALIGNED(CPU_HEAP_ALIGNMENT);
+
+static void *blocks[BLOCK_COUNT];
+
+static rtems_counter_ticks t[SAMPLES];
+
+static uint32_t bins[BIN_COUNT];
+
+static uint32_t seed;
+
+static uint32_t next_random(void)
+{
+  seed = seed * 1103515245U + 12345U;
+
+  return seed >> 8;
+}
+
+static uintptr_t next_size(void)
+{
+  uint32_t r = next_random();
+
+  /* Mostly small blocks and some larger ones */
+  if ((r & 0x7) == 0) {
+    return 512 + (r >> 3) % 2048;
+  }
+
+  return 8 + (r >> 3) % 256;
+}
+
+static void fragment(void)
+{
+  uintptr_t size;
+  size_t i;
+
+  seed = 0;
+
+  size = _Heap_Initialize(&heap, area, sizeof(area), 0);
+  rtems_test_assert(size > 0);
+
+  for (i = 0; i < BLOCK_COUNT; ++i) {
+    blocks[i] = _Heap_Allocate(&heap, next_size());
+    rtems_test_assert(blocks[i] != NULL);
+  }
+
+  for (i = 0; i < BLOCK_COUNT; i += 2) {
+    _Heap_Free(&heap, blocks[i]);
+    blocks[i] = NULL;
+  }
+
+  rtems_test_assert(_Heap_Walk(&heap, 0, false));
+}
+
+static int cmp(const void *ap, const void *bp)
+{
+  rtems_counter_ticks a = *(const rtems_counter_ticks *) ap;
+  rtems_counter_ticks b = *(const rtems_counter_ticks *) bp;
+
+  return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+static void print_value(const char *name, rtems_counter_ticks ticks)
+{
+  printf(
+    "<%s unit=\"ticks\">%" PRIu64 "</%s>"
+      "<%s unit=\"ns\">%" PRIu64 "</%s>",
+    name,
+    (uint64_t) ticks,
+    name,
+    name,
+    rtems_counter_ticks_to_nanoseconds(ticks),
+    name
+  );
+}
+
+static void print_histogram(void)
+{
+  size_t i;
+
+  memset(bins, 0, sizeof(bins));
+
+  for (i = 0; i < SAMPLES; ++i) {
+    rtems_counter_ticks ticks = t[i];
+    size_t bin = 0;
+
+    while (ticks > 1 && bin < BIN_COUNT - 1) {
+      ticks >>= 1;
+      ++bin;
+    }
+
+    ++bins[bin];
+  }
+
+  printf("    <Histogram unit=\"log2(ticks)\">");
+
+  for (i = 0; i < BIN_COUNT; ++i) {
+    if (bins[i] != 0) {
+      printf("<Bin value=\"%zu\">%" PRIu32 "</Bin>", i, bins[i]);
+    }
+  }
+
+  printf("</Histogram>\n");
+}
+
+static void test_allocate(const char *name, uintptr_t alignment)
+{
+  size_t s;
+
+  fragment();
+
+  for (s = 0; s < SAMPLES; ++s) {
+    size_t i = (next_random() >> 4) % BLOCK_COUNT;
+    rtems_counter_ticks begin;
+
+    if (blocks[i] != NULL) {
+      _Heap_Free(&heap, blocks[i]);
+    }
+
+    begin = rtems_counter_read();
+    blocks[i] = _Heap_Allocate_aligned(&heap, next_size(), alignment);
+    t[s] = rtems_counter_difference(rtems_counter_read(), begin);
+
+    rtems_test_assert(blocks[i] != NULL);
+  }
+
+  rtems_test_assert(_Heap_Walk(&heap, 0, false));
+
+  printf(
+    "  <%s alignment=\"%" PRIuPTR "\" max-search=\"%" PRIu32 "\">\n",
+    name,
+    alignment,
+    heap.stats.max_search
+  );
+
+  print_histogram();
+
+  qsort(&t[0], SAMPLES, sizeof(t[0]), cmp);
+
+  printf("    <Latency>");
+  print_value("Min", t[0]);
+  print_value("Q2", t[SAMPLES / 2]);
+  print_value("Q3", t[(3 * SAMPLES) / 4]);
+  print_value("Max", t[SAMPLES - 1]);
+  printf("</Latency>\n");
+
+  printf("  </%s>\n", name);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  printf(
+    "<Test>\n"
+    "  <Counter unit=\"Hz\">%" PRIu32 "</Counter>\n",
+    rtems_counter_frequency()
+  );
+
+  test_allocate("Allocate", 0);
+
+  /*
+   * Allocations without an alignment constraint examine at most two free
+   * blocks regardless of the free list length.
+   */
+  rtems_test_assert(heap.stats.max_search <= 2);
+
+  test_allocate("AllocateAligned", 256);
+
+  printf("</Test>\n");
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+/*
+ * Do not use a clock driver, since its interrupts would disturb the
+ * measurements.
+ */
+#define CONFIGURE_APPLICATION_DOES_NOT_NEED_CLOCK_DRIVER
+
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_MAXIMUM_TASKS 1
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2018.
+ * Amaan Cheval <amaan.cheval@gmail.com>
+ *
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <rtems/counter.h>
+#include <rtems/imfs.h>
+#include <rtems/libio.h>
+
+#include "tmacros.h"
+
+#define SAMPLES 5
+
+#define CHUNK_SIZE 4096
+
+#define MAX_FILE_SIZE (4 * 1024 * 1024)
+
+const char rtems_test_name[] = "TMIMFS 1";
+
+static const size_t file_sizes[] = {
+  1024 * 1024,
+  MAX_FILE_SIZE
+};
+
+static char *data;
+
+static char *buf;
+
+static rtems_counter_ticks t[SAMPLES];
+
+typedef enum {
+  WRITE_CHUNKS,
+  READ_CHUNKS,
+  READ_ALL
+} operation;
+
+static rtems_counter_ticks measure(
+  const char *path,
+  size_t size,
+  operation op
+)
+{
+  rtems_counter_ticks begin;
+  rtems_counter_ticks ticks;
+  size_t done;
+  ssize_t n;
+  int fd;
+  int rv;
+
+  if (op == WRITE_CHUNKS) {
+    unlink(path);
+    fd = open(path, O_WRONLY | O_CREAT, S_IRWXU);
+  } else {
+    fd = open(path, O_RDONLY);
+  }
+  rtems_test_assert(fd >= 0);
+
+  begin = rtems_counter_read();
+
+  switch (op) {
+    case WRITE_CHUNKS:
+      for (done = 0; done < size; done += CHUNK_SIZE) {
+        n = write(fd, &data[done], CHUNK_SIZE);
+        rtems_test_assert(n == CHUNK_SIZE);
+      }
+      break;
+    case READ_CHUNKS:
+      for (done = 0; done < size; done += CHUNK_SIZE) {
+        n = read(fd, &buf[done], CHUNK_SIZE);
+        rtems_test_assert(n == CHUNK_SIZE);
+      }
+      break;
+    default:
+      n = read(fd, buf, size);
+      rtems_test_assert(n == (ssize_t) size);
+      break;
+  }
+
+  ticks = rtems_counter_difference(rtems_counter_read(), begin);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  if (op != WRITE_CHUNKS) {
+    rtems_test_assert(memcmp(buf, data, size) == 0);
+  }
+
+  return ticks;
+}
+
+static int cmp(const void *ap, const void *bp)
+{
+  rtems_counter_ticks a = *(const rtems_counter_ticks *) ap;
+  rtems_counter_ticks b = *(const rtems_counter_ticks *) bp;
+
+  return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+static void print_value(const char *name, rtems_counter_ticks ticks)
+{
+  printf(
+    "<%s unit=\"ticks\">%" PRIu64 "</%s>"
+      "<%s unit=\"ns\">%" PRIu64 "</%s>",
+    name,
+    (uint64_t) ticks,
+    name,
+    name,
+    rtems_counter_ticks_to_nanoseconds(ticks),
+    name
+  );
+}
+
+static void test_operation(
+  const char *name,
+  const char *path,
+  size_t size,
+  operation op
+)
+{
+  int s;
+
+  for (s = 0; s < SAMPLES; ++s) {
+    t[s] = measure(path, size, op);
+  }
+
+  qsort(&t[0], SAMPLES, sizeof(t[0]), cmp);
+
+  printf("    <%s>", name);
+  print_value("Min", t[0]);
+  print_value("Q2", t[SAMPLES / 2]);
+  print_value("Max", t[SAMPLES - 1]);
+  printf("</%s>\n", name);
+}
+
+static void test_file(const char *layout, const char *path, size_t size)
+{
+  struct stat st;
+  int rv;
+
+  printf("  <File layout=\"%s\" size=\"%zu\">\n", layout, size);
+
+  test_operation("WriteChunks", path, size, WRITE_CHUNKS);
+  test_operation("ReadChunks", path, size, READ_CHUNKS);
+  test_operation("ReadAll", path, size, READ_ALL);
+
+  rv = stat(path, &st);
+  rtems_test_assert(rv == 0);
+  rtems_test_assert(st.st_size == (off_t) size);
+
+  rv = unlink(path);
+  rtems_test_assert(rv == 0);
+
+  printf("  </File>\n");
+}
+
+static void test_holes(const char *path)
+{
+  static const char end[] = "end";
+  off_t offset = 3 * IMFS_EXTFILE_MAX_EXTENT_SIZE + 1;
+  ssize_t n;
+  int fd;
+  int rv;
+
+  fd = open(path, O_RDWR | O_CREAT, S_IRWXU);
+  rtems_test_assert(fd >= 0);
+
+  n = write(fd, data, CHUNK_SIZE);
+  rtems_test_assert(n == CHUNK_SIZE);
+
+  rv = ftruncate(fd, 1);
+  rtems_test_assert(rv == 0);
+
+  n = pwrite(fd, end, sizeof(end), offset);
+  rtems_test_assert(n == (ssize_t) sizeof(end));
+
+  n = pread(fd, buf, (size_t) offset + sizeof(end), 0);
+  rtems_test_assert(n == (ssize_t) offset + (ssize_t) sizeof(end));
+  rtems_test_assert(buf[0] == data[0]);
+  rtems_test_assert(memcmp(&buf[offset], end, sizeof(end)) == 0);
+
+  memset(&buf[offset], 0, sizeof(end));
+  rtems_test_assert(buf[1] == 0);
+  rtems_test_assert(memcmp(&buf[1], &buf[2], (size_t) offset) == 0);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  rv = unlink(path);
+  rtems_test_assert(rv == 0);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  size_t i;
+  int rv;
+
+  TEST_BEGIN();
+
+  data = malloc(MAX_FILE_SIZE);
+  rtems_test_assert(data != NULL);
+
+  buf = malloc(MAX_FILE_SIZE);
+  rtems_test_assert(buf != NULL);
+
+  for (i = 0; i < MAX_FILE_SIZE; ++i) {
+    data[i] = (char) (i * 7 + i / 4096);
+  }
+
+  rv = mkdir("/mem", S_IRWXU);
+  rtems_test_assert(rv == 0);
+
+  /* The mounted IMFS uses the default memfile layout */
+  rv = mount(
+    NULL,
+    "/mem",
+    RTEMS_FILESYSTEM_TYPE_IMFS,
+    RTEMS_FILESYSTEM_READ_WRITE,
+    NULL
+  );
+  rtems_test_assert(rv == 0);
+
+  test_holes("/holes");
+
+  printf(
+    "<Test>\n"
+    "  <Counter unit=\"Hz\">%" PRIu32 "</Counter>\n",
+    rtems_counter_frequency()
+  );
+
+  for (i = 0; i < RTEMS_ARRAY_SIZE(file_sizes); ++i) {
+    test_file("memfile", "/mem/file", file_sizes[i]);
+    test_file("extent", "/file", file_sizes[i]);
+  }
+
+  printf("</Test>\n");
+
+  free(buf);
+  free(data);
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+/*
+ * Do not use a clock driver, since its interrupts would disturb the
+ * measurements.
+ */
+#define CONFIGURE_APPLICATION_DOES_NOT_NEED_CLOCK_DRIVER
+
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 4
+
+#define CONFIGURE_FILESYSTEM_IMFS
+
+/* The base IMFS uses extent files */
+#define CONFIGURE_IMFS_ENABLE_EXTENT_FILES
+
+/* Enough blocks for the largest file with the memfile layout */
+#define CONFIGURE_IMFS_MEMFILE_BYTES_PER_BLOCK 512
+
+#define CONFIGURE_MAXIMUM_TASKS 1
+
+#define CONFIGURE_INIT_TASK_STACK_SIZE (32 * 1024)
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>